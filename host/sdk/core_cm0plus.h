@@ -0,0 +1,160 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef CORE_CM0PLUS_H
+#define CORE_CM0PLUS_H
+
+#include "sim.h"
+#include <stdint.h>
+
+/**
+ * \file       core_cm0plus.h
+ * \defgroup   host-core Host Cortex-M0+ core access layer
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Replaces the CMSIS core header for the host build. Provides the register
+ * qualifiers needed by MKL17Z4.h, and maps the NVIC and PRIMASK functions to
+ * the simulated interrupt controller.
+ *
+ * @{
+ */
+
+#define __I volatile const
+#define __O volatile
+#define __IO volatile
+#define __IM volatile const
+#define __OM volatile
+#define __IOM volatile
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+
+/// \brief Enables an interrupt \param[in] IRQn Interrupt number
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+        if ((int)IRQn >= 0) {
+                sim_irq_enable((int)IRQn);
+        }
+}
+
+/// \brief Disables an interrupt \param[in] IRQn Interrupt number
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+        if ((int)IRQn >= 0) {
+                sim_irq_disable((int)IRQn);
+        }
+}
+
+/// \brief Sets an interrupt pending \param[in] IRQn Interrupt number
+static inline void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+        if ((int)IRQn >= 0) {
+                sim_irq_set_pending((int)IRQn);
+        }
+}
+
+/// \brief Clears a pending interrupt \param[in] IRQn Interrupt number
+static inline void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+        if ((int)IRQn >= 0) {
+                sim_irq_clear_pending((int)IRQn);
+        }
+}
+
+/// \brief Checks a pending interrupt \param[in] IRQn Interrupt number
+/// \return 1 if pending, else 0
+static inline uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+        return ((int)IRQn >= 0) ? sim_irq_is_pending((int)IRQn) : 0u;
+}
+
+/// \brief Sets an interrupt priority \param[in] IRQn Interrupt number
+/// \param[in] priority Priority, 0 is the highest
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+        if ((int)IRQn >= 0) {
+                sim_irq_set_priority((int)IRQn, priority);
+        }
+}
+
+/// \brief Unmasks the interrupts
+static inline void __enable_irq(void)
+{
+        sim_set_primask(0u);
+}
+
+/// \brief Masks the interrupts
+static inline void __disable_irq(void)
+{
+        sim_set_primask(1u);
+}
+
+/// \brief Gets the PRIMASK \return PRIMASK
+static inline uint32_t __get_PRIMASK(void)
+{
+        return sim_get_primask();
+}
+
+/// \brief Sets the PRIMASK \param[in] priMask PRIMASK
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+        sim_set_primask(priMask);
+}
+
+/// \brief Waits for an interrupt
+static inline void __WFI(void)
+{
+        sim_sleep(SIM_MODE_WAIT);
+}
+
+/// \brief No operation
+static inline void __NOP(void)
+{
+}
+
+/// \brief Data synchronization barrier
+static inline void __DSB(void)
+{
+}
+
+/// \brief Instruction synchronization barrier
+static inline void __ISB(void)
+{
+}
+
+/** @} */
+
+#endif // ifndef CORE_CM0PLUS_H
+
+/* EOF */
@@ -0,0 +1,383 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_adc16.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_adc16.c
+ * \defgroup   host-adc16-implementation Host ADC16 driver implementation
+ * \ingroup    host-adc16
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Interrupt of ADC0
+#define ADC0_IRQ 15
+/// Number of the input channels
+#define CHANNELS 32u
+/// Channel number which disables the converter
+#define CHANNEL_DISABLED 0x1Fu
+/// Frequency of the asynchronous clock in the normal speed mode
+#define ADACK_FREQUENCY 2400000u
+/// Frequency of the asynchronous clock in the high-speed mode
+#define ADACK_HIGH_SPEED_FREQUENCY 4000000u
+/// Clock cycles of a 16-bit conversion without the long sample time
+#define CONVERSION_CYCLES 25u
+
+/// Extra clock cycles of the long sample modes, indexed by ADLSTS
+static const uint32_t long_sample_cycles[4] = { 20u, 12u, 6u, 2u };
+
+/// Input voltages of the channels
+static uint16_t input[CHANNELS];
+/// Conversion complete event
+static sim_event_t conversion;
+/// Set when a conversion was held back by LLS
+static bool stalled;
+
+/**
+ * \brief Gets the length of a conversion
+ *
+ * \return Conversion time, including the hardware average
+ */
+static sim_time_t conversion_time(void)
+{
+        ADC_Type * const base = ADC0;
+        uint32_t const cfg1 = base->CFG1;
+        uint32_t const cfg2 = base->CFG2;
+        uint32_t const sc3 = base->SC3;
+        uint32_t const frequency = ((cfg2 & ADC_CFG2_ADHSC_MASK) ?
+                ADACK_HIGH_SPEED_FREQUENCY : ADACK_FREQUENCY) >>
+                ((cfg1 & ADC_CFG1_ADIV_MASK) >> ADC_CFG1_ADIV_SHIFT);
+        uint32_t cycles = CONVERSION_CYCLES;
+        uint32_t samples = 1u;
+
+        if (cfg1 & ADC_CFG1_ADLSMP_MASK) {
+                cycles += long_sample_cycles[(cfg2 & ADC_CFG2_ADLSTS_MASK) >>
+                        ADC_CFG2_ADLSTS_SHIFT];
+        }
+        if (sc3 & ADC_SC3_AVGE_MASK) {
+                samples = 4u << ((sc3 & ADC_SC3_AVGS_MASK) >>
+                        ADC_SC3_AVGS_SHIFT);
+        }
+
+        return ((sim_time_t)cycles * samples * SIM_S) / frequency;
+}
+
+/**
+ * \brief Checks a result against the hardware compare
+ *
+ * \param[in] value Conversion result
+ *
+ * \return True, if the result is stored
+ */
+static bool compare_true(uint32_t value)
+{
+        ADC_Type * const base = ADC0;
+        uint32_t const sc2 = base->SC2;
+        uint32_t const cv1 = base->CV1;
+        uint32_t const cv2 = base->CV2;
+        bool const greater = (sc2 & ADC_SC2_ACFGT_MASK) != 0u;
+
+        if (!(sc2 & ADC_SC2_ACFE_MASK)) {
+                return true;
+        }
+        if (!(sc2 & ADC_SC2_ACREN_MASK)) {
+                return greater ? (value >= cv1) : (value < cv1);
+        }
+        if (cv1 <= cv2) {
+                return greater ? ((value >= cv1) && (value <= cv2)) :
+                        ((value < cv1) || (value > cv2));
+        }
+
+        return greater ? ((value >= cv1) || (value <= cv2)) :
+                ((value < cv1) && (value > cv2));
+}
+
+/**
+ * \brief Starts a conversion on the channel group 0
+ */
+static void start(void)
+{
+        stalled = false;
+        if ((ADC0->SC1[0] & ADC_SC1_ADCH_MASK) == CHANNEL_DISABLED) {
+                sim_cancel(&conversion);
+                ADC0->SC2 &= ~ADC_SC2_ADACT_MASK;
+                return;
+        }
+        ADC0->SC2 |= ADC_SC2_ADACT_MASK;
+        sim_schedule(&conversion, sim_now() + conversion_time());
+}
+
+/**
+ * \brief Handles the end of a conversion
+ *
+ * \param[in] event Conversion complete event
+ */
+static void conversion_done(sim_event_t *event)
+{
+        ADC_Type * const base = ADC0;
+        uint32_t const value = input[base->SC1[0] & ADC_SC1_ADCH_MASK];
+
+        (void)event;
+
+        // The converter stops in LLS, and continues when the core wakes up.
+        if (sim_mode() == SIM_MODE_LLS) {
+                stalled = true;
+                return;
+        }
+
+        if (compare_true(value)) {
+                // R is read-only for the firmware.
+                *(uint32_t volatile *)&base->R[0] = value;
+                base->SC1[0] |= ADC_SC1_COCO_MASK;
+        }
+        if (base->SC3 & ADC_SC3_ADCO_MASK) {
+                start();
+        } else {
+                base->SC2 &= ~ADC_SC2_ADACT_MASK;
+        }
+
+        if (base->SC1[0] & ADC_SC1_COCO_MASK) {
+                sim_irq_raise(ADC0_IRQ);
+                sim_dma_request(SIM_DMA_SOURCE_ADC0);
+        }
+}
+
+/**
+ * \brief DMA request of the converter
+ *
+ * \return True, while a result waits for the DMA
+ */
+static bool adc_request(void)
+{
+        return (ADC0->SC2 & ADC_SC2_DMAEN_MASK) &&
+                (ADC0->SC1[0] & ADC_SC1_COCO_MASK);
+}
+
+/**
+ * \brief Level source of the ADC0 interrupt
+ *
+ * \return True, if the conversion complete interrupt is asserted
+ */
+static bool adc_level(void)
+{
+        uint32_t const sc1 = ADC0->SC1[0];
+
+        return (sc1 & ADC_SC1_AIEN_MASK) && (sc1 & ADC_SC1_COCO_MASK);
+}
+
+/**
+ * \brief Continues a conversion held back by LLS
+ *
+ * \param[in] from Previous power mode
+ * \param[in] to New power mode
+ */
+static void adc_power(sim_mode_t from, sim_mode_t to)
+{
+        (void)from;
+
+        if (stalled && (to != SIM_MODE_LLS)) {
+                start();
+        }
+}
+
+/// ADC model
+static const sim_peripheral_t adc_peripheral = {
+        .sync = NULL,
+        .power = adc_power
+};
+
+void sim_adc_model_init(void)
+{
+        for (uint32_t i = 0u; i < CHANNELS; ++i) {
+                input[i] = 0u;
+        }
+        conversion.handler = conversion_done;
+        conversion.next = NULL;
+        conversion.scheduled = false;
+        stalled = false;
+        ADC0->SC1[0] = ADC_SC1_ADCH(CHANNEL_DISABLED);
+        ADC0->SC1[1] = ADC_SC1_ADCH(CHANNEL_DISABLED);
+        sim_irq_set_level(ADC0_IRQ, adc_level);
+        sim_dma_set_request(SIM_DMA_SOURCE_ADC0, adc_request);
+        sim_add_peripheral(&adc_peripheral);
+}
+
+void sim_adc_set_input(uint32_t channel, uint16_t value)
+{
+        input[channel % CHANNELS] = value;
+}
+
+void sim_adc_read(uintptr_t address)
+{
+        if (address == (uintptr_t)&ADC0->R[0]) {
+                ADC0->SC1[0] &= ~ADC_SC1_COCO_MASK;
+        } else if (address == (uintptr_t)&ADC0->R[1]) {
+                ADC0->SC1[1] &= ~ADC_SC1_COCO_MASK;
+        }
+}
+
+void sim_adc_write(uintptr_t address)
+{
+        if (address == (uintptr_t)&ADC0->SC1[0]) {
+                ADC0->SC1[0] &= ~ADC_SC1_COCO_MASK;
+                start();
+        }
+}
+
+void ADC16_Init(ADC_Type *base, const adc16_config_t *config)
+{
+        uint32_t cfg1;
+        uint32_t cfg2 = ADC_CFG2_MUXSEL_MASK & base->CFG2;
+
+        CLOCK_EnableClock(kCLOCK_Adc0);
+
+        cfg1 = ADC_CFG1_ADICLK(config->clockSource) |
+                ADC_CFG1_ADIV(config->clockDivider) |
+                ADC_CFG1_MODE(config->resolution);
+        if (config->longSampleMode != kADC16_LongSampleDisabled) {
+                cfg1 |= ADC_CFG1_ADLSMP_MASK;
+                cfg2 |= ADC_CFG2_ADLSTS(config->longSampleMode);
+        }
+        if (config->enableLowPower) {
+                cfg1 |= ADC_CFG1_ADLPC_MASK;
+        }
+        if (config->enableHighSpeed) {
+                cfg2 |= ADC_CFG2_ADHSC_MASK;
+        }
+        if (config->enableAsynchronousClock) {
+                cfg2 |= ADC_CFG2_ADACKEN_MASK;
+        }
+        base->CFG1 = cfg1;
+        base->CFG2 = cfg2;
+        base->SC2 = (base->SC2 & ~ADC_SC2_REFSEL_MASK) |
+                ADC_SC2_REFSEL(config->referenceVoltageSource);
+        base->SC3 = (base->SC3 & ~ADC_SC3_ADCO_MASK) |
+                ADC_SC3_ADCO(config->enableContinuousConversion);
+}
+
+void ADC16_GetDefaultConfig(adc16_config_t *config)
+{
+        memset(config, 0, sizeof(*config));
+        config->referenceVoltageSource = kADC16_ReferenceVoltageSourceVref;
+        config->clockSource = kADC16_ClockSourceAsynchronousClock;
+        config->enableAsynchronousClock = true;
+        config->clockDivider = kADC16_ClockDivider8;
+        config->resolution = kADC16_ResolutionSE12Bit;
+        config->longSampleMode = kADC16_LongSampleDisabled;
+        config->enableHighSpeed = false;
+        config->enableLowPower = false;
+        config->enableContinuousConversion = false;
+}
+
+status_t ADC16_DoAutoCalibration(ADC_Type *base)
+{
+        (void)base;
+
+        return kStatus_Success;
+}
+
+void ADC16_SetHardwareCompareConfig(ADC_Type *base,
+        const adc16_hardware_compare_config_t *config)
+{
+        uint32_t sc2 = base->SC2 & ~(ADC_SC2_ACFE_MASK | ADC_SC2_ACFGT_MASK |
+                ADC_SC2_ACREN_MASK);
+
+        if (!config) {
+                base->SC2 = sc2;
+                return;
+        }
+
+        sc2 |= ADC_SC2_ACFE_MASK;
+        switch (config->hardwareCompareMode) {
+        case kADC16_HardwareCompareMode1:
+                sc2 |= ADC_SC2_ACFGT_MASK;
+                break;
+        case kADC16_HardwareCompareMode2:
+                sc2 |= ADC_SC2_ACREN_MASK;
+                break;
+        case kADC16_HardwareCompareMode3:
+                sc2 |= ADC_SC2_ACFGT_MASK | ADC_SC2_ACREN_MASK;
+                break;
+        default:
+                break;
+        }
+        base->SC2 = sc2;
+        base->CV1 = ADC_CV1_CV((uint16_t)config->value1);
+        base->CV2 = ADC_CV2_CV((uint16_t)config->value2);
+}
+
+void ADC16_SetHardwareAverage(ADC_Type *base,
+        adc16_hardware_average_mode_t mode)
+{
+        uint32_t sc3 = base->SC3 & ~(ADC_SC3_AVGE_MASK | ADC_SC3_AVGS_MASK |
+                ADC_SC3_CALF_MASK);
+
+        if (mode != kADC16_HardwareAverageDisabled) {
+                sc3 |= ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(mode);
+        }
+        base->SC3 = sc3;
+}
+
+void ADC16_EnableDMA(ADC_Type *base, bool enable)
+{
+        if (enable) {
+                base->SC2 |= ADC_SC2_DMAEN_MASK;
+                sim_dma_request(SIM_DMA_SOURCE_ADC0);
+        } else {
+                base->SC2 &= ~ADC_SC2_DMAEN_MASK;
+        }
+}
+
+void ADC16_SetChannelConfig(ADC_Type *base, uint32_t channelGroup,
+        const adc16_channel_config_t *config)
+{
+        base->SC1[channelGroup] = ADC_SC1_ADCH(config->channelNumber) |
+                ADC_SC1_AIEN(config->enableInterruptOnConversionCompleted) |
+                ADC_SC1_DIFF(config->enableDifferentialConversion);
+        sim_adc_write((uintptr_t)&base->SC1[channelGroup]);
+}
+
+uint32_t ADC16_GetChannelConversionValue(ADC_Type *base,
+        uint32_t channelGroup)
+{
+        uint32_t const value = base->R[channelGroup];
+
+        sim_adc_read((uintptr_t)&base->R[channelGroup]);
+
+        return value;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,253 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_ADC16_H
+#define FSL_ADC16_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_adc16.h
+ * \defgroup   host-adc16 Host ADC16 driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * A conversion samples the input voltage at its end. The conversion time
+ * follows the long sample and the hardware average settings on the
+ * asynchronous clock. Only the channel group 0 converts.
+ *
+ * @{
+ */
+
+/// Clock divider
+typedef enum _adc16_clock_divider {
+        kADC16_ClockDivider1 = 0U,
+        kADC16_ClockDivider2 = 1U,
+        kADC16_ClockDivider4 = 2U,
+        kADC16_ClockDivider8 = 3U
+} adc16_clock_divider_t;
+
+/// Resolution
+typedef enum _adc16_resolution {
+        kADC16_ResolutionSE8Bit = 0U,
+        kADC16_ResolutionSE12Bit = 1U,
+        kADC16_ResolutionSE10Bit = 2U,
+        kADC16_ResolutionSE16Bit = 3U
+} adc16_resolution_t;
+
+/// Clock source
+typedef enum _adc16_clock_source {
+        kADC16_ClockSourceAlt0 = 0U,
+        kADC16_ClockSourceAlt1 = 1U,
+        kADC16_ClockSourceAlt2 = 2U,
+        kADC16_ClockSourceAlt3 = 3U,
+        kADC16_ClockSourceAsynchronousClock = kADC16_ClockSourceAlt3
+} adc16_clock_source_t;
+
+/// Long sample mode
+typedef enum _adc16_long_sample_mode {
+        kADC16_LongSampleCycle24 = 0U,
+        kADC16_LongSampleCycle16 = 1U,
+        kADC16_LongSampleCycle10 = 2U,
+        kADC16_LongSampleCycle6 = 3U,
+        kADC16_LongSampleDisabled = 4U
+} adc16_long_sample_mode_t;
+
+/// Reference voltage source
+typedef enum _adc16_reference_voltage_source {
+        kADC16_ReferenceVoltageSourceVref = 0U,
+        kADC16_ReferenceVoltageSourceValt = 1U
+} adc16_reference_voltage_source_t;
+
+/// Hardware average
+typedef enum _adc16_hardware_average_mode {
+        kADC16_HardwareAverageCount4 = 0U,
+        kADC16_HardwareAverageCount8 = 1U,
+        kADC16_HardwareAverageCount16 = 2U,
+        kADC16_HardwareAverageCount32 = 3U,
+        kADC16_HardwareAverageDisabled = 4U
+} adc16_hardware_average_mode_t;
+
+/// Hardware compare mode
+typedef enum _adc16_hardware_compare_mode {
+        /// x < value1
+        kADC16_HardwareCompareMode0 = 0U,
+        /// x > value1
+        kADC16_HardwareCompareMode1 = 1U,
+        /// Outside of the range of value1 and value2
+        kADC16_HardwareCompareMode2 = 2U,
+        /// Inside of the range of value1 and value2
+        kADC16_HardwareCompareMode3 = 3U
+} adc16_hardware_compare_mode_t;
+
+/// Channel multiplexer mode
+typedef enum _adc_channel_mux_mode {
+        kADC16_ChannelMuxA = 0U,
+        kADC16_ChannelMuxB = 1U
+} adc16_channel_mux_mode_t;
+
+/// Converter configuration
+typedef struct _adc16_config {
+        /// Reference voltage source
+        adc16_reference_voltage_source_t referenceVoltageSource;
+        /// Clock source
+        adc16_clock_source_t clockSource;
+        /// True to keep the asynchronous clock running
+        bool enableAsynchronousClock;
+        /// Clock divider
+        adc16_clock_divider_t clockDivider;
+        /// Resolution
+        adc16_resolution_t resolution;
+        /// Long sample mode
+        adc16_long_sample_mode_t longSampleMode;
+        /// True for the high-speed mode
+        bool enableHighSpeed;
+        /// True for the low power mode
+        bool enableLowPower;
+        /// True for the continuous conversions
+        bool enableContinuousConversion;
+} adc16_config_t;
+
+/// Hardware compare configuration
+typedef struct _adc16_hardware_compare_config {
+        /// Compare mode
+        adc16_hardware_compare_mode_t hardwareCompareMode;
+        /// First compare value
+        int16_t value1;
+        /// Second compare value
+        int16_t value2;
+} adc16_hardware_compare_config_t;
+
+/// Channel configuration
+typedef struct _adc16_channel_config {
+        /// Input channel, 0x1F disables the converter
+        uint32_t channelNumber;
+        /// True to interrupt when a conversion completes
+        bool enableInterruptOnConversionCompleted;
+        /// True for a differential conversion
+        bool enableDifferentialConversion;
+} adc16_channel_config_t;
+
+/**
+ * \brief Initializes the converter
+ *
+ * \param[in] base ADC instance
+ * \param[in] config Configuration
+ */
+void ADC16_Init(ADC_Type *base, const adc16_config_t *config);
+
+/**
+ * \brief Gets the default configuration
+ *
+ * \param[out] config Configuration
+ */
+void ADC16_GetDefaultConfig(adc16_config_t *config);
+
+/**
+ * \brief Calibrates the converter
+ *
+ * \param[in] base ADC instance
+ *
+ * \return Status of the calibration
+ */
+status_t ADC16_DoAutoCalibration(ADC_Type *base);
+
+/**
+ * \brief Selects the channel multiplexer
+ *
+ * \param[in] base ADC instance
+ * \param[in] mode Multiplexer mode
+ */
+static inline void ADC16_SetChannelMuxMode(ADC_Type *base,
+        adc16_channel_mux_mode_t mode)
+{
+        if (mode == kADC16_ChannelMuxB) {
+                base->CFG2 |= ADC_CFG2_MUXSEL_MASK;
+        } else {
+                base->CFG2 &= ~ADC_CFG2_MUXSEL_MASK;
+        }
+}
+
+/**
+ * \brief Sets the hardware compare
+ *
+ * \param[in] base ADC instance
+ * \param[in] config Compare configuration, or NULL to disable the compare
+ */
+void ADC16_SetHardwareCompareConfig(ADC_Type *base,
+        const adc16_hardware_compare_config_t *config);
+
+/**
+ * \brief Sets the hardware average
+ *
+ * \param[in] base ADC instance
+ * \param[in] mode Average mode
+ */
+void ADC16_SetHardwareAverage(ADC_Type *base,
+        adc16_hardware_average_mode_t mode);
+
+/**
+ * \brief Enables or disables the DMA request on conversion complete
+ *
+ * \param[in] base ADC instance
+ * \param[in] enable True to enable
+ */
+void ADC16_EnableDMA(ADC_Type *base, bool enable);
+
+/**
+ * \brief Configures a channel group, which starts a conversion
+ *
+ * \param[in] base ADC instance
+ * \param[in] channelGroup Channel group
+ * \param[in] config Channel configuration
+ */
+void ADC16_SetChannelConfig(ADC_Type *base, uint32_t channelGroup,
+        const adc16_channel_config_t *config);
+
+/**
+ * \brief Gets the conversion result of a channel group
+ *
+ * Reading the result clears the conversion complete flag.
+ *
+ * \param[in] base ADC instance
+ * \param[in] channelGroup Channel group
+ *
+ * \return Conversion result
+ */
+uint32_t ADC16_GetChannelConversionValue(ADC_Type *base,
+        uint32_t channelGroup);
+
+/** @} */
+
+#endif // ifndef FSL_ADC16_H
+
+/* EOF */
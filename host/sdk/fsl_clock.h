@@ -0,0 +1,156 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_CLOCK_H
+#define FSL_CLOCK_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_clock.h
+ * \defgroup   host-clock Host clock driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The clock gates and the source selections are written to the SIM
+ * registers. The simulated clock tree is fixed: the LIRC runs at 8 MHz as
+ * the MCGIRCLK and the LPO at 1 kHz.
+ *
+ * @{
+ */
+
+/// Frequency of the MCGIRCLK in Hz
+#define SIM_MCGIRCLK_FREQUENCY 8000000u
+/// Frequency of the LPO in Hz
+#define SIM_LPO_FREQUENCY 1000u
+
+/// Encodes a clock gate as SIM register offset and bit position
+#define CLK_GATE_DEFINE(reg_offset, bit_shift) \
+        (((reg_offset) << 16U) | (bit_shift))
+/// Gets the SIM register offset of a clock gate
+#define CLK_GATE_ABSTRACT_REG_OFFSET(x) (((uint32_t)(x)) >> 16U)
+/// Gets the bit position of a clock gate
+#define CLK_GATE_ABSTRACT_BITS_SHIFT(x) (((uint32_t)(x)) & 0xFFFFU)
+
+/// Clock gates
+typedef enum _clock_ip_name {
+        kCLOCK_IpInvalid = 0U,
+        kCLOCK_Cmp0 = CLK_GATE_DEFINE(0x1034U, 19U),
+        kCLOCK_Lptmr0 = CLK_GATE_DEFINE(0x1038U, 0U),
+        kCLOCK_PortA = CLK_GATE_DEFINE(0x1038U, 9U),
+        kCLOCK_PortB = CLK_GATE_DEFINE(0x1038U, 10U),
+        kCLOCK_PortC = CLK_GATE_DEFINE(0x1038U, 11U),
+        kCLOCK_PortD = CLK_GATE_DEFINE(0x1038U, 12U),
+        kCLOCK_PortE = CLK_GATE_DEFINE(0x1038U, 13U),
+        kCLOCK_Lpuart0 = CLK_GATE_DEFINE(0x1038U, 20U),
+        kCLOCK_Ftf0 = CLK_GATE_DEFINE(0x103CU, 0U),
+        kCLOCK_Dmamux0 = CLK_GATE_DEFINE(0x103CU, 1U),
+        kCLOCK_Tpm0 = CLK_GATE_DEFINE(0x103CU, 24U),
+        kCLOCK_Tpm1 = CLK_GATE_DEFINE(0x103CU, 25U),
+        kCLOCK_Tpm2 = CLK_GATE_DEFINE(0x103CU, 26U),
+        kCLOCK_Adc0 = CLK_GATE_DEFINE(0x103CU, 27U),
+        kCLOCK_Dma0 = CLK_GATE_DEFINE(0x1040U, 8U)
+} clock_ip_name_t;
+
+/// Clocks
+typedef enum _clock_name {
+        kCLOCK_CoreSysClk,
+        kCLOCK_PlatClk,
+        kCLOCK_BusClk,
+        kCLOCK_FlexBusClk,
+        kCLOCK_FlashClk,
+        kCLOCK_FastPeriphClk,
+        kCLOCK_PllFllSelClk,
+        kCLOCK_Er32kClk,
+        kCLOCK_Osc0ErClk,
+        kCLOCK_Osc1ErClk,
+        kCLOCK_Osc0ErClkUndiv,
+        kCLOCK_McgFixedFreqClk,
+        kCLOCK_McgInternalRefClk,
+        kCLOCK_McgFllClk,
+        kCLOCK_McgPll0Clk,
+        kCLOCK_McgPll1Clk,
+        kCLOCK_McgExtPllClk,
+        kCLOCK_McgPeriphClk,
+        kCLOCK_McgIrc48MClk,
+        kCLOCK_LpoClk
+} clock_name_t;
+
+/**
+ * \brief Enables the clock of a module
+ *
+ * \param[in] name Clock gate
+ */
+static inline void CLOCK_EnableClock(clock_ip_name_t name)
+{
+        volatile uint32_t *reg = (volatile uint32_t *)(uintptr_t)(SIM_BASE +
+                CLK_GATE_ABSTRACT_REG_OFFSET(name));
+
+        *reg |= 1UL << CLK_GATE_ABSTRACT_BITS_SHIFT(name);
+}
+
+/**
+ * \brief Selects the LPUART0 clock source
+ *
+ * \param[in] src Source selection
+ */
+static inline void CLOCK_SetLpuart0Clock(uint32_t src)
+{
+        SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_LPUART0SRC_MASK) |
+                SIM_SOPT2_LPUART0SRC(src);
+}
+
+/**
+ * \brief Selects the TPM clock source
+ *
+ * \param[in] src Source selection
+ */
+static inline void CLOCK_SetTpmClock(uint32_t src)
+{
+        SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_TPMSRC_MASK) |
+                SIM_SOPT2_TPMSRC(src);
+}
+
+/**
+ * \brief Gets the frequency of a clock
+ *
+ * \param[in] clockName Clock
+ *
+ * \return Frequency in Hz, 0 for a clock not simulated
+ */
+uint32_t CLOCK_GetFreq(clock_name_t clockName);
+
+/** @} */
+
+#endif // ifndef FSL_CLOCK_H
+
+/* EOF */
@@ -0,0 +1,221 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_cmp.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_cmp.c
+ * \defgroup   host-cmp-implementation Host CMP driver implementation
+ * \ingroup    host-cmp
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Interrupt of CMP0
+#define CMP0_IRQ 16
+/// Number of the inputs
+#define INPUTS 8u
+/// Input connected to the DAC
+#define INPUT_DAC 7u
+/// Number of the DAC levels
+#define DAC_LEVELS 64u
+/// Event flags of the status register, cleared by writing one
+#define EVENT_FLAGS (CMP_SCR_CFR_MASK | CMP_SCR_CFF_MASK)
+
+/// Voltages of the external inputs
+static uint16_t input[INPUTS];
+
+/**
+ * \brief Gets the voltage of an input
+ *
+ * \param[in] channel Input
+ *
+ * \return Voltage relative to SIM_ANALOG_FULL_SCALE
+ */
+static uint32_t voltage_of(uint32_t channel)
+{
+        uint32_t const daccr = CMP0->DACCR;
+
+        if (channel != INPUT_DAC) {
+                return input[channel];
+        }
+        if (!(daccr & CMP_DACCR_DACEN_MASK)) {
+                return 0u;
+        }
+
+        return ((((daccr & CMP_DACCR_VOSEL_MASK) >> CMP_DACCR_VOSEL_SHIFT) +
+                1u) * SIM_ANALOG_FULL_SCALE) / DAC_LEVELS;
+}
+
+/**
+ * \brief Checks if an enabled event flag is set
+ *
+ * \return True, if the comparator requests an interrupt
+ */
+static bool cmp_level(void)
+{
+        uint32_t const scr = CMP0->SCR;
+
+        return ((scr & CMP_SCR_IER_MASK) && (scr & CMP_SCR_CFR_MASK)) ||
+                ((scr & CMP_SCR_IEF_MASK) && (scr & CMP_SCR_CFF_MASK));
+}
+
+/**
+ * \brief Updates the output and the event flags from the inputs
+ */
+static void compare(void)
+{
+        CMP_Type * const base = CMP0;
+        uint32_t const muxcr = base->MUXCR;
+        bool output = false;
+        bool previous = (base->SCR & CMP_SCR_COUT_MASK) != 0u;
+
+        if (base->CR1 & CMP_CR1_EN_MASK) {
+                output = voltage_of((muxcr & CMP_MUXCR_PSEL_MASK) >>
+                        CMP_MUXCR_PSEL_SHIFT) > voltage_of((muxcr &
+                        CMP_MUXCR_MSEL_MASK) >> CMP_MUXCR_MSEL_SHIFT);
+                if (base->CR1 & CMP_CR1_INV_MASK) {
+                        output = !output;
+                }
+        }
+        if (output == previous) {
+                return;
+        }
+
+        if (output) {
+                base->SCR = (uint8_t)(base->SCR | CMP_SCR_COUT_MASK |
+                        CMP_SCR_CFR_MASK);
+        } else {
+                base->SCR = (uint8_t)((base->SCR & ~CMP_SCR_COUT_MASK) |
+                        CMP_SCR_CFF_MASK);
+        }
+        sim_llwu_module_flag(SIM_LLWU_MODULE_CMP, cmp_level());
+        sim_irq_raise(CMP0_IRQ);
+}
+
+void sim_cmp_model_init(void)
+{
+        for (uint32_t i = 0u; i < INPUTS; ++i) {
+                input[i] = 0u;
+        }
+        sim_irq_set_level(CMP0_IRQ, cmp_level);
+}
+
+void sim_cmp_set_input(uint32_t channel, uint16_t value)
+{
+        if (channel < INPUTS) {
+                input[channel] = value;
+                compare();
+        }
+}
+
+void CMP_Init(CMP_Type *base, const cmp_config_t *config)
+{
+        CLOCK_EnableClock(kCLOCK_Cmp0);
+
+        base->CR0 = (uint8_t)CMP_CR0_HYSTCTR(config->hysteresisMode);
+        base->CR1 = (uint8_t)(CMP_CR1_EN(config->enableCmp) |
+                CMP_CR1_PMODE(config->enableHighSpeed) |
+                CMP_CR1_INV(config->enableInvertOutput) |
+                CMP_CR1_COS(config->useUnfilteredOutput) |
+                CMP_CR1_OPE(config->enablePinOut) |
+                CMP_CR1_TRIGM(config->enableTriggerMode));
+        compare();
+}
+
+void CMP_GetDefaultConfig(cmp_config_t *config)
+{
+        memset(config, 0, sizeof(*config));
+        config->enableCmp = true;
+        config->hysteresisMode = kCMP_HysteresisLevel0;
+}
+
+void CMP_Enable(CMP_Type *base, bool enable)
+{
+        if (enable) {
+                base->CR1 |= CMP_CR1_EN_MASK;
+        } else {
+                base->CR1 &= (uint8_t)~CMP_CR1_EN_MASK;
+        }
+        compare();
+}
+
+void CMP_SetInputChannels(CMP_Type *base, uint8_t positiveChannel,
+        uint8_t negativeChannel)
+{
+        base->MUXCR = (uint8_t)(CMP_MUXCR_PSEL(positiveChannel) |
+                CMP_MUXCR_MSEL(negativeChannel));
+        compare();
+}
+
+void CMP_SetFilterConfig(CMP_Type *base, const cmp_filter_config_t *config)
+{
+        base->CR0 = (uint8_t)((base->CR0 & ~CMP_CR0_FILTER_CNT_MASK) |
+                CMP_CR0_FILTER_CNT(config->filterCount));
+        base->FPR = config->filterPeriod;
+}
+
+void CMP_SetDACConfig(CMP_Type *base, const cmp_dac_config_t *config)
+{
+        if (!config) {
+                base->DACCR = 0u;
+        } else {
+                base->DACCR = (uint8_t)(CMP_DACCR_DACEN_MASK |
+                        CMP_DACCR_VRSEL(config->referenceVoltageSource) |
+                        CMP_DACCR_VOSEL(config->DACValue));
+        }
+        compare();
+}
+
+void CMP_EnableInterrupts(CMP_Type *base, uint32_t mask)
+{
+        base->SCR |= (uint8_t)(mask & (CMP_SCR_IER_MASK | CMP_SCR_IEF_MASK));
+        sim_llwu_module_flag(SIM_LLWU_MODULE_CMP, cmp_level());
+        sim_irq_raise(CMP0_IRQ);
+}
+
+void CMP_DisableInterrupts(CMP_Type *base, uint32_t mask)
+{
+        base->SCR &= (uint8_t)~mask;
+        sim_llwu_module_flag(SIM_LLWU_MODULE_CMP, cmp_level());
+}
+
+void CMP_ClearStatusFlags(CMP_Type *base, uint32_t mask)
+{
+        base->SCR &= (uint8_t)~(mask & EVENT_FLAGS);
+        sim_llwu_module_flag(SIM_LLWU_MODULE_CMP, cmp_level());
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,201 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_CMP_H
+#define FSL_CMP_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_cmp.h
+ * \defgroup   host-cmp Host CMP driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The output follows the inputs without the filter delay and the
+ * hysteresis. The comparator keeps running in all the power modes.
+ *
+ * @{
+ */
+
+/// Interrupt enables
+enum _cmp_interrupt_enable {
+        kCMP_OutputRisingInterruptEnable = CMP_SCR_IER_MASK,
+        kCMP_OutputFallingInterruptEnable = CMP_SCR_IEF_MASK
+};
+
+/// Status flags
+enum _cmp_status_flags {
+        kCMP_OutputRisingEventFlag = CMP_SCR_CFR_MASK,
+        kCMP_OutputFallingEventFlag = CMP_SCR_CFF_MASK,
+        kCMP_OutputAssertEventFlag = CMP_SCR_COUT_MASK
+};
+
+/// Hysteresis level
+typedef enum _cmp_hysteresis_mode {
+        kCMP_HysteresisLevel0 = 0U,
+        kCMP_HysteresisLevel1 = 1U,
+        kCMP_HysteresisLevel2 = 2U,
+        kCMP_HysteresisLevel3 = 3U
+} cmp_hysteresis_mode_t;
+
+/// Supply of the DAC
+typedef enum _cmp_reference_voltage_source {
+        kCMP_VrefSourceVin1 = 0U,
+        kCMP_VrefSourceVin2 = 1U
+} cmp_reference_voltage_source_t;
+
+/// Comparator configuration
+typedef struct _cmp_config {
+        /// True to enable the comparator
+        bool enableCmp;
+        /// Hysteresis level
+        cmp_hysteresis_mode_t hysteresisMode;
+        /// True for the high-speed mode
+        bool enableHighSpeed;
+        /// True to invert the output
+        bool enableInvertOutput;
+        /// True to bypass the filter
+        bool useUnfilteredOutput;
+        /// True to drive the output pin
+        bool enablePinOut;
+        /// True for the trigger mode
+        bool enableTriggerMode;
+} cmp_config_t;
+
+/// Filter configuration
+typedef struct _cmp_filter_config {
+        /// Number of the samples, 0 disables the filter
+        uint8_t filterCount;
+        /// Sample period in bus clock cycles
+        uint8_t filterPeriod;
+} cmp_filter_config_t;
+
+/// DAC configuration
+typedef struct _cmp_dac_config {
+        /// Supply of the DAC
+        cmp_reference_voltage_source_t referenceVoltageSource;
+        /// Output level, 0...63
+        uint8_t DACValue;
+} cmp_dac_config_t;
+
+/**
+ * \brief Initializes the comparator
+ *
+ * \param[in] base CMP instance
+ * \param[in] config Configuration
+ */
+void CMP_Init(CMP_Type *base, const cmp_config_t *config);
+
+/**
+ * \brief Gets the default configuration
+ *
+ * \param[out] config Configuration
+ */
+void CMP_GetDefaultConfig(cmp_config_t *config);
+
+/**
+ * \brief Enables or disables the comparator
+ *
+ * \param[in] base CMP instance
+ * \param[in] enable True to enable
+ */
+void CMP_Enable(CMP_Type *base, bool enable);
+
+/**
+ * \brief Selects the inputs
+ *
+ * \param[in] base CMP instance
+ * \param[in] positiveChannel Positive input
+ * \param[in] negativeChannel Negative input
+ */
+void CMP_SetInputChannels(CMP_Type *base, uint8_t positiveChannel,
+        uint8_t negativeChannel);
+
+/**
+ * \brief Configures the filter
+ *
+ * \param[in] base CMP instance
+ * \param[in] config Filter configuration
+ */
+void CMP_SetFilterConfig(CMP_Type *base, const cmp_filter_config_t *config);
+
+/**
+ * \brief Configures the DAC
+ *
+ * \param[in] base CMP instance
+ * \param[in] config DAC configuration, or NULL to disable the DAC
+ */
+void CMP_SetDACConfig(CMP_Type *base, const cmp_dac_config_t *config);
+
+/**
+ * \brief Enables interrupts
+ *
+ * \param[in] base CMP instance
+ * \param[in] mask Interrupts, as _cmp_interrupt_enable
+ */
+void CMP_EnableInterrupts(CMP_Type *base, uint32_t mask);
+
+/**
+ * \brief Disables interrupts
+ *
+ * \param[in] base CMP instance
+ * \param[in] mask Interrupts, as _cmp_interrupt_enable
+ */
+void CMP_DisableInterrupts(CMP_Type *base, uint32_t mask);
+
+/**
+ * \brief Gets the status flags
+ *
+ * \param[in] base CMP instance
+ *
+ * \return Flags, as _cmp_status_flags
+ */
+static inline uint32_t CMP_GetStatusFlags(CMP_Type *base)
+{
+        return base->SCR & (CMP_SCR_CFR_MASK | CMP_SCR_CFF_MASK |
+                CMP_SCR_COUT_MASK);
+}
+
+/**
+ * \brief Clears the status flags
+ *
+ * \param[in] base CMP instance
+ * \param[in] mask Flags, as _cmp_status_flags
+ */
+void CMP_ClearStatusFlags(CMP_Type *base, uint32_t mask);
+
+/** @} */
+
+#endif // ifndef FSL_CMP_H
+
+/* EOF */
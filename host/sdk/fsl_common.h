@@ -0,0 +1,150 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_COMMON_H
+#define FSL_COMMON_H
+
+#include "fsl_device_registers.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * \file       fsl_common.h
+ * \defgroup   host-sdk Host SDK drivers
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Host implementations of the MCUXpresso SDK driver functions used by the
+ * firmware. The declarations follow the SDK 2.7.0 drivers of the MKL17Z4, so
+ * the firmware compiles unmodified, but only the subset used by the firmware
+ * is provided. The functions operate on the RAM backed registers and
+ * simulate the side effects of the hardware.
+ *
+ * @{
+ */
+
+/// Constructs a status code from a group and a code
+#define MAKE_STATUS(group, code) ((((group)*100) + (code)))
+
+/// Aligns a variable
+#define SDK_ALIGN(var, alignbytes) var __attribute__((aligned(alignbytes)))
+
+/// Status groups
+enum _status_groups {
+        kStatusGroup_Generic = 0,
+        kStatusGroup_FLASH = 1,
+        kStatusGroup_DMA = 50,
+        kStatusGroup_LPUART = 13,
+        kStatusGroup_OSA = 143
+};
+
+/// Generic status codes
+enum {
+        kStatus_Success = MAKE_STATUS(kStatusGroup_Generic, 0),
+        kStatus_Fail = MAKE_STATUS(kStatusGroup_Generic, 1),
+        kStatus_ReadOnly = MAKE_STATUS(kStatusGroup_Generic, 2),
+        kStatus_OutOfRange = MAKE_STATUS(kStatusGroup_Generic, 3),
+        kStatus_InvalidArgument = MAKE_STATUS(kStatusGroup_Generic, 4),
+        kStatus_Timeout = MAKE_STATUS(kStatusGroup_Generic, 5),
+        kStatus_NoTransferInProgress = MAKE_STATUS(kStatusGroup_Generic, 6)
+};
+
+/// Status of a driver function
+typedef int32_t status_t;
+
+/**
+ * \brief Enables an interrupt in the NVIC
+ *
+ * \param[in] interrupt Interrupt number
+ *
+ * \return Status of the operation
+ */
+static inline status_t EnableIRQ(IRQn_Type interrupt)
+{
+        if (interrupt == NotAvail_IRQn) {
+                return kStatus_Fail;
+        }
+        NVIC_EnableIRQ(interrupt);
+
+        return kStatus_Success;
+}
+
+/**
+ * \brief Disables an interrupt in the NVIC
+ *
+ * \param[in] interrupt Interrupt number
+ *
+ * \return Status of the operation
+ */
+static inline status_t DisableIRQ(IRQn_Type interrupt)
+{
+        if (interrupt == NotAvail_IRQn) {
+                return kStatus_Fail;
+        }
+        NVIC_DisableIRQ(interrupt);
+
+        return kStatus_Success;
+}
+
+/**
+ * \brief Masks the interrupts
+ *
+ * \return PRIMASK before masking
+ */
+static inline uint32_t DisableGlobalIRQ(void)
+{
+        uint32_t const primask = __get_PRIMASK();
+
+        __disable_irq();
+
+        return primask;
+}
+
+/**
+ * \brief Restores the interrupt mask
+ *
+ * \param[in] primask PRIMASK returned by DisableGlobalIRQ()
+ */
+static inline void EnableGlobalIRQ(uint32_t primask)
+{
+        __set_PRIMASK(primask);
+}
+
+/** @} */
+
+#include "fsl_clock.h"
+
+#endif // ifndef FSL_COMMON_H
+
+/* EOF */
@@ -0,0 +1,181 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_cop.h"
+#include "sim_model.h"
+#include <stdio.h>
+
+/**
+ * \file       fsl_cop.c
+ * \defgroup   host-cop-implementation Host COP driver implementation
+ * \ingroup    host-cop
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Timeout event
+static sim_event_t timeout;
+/// True after the configuration has been written
+static bool configured;
+/// Remaining time while the watchdog is stopped in a stop mode
+static sim_time_t remaining;
+
+/**
+ * \brief Gets the timeout period
+ *
+ * \return Period, 0 if the watchdog is disabled
+ */
+static sim_time_t period(void)
+{
+        // Timeout exponents of the short and long timeout modes
+        static uint8_t const exponents[2][4] = {
+                { 0u, 5u, 8u, 10u }, { 0u, 13u, 16u, 18u }
+        };
+        uint32_t const copc = SIM->COPC;
+        uint32_t const copt = (copc & SIM_COPC_COPT_MASK) >>
+                SIM_COPC_COPT_SHIFT;
+        uint32_t const long_mode = (copc & SIM_COPC_COPCLKS_MASK) ? 1u : 0u;
+
+        if (!copt) {
+                return 0u;
+        }
+
+        return ((sim_time_t)SIM_S << exponents[long_mode][copt]) /
+                SIM_LPO_FREQUENCY;
+}
+
+/**
+ * \brief Checks if the watchdog runs in a power mode
+ *
+ * \param[in] mode Power mode
+ *
+ * \return True, if running
+ */
+static bool runs_in(sim_mode_t mode)
+{
+        return (mode == SIM_MODE_RUN) || (mode == SIM_MODE_WAIT) ||
+                (SIM->COPC & SIM_COPC_COPSTPEN_MASK);
+}
+
+/**
+ * \brief Handles the timeout
+ *
+ * \param[in] event Timeout event
+ */
+static void timeout_event(sim_event_t *event)
+{
+        (void)event;
+        fprintf(stderr, "sim: COP timeout at %.6f s\n",
+                (double)sim_now() / (double)SIM_S);
+        sim_stop();
+}
+
+/**
+ * \brief Pauses and resumes the watchdog in the stop modes
+ *
+ * \param[in] from Previous power mode
+ * \param[in] to New power mode
+ */
+static void cop_power(sim_mode_t from, sim_mode_t to)
+{
+        if (!configured || (runs_in(from) == runs_in(to))) {
+                return;
+        }
+        if (!runs_in(to)) {
+                remaining = timeout.scheduled ? (timeout.time - sim_now()) :
+                        0u;
+                sim_cancel(&timeout);
+        } else if (remaining) {
+                sim_schedule(&timeout, sim_now() + remaining);
+        }
+}
+
+/// COP model
+static const sim_peripheral_t cop_peripheral = {
+        .sync = NULL,
+        .power = cop_power
+};
+
+void sim_cop_model_init(void)
+{
+        timeout.handler = timeout_event;
+        timeout.next = NULL;
+        timeout.scheduled = false;
+        configured = false;
+        remaining = 0u;
+        sim_add_peripheral(&cop_peripheral);
+}
+
+void COP_GetDefaultConfig(cop_config_t *config)
+{
+        config->enableWindowMode = false;
+        config->timeoutMode = kCOP_LongTimeoutMode;
+        config->enableStop = false;
+        config->enableDebug = false;
+        config->clockSource = kCOP_LpoClock;
+        config->timeoutCycles = kCOP_2Power10CyclesOr2Power18Cycles;
+}
+
+void COP_Init(SIM_Type *base, const cop_config_t *config)
+{
+        if (configured) {
+                return;
+        }
+        configured = true;
+        base->COPC = SIM_COPC_COPW(config->enableWindowMode) |
+                SIM_COPC_COPCLKS(config->timeoutMode) |
+                SIM_COPC_COPT(config->timeoutCycles) |
+                SIM_COPC_COPSTPEN(config->enableStop) |
+                SIM_COPC_COPDBGEN(config->enableDebug) |
+                SIM_COPC_COPCLKSEL(config->clockSource);
+        COP_Refresh(base);
+}
+
+void COP_Refresh(SIM_Type *base)
+{
+        sim_time_t const length = period();
+
+        base->SRVCOP = COP_FIRST_BYTE_OF_REFRESH;
+        base->SRVCOP = COP_SECOND_BYTE_OF_REFRESH;
+        if (!length) {
+                return;
+        }
+        if (runs_in(sim_mode())) {
+                sim_schedule(&timeout, sim_now() + length);
+        } else {
+                remaining = length;
+        }
+}
+
+/** @} */
+
+/* EOF */
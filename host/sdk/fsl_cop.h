@@ -0,0 +1,123 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_COP_H
+#define FSL_COP_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_cop.h
+ * \defgroup   host-cop Host COP driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The watchdog counts the simulated time in RUN and WAIT, and also in the
+ * stop modes if enabled. A timeout stops the simulation, as the firmware
+ * would be reset. Only the LPO clock and the normal mode are simulated.
+ *
+ * @{
+ */
+
+/// First byte of the refresh sequence
+#define COP_FIRST_BYTE_OF_REFRESH (0x55U)
+/// Second byte of the refresh sequence
+#define COP_SECOND_BYTE_OF_REFRESH (0xAAU)
+
+/// Clock source
+typedef enum _cop_clock_source {
+        kCOP_LpoClock = 0U,
+        kCOP_McgIrClock = 1U,
+        kCOP_OscErClock = 2U,
+        kCOP_BusClock = 3U
+} cop_clock_source_t;
+
+/// Timeout in clock cycles, short or long timeout mode
+typedef enum _cop_timeout_cycles {
+        kCOP_2Power5CyclesOr2Power13Cycles = 1U,
+        kCOP_2Power8CyclesOr2Power16Cycles = 2U,
+        kCOP_2Power10CyclesOr2Power18Cycles = 3U
+} cop_timeout_cycles_t;
+
+/// Timeout mode
+typedef enum _cop_timeout_mode {
+        kCOP_ShortTimeoutMode = 0U,
+        kCOP_LongTimeoutMode = 1U
+} cop_timeout_mode_t;
+
+/// Watchdog configuration
+typedef struct _cop_config {
+        /// True for the window mode
+        bool enableWindowMode;
+        /// Timeout mode
+        cop_timeout_mode_t timeoutMode;
+        /// True to run in the stop modes
+        bool enableStop;
+        /// True to run while the debugger halts the core
+        bool enableDebug;
+        /// Clock source
+        cop_clock_source_t clockSource;
+        /// Timeout
+        cop_timeout_cycles_t timeoutCycles;
+} cop_config_t;
+
+/**
+ * \brief Gets the default configuration
+ *
+ * 2^18 LPO cycles in the long timeout mode, stopped in the stop modes.
+ *
+ * \param[out] config Watchdog configuration
+ */
+void COP_GetDefaultConfig(cop_config_t *config);
+
+/**
+ * \brief Configures and starts the watchdog
+ *
+ * The configuration can be written only once.
+ *
+ * \param[in] base SIM instance
+ * \param[in] config Watchdog configuration
+ */
+void COP_Init(SIM_Type *base, const cop_config_t *config);
+
+/**
+ * \brief Refreshes the watchdog
+ *
+ * \param[in] base SIM instance
+ */
+void COP_Refresh(SIM_Type *base);
+
+/** @} */
+
+#endif // ifndef FSL_COP_H
+
+/* EOF */
@@ -0,0 +1,518 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_dma.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_dma.c
+ * \defgroup   host-dma-implementation Host DMA driver implementation
+ * \ingroup    host-dma
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Number of the channels
+#define CHANNELS 4u
+/// Number of the DMAMUX request sources
+#define SOURCES 64u
+/// Interrupt of channel 0, the others follow
+#define DMA0_IRQ 0
+
+/// Start of the peripheral address space
+#define PERIPHERAL_START 0x40000000u
+/// End of the peripheral address space
+#define PERIPHERAL_END 0x40100000u
+
+/// Handles of the channels
+static dma_handle_t *handles[CHANNELS];
+/// Source addresses of the channels
+static uintptr_t source[CHANNELS];
+/// Destination addresses of the channels
+static uintptr_t destination[CHANNELS];
+/// Request states of the peripherals
+static sim_dma_request_t requests[SOURCES];
+
+/**
+ * \brief Gets the size of a transfer
+ *
+ * \param[in] size Size field of the DCR
+ *
+ * \return Size in bytes
+ */
+static inline uint32_t bytes_of(uint32_t size)
+{
+        return (size == kDMA_Transfersize8bits) ? 1u :
+                (size == kDMA_Transfersize16bits) ? 2u : 4u;
+}
+
+/**
+ * \brief Checks if an address is a peripheral register
+ *
+ * \param[in] address Address
+ *
+ * \return True, if a peripheral register
+ */
+static inline bool peripheral(uintptr_t address)
+{
+        return (address >= PERIPHERAL_START) && (address < PERIPHERAL_END);
+}
+
+/**
+ * \brief Increments an address within its modulo
+ *
+ * \param[in] address Address
+ * \param[in] increment Increment in bytes
+ * \param[in] modulo Modulo field of the DCR
+ *
+ * \return New address
+ */
+static uintptr_t increment(uintptr_t address, uint32_t increment,
+        uint32_t modulo)
+{
+        uintptr_t mask;
+
+        if (modulo == kDMA_ModuloDisable) {
+                return address + increment;
+        }
+        mask = (16u << (modulo - 1u)) - 1u;
+
+        return (address & ~mask) | ((address + increment) & mask);
+}
+
+/**
+ * \brief Performs one cycle-steal transfer of a channel
+ *
+ * One read of the source size and one write of the destination size, the
+ * byte count decreasing by the destination size.
+ *
+ * \param[in] channel Channel
+ *
+ * \return True, if the byte count reached zero
+ */
+static bool transfer(uint32_t channel)
+{
+        DMA_Type * const base = DMA0;
+        uint32_t const dcr = base->DMA[channel].DCR;
+        uint32_t const read_size = bytes_of((dcr & DMA_DCR_SSIZE_MASK) >>
+                DMA_DCR_SSIZE_SHIFT);
+        uint32_t const write_size = bytes_of((dcr & DMA_DCR_DSIZE_MASK) >>
+                DMA_DCR_DSIZE_SHIFT);
+        uint32_t count = DMA_GetRemainingBytes(base, channel);
+        uint32_t value = 0u;
+
+        if (!count) {
+                return false;
+        }
+
+        if (peripheral(source[channel])) {
+                sim_bus_read(source[channel]);
+        }
+        memcpy(&value, (void const *)source[channel], read_size);
+        memcpy((void *)destination[channel], &value, write_size);
+        if (peripheral(destination[channel])) {
+                sim_bus_write(destination[channel]);
+        }
+
+        if (dcr & DMA_DCR_SINC_MASK) {
+                source[channel] = increment(source[channel], read_size,
+                        (dcr & DMA_DCR_SMOD_MASK) >> DMA_DCR_SMOD_SHIFT);
+        }
+        if (dcr & DMA_DCR_DINC_MASK) {
+                destination[channel] = increment(destination[channel],
+                        write_size,
+                        (dcr & DMA_DCR_DMOD_MASK) >> DMA_DCR_DMOD_SHIFT);
+        }
+        base->DMA[channel].SAR = (uint32_t)source[channel];
+        base->DMA[channel].DAR = (uint32_t)destination[channel];
+
+        count = (count > write_size) ? (count - write_size) : 0u;
+        base->DMA[channel].DSR_BCR = (base->DMA[channel].DSR_BCR &
+                ~DMA_DSR_BCR_BCR_MASK) | DMA_DSR_BCR_BCR(count);
+        if (count) {
+                base->DMA[channel].DSR_BCR |= DMA_DSR_BCR_BSY_MASK;
+                return false;
+        }
+
+        base->DMA[channel].DSR_BCR = (base->DMA[channel].DSR_BCR &
+                ~DMA_DSR_BCR_BSY_MASK) | DMA_DSR_BCR_DONE_MASK;
+        if (dcr & DMA_DCR_D_REQ_MASK) {
+                base->DMA[channel].DCR &= ~DMA_DCR_ERQ_MASK;
+        }
+
+        return true;
+}
+
+/**
+ * \brief Performs a transfer and the transfers of the linked channels
+ *
+ * \param[in] channel Channel
+ *
+ * \return Channels whose byte count reached zero
+ */
+static uint32_t transfer_linked(uint32_t channel)
+{
+        uint32_t const dcr = DMA0->DMA[channel].DCR;
+        uint32_t const link = (dcr & DMA_DCR_LINKCC_MASK) >>
+                DMA_DCR_LINKCC_SHIFT;
+        uint32_t const channel1 = (dcr & DMA_DCR_LCH1_MASK) >>
+                DMA_DCR_LCH1_SHIFT;
+        uint32_t const channel2 = (dcr & DMA_DCR_LCH2_MASK) >>
+                DMA_DCR_LCH2_SHIFT;
+        bool const done = transfer(channel);
+        uint32_t finished = done ? (1u << channel) : 0u;
+
+        if ((link == kDMA_ChannelLinkChannel1) ||
+                (link == kDMA_ChannelLinkChannel1AndChannel2) ||
+                ((link == kDMA_ChannelLinkChannel1AfterBCR0) && done)) {
+                if (transfer(channel1)) {
+                        finished |= 1u << channel1;
+                }
+        }
+        if ((link == kDMA_ChannelLinkChannel1AndChannel2) && done) {
+                if (transfer(channel2)) {
+                        finished |= 1u << channel2;
+                }
+        }
+
+        return finished;
+}
+
+/**
+ * \brief Checks if a channel may serve a request
+ *
+ * \param[in] channel Channel
+ *
+ * \return True, if the channel is enabled for the requests
+ */
+static bool ready(uint32_t channel)
+{
+        uint32_t const dcr = DMA0->DMA[channel].DCR;
+
+        switch (sim_mode()) {
+        case SIM_MODE_LLS:
+                return false;
+        case SIM_MODE_VLPS:
+                // Only asynchronous requests are served in VLPS.
+                if (!(dcr & DMA_DCR_EADREQ_MASK)) {
+                        return false;
+                }
+                break;
+        default:
+                break;
+        }
+
+        return (dcr & DMA_DCR_ERQ_MASK) && DMA_GetRemainingBytes(DMA0, channel);
+}
+
+/**
+ * \brief Level source of a channel interrupt
+ *
+ * \param[in] channel Channel
+ *
+ * \return True, if the channel interrupt is asserted
+ */
+static bool irq_level(uint32_t channel)
+{
+        return (DMA0->DMA[channel].DCR & DMA_DCR_EINT_MASK) &&
+                (DMA0->DMA[channel].DSR_BCR & DMA_DSR_BCR_DONE_MASK);
+}
+
+/// \brief Level source of the DMA0 interrupt \return Interrupt level
+static bool dma0_level(void)
+{
+        return irq_level(0u);
+}
+
+/// \brief Level source of the DMA1 interrupt \return Interrupt level
+static bool dma1_level(void)
+{
+        return irq_level(1u);
+}
+
+/// \brief Level source of the DMA2 interrupt \return Interrupt level
+static bool dma2_level(void)
+{
+        return irq_level(2u);
+}
+
+/// \brief Level source of the DMA3 interrupt \return Interrupt level
+static bool dma3_level(void)
+{
+        return irq_level(3u);
+}
+
+/**
+ * \brief Serves the pending requests of all the channels
+ */
+static void serve_all(void)
+{
+        for (uint32_t channel = 0u; channel < CHANNELS; ++channel) {
+                uint32_t const chcfg = DMAMUX0->CHCFG[channel];
+
+                if (chcfg & DMAMUX_CHCFG_ENBL_MASK) {
+                        sim_dma_request(chcfg & DMAMUX_CHCFG_SOURCE_MASK);
+                }
+        }
+}
+
+/**
+ * \brief Serves the requests held back by a stop mode
+ *
+ * \param[in] from Previous power mode
+ * \param[in] to New power mode
+ */
+static void dma_power(sim_mode_t from, sim_mode_t to)
+{
+        (void)from;
+
+        if (to == SIM_MODE_RUN) {
+                serve_all();
+        }
+}
+
+/// DMA model
+static const sim_peripheral_t dma_peripheral = {
+        .sync = NULL,
+        .power = dma_power
+};
+
+void sim_dma_model_init(void)
+{
+        static const sim_irq_level_t levels[CHANNELS] = {
+                dma0_level, dma1_level, dma2_level, dma3_level
+        };
+
+        for (uint32_t channel = 0u; channel < CHANNELS; ++channel) {
+                handles[channel] = NULL;
+                source[channel] = 0u;
+                destination[channel] = 0u;
+                sim_irq_set_level(DMA0_IRQ + (int)channel, levels[channel]);
+        }
+        for (uint32_t i = 0u; i < SOURCES; ++i) {
+                requests[i] = NULL;
+        }
+        sim_add_peripheral(&dma_peripheral);
+}
+
+void sim_dma_set_request(uint32_t request_source, sim_dma_request_t request)
+{
+        requests[request_source % SOURCES] = request;
+}
+
+void sim_dma_request(uint32_t request_source)
+{
+        sim_dma_request_t const request = requests[request_source % SOURCES];
+        uint32_t finished = 0u;
+
+        if (!request) {
+                return;
+        }
+
+        for (uint32_t channel = 0u; channel < CHANNELS; ++channel) {
+                uint32_t const chcfg = DMAMUX0->CHCFG[channel];
+
+                if (!(chcfg & DMAMUX_CHCFG_ENBL_MASK) ||
+                        ((chcfg & DMAMUX_CHCFG_SOURCE_MASK) !=
+                        request_source)) {
+                        continue;
+                }
+                while (ready(channel) && request()) {
+                        finished |= transfer_linked(channel);
+                }
+        }
+
+        // Raise the interrupts last, as the handlers may start new transfers.
+        for (uint32_t channel = 0u; channel < CHANNELS; ++channel) {
+                if (finished & (1u << channel)) {
+                        sim_irq_raise(DMA0_IRQ + (int)channel);
+                }
+        }
+}
+
+void DMA_Init(DMA_Type *base)
+{
+        (void)base;
+        CLOCK_EnableClock(kCLOCK_Dma0);
+}
+
+void DMA_CreateHandle(dma_handle_t *handle, DMA_Type *base, uint32_t channel)
+{
+        memset(handle, 0, sizeof(*handle));
+        handle->base = base;
+        handle->channel = (uint8_t)channel;
+        handles[channel] = handle;
+        (void)EnableIRQ((IRQn_Type)(DMA0_IRQ + (int)channel));
+}
+
+void DMA_SetCallback(dma_handle_t *handle, dma_callback callback,
+        void *userData)
+{
+        handle->callback = callback;
+        handle->userData = userData;
+}
+
+void DMA_PrepareTransfer(dma_transfer_config_t *config, void *srcAddr,
+        uint32_t srcWidth, void *destAddr, uint32_t destWidth,
+        uint32_t transferBytes, dma_transfer_type_t type)
+{
+        memset(config, 0, sizeof(*config));
+        config->srcAddr = (uintptr_t)srcAddr;
+        config->destAddr = (uintptr_t)destAddr;
+        config->transferSize = transferBytes;
+        config->srcSize = (srcWidth == 1u) ? kDMA_Transfersize8bits :
+                (srcWidth == 2u) ? kDMA_Transfersize16bits :
+                kDMA_Transfersize32bits;
+        config->destSize = (destWidth == 1u) ? kDMA_Transfersize8bits :
+                (destWidth == 2u) ? kDMA_Transfersize16bits :
+                kDMA_Transfersize32bits;
+        config->enableSrcIncrement = (type != kDMA_PeripheralToMemory);
+        config->enableDestIncrement = (type != kDMA_MemoryToPeripheral);
+}
+
+status_t DMA_SubmitTransfer(dma_handle_t *handle,
+        const dma_transfer_config_t *config, uint32_t options)
+{
+        DMA_Type * const base = handle->base;
+        uint32_t const channel = handle->channel;
+
+        if (base->DMA[channel].DSR_BCR & DMA_DSR_BCR_BSY_MASK) {
+                return kStatus_DMA_Busy;
+        }
+
+        // Like the target driver: cycle steal, and the requests disabled
+        // when the byte count reaches zero.
+        source[channel] = config->srcAddr;
+        destination[channel] = config->destAddr;
+        base->DMA[channel].SAR = (uint32_t)config->srcAddr;
+        base->DMA[channel].DAR = (uint32_t)config->destAddr;
+        base->DMA[channel].DSR_BCR = DMA_DSR_BCR_BCR(config->transferSize);
+        base->DMA[channel].DCR = DMA_DCR_D_REQ_MASK | DMA_DCR_CS_MASK |
+                DMA_DCR_DSIZE(config->destSize) |
+                DMA_DCR_DINC(config->enableDestIncrement) |
+                DMA_DCR_SSIZE(config->srcSize) |
+                DMA_DCR_SINC(config->enableSrcIncrement) |
+                DMA_DCR_EINT(options & kDMA_EnableInterrupt);
+
+        return kStatus_Success;
+}
+
+void DMA_StartTransfer(dma_handle_t *handle)
+{
+        handle->base->DMA[handle->channel].DCR |= DMA_DCR_ERQ_MASK;
+        serve_all();
+}
+
+void DMA_StopTransfer(dma_handle_t *handle)
+{
+        handle->base->DMA[handle->channel].DCR &= ~DMA_DCR_ERQ_MASK;
+}
+
+void DMA_AbortTransfer(dma_handle_t *handle)
+{
+        DMA_Type * const base = handle->base;
+        uint32_t const channel = handle->channel;
+
+        base->DMA[channel].DCR &= ~DMA_DCR_ERQ_MASK;
+        // Writing DONE clears the status bits.
+        base->DMA[channel].DSR_BCR &= ~(DMA_DSR_BCR_DONE_MASK |
+                DMA_DSR_BCR_BSY_MASK | DMA_DSR_BCR_REQ_MASK);
+}
+
+void DMA_SetChannelLinkConfig(DMA_Type *base, uint32_t channel,
+        const dma_channel_link_config_t *config)
+{
+        base->DMA[channel].DCR = (base->DMA[channel].DCR &
+                ~(DMA_DCR_LINKCC_MASK | DMA_DCR_LCH1_MASK |
+                DMA_DCR_LCH2_MASK)) | DMA_DCR_LINKCC(config->linkType) |
+                DMA_DCR_LCH1(config->channel1) | DMA_DCR_LCH2(config->channel2);
+}
+
+void DMA_SetModulo(DMA_Type *base, uint32_t channel, dma_modulo_t srcModulo,
+        dma_modulo_t destModulo)
+{
+        base->DMA[channel].DCR = (base->DMA[channel].DCR &
+                ~(DMA_DCR_SMOD_MASK | DMA_DCR_DMOD_MASK)) |
+                DMA_DCR_SMOD(srcModulo) | DMA_DCR_DMOD(destModulo);
+}
+
+void DMA_EnableAsyncRequest(DMA_Type *base, uint32_t channel, bool enable)
+{
+        base->DMA[channel].DCR = (base->DMA[channel].DCR &
+                ~DMA_DCR_EADREQ_MASK) | DMA_DCR_EADREQ(enable);
+}
+
+/**
+ * \brief Handles the interrupt of a channel
+ *
+ * Clears the status and calls the callback of the channel handle.
+ *
+ * \param[in] channel Channel
+ */
+static void handle_irq(uint32_t channel)
+{
+        dma_handle_t * const handle = handles[channel];
+
+        DMA0->DMA[channel].DSR_BCR &= ~(DMA_DSR_BCR_DONE_MASK |
+                DMA_DSR_BCR_BSY_MASK | DMA_DSR_BCR_REQ_MASK);
+        if (handle && handle->callback) {
+                handle->callback(handle, handle->userData);
+        }
+}
+
+/// \brief DMA channel 0 interrupt handler
+void DMA0_IRQHandler(void)
+{
+        handle_irq(0u);
+}
+
+/// \brief DMA channel 1 interrupt handler
+void DMA1_IRQHandler(void)
+{
+        handle_irq(1u);
+}
+
+/// \brief DMA channel 2 interrupt handler
+void DMA2_IRQHandler(void)
+{
+        handle_irq(2u);
+}
+
+/// \brief DMA channel 3 interrupt handler
+void DMA3_IRQHandler(void)
+{
+        handle_irq(3u);
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,278 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_DMA_H
+#define FSL_DMA_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_dma.h
+ * \defgroup   host-dma Host DMA driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The channels transfer in cycle-steal mode on the requests of the
+ * peripherals routed by the DMAMUX. The transfer addresses are host pointers,
+ * so they are kept wider than the 32-bit address registers of the target.
+ *
+ * @{
+ */
+
+/// Transfer size
+typedef enum _dma_transfer_size {
+        kDMA_Transfersize32bits = 0x0U,
+        kDMA_Transfersize8bits,
+        kDMA_Transfersize16bits
+} dma_transfer_size_t;
+
+/// Address modulo
+typedef enum _dma_modulo {
+        kDMA_ModuloDisable = 0x0U,
+        kDMA_Modulo16Bytes,
+        kDMA_Modulo32Bytes,
+        kDMA_Modulo64Bytes,
+        kDMA_Modulo128Bytes,
+        kDMA_Modulo256Bytes,
+        kDMA_Modulo512Bytes,
+        kDMA_Modulo1KBytes,
+        kDMA_Modulo2KBytes,
+        kDMA_Modulo4KBytes,
+        kDMA_Modulo8KBytes,
+        kDMA_Modulo16KBytes,
+        kDMA_Modulo32KBytes,
+        kDMA_Modulo64KBytes,
+        kDMA_Modulo128KBytes,
+        kDMA_Modulo256KBytes
+} dma_modulo_t;
+
+/// Channel link type
+typedef enum _dma_channel_link_type {
+        kDMA_ChannelLinkDisable = 0x0U,
+        kDMA_ChannelLinkChannel1AndChannel2,
+        kDMA_ChannelLinkChannel1,
+        kDMA_ChannelLinkChannel1AfterBCR0
+} dma_channel_link_type_t;
+
+/// Transfer type
+typedef enum _dma_transfer_type {
+        kDMA_MemoryToMemory = 0x0U,
+        kDMA_PeripheralToMemory,
+        kDMA_MemoryToPeripheral
+} dma_transfer_type_t;
+
+/// Transfer options
+typedef enum _dma_transfer_options {
+        kDMA_NoOptions = 0x0U,
+        kDMA_EnableInterrupt
+} dma_transfer_options_t;
+
+/// DMA status codes
+enum {
+        kStatus_DMA_Busy = MAKE_STATUS(kStatusGroup_DMA, 0)
+};
+
+/// Transfer configuration
+typedef struct _dma_transfer_config {
+        /// Source address
+        uintptr_t srcAddr;
+        /// Destination address
+        uintptr_t destAddr;
+        /// True to increment the source address
+        bool enableSrcIncrement;
+        /// Source transfer size
+        dma_transfer_size_t srcSize;
+        /// True to increment the destination address
+        bool enableDestIncrement;
+        /// Destination transfer size
+        dma_transfer_size_t destSize;
+        /// Number of bytes to transfer
+        uint32_t transferSize;
+} dma_transfer_config_t;
+
+/// Channel link configuration
+typedef struct _dma_channel_link_config {
+        /// Link type
+        dma_channel_link_type_t linkType;
+        /// First linked channel
+        uint32_t channel1;
+        /// Second linked channel
+        uint32_t channel2;
+} dma_channel_link_config_t;
+
+struct _dma_handle;
+
+/**
+ * \brief Transfer done callback
+ *
+ * \param[in] handle DMA handle
+ * \param[in] userData User data
+ */
+typedef void (*dma_callback)(struct _dma_handle *handle, void *userData);
+
+/// DMA handle
+typedef struct _dma_handle {
+        /// DMA instance
+        DMA_Type *base;
+        /// Channel
+        uint8_t channel;
+        /// Transfer done callback
+        dma_callback callback;
+        /// User data of the callback
+        void *userData;
+} dma_handle_t;
+
+/**
+ * \brief Initializes the DMA
+ *
+ * \param[in] base DMA instance
+ */
+void DMA_Init(DMA_Type *base);
+
+/**
+ * \brief Creates a handle for a channel
+ *
+ * Enables the interrupt of the channel.
+ *
+ * \param[out] handle DMA handle
+ * \param[in] base DMA instance
+ * \param[in] channel Channel
+ */
+void DMA_CreateHandle(dma_handle_t *handle, DMA_Type *base, uint32_t channel);
+
+/**
+ * \brief Sets the transfer done callback
+ *
+ * \param[in] handle DMA handle
+ * \param[in] callback Callback
+ * \param[in] userData User data of the callback
+ */
+void DMA_SetCallback(dma_handle_t *handle, dma_callback callback,
+        void *userData);
+
+/**
+ * \brief Prepares a transfer configuration
+ *
+ * \param[out] config Transfer configuration
+ * \param[in] srcAddr Source address
+ * \param[in] srcWidth Source transfer width in bytes
+ * \param[in] destAddr Destination address
+ * \param[in] destWidth Destination transfer width in bytes
+ * \param[in] transferBytes Number of bytes to transfer
+ * \param[in] type Transfer type
+ */
+void DMA_PrepareTransfer(dma_transfer_config_t *config, void *srcAddr,
+        uint32_t srcWidth, void *destAddr, uint32_t destWidth,
+        uint32_t transferBytes, dma_transfer_type_t type);
+
+/**
+ * \brief Submits a transfer to a channel
+ *
+ * \param[in] handle DMA handle
+ * \param[in] config Transfer configuration
+ * \param[in] options Transfer options, as dma_transfer_options_t
+ *
+ * \return kStatus_Success, or kStatus_DMA_Busy if the channel is busy
+ */
+status_t DMA_SubmitTransfer(dma_handle_t *handle,
+        const dma_transfer_config_t *config, uint32_t options);
+
+/**
+ * \brief Enables the peripheral requests of the channel
+ *
+ * \param[in] handle DMA handle
+ */
+void DMA_StartTransfer(dma_handle_t *handle);
+
+/**
+ * \brief Disables the peripheral requests of the channel
+ *
+ * \param[in] handle DMA handle
+ */
+void DMA_StopTransfer(dma_handle_t *handle);
+
+/**
+ * \brief Aborts the transfer of the channel
+ *
+ * \param[in] handle DMA handle
+ */
+void DMA_AbortTransfer(dma_handle_t *handle);
+
+/**
+ * \brief Sets the channel link
+ *
+ * \param[in] base DMA instance
+ * \param[in] channel Channel
+ * \param[in] config Link configuration
+ */
+void DMA_SetChannelLinkConfig(DMA_Type *base, uint32_t channel,
+        const dma_channel_link_config_t *config);
+
+/**
+ * \brief Sets the address modulo
+ *
+ * \param[in] base DMA instance
+ * \param[in] channel Channel
+ * \param[in] srcModulo Source modulo
+ * \param[in] destModulo Destination modulo
+ */
+void DMA_SetModulo(DMA_Type *base, uint32_t channel, dma_modulo_t srcModulo,
+        dma_modulo_t destModulo);
+
+/**
+ * \brief Enables or disables the requests in VLPS
+ *
+ * \param[in] base DMA instance
+ * \param[in] channel Channel
+ * \param[in] enable True to enable
+ */
+void DMA_EnableAsyncRequest(DMA_Type *base, uint32_t channel, bool enable);
+
+/**
+ * \brief Gets the remaining bytes of the transfer
+ *
+ * \param[in] base DMA instance
+ * \param[in] channel Channel
+ *
+ * \return Remaining bytes
+ */
+static inline uint32_t DMA_GetRemainingBytes(DMA_Type *base, uint32_t channel)
+{
+        return (base->DMA[channel].DSR_BCR & DMA_DSR_BCR_BCR_MASK) >>
+                DMA_DSR_BCR_BCR_SHIFT;
+}
+
+/** @} */
+
+#endif // ifndef FSL_DMA_H
+
+/* EOF */
@@ -0,0 +1,101 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_DMAMUX_H
+#define FSL_DMAMUX_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_dmamux.h
+ * \defgroup   host-dmamux Host DMAMUX driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The DMA model reads the routing straight from the channel configuration
+ * registers.
+ *
+ * @{
+ */
+
+/**
+ * \brief Initializes the DMAMUX
+ *
+ * \param[in] base DMAMUX instance
+ */
+static inline void DMAMUX_Init(DMAMUX_Type *base)
+{
+        (void)base;
+        CLOCK_EnableClock(kCLOCK_Dmamux0);
+}
+
+/**
+ * \brief Sets the request source of a channel
+ *
+ * \param[in] base DMAMUX instance
+ * \param[in] channel Channel
+ * \param[in] source Request source, as dma_request_source_t
+ */
+static inline void DMAMUX_SetSource(DMAMUX_Type *base, uint32_t channel,
+        uint32_t source)
+{
+        base->CHCFG[channel] = (uint8_t)((base->CHCFG[channel] &
+                ~DMAMUX_CHCFG_SOURCE_MASK) | DMAMUX_CHCFG_SOURCE(source));
+}
+
+/**
+ * \brief Enables the routing of a channel
+ *
+ * \param[in] base DMAMUX instance
+ * \param[in] channel Channel
+ */
+static inline void DMAMUX_EnableChannel(DMAMUX_Type *base, uint32_t channel)
+{
+        base->CHCFG[channel] |= DMAMUX_CHCFG_ENBL_MASK;
+}
+
+/**
+ * \brief Disables the routing of a channel
+ *
+ * \param[in] base DMAMUX instance
+ * \param[in] channel Channel
+ */
+static inline void DMAMUX_DisableChannel(DMAMUX_Type *base, uint32_t channel)
+{
+        base->CHCFG[channel] &= (uint8_t)~DMAMUX_CHCFG_ENBL_MASK;
+}
+
+/** @} */
+
+#endif // ifndef FSL_DMAMUX_H
+
+/* EOF */
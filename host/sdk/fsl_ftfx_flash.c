@@ -0,0 +1,127 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_ftfx_flash.h"
+#include "sim.h"
+
+/**
+ * \file       fsl_ftfx_flash.c
+ * \defgroup   host-flash-implementation Host flash driver implementation
+ * \ingroup    host-flash
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Size of an erase sector
+#define SECTOR_SIZE 1024u
+/// Size of a program unit
+#define PROGRAM_UNIT 4u
+
+/**
+ * \brief Checks that a range is within the simulated flash
+ *
+ * \param[in] config Flash driver state
+ * \param[in] start Start address
+ * \param[in] length Length in bytes
+ *
+ * \return Status of the check
+ */
+static status_t check_range(flash_config_t const *config, uint32_t start,
+        uint32_t length)
+{
+        if ((start < config->blockBase) ||
+                (start >= (config->blockBase + config->totalSize)) ||
+                (length > (config->blockBase + config->totalSize - start))) {
+                return kStatus_FTFx_AddressError;
+        }
+
+        return kStatus_FTFx_Success;
+}
+
+status_t FLASH_Init(flash_config_t *config)
+{
+        if (!config) {
+                return kStatus_FTFx_InvalidArgument;
+        }
+        config->blockBase = SIM_FLASH_START;
+        config->totalSize = SIM_FLASH_SIZE;
+        config->sectorSize = SECTOR_SIZE;
+
+        return kStatus_FTFx_Success;
+}
+
+status_t FLASH_Erase(flash_config_t *config, uint32_t start,
+        uint32_t lengthInBytes, uint32_t key)
+{
+        if (key != kFTFx_ApiEraseKey) {
+                return kStatus_FTFx_EraseKeyError;
+        }
+        if ((start % config->sectorSize) ||
+                (lengthInBytes % config->sectorSize)) {
+                return kStatus_FTFx_AlignmentError;
+        }
+        if (check_range(config, start, lengthInBytes) !=
+                kStatus_FTFx_Success) {
+                return kStatus_FTFx_AddressError;
+        }
+
+        memset((void *)(uintptr_t)start, 0xFF, lengthInBytes);
+
+        return kStatus_FTFx_Success;
+}
+
+status_t FLASH_Program(flash_config_t *config, uint32_t start, uint8_t *src,
+        uint32_t lengthInBytes)
+{
+        uint8_t * const flash = (uint8_t *)(uintptr_t)start;
+
+        if (!src) {
+                return kStatus_FTFx_InvalidArgument;
+        }
+        if ((start % PROGRAM_UNIT) || (lengthInBytes % PROGRAM_UNIT)) {
+                return kStatus_FTFx_AlignmentError;
+        }
+        if (check_range(config, start, lengthInBytes) !=
+                kStatus_FTFx_Success) {
+                return kStatus_FTFx_AddressError;
+        }
+
+        for (uint32_t i = 0u; i < lengthInBytes; ++i) {
+                flash[i] &= src[i];
+        }
+
+        return kStatus_FTFx_Success;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,119 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_FTFX_FLASH_H
+#define FSL_FTFX_FLASH_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_ftfx_flash.h
+ * \defgroup   host-flash Host flash driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Only the data block of the program flash is simulated. The commands
+ * complete in zero time, and programming can only clear bits, like on the
+ * target.
+ *
+ * @{
+ */
+
+/// Flash driver status codes
+enum {
+        kStatus_FTFx_Success = MAKE_STATUS(kStatusGroup_Generic, 0),
+        kStatus_FTFx_InvalidArgument = MAKE_STATUS(kStatusGroup_Generic, 4),
+        kStatus_FTFx_SizeError = MAKE_STATUS(kStatusGroup_FLASH, 0),
+        kStatus_FTFx_AlignmentError = MAKE_STATUS(kStatusGroup_FLASH, 1),
+        kStatus_FTFx_AddressError = MAKE_STATUS(kStatusGroup_FLASH, 2),
+        kStatus_FTFx_EraseKeyError = MAKE_STATUS(kStatusGroup_FLASH, 7)
+};
+
+/// Builds a key from four characters
+#define FOUR_CHAR_CODE(a, b, c, d) (((uint32_t)(d) << 24u) | \
+        ((uint32_t)(c) << 16u) | ((uint32_t)(b) << 8u) | ((uint32_t)(a)))
+
+/// Erase key
+enum {
+        kFTFx_ApiEraseKey = FOUR_CHAR_CODE('k', 'f', 'e', 'k')
+};
+
+/// Flash driver state
+typedef struct _flash_config {
+        /// Start of the simulated flash
+        uint32_t blockBase;
+        /// Size of the simulated flash
+        uint32_t totalSize;
+        /// Size of an erase sector
+        uint32_t sectorSize;
+} flash_config_t;
+
+/**
+ * \brief Initializes the flash driver
+ *
+ * \param[out] config Flash driver state
+ *
+ * \return kStatus_FTFx_Success
+ */
+status_t FLASH_Init(flash_config_t *config);
+
+/**
+ * \brief Erases whole sectors
+ *
+ * \param[in] config Flash driver state
+ * \param[in] start Start address, aligned to a sector
+ * \param[in] lengthInBytes Length, a multiple of the sector size
+ * \param[in] key kFTFx_ApiEraseKey
+ *
+ * \return Status of the operation
+ */
+status_t FLASH_Erase(flash_config_t *config, uint32_t start,
+        uint32_t lengthInBytes, uint32_t key);
+
+/**
+ * \brief Programs long words
+ *
+ * \param[in] config Flash driver state
+ * \param[in] start Start address, aligned to a long word
+ * \param[in] src Data
+ * \param[in] lengthInBytes Length, a multiple of a long word
+ *
+ * \return Status of the operation
+ */
+status_t FLASH_Program(flash_config_t *config, uint32_t start, uint8_t *src,
+        uint32_t lengthInBytes);
+
+/** @} */
+
+#endif // ifndef FSL_FTFX_FLASH_H
+
+/* EOF */
@@ -0,0 +1,190 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_gpio.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_gpio.c
+ * \defgroup   host-gpio-implementation Host GPIO driver implementation
+ * \ingroup    host-gpio
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Distance between the GPIO instances
+#define GPIO_STRIDE (GPIOB_BASE - GPIOA_BASE)
+
+/// GPIO instances by port
+static GPIO_Type * const gpio[SIM_PORTS] = {
+        GPIOA, GPIOB, GPIOC, GPIOD, GPIOE
+};
+
+/// PORT instances by port
+static PORT_Type * const port_base[SIM_PORTS] = {
+        PORTA, PORTB, PORTC, PORTD, PORTE
+};
+
+/// Pins driven from the outside
+static uint32_t driven[SIM_PORTS];
+/// Levels of the pins driven from the outside
+static uint32_t driven_level[SIM_PORTS];
+/// Current pin levels
+static uint32_t level[SIM_PORTS];
+/// Pin output callback
+static sim_pin_output_t output_callback;
+
+/**
+ * \brief Gets the port of a GPIO instance
+ *
+ * \param[in] base GPIO instance
+ *
+ * \return Port
+ */
+static inline sim_port_t port_of(GPIO_Type const *base)
+{
+        return (sim_port_t)(((uintptr_t)base - GPIOA_BASE) / GPIO_STRIDE);
+}
+
+void sim_gpio_model_init(void)
+{
+        for (uint32_t port = 0u; port < SIM_PORTS; ++port) {
+                driven[port] = 0u;
+                driven_level[port] = 0u;
+                level[port] = 0u;
+        }
+        output_callback = NULL;
+}
+
+void sim_gpio_update(sim_port_t port)
+{
+        GPIO_Type * const base = gpio[port];
+        uint32_t outputs = 0u;
+        uint32_t pulled_up = 0u;
+        uint32_t levels;
+        uint32_t previous;
+
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                uint32_t const pcr = port_base[port]->PCR[pin];
+
+                if (((pcr & PORT_PCR_MUX_MASK) >> PORT_PCR_MUX_SHIFT) == 1u) {
+                        outputs |= 1u << pin;
+                }
+                if ((pcr & (PORT_PCR_PE_MASK | PORT_PCR_PS_MASK)) ==
+                        (PORT_PCR_PE_MASK | PORT_PCR_PS_MASK)) {
+                        pulled_up |= 1u << pin;
+                }
+        }
+        outputs &= base->PDDR;
+
+        levels = (base->PDOR & outputs) |
+                (driven_level[port] & driven[port] & ~outputs) |
+                (pulled_up & ~driven[port] & ~outputs);
+        *(volatile uint32_t *)&base->PDIR = levels;
+
+        previous = level[port];
+        if (levels == previous) {
+                return;
+        }
+        level[port] = levels;
+
+        if (output_callback && ((levels ^ previous) & outputs)) {
+                output_callback(port, (levels ^ previous) & outputs,
+                        levels & outputs);
+        }
+        sim_port_pins_changed(port, previous, levels);
+        sim_llwu_pins_changed(port, previous, levels);
+}
+
+void sim_pin_drive(sim_port_t port, uint32_t pin, bool drive_level)
+{
+        driven[port] |= 1u << pin;
+        if (drive_level) {
+                driven_level[port] |= 1u << pin;
+        } else {
+                driven_level[port] &= ~(1u << pin);
+        }
+        sim_gpio_update(port);
+}
+
+bool sim_pin_level(sim_port_t port, uint32_t pin)
+{
+        return (level[port] >> pin) & 1u;
+}
+
+void sim_pin_set_output(sim_pin_output_t output)
+{
+        output_callback = output;
+}
+
+void GPIO_PinInit(GPIO_Type *base, uint32_t pin,
+        const gpio_pin_config_t *config)
+{
+        if (config->pinDirection == kGPIO_DigitalInput) {
+                base->PDDR &= ~(1u << pin);
+        } else {
+                GPIO_PinWrite(base, pin, config->outputLogic);
+                base->PDDR |= 1u << pin;
+        }
+        sim_gpio_update(port_of(base));
+}
+
+void GPIO_PinWrite(GPIO_Type *base, uint32_t pin, uint8_t output)
+{
+        if (output) {
+                GPIO_PortSet(base, 1u << pin);
+        } else {
+                GPIO_PortClear(base, 1u << pin);
+        }
+}
+
+void GPIO_PortSet(GPIO_Type *base, uint32_t mask)
+{
+        base->PDOR |= mask;
+        sim_gpio_update(port_of(base));
+}
+
+void GPIO_PortClear(GPIO_Type *base, uint32_t mask)
+{
+        base->PDOR &= ~mask;
+        sim_gpio_update(port_of(base));
+}
+
+void GPIO_PortToggle(GPIO_Type *base, uint32_t mask)
+{
+        base->PDOR ^= mask;
+        sim_gpio_update(port_of(base));
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,125 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_GPIO_H
+#define FSL_GPIO_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_gpio.h
+ * \defgroup   host-gpio Host GPIO driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The output functions update the data registers and the levels of the pins.
+ * The input register follows the outputs, the pins driven from the outside
+ * and the pull resistors.
+ *
+ * @{
+ */
+
+/// Pin direction
+typedef enum _gpio_pin_direction {
+        kGPIO_DigitalInput = 0U,
+        kGPIO_DigitalOutput = 1U
+} gpio_pin_direction_t;
+
+/// Pin configuration
+typedef struct _gpio_pin_config {
+        /// Pin direction
+        gpio_pin_direction_t pinDirection;
+        /// Initial output level
+        uint8_t outputLogic;
+} gpio_pin_config_t;
+
+/**
+ * \brief Initializes a pin
+ *
+ * \param[in] base GPIO instance
+ * \param[in] pin Pin number
+ * \param[in] config Pin configuration
+ */
+void GPIO_PinInit(GPIO_Type *base, uint32_t pin,
+        const gpio_pin_config_t *config);
+
+/**
+ * \brief Sets the output level of a pin
+ *
+ * \param[in] base GPIO instance
+ * \param[in] pin Pin number
+ * \param[in] output Output level
+ */
+void GPIO_PinWrite(GPIO_Type *base, uint32_t pin, uint8_t output);
+
+/**
+ * \brief Sets the outputs of several pins high
+ *
+ * \param[in] base GPIO instance
+ * \param[in] mask Pins to set
+ */
+void GPIO_PortSet(GPIO_Type *base, uint32_t mask);
+
+/**
+ * \brief Sets the outputs of several pins low
+ *
+ * \param[in] base GPIO instance
+ * \param[in] mask Pins to clear
+ */
+void GPIO_PortClear(GPIO_Type *base, uint32_t mask);
+
+/**
+ * \brief Toggles the outputs of several pins
+ *
+ * \param[in] base GPIO instance
+ * \param[in] mask Pins to toggle
+ */
+void GPIO_PortToggle(GPIO_Type *base, uint32_t mask);
+
+/**
+ * \brief Reads the level of a pin
+ *
+ * \param[in] base GPIO instance
+ * \param[in] pin Pin number
+ *
+ * \return Pin level
+ */
+static inline uint32_t GPIO_PinRead(GPIO_Type *base, uint32_t pin)
+{
+        return (base->PDIR >> pin) & 0x01U;
+}
+
+/** @} */
+
+#endif // ifndef FSL_GPIO_H
+
+/* EOF */
@@ -0,0 +1,249 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_llwu.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_llwu.c
+ * \defgroup   host-llwu-implementation Host LLWU driver implementation
+ * \ingroup    host-llwu
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Interrupt of the LLWU
+#define LLWU_IRQ 7
+/// Number of the wake-up pins
+#define LLWU_PINS 16u
+/// Number of the pin filters
+#define LLWU_FILTERS 2u
+
+/// Wake-up pin
+typedef struct {
+        /// True, if the pin exists
+        bool present;
+        /// Port of the pin
+        sim_port_t port;
+        /// Pin number
+        uint32_t pin;
+} wake_pin_t;
+
+/// Wake-up pins of the MKL17Z256VLH4
+static const wake_pin_t wake_pins[LLWU_PINS] = {
+        [5] = { .present = true, .port = SIM_PORT_B, .pin = 0u },
+        [6] = { .present = true, .port = SIM_PORT_C, .pin = 1u },
+        [7] = { .present = true, .port = SIM_PORT_C, .pin = 3u },
+        [8] = { .present = true, .port = SIM_PORT_C, .pin = 4u },
+        [9] = { .present = true, .port = SIM_PORT_C, .pin = 5u },
+        [10] = { .present = true, .port = SIM_PORT_C, .pin = 6u },
+        [14] = { .present = true, .port = SIM_PORT_D, .pin = 4u },
+        [15] = { .present = true, .port = SIM_PORT_D, .pin = 6u }
+};
+
+/**
+ * \brief Gets the pin enable register of a wake-up pin
+ *
+ * \param[in] base LLWU instance
+ * \param[in] pinIndex Wake-up pin
+ *
+ * \return Register
+ */
+static volatile uint8_t *pin_enable(LLWU_Type *base, uint32_t pinIndex)
+{
+        return &base->PE1 + (pinIndex / 4u);
+}
+
+/**
+ * \brief Gets the flag register of a wake-up pin
+ *
+ * \param[in] base LLWU instance
+ * \param[in] pinIndex Wake-up pin
+ *
+ * \return Register
+ */
+static volatile uint8_t *pin_flag(LLWU_Type *base, uint32_t pinIndex)
+{
+        return (pinIndex < 8u) ? &base->F1 : &base->F2;
+}
+
+/**
+ * \brief Gets the register of a pin filter
+ *
+ * \param[in] base LLWU instance
+ * \param[in] filterIndex Pin filter (1...2)
+ *
+ * \return Register
+ */
+static volatile uint8_t *pin_filter(LLWU_Type *base, uint32_t filterIndex)
+{
+        return (filterIndex == 1u) ? &base->FILT1 : &base->FILT2;
+}
+
+/**
+ * \brief Checks if an edge matches a detection mode
+ *
+ * \param[in] mode Detection mode, as in the pin enable and filter registers
+ * \param[in] high Level after the edge
+ *
+ * \return True, if the edge is detected
+ */
+static inline bool detected(uint32_t mode, bool high)
+{
+        return (mode == 3u) || ((mode == 1u) && high) ||
+                ((mode == 2u) && !high);
+}
+
+/**
+ * \brief Level source of the LLWU interrupt
+ *
+ * \return True, if a wake-up flag is set
+ */
+static bool llwu_level(void)
+{
+        LLWU_Type * const base = LLWU;
+
+        return base->F1 || base->F2 || (base->FILT1 & LLWU_FILT1_FILTF_MASK) ||
+                (base->FILT2 & LLWU_FILT2_FILTF_MASK) ||
+                ((sim_mode() == SIM_MODE_LLS) && (base->F3 & base->ME));
+}
+
+void sim_llwu_model_init(void)
+{
+        sim_irq_set_level(LLWU_IRQ, llwu_level);
+}
+
+void sim_llwu_pins_changed(sim_port_t port, uint32_t previous,
+        uint32_t levels)
+{
+        LLWU_Type * const base = LLWU;
+        bool wake = false;
+
+        // The LLWU detects the pins only in LLS.
+        if (sim_mode() != SIM_MODE_LLS) {
+                return;
+        }
+
+        for (uint32_t index = 0u; index < LLWU_PINS; ++index) {
+                wake_pin_t const *wake_pin = &wake_pins[index];
+                uint32_t const mask = 1u << wake_pin->pin;
+                bool const high = (levels & mask) != 0u;
+                uint32_t mode;
+
+                if (!wake_pin->present || (wake_pin->port != port) ||
+                        !((previous ^ levels) & mask)) {
+                        continue;
+                }
+
+                mode = (*pin_enable(base, index) >> ((index % 4u) * 2u)) &
+                        3u;
+                if (detected(mode, high)) {
+                        *pin_flag(base, index) |= (uint8_t)(1u << (index %
+                                8u));
+                        wake = true;
+                }
+
+                for (uint32_t filter = 1u; filter <= LLWU_FILTERS; ++filter) {
+                        uint8_t const value = *pin_filter(base, filter);
+
+                        if (((value & LLWU_FILT1_FILTSEL_MASK) == index) &&
+                                detected((value & LLWU_FILT1_FILTE_MASK) >>
+                                LLWU_FILT1_FILTE_SHIFT, high)) {
+                                *pin_filter(base, filter) |=
+                                        LLWU_FILT1_FILTF_MASK;
+                                wake = true;
+                        }
+                }
+        }
+
+        if (wake) {
+                sim_irq_raise(LLWU_IRQ);
+        }
+}
+
+void sim_llwu_module_flag(uint32_t module, bool flag)
+{
+        volatile uint8_t * const f3 = (volatile uint8_t *)&LLWU->F3;
+
+        if (flag) {
+                *f3 |= (uint8_t)(1u << module);
+                if ((sim_mode() == SIM_MODE_LLS) &&
+                        (LLWU->ME & (1u << module))) {
+                        sim_irq_raise(LLWU_IRQ);
+                }
+        } else {
+                *f3 &= (uint8_t)~(1u << module);
+        }
+}
+
+void LLWU_SetExternalWakeupPinMode(LLWU_Type *base, uint32_t pinIndex,
+        llwu_external_pin_mode_t pinMode)
+{
+        volatile uint8_t * const reg = pin_enable(base, pinIndex);
+        uint32_t const shift = (pinIndex % 4u) * 2u;
+
+        *reg = (uint8_t)((*reg & ~(3u << shift)) |
+                ((uint32_t)pinMode << shift));
+}
+
+bool LLWU_GetExternalWakeupPinFlag(LLWU_Type *base, uint32_t pinIndex)
+{
+        return (*pin_flag(base, pinIndex) >> (pinIndex % 8u)) & 1u;
+}
+
+void LLWU_ClearExternalWakeupPinFlag(LLWU_Type *base, uint32_t pinIndex)
+{
+        *pin_flag(base, pinIndex) &= (uint8_t)~(1u << (pinIndex % 8u));
+}
+
+void LLWU_SetPinFilterMode(LLWU_Type *base, uint32_t filterIndex,
+        llwu_external_pin_filter_mode_t filterMode)
+{
+        // Like the target driver, clears the flag.
+        *pin_filter(base, filterIndex) = (uint8_t)(
+                LLWU_FILT1_FILTSEL(filterMode.pinIndex) |
+                LLWU_FILT1_FILTE(filterMode.filterMode));
+}
+
+bool LLWU_GetPinFilterFlag(LLWU_Type *base, uint32_t filterIndex)
+{
+        return (*pin_filter(base, filterIndex) & LLWU_FILT1_FILTF_MASK) != 0u;
+}
+
+void LLWU_ClearPinFilterFlag(LLWU_Type *base, uint32_t filterIndex)
+{
+        *pin_filter(base, filterIndex) &= (uint8_t)~LLWU_FILT1_FILTF_MASK;
+}
+
+/** @} */
+
+/* EOF */
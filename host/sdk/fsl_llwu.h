@@ -0,0 +1,167 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_LLWU_H
+#define FSL_LLWU_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_llwu.h
+ * \defgroup   host-llwu Host LLWU driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The LLWU detects the pin edges and the internal module events while the
+ * core is in LLS, and wakes the core up through the LLWU interrupt.
+ *
+ * @{
+ */
+
+/// Wake-up pin mode
+typedef enum _llwu_external_pin_mode {
+        kLLWU_ExternalPinDisable = 0U,
+        kLLWU_ExternalPinRisingEdge = 1U,
+        kLLWU_ExternalPinFallingEdge = 2U,
+        kLLWU_ExternalPinAnyEdge = 3U
+} llwu_external_pin_mode_t;
+
+/// Pin filter mode
+typedef enum _llwu_pin_filter_mode {
+        kLLWU_PinFilterDisable = 0U,
+        kLLWU_PinFilterRisingEdge = 1U,
+        kLLWU_PinFilterFallingEdge = 2U,
+        kLLWU_PinFilterAnyEdge = 3U
+} llwu_pin_filter_mode_t;
+
+/// Pin filter configuration
+typedef struct _llwu_external_pin_filter_mode {
+        /// Wake-up pin
+        uint32_t pinIndex;
+        /// Filter mode
+        llwu_pin_filter_mode_t filterMode;
+} llwu_external_pin_filter_mode_t;
+
+/**
+ * \brief Sets the mode of a wake-up pin
+ *
+ * \param[in] base LLWU instance
+ * \param[in] pinIndex Wake-up pin
+ * \param[in] pinMode Pin mode
+ */
+void LLWU_SetExternalWakeupPinMode(LLWU_Type *base, uint32_t pinIndex,
+        llwu_external_pin_mode_t pinMode);
+
+/**
+ * \brief Gets the flag of a wake-up pin
+ *
+ * \param[in] base LLWU instance
+ * \param[in] pinIndex Wake-up pin
+ *
+ * \return True, if the pin woke up the core
+ */
+bool LLWU_GetExternalWakeupPinFlag(LLWU_Type *base, uint32_t pinIndex);
+
+/**
+ * \brief Clears the flag of a wake-up pin
+ *
+ * \param[in] base LLWU instance
+ * \param[in] pinIndex Wake-up pin
+ */
+void LLWU_ClearExternalWakeupPinFlag(LLWU_Type *base, uint32_t pinIndex);
+
+/**
+ * \brief Enables or disables the wake-up by an internal module
+ *
+ * \param[in] base LLWU instance
+ * \param[in] moduleIndex Internal module
+ * \param[in] enable True to enable
+ */
+static inline void LLWU_EnableInternalModuleInterruptWakup(LLWU_Type *base,
+        uint32_t moduleIndex, bool enable)
+{
+        if (enable) {
+                base->ME |= (uint8_t)(1U << moduleIndex);
+        } else {
+                base->ME &= (uint8_t)~(1U << moduleIndex);
+        }
+}
+
+/**
+ * \brief Gets the wake-up flag of an internal module
+ *
+ * The flag follows the interrupt flag of the module.
+ *
+ * \param[in] base LLWU instance
+ * \param[in] moduleIndex Internal module
+ *
+ * \return True, if the module woke up the core
+ */
+static inline bool LLWU_GetInternalWakeupModuleFlag(LLWU_Type *base,
+        uint32_t moduleIndex)
+{
+        return (base->F3 >> moduleIndex) & 1U;
+}
+
+/**
+ * \brief Sets the mode of a pin filter
+ *
+ * \param[in] base LLWU instance
+ * \param[in] filterIndex Pin filter (1...2)
+ * \param[in] filterMode Filter configuration
+ */
+void LLWU_SetPinFilterMode(LLWU_Type *base, uint32_t filterIndex,
+        llwu_external_pin_filter_mode_t filterMode);
+
+/**
+ * \brief Gets the flag of a pin filter
+ *
+ * \param[in] base LLWU instance
+ * \param[in] filterIndex Pin filter (1...2)
+ *
+ * \return True, if the filtered pin woke up the core
+ */
+bool LLWU_GetPinFilterFlag(LLWU_Type *base, uint32_t filterIndex);
+
+/**
+ * \brief Clears the flag of a pin filter
+ *
+ * \param[in] base LLWU instance
+ * \param[in] filterIndex Pin filter (1...2)
+ */
+void LLWU_ClearPinFilterFlag(LLWU_Type *base, uint32_t filterIndex);
+
+/** @} */
+
+#endif // ifndef FSL_LLWU_H
+
+/* EOF */
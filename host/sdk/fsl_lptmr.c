@@ -0,0 +1,211 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_lptmr.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_lptmr.c
+ * \defgroup   host-lptmr-implementation Host LPTMR driver implementation
+ * \ingroup    host-lptmr
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Interrupt of LPTMR0
+#define LPTMR0_IRQ 28
+
+/// Compare event
+static sim_event_t compare;
+/// True while the timer runs
+static bool running;
+/// Time of the counter value 0
+static sim_time_t origin;
+
+/**
+ * \brief Gets the length of a counter tick
+ *
+ * \return Tick length
+ */
+static sim_time_t tick(void)
+{
+        uint32_t const psr = LPTMR0->PSR;
+
+        if (psr & LPTMR_PSR_PBYP_MASK) {
+                return SIM_S / SIM_LPO_FREQUENCY;
+        }
+
+        return (SIM_S / SIM_LPO_FREQUENCY) << (((psr &
+                LPTMR_PSR_PRESCALE_MASK) >> LPTMR_PSR_PRESCALE_SHIFT) + 1u);
+}
+
+/**
+ * \brief Gets the length of the compare period
+ *
+ * \return Period length
+ */
+static inline sim_time_t period(void)
+{
+        return ((sim_time_t)(LPTMR0->CMR & LPTMR_CMR_COMPARE_MASK) + 1u) *
+                tick();
+}
+
+/**
+ * \brief Handles the compare event
+ *
+ * \param[in] event Compare event
+ */
+static void compare_event(sim_event_t *event)
+{
+        LPTMR_Type * const base = LPTMR0;
+
+        origin += period();
+        sim_schedule(event, origin + period());
+        base->CNR = 0u;
+        base->CSR |= LPTMR_CSR_TCF_MASK;
+        sim_llwu_module_flag(SIM_LLWU_MODULE_LPTMR, true);
+        sim_irq_raise(LPTMR0_IRQ);
+}
+
+/**
+ * \brief Level source of the LPTMR0 interrupt
+ *
+ * \return True, if the compare interrupt is asserted
+ */
+static bool lptmr_level(void)
+{
+        uint32_t const csr = LPTMR0->CSR;
+
+        return (csr & LPTMR_CSR_TIE_MASK) && (csr & LPTMR_CSR_TCF_MASK);
+}
+
+/// \brief Brings the counter up to the current time
+static void lptmr_sync(void)
+{
+        if (running) {
+                LPTMR0->CNR = (uint32_t)((sim_now() - origin) / tick());
+        }
+}
+
+/// LPTMR model
+static const sim_peripheral_t lptmr_peripheral = {
+        .sync = lptmr_sync,
+        .power = NULL
+};
+
+void sim_lptmr_model_init(void)
+{
+        compare.handler = compare_event;
+        compare.next = NULL;
+        compare.scheduled = false;
+        running = false;
+        origin = 0u;
+        sim_irq_set_level(LPTMR0_IRQ, lptmr_level);
+        sim_add_peripheral(&lptmr_peripheral);
+}
+
+void LPTMR_Init(LPTMR_Type *base, const lptmr_config_t *config)
+{
+        LPTMR_StopTimer(base);
+        base->CSR = LPTMR_CSR_TMS(config->timerMode) |
+                LPTMR_CSR_TFC(config->enableFreeRunning) |
+                LPTMR_CSR_TPP(config->pinPolarity) |
+                LPTMR_CSR_TPS(config->pinSelect);
+        base->PSR = LPTMR_PSR_PCS(config->prescalerClockSource) |
+                LPTMR_PSR_PBYP(config->bypassPrescaler) |
+                LPTMR_PSR_PRESCALE(config->value);
+}
+
+void LPTMR_GetDefaultConfig(lptmr_config_t *config)
+{
+        config->timerMode = kLPTMR_TimerModeTimeCounter;
+        config->pinSelect = kLPTMR_PinSelectInput_0;
+        config->pinPolarity = kLPTMR_PinPolarityActiveHigh;
+        config->enableFreeRunning = false;
+        config->bypassPrescaler = true;
+        config->prescalerClockSource = kLPTMR_PrescalerClock_1;
+        config->value = kLPTMR_Prescale_Glitch_0;
+}
+
+void LPTMR_EnableInterrupts(LPTMR_Type *base, uint32_t mask)
+{
+        base->CSR |= mask & LPTMR_CSR_TIE_MASK;
+        sim_irq_raise(LPTMR0_IRQ);
+}
+
+void LPTMR_DisableInterrupts(LPTMR_Type *base, uint32_t mask)
+{
+        base->CSR &= ~(mask & LPTMR_CSR_TIE_MASK);
+}
+
+void LPTMR_ClearStatusFlags(LPTMR_Type *base, uint32_t mask)
+{
+        if (mask & LPTMR_CSR_TCF_MASK) {
+                base->CSR &= ~LPTMR_CSR_TCF_MASK;
+                sim_llwu_module_flag(SIM_LLWU_MODULE_LPTMR, false);
+        }
+}
+
+void LPTMR_SetTimerPeriod(LPTMR_Type *base, uint32_t ticks)
+{
+        base->CMR = ticks - 1u;
+}
+
+uint32_t LPTMR_GetCurrentTimerCount(LPTMR_Type *base)
+{
+        return base->CNR & LPTMR_CNR_COUNTER_MASK;
+}
+
+void LPTMR_StartTimer(LPTMR_Type *base)
+{
+        if (running) {
+                return;
+        }
+        base->CSR |= LPTMR_CSR_TEN_MASK;
+        running = true;
+        origin = sim_now();
+        base->CNR = 0u;
+        sim_schedule(&compare, origin + period());
+}
+
+void LPTMR_StopTimer(LPTMR_Type *base)
+{
+        base->CSR &= ~(LPTMR_CSR_TEN_MASK | LPTMR_CSR_TCF_MASK);
+        base->CNR = 0u;
+        running = false;
+        sim_cancel(&compare);
+        sim_llwu_module_flag(SIM_LLWU_MODULE_LPTMR, false);
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,201 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_LPTMR_H
+#define FSL_LPTMR_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_lptmr.h
+ * \defgroup   host-lptmr Host LPTMR driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The timer counts the 1 kHz LPO in all the power modes. Only the time
+ * counter mode is simulated.
+ *
+ * @{
+ */
+
+/// Pulse counter input
+typedef enum _lptmr_pin_select {
+        kLPTMR_PinSelectInput_0 = 0x0U,
+        kLPTMR_PinSelectInput_1 = 0x1U,
+        kLPTMR_PinSelectInput_2 = 0x2U,
+        kLPTMR_PinSelectInput_3 = 0x3U
+} lptmr_pin_select_t;
+
+/// Pulse counter input polarity
+typedef enum _lptmr_pin_polarity {
+        kLPTMR_PinPolarityActiveHigh = 0x0U,
+        kLPTMR_PinPolarityActiveLow = 0x1U
+} lptmr_pin_polarity_t;
+
+/// Timer mode
+typedef enum _lptmr_timer_mode {
+        kLPTMR_TimerModeTimeCounter = 0x0U,
+        kLPTMR_TimerModePulseCounter = 0x1U
+} lptmr_timer_mode_t;
+
+/// Prescaler value, divides by 2^(value+1)
+typedef enum _lptmr_prescaler_glitch_value {
+        kLPTMR_Prescale_Glitch_0 = 0x0U
+} lptmr_prescaler_glitch_value_t;
+
+/// Prescaler clock
+typedef enum _lptmr_prescaler_clock_select {
+        kLPTMR_PrescalerClock_0 = 0x0U,
+        kLPTMR_PrescalerClock_1 = 0x1U,
+        kLPTMR_PrescalerClock_2 = 0x2U,
+        kLPTMR_PrescalerClock_3 = 0x3U
+} lptmr_prescaler_clock_select_t;
+
+/// Interrupts
+typedef enum _lptmr_interrupt_enable {
+        kLPTMR_TimerInterruptEnable = LPTMR_CSR_TIE_MASK
+} lptmr_interrupt_enable_t;
+
+/// Status flags
+typedef enum _lptmr_status_flags {
+        kLPTMR_TimerCompareFlag = LPTMR_CSR_TCF_MASK
+} lptmr_status_flags_t;
+
+/// Timer configuration
+typedef struct _lptmr_config {
+        /// Timer mode
+        lptmr_timer_mode_t timerMode;
+        /// Pulse counter input
+        lptmr_pin_select_t pinSelect;
+        /// Pulse counter input polarity
+        lptmr_pin_polarity_t pinPolarity;
+        /// True to reset the counter only on overflow
+        bool enableFreeRunning;
+        /// True to bypass the prescaler
+        bool bypassPrescaler;
+        /// Prescaler clock, 1 for the LPO
+        lptmr_prescaler_clock_select_t prescalerClockSource;
+        /// Prescaler value
+        lptmr_prescaler_glitch_value_t value;
+} lptmr_config_t;
+
+/**
+ * \brief Initializes the timer
+ *
+ * \param[in] base LPTMR instance
+ * \param[in] config Timer configuration
+ */
+void LPTMR_Init(LPTMR_Type *base, const lptmr_config_t *config);
+
+/**
+ * \brief Gets the default timer configuration
+ *
+ * The timer counts the LPO without the prescaler.
+ *
+ * \param[out] config Timer configuration
+ */
+void LPTMR_GetDefaultConfig(lptmr_config_t *config);
+
+/**
+ * \brief Enables interrupts
+ *
+ * \param[in] base LPTMR instance
+ * \param[in] mask Interrupts, as lptmr_interrupt_enable_t
+ */
+void LPTMR_EnableInterrupts(LPTMR_Type *base, uint32_t mask);
+
+/**
+ * \brief Disables interrupts
+ *
+ * \param[in] base LPTMR instance
+ * \param[in] mask Interrupts, as lptmr_interrupt_enable_t
+ */
+void LPTMR_DisableInterrupts(LPTMR_Type *base, uint32_t mask);
+
+/**
+ * \brief Gets the status flags
+ *
+ * \param[in] base LPTMR instance
+ *
+ * \return Status flags, as lptmr_status_flags_t
+ */
+static inline uint32_t LPTMR_GetStatusFlags(LPTMR_Type *base)
+{
+        return base->CSR & LPTMR_CSR_TCF_MASK;
+}
+
+/**
+ * \brief Clears status flags
+ *
+ * \param[in] base LPTMR instance
+ * \param[in] mask Status flags, as lptmr_status_flags_t
+ */
+void LPTMR_ClearStatusFlags(LPTMR_Type *base, uint32_t mask);
+
+/**
+ * \brief Sets the timer period
+ *
+ * \param[in] base LPTMR instance
+ * \param[in] ticks Period in counter ticks, at least 1
+ */
+void LPTMR_SetTimerPeriod(LPTMR_Type *base, uint32_t ticks);
+
+/**
+ * \brief Gets the counter value
+ *
+ * \param[in] base LPTMR instance
+ *
+ * \return Counter value in ticks
+ */
+uint32_t LPTMR_GetCurrentTimerCount(LPTMR_Type *base);
+
+/**
+ * \brief Starts the timer
+ *
+ * \param[in] base LPTMR instance
+ */
+void LPTMR_StartTimer(LPTMR_Type *base);
+
+/**
+ * \brief Stops the timer
+ *
+ * Resets the counter and clears the compare flag.
+ *
+ * \param[in] base LPTMR instance
+ */
+void LPTMR_StopTimer(LPTMR_Type *base);
+
+/** @} */
+
+#endif // ifndef FSL_LPTMR_H
+
+/* EOF */
@@ -0,0 +1,359 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_lpuart.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_lpuart.c
+ * \defgroup   host-lpuart-implementation Host LPUART driver implementation
+ * \ingroup    host-lpuart
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Interrupt of LPUART0
+#define LPUART0_IRQ 12
+/// Bits in a character, with the start and stop bits
+#define CHARACTER_BITS 10u
+/// Smallest oversampling ratio
+#define OSR_MIN 4u
+/// Largest oversampling ratio
+#define OSR_MAX 32u
+/// Size of the receive queue, a power of two
+#define RX_QUEUE_SIZE 4096u
+/// Status flags cleared by writing one
+#define W1C_FLAGS (LPUART_STAT_IDLE_MASK | LPUART_STAT_OR_MASK | \
+        LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK | \
+        LPUART_STAT_RXEDGIF_MASK)
+
+/// Length of a character
+static sim_time_t character_time;
+/// Transmitted character event
+static sim_event_t tx_event;
+/// Received character event
+static sim_event_t rx_event;
+/// Idle line event
+static sim_event_t idle_event;
+/// Character in the transmitter
+static uint8_t tx_character;
+/// Characters waiting to arrive
+static uint8_t rx_queue[RX_QUEUE_SIZE];
+/// Index of the next character to arrive
+static uint32_t rx_head;
+/// Number of the characters waiting
+static uint32_t rx_count;
+/// Transmitted byte callback
+static sim_serial_output_t output_callback;
+
+/**
+ * \brief Transmitter DMA request
+ *
+ * \return True, while the transmitter requests data
+ */
+static bool tx_request(void)
+{
+        LPUART_Type * const base = LPUART0;
+
+        return (base->CTRL & LPUART_CTRL_TE_MASK) &&
+                (base->BAUD & LPUART_BAUD_TDMAE_MASK) &&
+                (base->STAT & LPUART_STAT_TDRE_MASK);
+}
+
+/**
+ * \brief Receiver DMA request
+ *
+ * \return True, while the receiver holds data
+ */
+static bool rx_request(void)
+{
+        LPUART_Type * const base = LPUART0;
+
+        return (base->CTRL & LPUART_CTRL_RE_MASK) &&
+                (base->BAUD & LPUART_BAUD_RDMAE_MASK) &&
+                (base->STAT & LPUART_STAT_RDRF_MASK);
+}
+
+/**
+ * \brief Level source of the LPUART0 interrupt
+ *
+ * \return True, if an enabled status interrupt is asserted
+ */
+static bool lpuart_level(void)
+{
+        uint32_t const ctrl = LPUART0->CTRL;
+        uint32_t const stat = LPUART0->STAT;
+
+        return ((ctrl & LPUART_CTRL_ILIE_MASK) &&
+                (stat & LPUART_STAT_IDLE_MASK)) ||
+                ((ctrl & LPUART_CTRL_ORIE_MASK) &&
+                (stat & LPUART_STAT_OR_MASK)) ||
+                ((ctrl & LPUART_CTRL_RIE_MASK) &&
+                (stat & LPUART_STAT_RDRF_MASK) &&
+                !(LPUART0->BAUD & LPUART_BAUD_RDMAE_MASK)) ||
+                ((ctrl & LPUART_CTRL_TCIE_MASK) &&
+                (stat & LPUART_STAT_TC_MASK));
+}
+
+/**
+ * \brief Handles the end of a transmitted character
+ *
+ * \param[in] event Transmitted character event
+ */
+static void tx_done(sim_event_t *event)
+{
+        (void)event;
+
+        LPUART0->STAT |= LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK;
+        if (output_callback) {
+                output_callback(tx_character);
+        }
+        sim_irq_raise(LPUART0_IRQ);
+        sim_dma_request(SIM_DMA_SOURCE_LPUART0_TX);
+}
+
+/**
+ * \brief Handles the end of a received character
+ *
+ * \param[in] event Received character event
+ */
+static void rx_done(sim_event_t *event)
+{
+        LPUART_Type * const base = LPUART0;
+        uint8_t const character = rx_queue[rx_head];
+        uint32_t const idle_characters = 1u << ((base->CTRL &
+                LPUART_CTRL_IDLECFG_MASK) >> LPUART_CTRL_IDLECFG_SHIFT);
+
+        rx_head = (rx_head + 1u) & (RX_QUEUE_SIZE - 1u);
+        --rx_count;
+
+        if (base->CTRL & LPUART_CTRL_RE_MASK) {
+                if (base->STAT & LPUART_STAT_RDRF_MASK) {
+                        // The previous character was not read in time.
+                        base->STAT |= LPUART_STAT_OR_MASK;
+                } else {
+                        base->DATA = character;
+                        base->STAT |= LPUART_STAT_RDRF_MASK;
+                }
+        }
+
+        if (rx_count) {
+                sim_schedule(event, sim_now() + character_time);
+                sim_cancel(&idle_event);
+        } else {
+                sim_schedule(&idle_event, sim_now() +
+                        (idle_characters * character_time));
+        }
+        sim_irq_raise(LPUART0_IRQ);
+        sim_dma_request(SIM_DMA_SOURCE_LPUART0_RX);
+}
+
+/**
+ * \brief Handles the idle line after the received characters
+ *
+ * \param[in] event Idle line event
+ */
+static void idle(sim_event_t *event)
+{
+        (void)event;
+
+        if (LPUART0->CTRL & LPUART_CTRL_RE_MASK) {
+                LPUART0->STAT |= LPUART_STAT_IDLE_MASK;
+                sim_irq_raise(LPUART0_IRQ);
+        }
+}
+
+void sim_lpuart_model_init(void)
+{
+        tx_event.handler = tx_done;
+        tx_event.next = NULL;
+        tx_event.scheduled = false;
+        rx_event.handler = rx_done;
+        rx_event.next = NULL;
+        rx_event.scheduled = false;
+        idle_event.handler = idle;
+        idle_event.next = NULL;
+        idle_event.scheduled = false;
+        character_time = (CHARACTER_BITS * SIM_S) / 9600u;
+        rx_head = 0u;
+        rx_count = 0u;
+        output_callback = NULL;
+        LPUART0->STAT = LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK;
+        sim_irq_set_level(LPUART0_IRQ, lpuart_level);
+        sim_dma_set_request(SIM_DMA_SOURCE_LPUART0_TX, tx_request);
+        sim_dma_set_request(SIM_DMA_SOURCE_LPUART0_RX, rx_request);
+}
+
+void sim_serial_receive(uint8_t const *data, size_t length)
+{
+        for (size_t i = 0u; (i < length) && (rx_count < RX_QUEUE_SIZE);
+                ++i) {
+                rx_queue[(rx_head + rx_count) & (RX_QUEUE_SIZE - 1u)] =
+                        data[i];
+                ++rx_count;
+        }
+        if (rx_count && !rx_event.scheduled) {
+                sim_schedule(&rx_event, sim_now() + character_time);
+        }
+}
+
+void sim_serial_set_output(sim_serial_output_t output)
+{
+        output_callback = output;
+}
+
+void sim_lpuart_read(void)
+{
+        LPUART0->STAT &= ~LPUART_STAT_RDRF_MASK;
+}
+
+void sim_lpuart_write(void)
+{
+        LPUART_Type * const base = LPUART0;
+
+        if (!(base->CTRL & LPUART_CTRL_TE_MASK)) {
+                return;
+        }
+        tx_character = (uint8_t)base->DATA;
+        base->STAT &= ~(LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK);
+        sim_schedule(&tx_event, sim_now() + character_time);
+}
+
+status_t LPUART_Init(LPUART_Type *base, const lpuart_config_t *config,
+        uint32_t srcClock_Hz)
+{
+        uint32_t best_osr = 0u;
+        uint32_t best_sbr = 0u;
+        uint32_t best_difference = config->baudRate_Bps;
+
+        // Like the target driver, search for the closest oversampling ratio.
+        for (uint32_t osr = OSR_MIN; osr <= OSR_MAX; ++osr) {
+                uint32_t sbr = (srcClock_Hz * 10u / (config->baudRate_Bps *
+                        osr) + 5u) / 10u;
+                uint32_t rate;
+                uint32_t difference;
+
+                if (!sbr) {
+                        sbr = 1u;
+                }
+                if (sbr > (LPUART_BAUD_SBR_MASK >> LPUART_BAUD_SBR_SHIFT)) {
+                        continue;
+                }
+                rate = srcClock_Hz / (osr * sbr);
+                difference = (rate > config->baudRate_Bps) ?
+                        (rate - config->baudRate_Bps) :
+                        (config->baudRate_Bps - rate);
+                if (difference <= best_difference) {
+                        best_difference = difference;
+                        best_osr = osr;
+                        best_sbr = sbr;
+                }
+        }
+        if (!best_osr ||
+                (best_difference > ((config->baudRate_Bps / 100u) * 3u))) {
+                return kStatus_LPUART_BaudrateNotSupport;
+        }
+
+        CLOCK_EnableClock(kCLOCK_Lpuart0);
+        base->BAUD = LPUART_BAUD_OSR(best_osr - 1u) |
+                LPUART_BAUD_SBR(best_sbr) |
+                LPUART_BAUD_SBNS(config->stopBitCount) |
+                ((best_osr < 8u) ? LPUART_BAUD_BOTHEDGE_MASK : 0u);
+        base->CTRL = LPUART_CTRL_ILT(config->rxIdleType) |
+                LPUART_CTRL_IDLECFG(config->rxIdleConfig) |
+                LPUART_CTRL_TE(config->enableTx) |
+                LPUART_CTRL_RE(config->enableRx) |
+                ((uint32_t)config->parityMode << LPUART_CTRL_PT_SHIFT);
+        base->STAT = LPUART_STAT_TDRE_MASK | LPUART_STAT_TC_MASK |
+                LPUART_STAT_MSBF(config->isMsb);
+        character_time = (CHARACTER_BITS * SIM_S * best_osr * best_sbr) /
+                srcClock_Hz;
+
+        return kStatus_Success;
+}
+
+void LPUART_GetDefaultConfig(lpuart_config_t *config)
+{
+        memset(config, 0, sizeof(*config));
+        config->baudRate_Bps = 115200u;
+        config->parityMode = kLPUART_ParityDisabled;
+        config->dataBitsCount = kLPUART_EightDataBits;
+        config->isMsb = false;
+        config->stopBitCount = kLPUART_OneStopBit;
+        config->rxIdleType = kLPUART_IdleTypeStartBit;
+        config->rxIdleConfig = kLPUART_IdleCharacter1;
+        config->enableTx = false;
+        config->enableRx = false;
+}
+
+status_t LPUART_ClearStatusFlags(LPUART_Type *base, uint32_t mask)
+{
+        base->STAT &= ~(mask & W1C_FLAGS);
+
+        return (mask & ~W1C_FLAGS) ? kStatus_LPUART_FlagCannotClearManually :
+                kStatus_Success;
+}
+
+void LPUART_EnableInterrupts(LPUART_Type *base, uint32_t mask)
+{
+        base->CTRL |= mask;
+        sim_irq_raise(LPUART0_IRQ);
+}
+
+void LPUART_DisableInterrupts(LPUART_Type *base, uint32_t mask)
+{
+        base->CTRL &= ~mask;
+}
+
+void LPUART_EnableTxDMA(LPUART_Type *base, bool enable)
+{
+        if (enable) {
+                base->BAUD |= LPUART_BAUD_TDMAE_MASK;
+                sim_dma_request(SIM_DMA_SOURCE_LPUART0_TX);
+        } else {
+                base->BAUD &= ~LPUART_BAUD_TDMAE_MASK;
+        }
+}
+
+void LPUART_EnableRxDMA(LPUART_Type *base, bool enable)
+{
+        if (enable) {
+                base->BAUD |= LPUART_BAUD_RDMAE_MASK;
+                sim_dma_request(SIM_DMA_SOURCE_LPUART0_RX);
+        } else {
+                base->BAUD &= ~LPUART_BAUD_RDMAE_MASK;
+        }
+}
+
+/** @} */
+
+/* EOF */
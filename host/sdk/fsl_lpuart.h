@@ -0,0 +1,238 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_LPUART_H
+#define FSL_LPUART_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_lpuart.h
+ * \defgroup   host-lpuart Host LPUART driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The characters take ten bit times at the configured baud rate. The
+ * receiver and the transmitter have one data register each, without the
+ * separate shift register of the target.
+ *
+ * @{
+ */
+
+/// LPUART status codes
+enum {
+        kStatus_LPUART_TxBusy = MAKE_STATUS(kStatusGroup_LPUART, 0),
+        kStatus_LPUART_RxBusy = MAKE_STATUS(kStatusGroup_LPUART, 1),
+        kStatus_LPUART_TxIdle = MAKE_STATUS(kStatusGroup_LPUART, 2),
+        kStatus_LPUART_RxIdle = MAKE_STATUS(kStatusGroup_LPUART, 3),
+        kStatus_LPUART_FlagCannotClearManually =
+                MAKE_STATUS(kStatusGroup_LPUART, 6),
+        kStatus_LPUART_BaudrateNotSupport =
+                MAKE_STATUS(kStatusGroup_LPUART, 13)
+};
+
+/// Parity mode
+typedef enum _lpuart_parity_mode {
+        kLPUART_ParityDisabled = 0x0U,
+        kLPUART_ParityEven = 0x2U,
+        kLPUART_ParityOdd = 0x3U
+} lpuart_parity_mode_t;
+
+/// Number of the data bits
+typedef enum _lpuart_data_bits {
+        kLPUART_EightDataBits = 0x0U
+} lpuart_data_bits_t;
+
+/// Number of the stop bits
+typedef enum _lpuart_stop_bit_count {
+        kLPUART_OneStopBit = 0U,
+        kLPUART_TwoStopBit = 1U
+} lpuart_stop_bit_count_t;
+
+/// Start of the idle count
+typedef enum _lpuart_idle_type_select {
+        kLPUART_IdleTypeStartBit = 0U,
+        kLPUART_IdleTypeStopBit = 1U
+} lpuart_idle_type_select_t;
+
+/// Number of the idle characters before the idle flag
+typedef enum _lpuart_idle_config {
+        kLPUART_IdleCharacter1 = 0U,
+        kLPUART_IdleCharacter2 = 1U,
+        kLPUART_IdleCharacter4 = 2U,
+        kLPUART_IdleCharacter8 = 3U,
+        kLPUART_IdleCharacter16 = 4U,
+        kLPUART_IdleCharacter32 = 5U,
+        kLPUART_IdleCharacter64 = 6U,
+        kLPUART_IdleCharacter128 = 7U
+} lpuart_idle_config_t;
+
+/// Interrupt enables
+enum _lpuart_interrupt_enable {
+        kLPUART_TxDataRegEmptyInterruptEnable = LPUART_CTRL_TIE_MASK,
+        kLPUART_TransmissionCompleteInterruptEnable = LPUART_CTRL_TCIE_MASK,
+        kLPUART_RxDataRegFullInterruptEnable = LPUART_CTRL_RIE_MASK,
+        kLPUART_IdleLineInterruptEnable = LPUART_CTRL_ILIE_MASK,
+        kLPUART_RxOverrunInterruptEnable = LPUART_CTRL_ORIE_MASK
+};
+
+/// Status flags
+enum _lpuart_flags {
+        kLPUART_TxDataRegEmptyFlag = LPUART_STAT_TDRE_MASK,
+        kLPUART_TransmissionCompleteFlag = LPUART_STAT_TC_MASK,
+        kLPUART_RxDataRegFullFlag = LPUART_STAT_RDRF_MASK,
+        kLPUART_IdleLineFlag = LPUART_STAT_IDLE_MASK,
+        kLPUART_RxOverrunFlag = LPUART_STAT_OR_MASK
+};
+
+/// LPUART configuration
+typedef struct _lpuart_config {
+        /// Baud rate
+        uint32_t baudRate_Bps;
+        /// Parity mode
+        lpuart_parity_mode_t parityMode;
+        /// Number of the data bits
+        lpuart_data_bits_t dataBitsCount;
+        /// True to send the most significant bit first
+        bool isMsb;
+        /// Number of the stop bits
+        lpuart_stop_bit_count_t stopBitCount;
+        /// Start of the idle count
+        lpuart_idle_type_select_t rxIdleType;
+        /// Number of the idle characters
+        lpuart_idle_config_t rxIdleConfig;
+        /// True to enable the transmitter
+        bool enableTx;
+        /// True to enable the receiver
+        bool enableRx;
+} lpuart_config_t;
+
+/// Transfer buffer
+typedef struct _lpuart_transfer {
+        /// Data
+        uint8_t *data;
+        /// Number of the bytes
+        size_t dataSize;
+} lpuart_transfer_t;
+
+/**
+ * \brief Initializes the LPUART
+ *
+ * \param[in] base LPUART instance
+ * \param[in] config Configuration
+ * \param[in] srcClock_Hz Frequency of the LPUART clock
+ *
+ * \return kStatus_Success, or kStatus_LPUART_BaudrateNotSupport if the baud
+ * rate can not be reached within 3 %
+ */
+status_t LPUART_Init(LPUART_Type *base, const lpuart_config_t *config,
+        uint32_t srcClock_Hz);
+
+/**
+ * \brief Gets the default configuration
+ *
+ * \param[out] config Configuration
+ */
+void LPUART_GetDefaultConfig(lpuart_config_t *config);
+
+/**
+ * \brief Gets the status flags
+ *
+ * \param[in] base LPUART instance
+ *
+ * \return Flags, as _lpuart_flags
+ */
+static inline uint32_t LPUART_GetStatusFlags(LPUART_Type *base)
+{
+        return base->STAT;
+}
+
+/**
+ * \brief Clears the status flags
+ *
+ * \param[in] base LPUART instance
+ * \param[in] mask Flags to clear, as _lpuart_flags
+ *
+ * \return kStatus_Success, or kStatus_LPUART_FlagCannotClearManually if a
+ * flag can not be cleared by writing
+ */
+status_t LPUART_ClearStatusFlags(LPUART_Type *base, uint32_t mask);
+
+/**
+ * \brief Enables interrupts
+ *
+ * \param[in] base LPUART instance
+ * \param[in] mask Interrupts to enable, as _lpuart_interrupt_enable
+ */
+void LPUART_EnableInterrupts(LPUART_Type *base, uint32_t mask);
+
+/**
+ * \brief Disables interrupts
+ *
+ * \param[in] base LPUART instance
+ * \param[in] mask Interrupts to disable, as _lpuart_interrupt_enable
+ */
+void LPUART_DisableInterrupts(LPUART_Type *base, uint32_t mask);
+
+/**
+ * \brief Enables or disables the transmitter DMA requests
+ *
+ * \param[in] base LPUART instance
+ * \param[in] enable True to enable
+ */
+void LPUART_EnableTxDMA(LPUART_Type *base, bool enable);
+
+/**
+ * \brief Enables or disables the receiver DMA requests
+ *
+ * \param[in] base LPUART instance
+ * \param[in] enable True to enable
+ */
+void LPUART_EnableRxDMA(LPUART_Type *base, bool enable);
+
+/**
+ * \brief Gets the address of the data register
+ *
+ * \param[in] base LPUART instance
+ *
+ * \return Address of the data register
+ */
+static inline uintptr_t LPUART_GetDataRegisterAddress(LPUART_Type *base)
+{
+        return (uintptr_t)&base->DATA;
+}
+
+/** @} */
+
+#endif // ifndef FSL_LPUART_H
+
+/* EOF */
@@ -0,0 +1,161 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_lpuart_dma.h"
+
+/**
+ * \file       fsl_lpuart_dma.c
+ * \defgroup   host-lpuart-dma-implementation Host LPUART DMA implementation
+ * \ingroup    host-lpuart-dma
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Transfer states
+enum {
+        LPUART_TX_IDLE,
+        LPUART_TX_BUSY,
+        LPUART_RX_IDLE,
+        LPUART_RX_BUSY
+};
+
+/// Instance of the handle
+static LPUART_Type *handle_base;
+
+/**
+ * \brief Send done callback of the DMA
+ *
+ * \param[in] dma DMA handle
+ * \param[in] param LPUART DMA handle
+ */
+static void send_done(dma_handle_t *dma, void *param)
+{
+        lpuart_dma_handle_t * const handle = param;
+
+        (void)dma;
+
+        LPUART_EnableTxDMA(handle_base, false);
+        handle->txState = LPUART_TX_IDLE;
+        if (handle->callback) {
+                handle->callback(handle_base, handle, kStatus_LPUART_TxIdle,
+                        handle->userData);
+        }
+}
+
+/**
+ * \brief Receive done callback of the DMA
+ *
+ * \param[in] dma DMA handle
+ * \param[in] param LPUART DMA handle
+ */
+static void receive_done(dma_handle_t *dma, void *param)
+{
+        lpuart_dma_handle_t * const handle = param;
+
+        (void)dma;
+
+        LPUART_EnableRxDMA(handle_base, false);
+        handle->rxState = LPUART_RX_IDLE;
+        if (handle->callback) {
+                handle->callback(handle_base, handle, kStatus_LPUART_RxIdle,
+                        handle->userData);
+        }
+}
+
+void LPUART_TransferCreateHandleDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_dma_transfer_callback_t callback,
+        void *userData, dma_handle_t *txDmaHandle, dma_handle_t *rxDmaHandle)
+{
+        memset(handle, 0, sizeof(*handle));
+        handle_base = base;
+        handle->callback = callback;
+        handle->userData = userData;
+        handle->txState = LPUART_TX_IDLE;
+        handle->rxState = LPUART_RX_IDLE;
+        handle->txDmaHandle = txDmaHandle;
+        handle->rxDmaHandle = rxDmaHandle;
+        if (txDmaHandle) {
+                DMA_SetCallback(txDmaHandle, send_done, handle);
+        }
+        if (rxDmaHandle) {
+                DMA_SetCallback(rxDmaHandle, receive_done, handle);
+        }
+}
+
+status_t LPUART_TransferSendDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_transfer_t *xfer)
+{
+        dma_transfer_config_t config;
+
+        if (handle->txState == LPUART_TX_BUSY) {
+                return kStatus_LPUART_TxBusy;
+        }
+        handle->txState = LPUART_TX_BUSY;
+        handle->txDataSizeAll = xfer->dataSize;
+
+        DMA_PrepareTransfer(&config, xfer->data, sizeof(uint8_t),
+                (void *)LPUART_GetDataRegisterAddress(base), sizeof(uint8_t),
+                (uint32_t)xfer->dataSize, kDMA_MemoryToPeripheral);
+        (void)DMA_SubmitTransfer(handle->txDmaHandle, &config,
+                kDMA_EnableInterrupt);
+        DMA_StartTransfer(handle->txDmaHandle);
+        LPUART_EnableTxDMA(base, true);
+
+        return kStatus_Success;
+}
+
+status_t LPUART_TransferReceiveDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_transfer_t *xfer)
+{
+        dma_transfer_config_t config;
+
+        if (handle->rxState == LPUART_RX_BUSY) {
+                return kStatus_LPUART_RxBusy;
+        }
+        handle->rxState = LPUART_RX_BUSY;
+        handle->rxDataSizeAll = xfer->dataSize;
+
+        DMA_PrepareTransfer(&config,
+                (void *)LPUART_GetDataRegisterAddress(base), sizeof(uint8_t),
+                xfer->data, sizeof(uint8_t), (uint32_t)xfer->dataSize,
+                kDMA_PeripheralToMemory);
+        (void)DMA_SubmitTransfer(handle->rxDmaHandle, &config,
+                kDMA_EnableInterrupt);
+        DMA_StartTransfer(handle->rxDmaHandle);
+        LPUART_EnableRxDMA(base, true);
+
+        return kStatus_Success;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,126 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_LPUART_DMA_H
+#define FSL_LPUART_DMA_H
+
+#include "fsl_dma.h"
+#include "fsl_lpuart.h"
+
+/**
+ * \file       fsl_lpuart_dma.h
+ * \defgroup   host-lpuart-dma Host LPUART DMA driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Unlike the target driver, the transmit done callback does not wait for
+ * the last character to leave the transmitter.
+ *
+ * @{
+ */
+
+typedef struct _lpuart_dma_handle lpuart_dma_handle_t;
+
+/**
+ * \brief Transfer callback
+ *
+ * \param[in] base LPUART instance
+ * \param[in] handle LPUART DMA handle
+ * \param[in] status kStatus_LPUART_TxIdle or kStatus_LPUART_RxIdle
+ * \param[in] userData User data
+ */
+typedef void (*lpuart_dma_transfer_callback_t)(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, status_t status, void *userData);
+
+/// LPUART DMA handle
+struct _lpuart_dma_handle {
+        /// Transfer callback
+        lpuart_dma_transfer_callback_t callback;
+        /// User data of the callback
+        void *userData;
+        /// Size of the receive transfer
+        size_t rxDataSizeAll;
+        /// Size of the send transfer
+        size_t txDataSizeAll;
+        /// DMA handle of the transmitter
+        dma_handle_t *txDmaHandle;
+        /// DMA handle of the receiver
+        dma_handle_t *rxDmaHandle;
+        /// Transmitter state
+        volatile uint8_t txState;
+        /// Receiver state
+        volatile uint8_t rxState;
+};
+
+/**
+ * \brief Creates a DMA transfer handle
+ *
+ * \param[in] base LPUART instance
+ * \param[out] handle LPUART DMA handle
+ * \param[in] callback Transfer callback
+ * \param[in] userData User data of the callback
+ * \param[in] txDmaHandle DMA handle of the transmitter
+ * \param[in] rxDmaHandle DMA handle of the receiver
+ */
+void LPUART_TransferCreateHandleDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_dma_transfer_callback_t callback,
+        void *userData, dma_handle_t *txDmaHandle, dma_handle_t *rxDmaHandle);
+
+/**
+ * \brief Sends data by DMA
+ *
+ * \param[in] base LPUART instance
+ * \param[in] handle LPUART DMA handle
+ * \param[in] xfer Data to send
+ *
+ * \return kStatus_Success, or kStatus_LPUART_TxBusy if a send is ongoing
+ */
+status_t LPUART_TransferSendDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_transfer_t *xfer);
+
+/**
+ * \brief Receives data by DMA
+ *
+ * \param[in] base LPUART instance
+ * \param[in] handle LPUART DMA handle
+ * \param[in] xfer Receive buffer
+ *
+ * \return kStatus_Success, or kStatus_LPUART_RxBusy if a receive is ongoing
+ */
+status_t LPUART_TransferReceiveDMA(LPUART_Type *base,
+        lpuart_dma_handle_t *handle, lpuart_transfer_t *xfer);
+
+/** @} */
+
+#endif // ifndef FSL_LPUART_DMA_H
+
+/* EOF */
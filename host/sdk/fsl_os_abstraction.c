@@ -0,0 +1,133 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_os_abstraction.h"
+
+/**
+ * \file       fsl_os_abstraction.c
+ * \defgroup   host-osa-implementation Host OS abstraction implementation
+ * \ingroup    host-osa
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Event state, within OSA_EVENT_HANDLE_SIZE
+typedef struct {
+        /// Event flags
+        volatile osa_event_flags_t flags;
+        /// True to clear the flags when a wait is satisfied
+        bool autoClear;
+} event_t;
+
+/// Nesting depth of the interrupt masking
+static uint32_t disable_count;
+
+osa_status_t OSA_EventCreate(osa_event_handle_t eventHandle,
+        uint8_t autoClear)
+{
+        event_t * const event = eventHandle;
+
+        event->flags = 0u;
+        event->autoClear = autoClear != 0u;
+
+        return KOSA_StatusSuccess;
+}
+
+osa_status_t OSA_EventSet(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToSet)
+{
+        event_t * const event = eventHandle;
+
+        OSA_DisableIRQGlobal();
+        event->flags |= flagsToSet;
+        OSA_EnableIRQGlobal();
+
+        return KOSA_StatusSuccess;
+}
+
+osa_status_t OSA_EventClear(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToClear)
+{
+        event_t * const event = eventHandle;
+
+        OSA_DisableIRQGlobal();
+        event->flags &= ~flagsToClear;
+        OSA_EnableIRQGlobal();
+
+        return KOSA_StatusSuccess;
+}
+
+osa_status_t OSA_EventWait(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToWait, uint8_t waitAll, uint32_t millisec,
+        osa_event_flags_t *pSetFlags)
+{
+        event_t * const event = eventHandle;
+        osa_status_t status = KOSA_StatusIdle;
+
+        if (!pSetFlags) {
+                return KOSA_StatusError;
+        }
+
+        OSA_DisableIRQGlobal();
+        *pSetFlags = event->flags & flagsToWait;
+        if ((!waitAll && *pSetFlags) || (*pSetFlags == flagsToWait)) {
+                if (event->autoClear) {
+                        event->flags &= ~flagsToWait;
+                }
+                status = KOSA_StatusSuccess;
+        } else if (!millisec) {
+                status = KOSA_StatusTimeout;
+        }
+        OSA_EnableIRQGlobal();
+
+        return status;
+}
+
+void OSA_DisableIRQGlobal(void)
+{
+        __disable_irq();
+        ++disable_count;
+}
+
+void OSA_EnableIRQGlobal(void)
+{
+        if (disable_count) {
+                --disable_count;
+                if (!disable_count) {
+                        __enable_irq();
+                }
+        }
+}
+
+/** @} */
+
+/* EOF */
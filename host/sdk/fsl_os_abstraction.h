@@ -0,0 +1,133 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_OS_ABSTRACTION_H
+#define FSL_OS_ABSTRACTION_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_os_abstraction.h
+ * \defgroup   host-osa Host OS abstraction
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The event and the interrupt functions of the bare-metal OS abstraction.
+ * The waits do not block, as on bare metal without the timer.
+ *
+ * @{
+ */
+
+/// Event handle
+typedef void *osa_event_handle_t;
+/// Event flags
+typedef uint32_t osa_event_flags_t;
+
+/// OS abstraction status codes
+typedef enum _osa_status {
+        KOSA_StatusSuccess = kStatus_Success,
+        KOSA_StatusError = MAKE_STATUS(kStatusGroup_OSA, 1),
+        KOSA_StatusTimeout = MAKE_STATUS(kStatusGroup_OSA, 2),
+        KOSA_StatusIdle = MAKE_STATUS(kStatusGroup_OSA, 3)
+} osa_status_t;
+
+/// All the event flags
+#define osaEventFlagsAll_c ((osa_event_flags_t)(0x00FFFFFF))
+/// Wait without a timeout
+#define osaWaitForever_c ((uint32_t)(-1))
+
+/// Size of an event in bytes
+#define OSA_EVENT_HANDLE_SIZE (16)
+
+/// Defines the storage of an event
+#define EVENT_HANDLE_BUFFER_DEFINE(name) \
+        uint32_t name[((OSA_EVENT_HANDLE_SIZE - 1) >> 2) + 1]
+
+/**
+ * \brief Creates an event
+ *
+ * \param[in] eventHandle Storage of the event
+ * \param[in] autoClear 1 to clear the flags when a wait is satisfied
+ *
+ * \return KOSA_StatusSuccess
+ */
+osa_status_t OSA_EventCreate(osa_event_handle_t eventHandle,
+        uint8_t autoClear);
+
+/**
+ * \brief Sets event flags
+ *
+ * \param[in] eventHandle Event
+ * \param[in] flagsToSet Flags to set
+ *
+ * \return KOSA_StatusSuccess
+ */
+osa_status_t OSA_EventSet(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToSet);
+
+/**
+ * \brief Clears event flags
+ *
+ * \param[in] eventHandle Event
+ * \param[in] flagsToClear Flags to clear
+ *
+ * \return KOSA_StatusSuccess
+ */
+osa_status_t OSA_EventClear(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToClear);
+
+/**
+ * \brief Checks the event flags
+ *
+ * \param[in] eventHandle Event
+ * \param[in] flagsToWait Flags to check
+ * \param[in] waitAll 1 to require all the flags
+ * \param[in] millisec Timeout, only 0 is meaningful on bare metal
+ * \param[out] pSetFlags Flags which were set
+ *
+ * \return KOSA_StatusSuccess if the condition is met, KOSA_StatusTimeout
+ * with a zero timeout, otherwise KOSA_StatusIdle
+ */
+osa_status_t OSA_EventWait(osa_event_handle_t eventHandle,
+        osa_event_flags_t flagsToWait, uint8_t waitAll, uint32_t millisec,
+        osa_event_flags_t *pSetFlags);
+
+/// \brief Masks the interrupts, nesting
+void OSA_DisableIRQGlobal(void);
+/// \brief Unmasks the interrupts at the outermost level
+void OSA_EnableIRQGlobal(void);
+
+/** @} */
+
+#endif // ifndef FSL_OS_ABSTRACTION_H
+
+/* EOF */
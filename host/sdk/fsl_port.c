@@ -0,0 +1,273 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_port.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_port.c
+ * \defgroup   host-port-implementation Host PORT driver implementation
+ * \ingroup    host-port
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Distance between the PORT instances
+#define PORT_STRIDE (PORTB_BASE - PORTA_BASE)
+
+/// Interrupt of the port A pins
+#define PORTA_IRQ 30
+/// Shared interrupt of the port C and D pins
+#define PORTC_PORTD_IRQ 31
+
+/// PORT instances by port
+static PORT_Type * const port_base[SIM_PORTS] = {
+        PORTA, PORTB, PORTC, PORTD, PORTE
+};
+
+/// Pin levels as last seen by the PORT model
+static uint32_t level[SIM_PORTS];
+
+/**
+ * \brief Gets the port of a PORT instance
+ *
+ * \param[in] base PORT instance
+ *
+ * \return Port
+ */
+static inline sim_port_t port_of(PORT_Type const *base)
+{
+        return (sim_port_t)(((uintptr_t)base - PORTA_BASE) / PORT_STRIDE);
+}
+
+/**
+ * \brief Gets the interrupt of a port
+ *
+ * \param[in] port Port
+ *
+ * \return Interrupt number, or -1 for a port without pin interrupts
+ */
+static int irq_of(sim_port_t port)
+{
+        switch (port) {
+        case SIM_PORT_A:
+                return PORTA_IRQ;
+        case SIM_PORT_C:
+        case SIM_PORT_D:
+                return PORTC_PORTD_IRQ;
+        default:
+                return -1;
+        }
+}
+
+/**
+ * \brief Level source of the port A interrupt
+ *
+ * \return True, if a pin interrupt flag is set
+ */
+static bool porta_level(void)
+{
+        return PORTA->ISFR != 0u;
+}
+
+/**
+ * \brief Level source of the port C and D interrupt
+ *
+ * \return True, if a pin interrupt flag is set
+ */
+static bool portc_portd_level(void)
+{
+        return (PORTC->ISFR | PORTD->ISFR) != 0u;
+}
+
+/**
+ * \brief Sets the interrupt flags of pins
+ *
+ * \param[in] port Port
+ * \param[in] flags Flags to set
+ */
+static void set_flags(sim_port_t port, uint32_t flags)
+{
+        PORT_Type * const base = port_base[port];
+        int const irq = irq_of(port);
+
+        if (!flags || (irq < 0)) {
+                return;
+        }
+        base->ISFR |= flags;
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                if (flags & (1u << pin)) {
+                        base->PCR[pin] |= PORT_PCR_ISF_MASK;
+                }
+        }
+        sim_irq_raise(irq);
+}
+
+/**
+ * \brief Sets the flags of the pins with a level sensitive interrupt
+ *
+ * \param[in] port Port
+ * \param[in] mask Pins to check
+ */
+static void check_levels(sim_port_t port, uint32_t mask)
+{
+        PORT_Type * const base = port_base[port];
+        uint32_t flags = 0u;
+
+        if (sim_mode() == SIM_MODE_LLS) {
+                return;
+        }
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                uint32_t const irqc = (base->PCR[pin] & PORT_PCR_IRQC_MASK) >>
+                        PORT_PCR_IRQC_SHIFT;
+                bool const high = (level[port] >> pin) & 1u;
+
+                if (!(mask & (1u << pin))) {
+                        continue;
+                }
+                if (((irqc == kPORT_InterruptLogicZero) && !high) ||
+                        ((irqc == kPORT_InterruptLogicOne) && high)) {
+                        flags |= 1u << pin;
+                }
+        }
+        set_flags(port, flags);
+}
+
+/**
+ * \brief Writes a pin control register
+ *
+ * The interrupt flag is cleared by writing one, like on the target.
+ *
+ * \param[in] base PORT instance
+ * \param[in] pin Pin number
+ * \param[in] value Register value
+ */
+static void write_pcr(PORT_Type *base, uint32_t pin, uint32_t value)
+{
+        if (value & PORT_PCR_ISF_MASK) {
+                base->ISFR &= ~(1u << pin);
+                value &= ~PORT_PCR_ISF_MASK;
+        } else {
+                value |= base->PCR[pin] & PORT_PCR_ISF_MASK;
+        }
+        base->PCR[pin] = value;
+}
+
+void sim_port_model_init(void)
+{
+        for (uint32_t port = 0u; port < SIM_PORTS; ++port) {
+                level[port] = 0u;
+        }
+        sim_irq_set_level(PORTA_IRQ, porta_level);
+        sim_irq_set_level(PORTC_PORTD_IRQ, portc_portd_level);
+}
+
+void sim_port_pins_changed(sim_port_t port, uint32_t previous,
+        uint32_t levels)
+{
+        PORT_Type * const base = port_base[port];
+        uint32_t const changed = previous ^ levels;
+        uint32_t flags = 0u;
+
+        level[port] = levels;
+        // In LLS the pin changes are detected by the LLWU.
+        if (sim_mode() == SIM_MODE_LLS) {
+                return;
+        }
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                uint32_t const irqc = (base->PCR[pin] & PORT_PCR_IRQC_MASK) >>
+                        PORT_PCR_IRQC_SHIFT;
+                bool const high = (levels >> pin) & 1u;
+
+                if (!(changed & (1u << pin))) {
+                        continue;
+                }
+                if ((irqc == kPORT_InterruptEitherEdge) ||
+                        ((irqc == kPORT_InterruptRisingEdge) && high) ||
+                        ((irqc == kPORT_InterruptFallingEdge) && !high)) {
+                        flags |= 1u << pin;
+                }
+        }
+        set_flags(port, flags);
+        check_levels(port, changed);
+}
+
+void PORT_SetPinConfig(PORT_Type *base, uint32_t pin,
+        const port_pin_config_t *config)
+{
+        uint16_t value;
+
+        memcpy(&value, config, sizeof(value));
+        write_pcr(base, pin, (base->PCR[pin] & 0xFFFF0000u &
+                ~PORT_PCR_ISF_MASK) | value);
+        sim_gpio_update(port_of(base));
+}
+
+void PORT_SetMultiplePinsConfig(PORT_Type *base, uint32_t mask,
+        const port_pin_config_t *config)
+{
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                if (mask & (1u << pin)) {
+                        PORT_SetPinConfig(base, pin, config);
+                }
+        }
+}
+
+void PORT_SetPinMux(PORT_Type *base, uint32_t pin, port_mux_t mux)
+{
+        write_pcr(base, pin, (base->PCR[pin] & ~PORT_PCR_MUX_MASK) |
+                PORT_PCR_MUX(mux));
+        sim_gpio_update(port_of(base));
+}
+
+void PORT_SetPinInterruptConfig(PORT_Type *base, uint32_t pin,
+        port_interrupt_t config)
+{
+        write_pcr(base, pin, (base->PCR[pin] & ~PORT_PCR_IRQC_MASK) |
+                PORT_PCR_IRQC(config));
+        check_levels(port_of(base), 1u << pin);
+}
+
+void PORT_ClearPinsInterruptFlags(PORT_Type *base, uint32_t mask)
+{
+        base->ISFR &= ~mask;
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                if (mask & (1u << pin)) {
+                        base->PCR[pin] &= ~PORT_PCR_ISF_MASK;
+                }
+        }
+        check_levels(port_of(base), mask);
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,182 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_PORT_H
+#define FSL_PORT_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_port.h
+ * \defgroup   host-port Host PORT driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The pin control registers are written like on the target. The interrupt
+ * flags are set by the pin model when the level of a pin changes, and they
+ * are cleared by writing one, like on the target.
+ *
+ * @{
+ */
+
+/// Internal pull resistor selection
+enum _port_pull {
+        kPORT_PullDisable = 0U,
+        kPORT_PullDown = 2U,
+        kPORT_PullUp = 3U
+};
+
+/// Slew rate selection
+enum _port_slew_rate {
+        kPORT_FastSlewRate = 0U,
+        kPORT_SlowSlewRate = 1U
+};
+
+/// Passive filter selection
+enum _port_passive_filter_enable {
+        kPORT_PassiveFilterDisable = 0U,
+        kPORT_PassiveFilterEnable = 1U
+};
+
+/// Drive strength selection
+enum _port_drive_strength {
+        kPORT_LowDriveStrength = 0U,
+        kPORT_HighDriveStrength = 1U
+};
+
+/// Pin mux selection
+typedef enum _port_mux {
+        kPORT_PinDisabledOrAnalog = 0U,
+        kPORT_MuxAsGpio = 1U,
+        kPORT_MuxAlt2 = 2U,
+        kPORT_MuxAlt3 = 3U,
+        kPORT_MuxAlt4 = 4U,
+        kPORT_MuxAlt5 = 5U,
+        kPORT_MuxAlt6 = 6U,
+        kPORT_MuxAlt7 = 7U
+} port_mux_t;
+
+/// Pin interrupt configuration
+typedef enum _port_interrupt {
+        kPORT_InterruptOrDMADisabled = 0x0U,
+        kPORT_DMARisingEdge = 0x1U,
+        kPORT_DMAFallingEdge = 0x2U,
+        kPORT_DMAEitherEdge = 0x3U,
+        kPORT_InterruptLogicZero = 0x8U,
+        kPORT_InterruptRisingEdge = 0x9U,
+        kPORT_InterruptFallingEdge = 0xAU,
+        kPORT_InterruptEitherEdge = 0xBU,
+        kPORT_InterruptLogicOne = 0xCU
+} port_interrupt_t;
+
+/// Pin configuration, laid out as the lower half of the PCR
+typedef struct _port_pin_config {
+        uint16_t pullSelect : 2;
+        uint16_t slewRate : 1;
+        uint16_t : 1;
+        uint16_t passiveFilterEnable : 1;
+        uint16_t : 1;
+        uint16_t driveStrength : 1;
+        uint16_t : 1;
+        uint16_t mux : 3;
+        uint16_t : 5;
+} port_pin_config_t;
+
+/**
+ * \brief Configures a pin
+ *
+ * Writes the lower half of the PCR, keeping the interrupt configuration.
+ *
+ * \param[in] base PORT instance
+ * \param[in] pin Pin number
+ * \param[in] config Pin configuration
+ */
+void PORT_SetPinConfig(PORT_Type *base, uint32_t pin,
+        const port_pin_config_t *config);
+
+/**
+ * \brief Configures several pins
+ *
+ * \param[in] base PORT instance
+ * \param[in] mask Pins to configure
+ * \param[in] config Pin configuration
+ */
+void PORT_SetMultiplePinsConfig(PORT_Type *base, uint32_t mask,
+        const port_pin_config_t *config);
+
+/**
+ * \brief Selects the mux of a pin
+ *
+ * \param[in] base PORT instance
+ * \param[in] pin Pin number
+ * \param[in] mux Mux selection
+ */
+void PORT_SetPinMux(PORT_Type *base, uint32_t pin, port_mux_t mux);
+
+/**
+ * \brief Configures the interrupt of a pin
+ *
+ * Like on the target, the read-modify-write of the PCR clears a pending
+ * interrupt flag of the pin.
+ *
+ * \param[in] base PORT instance
+ * \param[in] pin Pin number
+ * \param[in] config Interrupt configuration
+ */
+void PORT_SetPinInterruptConfig(PORT_Type *base, uint32_t pin,
+        port_interrupt_t config);
+
+/**
+ * \brief Gets the interrupt flags of a port
+ *
+ * \param[in] base PORT instance
+ *
+ * \return Interrupt flags, one bit per pin
+ */
+static inline uint32_t PORT_GetPinsInterruptFlags(PORT_Type *base)
+{
+        return base->ISFR;
+}
+
+/**
+ * \brief Clears interrupt flags of a port
+ *
+ * \param[in] base PORT instance
+ * \param[in] mask Flags to clear
+ */
+void PORT_ClearPinsInterruptFlags(PORT_Type *base, uint32_t mask);
+
+/** @} */
+
+#endif // ifndef FSL_PORT_H
+
+/* EOF */
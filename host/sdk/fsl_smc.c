@@ -0,0 +1,110 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_smc.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_smc.c
+ * \defgroup   host-smc-implementation Host SMC driver implementation
+ * \ingroup    host-smc
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Stop mode selection of VLPS
+#define STOPM_VLPS 2u
+/// Stop mode selection of LLS
+#define STOPM_LLS 3u
+
+/// Interrupt mask saved before a low-power mode
+static uint32_t saved_primask;
+
+/**
+ * \brief Enters a stop mode
+ *
+ * \param[in] base SMC instance
+ * \param[in] stopm Stop mode selection
+ * \param[in] mode Simulated power mode
+ *
+ * \return Status of the operation
+ */
+static status_t enter_stop(SMC_Type *base, uint32_t stopm, sim_mode_t mode)
+{
+        base->PMCTRL = (uint8_t)((base->PMCTRL & ~SMC_PMCTRL_STOPM_MASK) |
+                SMC_PMCTRL_STOPM(stopm));
+        sim_sleep(mode);
+
+        return kStatus_Success;
+}
+
+void SMC_PreEnterStopModes(void)
+{
+        saved_primask = DisableGlobalIRQ();
+}
+
+void SMC_PostExitStopModes(void)
+{
+        EnableGlobalIRQ(saved_primask);
+}
+
+void SMC_PreEnterWaitModes(void)
+{
+        saved_primask = DisableGlobalIRQ();
+}
+
+void SMC_PostExitWaitModes(void)
+{
+        EnableGlobalIRQ(saved_primask);
+}
+
+status_t SMC_SetPowerModeWait(SMC_Type *base)
+{
+        (void)base;
+        sim_sleep(SIM_MODE_WAIT);
+
+        return kStatus_Success;
+}
+
+status_t SMC_SetPowerModeVlps(SMC_Type *base)
+{
+        return enter_stop(base, STOPM_VLPS, SIM_MODE_VLPS);
+}
+
+status_t SMC_SetPowerModeLls(SMC_Type *base)
+{
+        return enter_stop(base, STOPM_LLS, SIM_MODE_LLS);
+}
+
+/** @} */
+
+/* EOF */
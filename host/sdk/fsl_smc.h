@@ -0,0 +1,111 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_SMC_H
+#define FSL_SMC_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_smc.h
+ * \defgroup   host-smc Host SMC driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The power mode functions sleep in the simulated time until an enabled
+ * interrupt is pending, like WFI on the target.
+ *
+ * @{
+ */
+
+/// Allowed power modes
+typedef enum _smc_power_mode_protection {
+        kSMC_AllowPowerModeVlls = SMC_PMPROT_AVLLS_MASK,
+        kSMC_AllowPowerModeLls = SMC_PMPROT_ALLS_MASK,
+        kSMC_AllowPowerModeVlp = SMC_PMPROT_AVLP_MASK,
+        kSMC_AllowPowerModeAll = SMC_PMPROT_AVLLS_MASK |
+                SMC_PMPROT_ALLS_MASK | SMC_PMPROT_AVLP_MASK
+} smc_power_mode_protection_t;
+
+/**
+ * \brief Sets the allowed power modes
+ *
+ * \param[in] base SMC instance
+ * \param[in] allowedModes Allowed modes, as smc_power_mode_protection_t
+ */
+static inline void SMC_SetPowerModeProtection(SMC_Type *base,
+        uint8_t allowedModes)
+{
+        base->PMPROT = allowedModes;
+}
+
+/// \brief Prepares for a stop mode by masking the interrupts
+void SMC_PreEnterStopModes(void);
+/// \brief Restores the interrupt mask after a stop mode
+void SMC_PostExitStopModes(void);
+/// \brief Prepares for a wait mode by masking the interrupts
+void SMC_PreEnterWaitModes(void);
+/// \brief Restores the interrupt mask after a wait mode
+void SMC_PostExitWaitModes(void);
+
+/**
+ * \brief Enters the wait mode
+ *
+ * \param[in] base SMC instance
+ *
+ * \return Status of the operation
+ */
+status_t SMC_SetPowerModeWait(SMC_Type *base);
+
+/**
+ * \brief Enters the very low power stop mode
+ *
+ * \param[in] base SMC instance
+ *
+ * \return Status of the operation
+ */
+status_t SMC_SetPowerModeVlps(SMC_Type *base);
+
+/**
+ * \brief Enters the low leakage stop mode
+ *
+ * \param[in] base SMC instance
+ *
+ * \return Status of the operation
+ */
+status_t SMC_SetPowerModeLls(SMC_Type *base);
+
+/** @} */
+
+#endif // ifndef FSL_SMC_H
+
+/* EOF */
@@ -0,0 +1,323 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "fsl_tpm.h"
+#include "sim_model.h"
+
+/**
+ * \file       fsl_tpm.c
+ * \defgroup   host-tpm-implementation Host TPM driver implementation
+ * \ingroup    host-tpm
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Number of the TPM instances
+#define TPMS 3u
+/// Interrupt of TPM0, the others follow
+#define TPM0_IRQ 17
+/// Distance between the TPM instances
+#define TPM_STRIDE (TPM1_BASE - TPM0_BASE)
+
+/// Counter state of a TPM
+typedef struct {
+        /// Overflow event
+        sim_event_t event;
+        /// Instance
+        TPM_Type *base;
+        /// True while the counter runs
+        bool running;
+        /// Clock time of the counter value 0 in the current period
+        sim_time_t origin;
+        /// Length of a counter tick
+        sim_time_t tick;
+        /// Modulo value of the current period
+        uint32_t modulo;
+} tpm_model_t;
+
+/// Counter states
+static tpm_model_t tpm[TPMS];
+
+/**
+ * \brief Gets the counter state of a TPM instance
+ *
+ * \param[in] base TPM instance
+ *
+ * \return Counter state
+ */
+static inline tpm_model_t *model_of(TPM_Type const *base)
+{
+        return &tpm[((uintptr_t)base - TPM0_BASE) / TPM_STRIDE];
+}
+
+/**
+ * \brief Gets the length of the current counter period
+ *
+ * \param[in] model Counter state
+ *
+ * \return Period in clock time
+ */
+static inline sim_time_t period_of(tpm_model_t const *model)
+{
+        return ((sim_time_t)model->modulo + 1u) * model->tick;
+}
+
+/**
+ * \brief Schedules the next overflow
+ *
+ * \param[in] model Counter state
+ */
+static void schedule(tpm_model_t *model)
+{
+        if (!model->running || (sim_mode() == SIM_MODE_LLS)) {
+                sim_cancel(&model->event);
+                return;
+        }
+        sim_schedule(&model->event, sim_now() + (model->origin +
+                period_of(model) - sim_clock_time()));
+}
+
+/**
+ * \brief Brings the counter up to the current time
+ *
+ * \param[in] model Counter state
+ */
+static void update(tpm_model_t *model)
+{
+        TPM_Type * const base = model->base;
+        sim_time_t const clock = sim_clock_time();
+        bool overflow = false;
+
+        if (!model->running) {
+                return;
+        }
+
+        while (clock >= model->origin + period_of(model)) {
+                model->origin += period_of(model);
+                // The buffered modulo takes effect at the overflow.
+                model->modulo = base->MOD & TPM_MOD_MOD_MASK;
+                overflow = true;
+        }
+        base->CNT = (uint32_t)((clock - model->origin) / model->tick);
+
+        if (overflow) {
+                base->STATUS |= TPM_STATUS_TOF_MASK;
+                base->SC |= TPM_SC_TOF_MASK;
+                schedule(model);
+                sim_irq_raise(TPM0_IRQ + (int)(model - tpm));
+        }
+}
+
+/**
+ * \brief Handles the overflow event
+ *
+ * \param[in] event Overflow event
+ */
+static void overflow_event(sim_event_t *event)
+{
+        tpm_model_t * const model = (tpm_model_t *)((char *)event -
+                offsetof(tpm_model_t, event));
+
+        update(model);
+        schedule(model);
+}
+
+/**
+ * \brief Gets the interrupt level of a TPM
+ *
+ * \param[in] index TPM index
+ *
+ * \return True, if the overflow interrupt is asserted
+ */
+static bool irq_level(uint32_t index)
+{
+        TPM_Type const * const base = tpm[index].base;
+
+        return (base->SC & TPM_SC_TOIE_MASK) &&
+                (base->STATUS & TPM_STATUS_TOF_MASK);
+}
+
+/// \brief Level source of the TPM0 interrupt \return Interrupt level
+static bool tpm0_level(void)
+{
+        return irq_level(0u);
+}
+
+/// \brief Level source of the TPM1 interrupt \return Interrupt level
+static bool tpm1_level(void)
+{
+        return irq_level(1u);
+}
+
+/// \brief Level source of the TPM2 interrupt \return Interrupt level
+static bool tpm2_level(void)
+{
+        return irq_level(2u);
+}
+
+/// \brief Brings the counters up to the current time
+static void tpm_sync(void)
+{
+        for (uint32_t i = 0u; i < TPMS; ++i) {
+                update(&tpm[i]);
+        }
+}
+
+/**
+ * \brief Stops and restarts the counting around LLS
+ *
+ * \param[in] from Previous power mode
+ * \param[in] to New power mode
+ */
+static void tpm_power(sim_mode_t from, sim_mode_t to)
+{
+        if ((from == SIM_MODE_LLS) || (to == SIM_MODE_LLS)) {
+                for (uint32_t i = 0u; i < TPMS; ++i) {
+                        schedule(&tpm[i]);
+                }
+        }
+}
+
+/// TPM model
+static const sim_peripheral_t tpm_peripheral = {
+        .sync = tpm_sync,
+        .power = tpm_power
+};
+
+void sim_tpm_model_init(void)
+{
+        static const sim_irq_level_t levels[TPMS] = {
+                tpm0_level, tpm1_level, tpm2_level
+        };
+
+        for (uint32_t i = 0u; i < TPMS; ++i) {
+                tpm[i].event.handler = overflow_event;
+                tpm[i].event.next = NULL;
+                tpm[i].event.scheduled = false;
+                tpm[i].base = (TPM_Type *)(TPM0_BASE + i * TPM_STRIDE);
+                tpm[i].running = false;
+                tpm[i].origin = 0u;
+                tpm[i].tick = SIM_S / SIM_MCGIRCLK_FREQUENCY;
+                tpm[i].modulo = 0xFFFFu;
+                tpm[i].base->MOD = 0xFFFFu;
+                sim_irq_set_level(TPM0_IRQ + (int)i, levels[i]);
+        }
+        sim_add_peripheral(&tpm_peripheral);
+}
+
+void TPM_Init(TPM_Type *base, const tpm_config_t *config)
+{
+        tpm_model_t * const model = model_of(base);
+
+        TPM_StopTimer(base);
+        base->SC = TPM_SC_PS(config->prescale);
+        base->CONF = TPM_CONF_DOZEEN(config->enableDoze) |
+                TPM_CONF_DBGMODE(config->enableDebugMode ? 3u : 0u) |
+                TPM_CONF_CROT(config->enableReloadOnTrigger) |
+                TPM_CONF_CSOO(config->enableStopOnOverflow) |
+                TPM_CONF_CSOT(config->enableStartOnTrigger) |
+                TPM_CONF_TRGSEL(config->triggerSelect);
+        base->CNT = 0u;
+        base->STATUS = 0u;
+        model->tick = (SIM_S << config->prescale) / SIM_MCGIRCLK_FREQUENCY;
+}
+
+void TPM_GetDefaultConfig(tpm_config_t *config)
+{
+        config->prescale = kTPM_Prescale_Divide_1;
+        config->triggerSelect = kTPM_Trigger_Select_0;
+        config->enableDoze = false;
+        config->enableDebugMode = false;
+        config->enableReloadOnTrigger = false;
+        config->enableStopOnOverflow = false;
+        config->enableStartOnTrigger = false;
+}
+
+void TPM_SetTimerPeriod(TPM_Type *base, uint32_t ticks)
+{
+        tpm_model_t * const model = model_of(base);
+
+        base->MOD = ticks & TPM_MOD_MOD_MASK;
+        if (!model->running) {
+                model->modulo = base->MOD;
+        }
+}
+
+void TPM_EnableInterrupts(TPM_Type *base, uint32_t mask)
+{
+        if (mask & kTPM_TimeOverflowInterruptEnable) {
+                base->SC |= TPM_SC_TOIE_MASK;
+                sim_irq_raise(TPM0_IRQ + (int)(model_of(base) - tpm));
+        }
+}
+
+void TPM_DisableInterrupts(TPM_Type *base, uint32_t mask)
+{
+        if (mask & kTPM_TimeOverflowInterruptEnable) {
+                base->SC &= ~TPM_SC_TOIE_MASK;
+        }
+}
+
+void TPM_ClearStatusFlags(TPM_Type *base, uint32_t mask)
+{
+        base->STATUS &= ~mask;
+        if (mask & kTPM_TimeOverflowFlag) {
+                base->SC &= ~TPM_SC_TOF_MASK;
+        }
+}
+
+void TPM_StartTimer(TPM_Type *base, tpm_clock_source_t clockSource)
+{
+        tpm_model_t * const model = model_of(base);
+
+        if (model->running) {
+                return;
+        }
+        base->SC = (base->SC & ~TPM_SC_CMOD_MASK) | TPM_SC_CMOD(clockSource);
+        model->running = true;
+        model->origin = sim_clock_time() - (sim_time_t)base->CNT * model->tick;
+        schedule(model);
+}
+
+void TPM_StopTimer(TPM_Type *base)
+{
+        tpm_model_t * const model = model_of(base);
+
+        update(model);
+        base->SC &= ~TPM_SC_CMOD_MASK;
+        model->running = false;
+        schedule(model);
+}
+
+/** @} */
+
+/* EOF */
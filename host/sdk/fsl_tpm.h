@@ -0,0 +1,181 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FSL_TPM_H
+#define FSL_TPM_H
+
+#include "fsl_common.h"
+
+/**
+ * \file       fsl_tpm.h
+ * \defgroup   host-tpm Host TPM driver
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The counters run from the 8 MHz MCGIRCLK, which is stopped in LLS. Only
+ * the timer overflow is simulated, the channels are not.
+ *
+ * @{
+ */
+
+/// Clock source of the counter
+typedef enum _tpm_clock_source {
+        kTPM_SystemClock = 1U,
+        kTPM_ExternalClock
+} tpm_clock_source_t;
+
+/// Prescaler of the counter clock
+typedef enum _tpm_clock_prescale {
+        kTPM_Prescale_Divide_1 = 0U,
+        kTPM_Prescale_Divide_2,
+        kTPM_Prescale_Divide_4,
+        kTPM_Prescale_Divide_8,
+        kTPM_Prescale_Divide_16,
+        kTPM_Prescale_Divide_32,
+        kTPM_Prescale_Divide_64,
+        kTPM_Prescale_Divide_128
+} tpm_clock_prescale_t;
+
+/// Trigger selection
+typedef enum _tpm_trigger_select {
+        kTPM_Trigger_Select_0 = 0U
+} tpm_trigger_select_t;
+
+/// Counter configuration
+typedef struct _tpm_config {
+        /// Clock prescaler
+        tpm_clock_prescale_t prescale;
+        /// Trigger of the counter
+        tpm_trigger_select_t triggerSelect;
+        /// True to pause the counter in doze modes
+        bool enableDoze;
+        /// True to keep counting in debug mode
+        bool enableDebugMode;
+        /// True to reload the counter on trigger
+        bool enableReloadOnTrigger;
+        /// True to stop the counter on overflow
+        bool enableStopOnOverflow;
+        /// True to start the counter on trigger
+        bool enableStartOnTrigger;
+} tpm_config_t;
+
+/// Interrupts
+typedef enum _tpm_interrupt_enable {
+        kTPM_TimeOverflowInterruptEnable = (1U << 8)
+} tpm_interrupt_enable_t;
+
+/// Status flags
+typedef enum _tpm_status_flags {
+        kTPM_TimeOverflowFlag = (1U << 8)
+} tpm_status_flags_t;
+
+/**
+ * \brief Initializes a TPM
+ *
+ * \param[in] base TPM instance
+ * \param[in] config Counter configuration
+ */
+void TPM_Init(TPM_Type *base, const tpm_config_t *config);
+
+/**
+ * \brief Gets the default counter configuration
+ *
+ * \param[out] config Counter configuration
+ */
+void TPM_GetDefaultConfig(tpm_config_t *config);
+
+/**
+ * \brief Sets the counter period
+ *
+ * While the counter runs, the period takes effect at the next overflow.
+ *
+ * \param[in] base TPM instance
+ * \param[in] ticks Modulo value, the period minus one
+ */
+void TPM_SetTimerPeriod(TPM_Type *base, uint32_t ticks);
+
+/**
+ * \brief Enables interrupts
+ *
+ * \param[in] base TPM instance
+ * \param[in] mask Interrupts, as tpm_interrupt_enable_t
+ */
+void TPM_EnableInterrupts(TPM_Type *base, uint32_t mask);
+
+/**
+ * \brief Disables interrupts
+ *
+ * \param[in] base TPM instance
+ * \param[in] mask Interrupts, as tpm_interrupt_enable_t
+ */
+void TPM_DisableInterrupts(TPM_Type *base, uint32_t mask);
+
+/**
+ * \brief Gets the status flags
+ *
+ * \param[in] base TPM instance
+ *
+ * \return Status flags, as tpm_status_flags_t
+ */
+static inline uint32_t TPM_GetStatusFlags(TPM_Type *base)
+{
+        return base->STATUS;
+}
+
+/**
+ * \brief Clears status flags
+ *
+ * \param[in] base TPM instance
+ * \param[in] mask Status flags, as tpm_status_flags_t
+ */
+void TPM_ClearStatusFlags(TPM_Type *base, uint32_t mask);
+
+/**
+ * \brief Starts the counter
+ *
+ * \param[in] base TPM instance
+ * \param[in] clockSource Clock source
+ */
+void TPM_StartTimer(TPM_Type *base, tpm_clock_source_t clockSource);
+
+/**
+ * \brief Stops the counter
+ *
+ * \param[in] base TPM instance
+ */
+void TPM_StopTimer(TPM_Type *base);
+
+/** @} */
+
+#endif // ifndef FSL_TPM_H
+
+/* EOF */
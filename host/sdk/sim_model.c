@@ -0,0 +1,92 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "sim_model.h"
+#include "fsl_common.h"
+
+/**
+ * \file       sim_model.c
+ * \defgroup   sim-model-implementation Peripheral model implementation
+ * \ingroup    sim-model
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/**
+ * \brief Checks if an address is within a register block
+ *
+ * \param[in] address Address
+ * \param[in] base Base address of the block
+ * \param[in] size Size of the block
+ *
+ * \return True, if within the block
+ */
+static inline bool within(uintptr_t address, uintptr_t base, size_t size)
+{
+        return (address >= base) && (address < base + size);
+}
+
+void sim_model_init(void)
+{
+        sim_gpio_model_init();
+        sim_port_model_init();
+        sim_llwu_model_init();
+        sim_tpm_model_init();
+        sim_lptmr_model_init();
+        sim_dma_model_init();
+        sim_adc_model_init();
+        sim_cmp_model_init();
+        sim_lpuart_model_init();
+        sim_cop_model_init();
+}
+
+void sim_bus_read(uintptr_t address)
+{
+        if (within(address, ADC0_BASE, sizeof(ADC_Type))) {
+                sim_adc_read(address);
+        } else if (address == (uintptr_t)&LPUART0->DATA) {
+                sim_lpuart_read();
+        }
+}
+
+void sim_bus_write(uintptr_t address)
+{
+        if (within(address, ADC0_BASE, sizeof(ADC_Type))) {
+                sim_adc_write(address);
+        } else if (address == (uintptr_t)&LPUART0->DATA) {
+                sim_lpuart_write();
+        }
+}
+
+/** @} */
+
+/* EOF */
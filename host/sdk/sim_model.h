@@ -0,0 +1,284 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SIM_MODEL_H
+#define SIM_MODEL_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \file       sim_model.h
+ * \defgroup   sim-model Peripheral models
+ * \ingroup    host-sdk
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * The peripheral models live in the host drivers of their modules. This
+ * header connects the models to each other, and to the stimuli of the
+ * simulation: the external pin levels, the analog inputs and the received
+ * serial data.
+ *
+ * @{
+ */
+
+/// Pin ports
+typedef enum {
+        SIM_PORT_A,
+        SIM_PORT_B,
+        SIM_PORT_C,
+        SIM_PORT_D,
+        SIM_PORT_E,
+        /// Number of the ports
+        SIM_PORTS
+} sim_port_t;
+
+/// DMAMUX request source of ADC0
+#define SIM_DMA_SOURCE_ADC0 40u
+/// DMAMUX request source of the LPUART0 receiver
+#define SIM_DMA_SOURCE_LPUART0_RX 2u
+/// DMAMUX request source of the LPUART0 transmitter
+#define SIM_DMA_SOURCE_LPUART0_TX 3u
+
+/// LLWU internal module of the low-power timer
+#define SIM_LLWU_MODULE_LPTMR 0u
+/// LLWU internal module of the comparator
+#define SIM_LLWU_MODULE_CMP 1u
+
+/// Full scale of the analog inputs
+#define SIM_ANALOG_FULL_SCALE 0xFFFFu
+
+/**
+ * \brief Pin output callback
+ *
+ * \param[in] port Port
+ * \param[in] changed Pins whose output level changed
+ * \param[in] levels Output levels of the port
+ */
+typedef void (*sim_pin_output_t)(sim_port_t port, uint32_t changed,
+        uint32_t levels);
+
+/**
+ * \brief Transmitted byte callback
+ *
+ * \param[in] byte Byte which left the transmitter
+ */
+typedef void (*sim_serial_output_t)(uint8_t byte);
+
+/**
+ * \brief Resets the peripheral models and registers them to the simulation
+ *
+ * Must be called after sim_init().
+ */
+void sim_model_init(void);
+
+/**
+ * \brief Drives a pin from the outside
+ *
+ * Pins not driven from the outside read as their pull resistor selects.
+ *
+ * \param[in] port Port
+ * \param[in] pin Pin number
+ * \param[in] level Driven level
+ */
+void sim_pin_drive(sim_port_t port, uint32_t pin, bool level);
+
+/**
+ * \brief Gets the level of a pin
+ *
+ * \param[in] port Port
+ * \param[in] pin Pin number
+ *
+ * \return Pin level
+ */
+bool sim_pin_level(sim_port_t port, uint32_t pin);
+
+/**
+ * \brief Sets the pin output callback
+ *
+ * \param[in] output Callback, or NULL
+ */
+void sim_pin_set_output(sim_pin_output_t output);
+
+/**
+ * \brief Sets the voltage of an ADC0 input channel
+ *
+ * \param[in] channel ADC channel
+ * \param[in] value Voltage relative to SIM_ANALOG_FULL_SCALE
+ */
+void sim_adc_set_input(uint32_t channel, uint16_t value);
+
+/**
+ * \brief Sets the voltage of a CMP0 input
+ *
+ * \param[in] input Comparator input
+ * \param[in] value Voltage relative to SIM_ANALOG_FULL_SCALE
+ */
+void sim_cmp_set_input(uint32_t input, uint16_t value);
+
+/**
+ * \brief Receives bytes on the serial port
+ *
+ * The bytes arrive back to back after the bytes already queued.
+ *
+ * \param[in] data Bytes
+ * \param[in] length Number of bytes
+ */
+void sim_serial_receive(uint8_t const *data, size_t length);
+
+/**
+ * \brief Sets the transmitted byte callback
+ *
+ * \param[in] output Callback, or NULL
+ */
+void sim_serial_set_output(sim_serial_output_t output);
+
+// The rest are used between the models.
+
+/// \brief Resets the pin model
+void sim_gpio_model_init(void);
+/// \brief Resets the PORT model
+void sim_port_model_init(void);
+/// \brief Resets the LLWU model
+void sim_llwu_model_init(void);
+/// \brief Resets the TPM model
+void sim_tpm_model_init(void);
+/// \brief Resets the LPTMR model
+void sim_lptmr_model_init(void);
+/// \brief Resets the DMA model
+void sim_dma_model_init(void);
+/// \brief Resets the ADC model
+void sim_adc_model_init(void);
+/// \brief Resets the CMP model
+void sim_cmp_model_init(void);
+/// \brief Resets the LPUART model
+void sim_lpuart_model_init(void);
+/// \brief Resets the COP model
+void sim_cop_model_init(void);
+
+/**
+ * \brief Updates the pin levels of a port after a pin configuration change
+ *
+ * \param[in] port Port
+ */
+void sim_gpio_update(sim_port_t port);
+
+/**
+ * \brief Notifies the PORT model of changed pin levels
+ *
+ * \param[in] port Port
+ * \param[in] previous Previous levels
+ * \param[in] levels New levels
+ */
+void sim_port_pins_changed(sim_port_t port, uint32_t previous,
+        uint32_t levels);
+
+/**
+ * \brief Notifies the LLWU model of changed pin levels
+ *
+ * \param[in] port Port
+ * \param[in] previous Previous levels
+ * \param[in] levels New levels
+ */
+void sim_llwu_pins_changed(sim_port_t port, uint32_t previous,
+        uint32_t levels);
+
+/**
+ * \brief Sets or clears the wake-up flag of an LLWU internal module
+ *
+ * A set flag wakes the core from LLS, if enabled in the LLWU.
+ *
+ * \param[in] module Internal module
+ * \param[in] flag Flag state
+ */
+void sim_llwu_module_flag(uint32_t module, bool flag);
+
+/**
+ * \brief DMA request state of a peripheral
+ *
+ * \return True, while the peripheral requests transfers
+ */
+typedef bool (*sim_dma_request_t)(void);
+
+/**
+ * \brief Registers the DMA request state of a peripheral
+ *
+ * \param[in] source DMAMUX request source
+ * \param[in] request Request state
+ */
+void sim_dma_set_request(uint32_t source, sim_dma_request_t request);
+
+/**
+ * \brief Serves the DMA requests of a peripheral
+ *
+ * Called when the peripheral asserts its request. The channel of the source
+ * transfers while the request stays asserted, or until the channel stops.
+ *
+ * \param[in] source DMAMUX request source
+ */
+void sim_dma_request(uint32_t source);
+
+/**
+ * \brief Notifies a DMA read of a peripheral register
+ *
+ * Called before the read.
+ *
+ * \param[in] address Register address
+ */
+void sim_bus_read(uintptr_t address);
+
+/**
+ * \brief Notifies a DMA write of a peripheral register
+ *
+ * Called after the write.
+ *
+ * \param[in] address Register address
+ */
+void sim_bus_write(uintptr_t address);
+
+/// \brief Notifies the ADC model of a read of a result register
+/// \param[in] address Register address
+void sim_adc_read(uintptr_t address);
+/// \brief Notifies the ADC model of a write of a channel register
+/// \param[in] address Register address
+void sim_adc_write(uintptr_t address);
+/// \brief Notifies the LPUART model of a read of the data register
+void sim_lpuart_read(void);
+/// \brief Notifies the LPUART model of a write of the data register
+void sim_lpuart_write(void);
+
+/** @} */
+
+#endif // ifndef SIM_MODEL_H
+
+/* EOF */
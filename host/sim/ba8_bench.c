@@ -0,0 +1,129 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+#include "journal.h"
+#include "alarm_loop_io.h"
+#include "button_io.h"
+#include "flash_io.h"
+#include "sim.h"
+#include "sim_model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * \file       ba8_bench.c
+ * \defgroup   ba8-bench Host benchmark runner
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Runs the benchmark suite of \ref bench against the simulated peripherals,
+ * timed with the monotonic clock in nanoseconds:
+ *
+ *     ba8_bench [-r runs]
+ *
+ * The result lines have the same format as on the target, with "host" as
+ * the clock configuration. The host figures show the relative costs of the
+ * cases and catch regressions, but they include the register model of the
+ * simulation and say nothing about the target cycle counts.
+ *
+ * @{
+ */
+
+/**
+ * \brief Reads the monotonic clock
+ *
+ * \return Nanoseconds, wrapping around every 4.3 seconds
+ */
+static uint32_t clock_read(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return (uint32_t)((uint64_t)now.tv_sec * 1000000000u +
+                (uint64_t)now.tv_nsec);
+}
+
+/**
+ * \brief Prints a result line without the carriage return
+ *
+ * \param[in] text Zero terminated text
+ */
+static void write_line(char const *text)
+{
+        for (; *text; ++text) {
+                if (*text != '\r') {
+                        putchar(*text);
+                }
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        bench_timer_t const timer = { clock_read, 0xFFFFFFFFu, 1000000000u };
+        uint32_t runs = 1u;
+        int option;
+
+        while ((option = getopt(argc, argv, "r:")) != -1) {
+                switch (option) {
+                case 'r':
+                        runs = (uint32_t)strtoul(optarg, NULL, 0);
+                        break;
+                default:
+                        fprintf(stderr, "usage: %s [-r runs]\n", argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+
+        sim_init();
+        sim_model_init();
+        (void)alarm_loop_io_init();
+        (void)button_io_init();
+        if ((flash_io_init() != MDV_RESULT_OK) ||
+                (journal_init() != MDV_RESULT_OK)) {
+                fprintf(stderr, "flash initialization failed\n");
+                return EXIT_FAILURE;
+        }
+
+        for (uint32_t run = 0u; run < runs; ++run) {
+                bench_run(&timer, "host", true, write_line);
+        }
+
+        return EXIT_SUCCESS;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,252 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "sim.h"
+#include "sim_model.h"
+#include "waveform.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * \file       ba8_sim.c
+ * \defgroup   ba8-sim Host simulation runner
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Runs the firmware against a scenario script:
+ *
+ *     ba8_sim [-d seconds] [-o file] [-f file] [-t] scenario
+ *
+ * -d sets the simulated duration (the end step of the scenario, or 10 s by
+ * default). -o writes the transmitted serial data into a file. -f loads the
+ * flash contents from a file at the start, and saves them back at the end,
+ * so that the configuration and the journal survive between the runs. -t
+ * prints the changes of the output pins to stdout. The exit status is
+ * nonzero if an expect step of the scenario failed.
+ *
+ * @{
+ */
+
+/// Default simulated duration
+#define DEFAULT_DURATION (10u * SIM_S)
+
+/// Entry point of the firmware, the main() of src/main.c
+void ba8_main(void);
+
+/// Transmitted serial data, or NULL
+static FILE *tx_file;
+
+/**
+ * \brief Writes a transmitted byte
+ *
+ * \param[in] byte Transmitted byte
+ */
+static void tx_output(uint8_t byte)
+{
+        fputc(byte, tx_file);
+}
+
+/**
+ * \brief Prints the changes of the output pins
+ *
+ * \param[in] port Port
+ * \param[in] changed Changed pins
+ * \param[in] levels New levels of the port
+ */
+static void trace_output(sim_port_t port, uint32_t changed, uint32_t levels)
+{
+        double const seconds = (double)sim_now() / (double)SIM_S;
+
+        for (uint32_t pin = 0u; pin < 32u; ++pin) {
+                if (changed & (1u << pin)) {
+                        printf("%.6f P%c%u %u\n", seconds, 'A' + port, pin,
+                                (levels >> pin) & 1u);
+                }
+        }
+}
+
+/**
+ * \brief Loads or saves the flash contents
+ *
+ * A missing file leaves the flash erased on load.
+ *
+ * \param[in] path File
+ * \param[in] save True to save, false to load
+ *
+ * \return True, if successful
+ */
+static bool flash_image(char const *path, bool save)
+{
+        uint8_t * const flash = sim_flash();
+        FILE * const file = fopen(path, save ? "wb" : "rb");
+        bool success;
+
+        if (!file) {
+                return !save;
+        }
+        if (save) {
+                success = fwrite(flash, 1u, SIM_FLASH_SIZE, file) ==
+                        SIM_FLASH_SIZE;
+        } else {
+                success = fread(flash, 1u, SIM_FLASH_SIZE, file) ==
+                        SIM_FLASH_SIZE;
+        }
+        fclose(file);
+
+        return success;
+}
+
+/**
+ * \brief Gets the wall clock time
+ *
+ * \return Monotonic time in seconds
+ */
+static double wall_time(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+/**
+ * \brief Prints the usage
+ *
+ * \param[in] name Program name
+ */
+static void usage(char const *name)
+{
+        fprintf(stderr, "usage: %s [-d seconds] [-o file] [-f file] [-t] "
+                "scenario\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+        sim_time_t duration = 0u;
+        char const *flash_path = NULL;
+        bool trace = false;
+        FILE *scenario;
+        double start;
+        double wall;
+        double simulated;
+        uint32_t failures;
+        int option;
+
+        while ((option = getopt(argc, argv, "d:o:f:t")) != -1) {
+                switch (option) {
+                case 'd':
+                        duration = (sim_time_t)(strtod(optarg, NULL) *
+                                (double)SIM_S);
+                        break;
+                case 'o':
+                        tx_file = fopen(optarg, "wb");
+                        if (!tx_file) {
+                                perror(optarg);
+                                return EXIT_FAILURE;
+                        }
+                        break;
+                case 'f':
+                        flash_path = optarg;
+                        break;
+                case 't':
+                        trace = true;
+                        break;
+                default:
+                        usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+        if (optind != (argc - 1)) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        scenario = fopen(argv[optind], "r");
+        if (!scenario) {
+                perror(argv[optind]);
+                return EXIT_FAILURE;
+        }
+        if (!waveform_load(scenario, argv[optind])) {
+                fclose(scenario);
+                return EXIT_FAILURE;
+        }
+        fclose(scenario);
+        if (!duration) {
+                duration = waveform_end() ? waveform_end() : DEFAULT_DURATION;
+        }
+
+        sim_init();
+        sim_model_init();
+        if (flash_path && !flash_image(flash_path, false)) {
+                fprintf(stderr, "%s: invalid flash image\n", flash_path);
+                return EXIT_FAILURE;
+        }
+        if (tx_file) {
+                sim_serial_set_output(tx_output);
+        }
+        if (trace) {
+                sim_pin_set_output(trace_output);
+        }
+        waveform_start();
+
+        start = wall_time();
+        sim_run(ba8_main, duration);
+        wall = wall_time() - start;
+        simulated = (double)sim_now() / (double)SIM_S;
+
+        if (flash_path && !flash_image(flash_path, true)) {
+                perror(flash_path);
+        }
+        if (tx_file) {
+                fclose(tx_file);
+        }
+        failures = waveform_failures();
+        waveform_free();
+
+        fprintf(stderr, "simulated %.3f s in %.3f s wall (%.0f simulated-s "
+                "per wall-s), %llu interrupts\n", simulated, wall,
+                (wall > 0.0) ? (simulated / wall) : 0.0,
+                (unsigned long long)sim_irq_count());
+        if (failures) {
+                fprintf(stderr, "%u failed expectations\n", failures);
+                return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+}
+
+/** @} */
+
+/* EOF */
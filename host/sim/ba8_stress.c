@@ -0,0 +1,733 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "alarm_core.h"
+#include "input_debounce.h"
+#include "alarm_loop_io.h"
+#include "button_io.h"
+#include "sim.h"
+#include "sim_model.h"
+#include "fsl_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * \file       ba8_stress.c
+ * \defgroup   ba8-stress Randomized input stress test
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Drives the real alarm loop and button drivers through the simulated GPIO
+ * and port blocks with randomized and adversarial waveforms, and checks the
+ * edge queue, the loop snapshots, the debouncer and the alarm state machine
+ * against simple reference models after every sample:
+ *
+ *     ba8_stress [-n samples] [-s seed]
+ *
+ * The samples are generated in blocks of one scenario:
+ *
+ * - random: every signal flips with a probability of 1/8 per sample
+ * - chatter: a group of signals toggles on every sample
+ * - burst: a signal toggles several times within one interrupt latency
+ * - cut: a group of loops opens and closes at once
+ * - pulse: pulses of one sample shorter than, or equal to, the debounce
+ *   threshold
+ *
+ * The edge queue is drained at random, so that it also overflows. The
+ * thresholds, the entry delay and the arming change at random too.
+ *
+ * The simulated time does not advance, so all the edges get the same
+ * timestamp. The run stops at the first mismatch. At the end, the rate of
+ * the processed pin transitions per second is printed.
+ *
+ * @{
+ */
+
+/// Default number of samples
+#define DEFAULT_SAMPLES 1000000u
+/// Number of signals in the input word
+#define SIGNALS 24u
+/// Mask of all the signals in the input word
+#define SIGNAL_MASK ((1u << SIGNALS) - 1u)
+/// Number of loop signals, with the edge interrupts
+#define LOOP_SIGNALS 16u
+/// Shortest scenario block in samples
+#define BLOCK_MINIMUM 32u
+/// Random part of the scenario block length
+#define BLOCK_MASK 1023u
+
+/// Scenarios
+typedef enum {
+        SCENARIO_RANDOM,
+        SCENARIO_CHATTER,
+        SCENARIO_BURST,
+        SCENARIO_CUT,
+        SCENARIO_PULSE,
+        SCENARIOS
+} scenario_t;
+
+/// Pin of a signal
+typedef struct {
+        /// Port
+        sim_port_t port;
+        /// Pin
+        uint32_t pin;
+} signal_pin_t;
+
+/// Reference model of the input drivers and the application logic
+typedef struct {
+        /// Pin levels in the input word order
+        uint32_t level;
+        /// Pending edge interrupt flags by the edge position
+        uint32_t flags;
+        /// Expected edges
+        alarm_loop_edge_t queue[ALARM_LOOP_EDGE_QUEUE_LENGTH];
+        /// Expected edges in the queue
+        uint32_t queued;
+        /// Index of the oldest expected edge
+        uint32_t oldest;
+        /// Expected lost edges
+        uint32_t lost;
+        /// Debounced states
+        uint32_t debounced;
+        /// Debounce thresholds
+        uint32_t threshold[SIGNALS];
+        /// Debounce counters
+        uint32_t count[SIGNALS];
+        /// Armed loops
+        bool armed[BA8_MAXIMUM_LOOPS];
+        /// Loops in the entry delay
+        bool entry[BA8_MAXIMUM_LOOPS];
+        /// Loops with the alarm latched
+        bool latched[BA8_MAXIMUM_LOOPS];
+        /// Loops with the tamper alarm latched
+        bool tamper[BA8_MAXIMUM_LOOPS];
+        /// Loops using the entry delay
+        bool delayed[BA8_MAXIMUM_LOOPS];
+        /// Entry delay in steps
+        uint32_t entry_delay;
+        /// Remaining entry delay in steps
+        uint32_t entry_remaining;
+} reference_t;
+
+/// Pins in the input word order: alarms, shield alarms and buttons
+static const signal_pin_t signal_pins[SIGNALS] = {
+        { SIM_PORT_C, 5u }, { SIM_PORT_C, 7u }, { SIM_PORT_C, 9u },
+        { SIM_PORT_C, 11u }, { SIM_PORT_D, 1u }, { SIM_PORT_D, 3u },
+        { SIM_PORT_D, 5u }, { SIM_PORT_D, 7u },
+        { SIM_PORT_C, 4u }, { SIM_PORT_C, 6u }, { SIM_PORT_C, 8u },
+        { SIM_PORT_C, 10u }, { SIM_PORT_D, 0u }, { SIM_PORT_D, 2u },
+        { SIM_PORT_D, 4u }, { SIM_PORT_D, 6u },
+        { SIM_PORT_C, 3u }, { SIM_PORT_C, 1u }, { SIM_PORT_B, 19u },
+        { SIM_PORT_B, 17u }, { SIM_PORT_B, 3u }, { SIM_PORT_B, 1u },
+        { SIM_PORT_A, 19u }, { SIM_PORT_A, 13u }
+};
+
+/// Names of the scenarios
+static char const * const scenario_names[SCENARIOS] = {
+        "random", "chatter", "burst", "cut", "pulse"
+};
+
+/// Reference model
+static reference_t ref;
+/// Debouncer under test
+static input_debounce_t debounce;
+/// Alarm state machine under test
+static alarm_core_t core;
+/// State of the random number generator
+static uint64_t random_state;
+/// True while the edge interrupts are held back
+static bool masked;
+/// Current scenario
+static scenario_t scenario;
+/// Current sample
+static uint32_t sample;
+/// Processed pin transitions
+static uint64_t transitions;
+/// Edges taken from the edge queue
+static uint64_t edges;
+
+/**
+ * \brief Gets a random number (xorshift64*)
+ *
+ * \return Random 32-bit number
+ */
+static uint32_t random_next(void)
+{
+        random_state ^= random_state >> 12u;
+        random_state ^= random_state << 25u;
+        random_state ^= random_state >> 27u;
+
+        return (uint32_t)((random_state * 2685821657736338717ull) >> 32u);
+}
+
+/**
+ * \brief Gets a random number below a limit
+ *
+ * \param[in] limit Limit
+ *
+ * \return Random number 0...limit - 1
+ */
+static uint32_t random_below(uint32_t limit)
+{
+        return (uint32_t)(((uint64_t)random_next() * limit) >> 32u);
+}
+
+/**
+ * \brief Reports a mismatch and exits
+ *
+ * \param[in] what Mismatching value
+ * \param[in] expected Expected value
+ * \param[in] actual Actual value
+ */
+static void fail(char const *what, uint32_t expected, uint32_t actual)
+{
+        fprintf(stderr, "stress: sample %u (%s): %s expected 0x%X, got "
+                "0x%X\n", sample, scenario_names[scenario], what, expected,
+                actual);
+        exit(EXIT_FAILURE);
+}
+
+/**
+ * \brief Gets the edge position of a loop signal
+ *
+ * \param[in] signal Signal in the input word
+ *
+ * \return Position, even for the shield alarm and odd for the alarm signals
+ */
+static uint32_t edge_position(uint32_t signal)
+{
+        return (signal < BA8_MAXIMUM_LOOPS) ? ((signal << 1u) | 1u) :
+                ((signal - BA8_MAXIMUM_LOOPS) << 1u);
+}
+
+/**
+ * \brief Serves the pending edge flags like the port interrupt handler
+ */
+static void reference_serve(void)
+{
+        while (ref.flags) {
+                uint32_t position = 0u;
+                uint32_t signal;
+                alarm_loop_edge_t *edge;
+
+                while (!((ref.flags >> position) & 1u)) {
+                        ++position;
+                }
+                ref.flags &= ~(1u << position);
+
+                if (ref.queued == ALARM_LOOP_EDGE_QUEUE_LENGTH) {
+                        ++ref.lost;
+                        continue;
+                }
+                signal = (position & 1u) ? (position >> 1u) :
+                        ((position >> 1u) + BA8_MAXIMUM_LOOPS);
+                edge = &ref.queue[(ref.oldest + ref.queued) %
+                        ALARM_LOOP_EDGE_QUEUE_LENGTH];
+                edge->loop = (uint8_t)(position >> 1u);
+                edge->signal = (uint8_t)(position & 1u);
+                edge->level = (uint8_t)((ref.level >> signal) & 1u);
+                ++ref.queued;
+        }
+}
+
+/**
+ * \brief Sets the level of a signal
+ *
+ * \param[in] signal Signal in the input word
+ * \param[in] level New level
+ */
+static void set_signal(uint32_t signal, bool level)
+{
+        uint32_t const bit = 1u << signal;
+
+        if (((ref.level & bit) != 0u) == level) {
+                return;
+        }
+        ref.level ^= bit;
+        ++transitions;
+        if (signal < LOOP_SIGNALS) {
+                ref.flags |= 1u << edge_position(signal);
+        }
+
+        sim_pin_drive(signal_pins[signal].port, signal_pins[signal].pin,
+                level);
+        if (!masked) {
+                reference_serve();
+        }
+}
+
+/**
+ * \brief Sets the levels of a group of signals
+ *
+ * \param[in] mask Signals to set
+ * \param[in] levels New levels
+ */
+static void set_signals(uint32_t mask, uint32_t levels)
+{
+        for (uint32_t signal = 0u; mask; ++signal, mask >>= 1u) {
+                if (mask & 1u) {
+                        set_signal(signal, (levels >> signal) & 1u);
+                }
+        }
+}
+
+/**
+ * \brief Holds back the edge interrupts, like a long interrupt latency
+ */
+static void begin_burst(void)
+{
+        masked = true;
+        __disable_irq();
+}
+
+/**
+ * \brief Lets the held back edge interrupts to be served
+ */
+static void end_burst(void)
+{
+        masked = false;
+        __enable_irq();
+        reference_serve();
+}
+
+/**
+ * \brief Takes the edges from the edge queue and checks them
+ *
+ * \param[in] count Maximum number of edges to take
+ */
+static void drain(uint32_t count)
+{
+        bool const all = (count == UINT32_MAX);
+        alarm_loop_edge_t edge;
+
+        while (count-- && alarm_loop_io_get_edge(&edge)) {
+                alarm_loop_edge_t const *expected = &ref.queue[ref.oldest];
+                uint32_t const actual = ((uint32_t)edge.loop << 16u) |
+                        ((uint32_t)edge.signal << 8u) | edge.level;
+
+                if (!ref.queued) {
+                        fail("unexpected edge", 0u, actual);
+                }
+                if ((expected->loop != edge.loop) ||
+                        (expected->signal != edge.signal) ||
+                        (expected->level != edge.level)) {
+                        fail("edge (loop, signal, level)",
+                                ((uint32_t)expected->loop << 16u) |
+                                ((uint32_t)expected->signal << 8u) |
+                                expected->level, actual);
+                }
+                ref.oldest = (ref.oldest + 1u) % ALARM_LOOP_EDGE_QUEUE_LENGTH;
+                --ref.queued;
+                ++edges;
+        }
+        if (all && ref.queued) {
+                fail("queued edges", ref.queued, 0u);
+        }
+        if (alarm_loop_io_get_lost_edges() != ref.lost) {
+                fail("lost edges", ref.lost, alarm_loop_io_get_lost_edges());
+        }
+}
+
+/**
+ * \brief Sets the debounce threshold of a signal
+ *
+ * \param[in] signal Signal in the input word
+ * \param[in] samples Threshold
+ */
+static void set_threshold(uint32_t signal, uint32_t samples)
+{
+        input_debounce_set_threshold(&debounce, 1u << signal, samples);
+        ref.threshold[signal] = samples;
+        ref.count[signal] = 0u;
+}
+
+/**
+ * \brief Steps the reference debouncer
+ *
+ * \param[in] input Raw signal states
+ *
+ * \return Signals whose debounced state changed
+ */
+static uint32_t reference_debounce(uint32_t input)
+{
+        uint32_t changed = 0u;
+
+        for (uint32_t signal = 0u; signal < SIGNALS; ++signal) {
+                uint32_t const bit = 1u << signal;
+
+                if ((input & bit) == (ref.debounced & bit)) {
+                        ref.count[signal] = 0u;
+                } else if (++ref.count[signal] == ref.threshold[signal]) {
+                        ref.count[signal] = 0u;
+                        changed |= bit;
+                }
+        }
+        ref.debounced ^= changed;
+
+        return changed;
+}
+
+/**
+ * \brief Steps the reference alarm logic
+ *
+ * \param[in] alarm Alarm signals
+ * \param[in] shield Shield alarm signals
+ *
+ * \return Relay state
+ */
+static bool reference_alarm(uint8_t alarm, uint8_t shield)
+{
+        bool triggered[BA8_MAXIMUM_LOOPS];
+        bool was_idle = true;
+        bool now_in_entry = false;
+        bool relay = false;
+        uint32_t loop;
+
+        for (loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                triggered[loop] = ((alarm >> loop) & 1u) && ref.armed[loop] &&
+                        !ref.latched[loop];
+                if (ref.entry[loop]) {
+                        was_idle = false;
+                }
+                if (triggered[loop] && ref.delayed[loop]) {
+                        ref.entry[loop] = true;
+                }
+                if (ref.entry[loop]) {
+                        now_in_entry = true;
+                }
+        }
+
+        if (was_idle && now_in_entry) {
+                ref.entry_remaining = ref.entry_delay;
+        } else if (ref.entry_remaining) {
+                --ref.entry_remaining;
+        }
+
+        for (loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if (triggered[loop] && !ref.delayed[loop]) {
+                        ref.latched[loop] = true;
+                }
+                if (ref.entry[loop] && !ref.entry_remaining) {
+                        ref.latched[loop] = true;
+                        ref.entry[loop] = false;
+                }
+                if ((shield >> loop) & 1u) {
+                        ref.tamper[loop] = true;
+                }
+                relay = relay || ref.latched[loop] || ref.tamper[loop];
+        }
+
+        return relay;
+}
+
+/**
+ * \brief Packs reference loop flags into a bitmap
+ *
+ * \param[in] flags Flags of the loops
+ *
+ * \return Bitmap, bit n for loop n + 1
+ */
+static uint32_t loops_of(bool const *flags)
+{
+        uint32_t bitmap = 0u;
+
+        for (uint32_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                bitmap |= (uint32_t)flags[loop] << loop;
+        }
+
+        return bitmap;
+}
+
+/**
+ * \brief Arms or disarms random loops now and then
+ */
+static void random_arming(void)
+{
+        uint32_t const action = random_next();
+        uint8_t const loops = (uint8_t)(action >> 8u);
+
+        if ((action & 0xFFu) == 0u) {
+                alarm_core_arm(&core, loops);
+                for (uint32_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                        ref.armed[loop] |= (loops >> loop) & 1u;
+                }
+        } else if ((action & 0xFFu) == 1u) {
+                alarm_core_disarm(&core, loops);
+                for (uint32_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                        if ((loops >> loop) & 1u) {
+                                ref.armed[loop] = false;
+                                ref.entry[loop] = false;
+                                ref.latched[loop] = false;
+                                ref.tamper[loop] = false;
+                        }
+                }
+        }
+}
+
+/**
+ * \brief Processes one sample through the application logic and checks it
+ */
+static void check_sample(void)
+{
+        alarm_loop_io_snapshot_t const snapshot = alarm_loop_io_snapshot();
+        uint32_t const input = input_debounce_pack(snapshot.alarm,
+                snapshot.shield, button_io_snapshot());
+        uint32_t const changed = input_debounce_step(&debounce, input);
+        uint32_t const expected_changed = reference_debounce(ref.level);
+        alarm_core_input_t core_input;
+        bool relay;
+        bool expected_relay;
+
+        if (input != ref.level) {
+                fail("input snapshot", ref.level, input);
+        }
+        if (changed != expected_changed) {
+                fail("debounce changes", expected_changed, changed);
+        }
+        if (debounce.state != ref.debounced) {
+                fail("debounced state", ref.debounced, debounce.state);
+        }
+
+        random_arming();
+        core_input.alarm = (uint8_t)(debounce.state >>
+                INPUT_DEBOUNCE_ALARM_SHIFT);
+        core_input.shield = (uint8_t)(debounce.state >>
+                INPUT_DEBOUNCE_SHIELD_SHIFT);
+        core_input.fault = 0u;
+        relay = alarm_core_step(&core, &core_input, 1u);
+        expected_relay = reference_alarm(core_input.alarm, core_input.shield);
+
+        if (relay != expected_relay) {
+                fail("relay", expected_relay, relay);
+        }
+        if (core.armed != loops_of(ref.armed)) {
+                fail("armed", loops_of(ref.armed), core.armed);
+        }
+        if (core.entry != loops_of(ref.entry)) {
+                fail("entry", loops_of(ref.entry), core.entry);
+        }
+        if (core.latched != loops_of(ref.latched)) {
+                fail("latched", loops_of(ref.latched), core.latched);
+        }
+        if (core.tamper != loops_of(ref.tamper)) {
+                fail("tamper", loops_of(ref.tamper), core.tamper);
+        }
+        if (core.entry_remaining != ref.entry_remaining) {
+                fail("entry delay", ref.entry_remaining, core.entry_remaining);
+        }
+
+        // Drain now and then only partially or not at all, so that the edge
+        // queue also fills up and overflows.
+        switch (random_next() & 7u) {
+        case 0u:
+                break;
+        case 1u:
+                drain(random_below(8u));
+                break;
+        default:
+                drain(UINT32_MAX);
+                break;
+        }
+        ++sample;
+}
+
+/**
+ * \brief Starts a new scenario block with new random settings
+ */
+static void configure_block(void)
+{
+        uint8_t delayed = (uint8_t)random_next();
+
+        for (uint32_t signal = 0u; signal < SIGNALS; ++signal) {
+                set_threshold(signal, 1u + random_below(
+                        INPUT_DEBOUNCE_MAXIMUM_THRESHOLD));
+        }
+
+        // The entry delay can change only when no loop is in the delay.
+        if (!core.entry) {
+                uint16_t const steps = (uint16_t)random_below(16u);
+
+                alarm_core_set_entry_delay(&core, delayed, steps);
+                ref.entry_delay = steps;
+                for (uint32_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                        ref.delayed[loop] = (delayed >> loop) & 1u;
+                }
+        }
+}
+
+/**
+ * \brief Runs a block of a scenario
+ *
+ * \param[in] length Block length in samples
+ * \param[in] end Last sample to run
+ */
+static void run_block(uint32_t length, uint32_t end)
+{
+        uint32_t group = random_next() & SIGNAL_MASK;
+
+        scenario = (scenario_t)random_below(SCENARIOS);
+        configure_block();
+
+        while (length-- && (sample < end)) {
+                switch (scenario) {
+                case SCENARIO_RANDOM:
+                        set_signals(random_next() & random_next() &
+                                random_next() & SIGNAL_MASK, ~ref.level);
+                        break;
+                case SCENARIO_CHATTER:
+                        set_signals(group, ~ref.level);
+                        break;
+                case SCENARIO_BURST: {
+                        uint32_t const signal = random_below(LOOP_SIGNALS);
+                        uint32_t toggles = 2u + random_below(8u);
+
+                        begin_burst();
+                        while (toggles--) {
+                                set_signal(signal,
+                                        !((ref.level >> signal) & 1u));
+                        }
+                        end_burst();
+                        break;
+                }
+                case SCENARIO_CUT: {
+                        uint32_t const loops = group & 0xFFu;
+                        uint32_t const pins = loops | (loops << 8u);
+
+                        // Open and close the group at once, now and then.
+                        if (!random_below(16u)) {
+                                begin_burst();
+                                set_signals(pins, (ref.level & pins) ?
+                                        0u : pins);
+                                end_burst();
+                        }
+                        break;
+                }
+                case SCENARIO_PULSE: {
+                        uint32_t const signal = random_below(SIGNALS);
+                        uint32_t const threshold = ref.threshold[signal];
+                        uint32_t const width = threshold - random_below(2u);
+                        uint32_t i;
+
+                        // A pulse one sample shorter than the threshold must
+                        // be filtered out, one as long as the threshold not.
+                        set_signal(signal, !((ref.level >> signal) & 1u));
+                        for (i = 0u; (i < width) && (sample < end); ++i) {
+                                check_sample();
+                        }
+                        set_signal(signal, !((ref.level >> signal) & 1u));
+                        for (i = 0u; (i < threshold) && (sample < end); ++i) {
+                                check_sample();
+                        }
+                        break;
+                }
+                default:
+                        break;
+                }
+                if (sample < end) {
+                        check_sample();
+                }
+        }
+}
+
+/**
+ * \brief Gets the wall clock time
+ *
+ * \return Monotonic time in seconds
+ */
+static double wall_time(void)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+int main(int argc, char *argv[])
+{
+        uint32_t samples = DEFAULT_SAMPLES;
+        uint32_t seed = 1u;
+        double start;
+        double wall;
+        int option;
+
+        while ((option = getopt(argc, argv, "n:s:")) != -1) {
+                switch (option) {
+                case 'n':
+                        samples = (uint32_t)strtoul(optarg, NULL, 0);
+                        break;
+                case 's':
+                        seed = (uint32_t)strtoul(optarg, NULL, 0);
+                        break;
+                default:
+                        fprintf(stderr, "usage: %s [-n samples] [-s seed]\n",
+                                argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+        random_state = ((uint64_t)seed << 1u) | 1u;
+
+        sim_init();
+        sim_model_init();
+        (void)alarm_loop_io_init();
+        (void)button_io_init();
+        for (uint32_t signal = 0u; signal < SIGNALS; ++signal) {
+                sim_pin_drive(signal_pins[signal].port,
+                        signal_pins[signal].pin, false);
+        }
+        (void)alarm_loop_io_enable_edge_interrupts();
+        input_debounce_init(&debounce, 0u);
+        alarm_core_init(&core);
+        ref.entry_delay = ALARM_CORE_DEFAULT_ENTRY_DELAY;
+
+        start = wall_time();
+        while (sample < samples) {
+                run_block(BLOCK_MINIMUM + (random_next() & BLOCK_MASK),
+                        samples);
+        }
+        drain(UINT32_MAX);
+        wall = wall_time() - start;
+
+        printf("seed %u: %u samples, %llu transitions, %llu edges, %u lost, "
+                "%.3f s, %.0f transitions/s\n", seed, sample,
+                (unsigned long long)transitions, (unsigned long long)edges,
+                ref.lost, wall, (wall > 0.0) ? (transitions / wall) : 0.0);
+
+        return EXIT_SUCCESS;
+}
+
+/** @} */
+
+/* EOF */
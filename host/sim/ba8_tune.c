@@ -0,0 +1,863 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "alarm_core.h"
+#include "input_debounce.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file       ba8_tune.c
+ * \defgroup   ba8-tune Debounce parameter tuner
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Replays loop captures recorded on a site through the debouncer and the
+ * alarm state machine of the firmware with each input filter width of the
+ * loop configuration (config_loop_t filter, 1...16 samples), and ranks the
+ * widths by the missed and the nuisance alarms:
+ *
+ *     ba8_tune [-j jobs] [-n count] [-d loops] [-e steps] capture...
+ *
+ * A capture is a text file with one record per line:
+ *
+ *     <time> loops <alarm> <shield>
+ *     <time> intrusion <loops> <length>
+ *
+ * The loops record gives the raw alarm and shield alarm signals (bitmaps,
+ * bit n for loop n + 1) from its time on. The intrusion record marks a real
+ * intrusion or tamper on the loops lasting the given length, e.g. from the
+ * site log. The times and lengths are in seconds by default, or in ms or us
+ * by their suffix. Everything after # is a comment.
+ *
+ * The replay follows the alarm path of the firmware: a loop edge samples
+ * the loops and evaluates the alarm state, the loops are sampled 2 ms apart
+ * until they settle, and the entry delay counts down in 100 ms steps. All
+ * the loops are armed. The delayed loops are given with -d (bitmap, as the
+ * loop type) and their entry delay in steps with -e (300 by default, as the
+ * entry delay), the others trigger instantly.
+ *
+ * An alarm or tamper alarm of a loop counts as detected, if it latches
+ * during an intrusion of the loop or within the response time (the filter
+ * width, plus the entry delay of a delayed loop) after it. Other alarms are
+ * nuisance alarms, and intrusions without an alarm are missed alarms. A
+ * loop in alarm is rearmed once its filtered signals are back to normal.
+ *
+ * The filter widths are evaluated in parallel by -j worker processes (the
+ * number of the online cores by default). The best -n widths for all the
+ * loops and the best width of each loop are printed, ordered by the missed
+ * alarms first and the nuisance alarms second, with the console command
+ * setting the width of the loop. The input glitch filter of the port groups
+ * acts on pulses far shorter than the capture resolution, so it is not
+ * tuned.
+ *
+ * @{
+ */
+
+/// Loop sample interval of the firmware in microseconds
+#define SAMPLE_INTERVAL 2000u
+/// Entry delay step of the firmware in microseconds
+#define STEP_INTERVAL 100000u
+/// Console command field of the filter width (config_field_t in main.c)
+#define FILTER_FIELD 3u
+/// Number of the filter widths
+#define GRID_POINTS INPUT_DEBOUNCE_MAXIMUM_THRESHOLD
+/// Time of no pending event
+#define NEVER UINT64_MAX
+/// Default number of the settings printed
+#define DEFAULT_COUNT 10u
+/// Longest capture line
+#define LINE_LENGTH 256u
+/// Microseconds in a second
+#define US_PER_S 1000000ull
+
+/// Raw loop signals from a point in time on
+typedef struct {
+        /// Time in microseconds
+        uint64_t time;
+        /// Alarm signals
+        uint8_t alarm;
+        /// Shield alarm signals
+        uint8_t shield;
+} loop_record_t;
+
+/// Intrusion on one loop
+typedef struct {
+        /// Start time in microseconds
+        uint64_t start;
+        /// End time in microseconds
+        uint64_t end;
+        /// Loop index
+        uint8_t loop;
+        /// True once an alarm has been latched for the intrusion
+        bool detected;
+} intrusion_t;
+
+/// Recorded capture
+typedef struct {
+        /// Loop records in time order
+        loop_record_t *records;
+        /// Number of the loop records
+        size_t record_count;
+        /// Intrusions in start time order
+        intrusion_t *intrusions;
+        /// Number of the intrusions
+        size_t intrusion_count;
+} capture_t;
+
+/// Result of one filter width
+typedef struct {
+        /// Filter width in samples
+        uint32_t filter;
+        /// Missed alarms of each loop
+        uint32_t missed[BA8_MAXIMUM_LOOPS];
+        /// Nuisance alarms of each loop
+        uint32_t nuisance[BA8_MAXIMUM_LOOPS];
+        /// Sum of the detection delays of each loop in microseconds
+        uint64_t delay[BA8_MAXIMUM_LOOPS];
+        /// Detected intrusions of each loop
+        uint32_t detected[BA8_MAXIMUM_LOOPS];
+} result_t;
+
+/// Captures
+static capture_t *captures;
+/// Number of the captures
+static size_t capture_count;
+/// Loops using the entry delay
+static uint8_t delayed_loops;
+/// Entry delay in steps
+static uint16_t entry_delay = ALARM_CORE_DEFAULT_ENTRY_DELAY;
+
+/**
+ * \brief Parses a time
+ *
+ * \param[in] text Time with an optional unit suffix
+ * \param[out] time Time in microseconds
+ *
+ * \return True, if valid
+ */
+static bool parse_time(char const *text, uint64_t *time)
+{
+        char *suffix;
+        double const value = strtod(text, &suffix);
+        double scale;
+
+        if ((suffix == text) || (value < 0.0)) {
+                return false;
+        }
+        if (!*suffix || !strcmp(suffix, "s")) {
+                scale = (double)US_PER_S;
+        } else if (!strcmp(suffix, "ms")) {
+                scale = 1000.0;
+        } else if (!strcmp(suffix, "us")) {
+                scale = 1.0;
+        } else {
+                return false;
+        }
+        *time = (uint64_t)((value * scale) + 0.5);
+
+        return true;
+}
+
+/**
+ * \brief Parses a loop bitmap
+ *
+ * \param[in] text Bitmap
+ * \param[out] loops Bitmap
+ *
+ * \return True, if valid
+ */
+static bool parse_loops(char const *text, uint8_t *loops)
+{
+        char *rest;
+        unsigned long const value = text ? strtoul(text, &rest, 0) : 0u;
+
+        if (!text || (rest == text) || *rest || (value > 0xFFu)) {
+                return false;
+        }
+        *loops = (uint8_t)value;
+
+        return true;
+}
+
+/**
+ * \brief Appends an element to a growing array
+ *
+ * \param[in,out] array Array
+ * \param[in,out] count Number of the elements
+ * \param[in] size Size of an element
+ *
+ * \return New element, or NULL if out of memory
+ */
+static void *append(void **array, size_t *count, size_t size)
+{
+        // Double the size when full, starting from 16 elements.
+        if (!*count || ((*count >= 16u) && !(*count & (*count - 1u)))) {
+                void * const grown = realloc(*array,
+                        (*count ? (*count * 2u) : 16u) * size);
+
+                if (!grown) {
+                        return NULL;
+                }
+                *array = grown;
+        }
+
+        return (uint8_t *)*array + ((*count)++ * size);
+}
+
+/**
+ * \brief Orders the loop records by time
+ *
+ * \param[in] a First record
+ * \param[in] b Second record
+ *
+ * \return Order of the records
+ */
+static int compare_records(void const *a, void const *b)
+{
+        uint64_t const first = ((loop_record_t const *)a)->time;
+        uint64_t const second = ((loop_record_t const *)b)->time;
+
+        return (first > second) - (first < second);
+}
+
+/**
+ * \brief Orders the intrusions by start time
+ *
+ * \param[in] a First intrusion
+ * \param[in] b Second intrusion
+ *
+ * \return Order of the intrusions
+ */
+static int compare_intrusions(void const *a, void const *b)
+{
+        uint64_t const first = ((intrusion_t const *)a)->start;
+        uint64_t const second = ((intrusion_t const *)b)->start;
+
+        return (first > second) - (first < second);
+}
+
+/**
+ * \brief Loads a capture
+ *
+ * Prints the errors to stderr.
+ *
+ * \param[in] path Capture file
+ * \param[out] capture Capture
+ *
+ * \return True, if the capture was valid
+ */
+static bool load_capture(char const *path, capture_t *capture)
+{
+        FILE * const file = fopen(path, "r");
+        char line[LINE_LENGTH];
+        uint32_t number = 0u;
+        bool valid = true;
+
+        memset(capture, 0, sizeof(*capture));
+        if (!file) {
+                perror(path);
+                return false;
+        }
+
+        while (fgets(line, sizeof(line), file)) {
+                char * const comment = strchr(line, '#');
+                char const *time_text;
+                char const *kind;
+                char const *error = NULL;
+                uint64_t time;
+
+                ++number;
+                if (comment) {
+                        *comment = '\0';
+                }
+                time_text = strtok(line, " \t\r\n");
+                if (!time_text) {
+                        continue;
+                }
+                kind = strtok(NULL, " \t\r\n");
+
+                if (!parse_time(time_text, &time)) {
+                        error = "invalid time";
+                } else if (kind && !strcmp(kind, "loops")) {
+                        loop_record_t record = { .time = time };
+                        loop_record_t *added;
+
+                        if (!parse_loops(strtok(NULL, " \t\r\n"),
+                                &record.alarm) ||
+                                !parse_loops(strtok(NULL, " \t\r\n"),
+                                &record.shield)) {
+                                error = "invalid loops";
+                        } else if (!(added = append(
+                                (void **)&capture->records,
+                                &capture->record_count,
+                                sizeof(loop_record_t)))) {
+                                error = "out of memory";
+                        } else {
+                                *added = record;
+                        }
+                } else if (kind && !strcmp(kind, "intrusion")) {
+                        uint8_t loops;
+                        uint64_t length;
+                        char const *length_text;
+
+                        if (!parse_loops(strtok(NULL, " \t\r\n"), &loops)) {
+                                error = "invalid loops";
+                        } else if (!(length_text = strtok(NULL,
+                                " \t\r\n")) || !parse_time(length_text,
+                                &length)) {
+                                error = "invalid length";
+                        }
+                        for (uint8_t loop = 0u; !error &&
+                                (loop < BA8_MAXIMUM_LOOPS); ++loop) {
+                                intrusion_t *added;
+
+                                if (!((loops >> loop) & 1u)) {
+                                        continue;
+                                }
+                                added = append((void **)&capture->intrusions,
+                                        &capture->intrusion_count,
+                                        sizeof(intrusion_t));
+                                if (!added) {
+                                        error = "out of memory";
+                                        break;
+                                }
+                                added->start = time;
+                                added->end = time + length;
+                                added->loop = loop;
+                                added->detected = false;
+                        }
+                } else {
+                        error = "unknown record";
+                }
+
+                if (error) {
+                        fprintf(stderr, "%s:%u: %s\n", path, number, error);
+                        valid = false;
+                }
+        }
+        fclose(file);
+
+        if (valid && !capture->record_count) {
+                fprintf(stderr, "%s: no loop records\n", path);
+                valid = false;
+        }
+        if (valid) {
+                qsort(capture->records, capture->record_count,
+                        sizeof(loop_record_t), compare_records);
+                qsort(capture->intrusions, capture->intrusion_count,
+                        sizeof(intrusion_t), compare_intrusions);
+        }
+
+        return valid;
+}
+
+/**
+ * \brief Gets the response time of a loop
+ *
+ * \param[in] filter Filter width in samples
+ * \param[in] loop Loop index
+ *
+ * \return Response time in microseconds
+ */
+static uint64_t response_time(uint32_t filter, uint8_t loop)
+{
+        uint64_t response = (uint64_t)SAMPLE_INTERVAL * filter;
+
+        if ((delayed_loops >> loop) & 1u) {
+                response += (uint64_t)STEP_INTERVAL * entry_delay;
+        }
+
+        return response;
+}
+
+/**
+ * \brief Finds the intrusion an alarm belongs to
+ *
+ * \param[in,out] capture Capture
+ * \param[in] loop Loop index
+ * \param[in] time Time of the alarm
+ * \param[in] response Response time in microseconds
+ *
+ * \return Intrusion, or NULL for a nuisance alarm
+ */
+static intrusion_t *find_intrusion(capture_t *capture, uint8_t loop,
+        uint64_t time, uint64_t response)
+{
+        for (size_t i = 0u; i < capture->intrusion_count; ++i) {
+                intrusion_t * const intrusion = &capture->intrusions[i];
+
+                if (intrusion->start > time) {
+                        break;
+                }
+                if ((intrusion->loop == loop) &&
+                        (time <= (intrusion->end + response))) {
+                        return intrusion;
+                }
+        }
+
+        return NULL;
+}
+
+/// Replay state of one capture
+typedef struct {
+        /// Capture
+        capture_t *capture;
+        /// Result to add to
+        result_t *result;
+        /// Loop signal debouncer
+        input_debounce_t debounce;
+        /// Alarm state
+        alarm_core_t core;
+        /// Current raw loop signals
+        uint32_t raw;
+        /// Loops counted in alarm
+        uint8_t in_alarm;
+        /// Time of the next loop sample, or NEVER
+        uint64_t sample_time;
+        /// Time of the next entry delay step, or NEVER
+        uint64_t step_time;
+} replay_t;
+
+/**
+ * \brief Evaluates the alarm state from the debounced loop signals
+ *
+ * As evaluate() in main.c, and counts the new alarms.
+ *
+ * \param[in,out] replay Replay state
+ * \param[in] time Current time
+ * \param[in] steps Entry delay steps elapsed since the previous evaluation
+ */
+static void replay_evaluate(replay_t *replay, uint64_t time, uint16_t steps)
+{
+        alarm_core_input_t const input = {
+                .alarm = (uint8_t)(replay->debounce.state >>
+                        INPUT_DEBOUNCE_ALARM_SHIFT),
+                .shield = (uint8_t)(replay->debounce.state >>
+                        INPUT_DEBOUNCE_SHIELD_SHIFT),
+                .fault = 0u
+        };
+        result_t * const result = replay->result;
+        uint8_t alarms;
+        uint8_t quiet;
+
+        (void)alarm_core_step(&replay->core, &input, steps);
+
+        alarms = (replay->core.latched | replay->core.tamper) &
+                ~replay->in_alarm;
+        for (uint8_t loop = 0u; alarms; ++loop, alarms >>= 1u) {
+                intrusion_t *intrusion;
+
+                if (!(alarms & 1u)) {
+                        continue;
+                }
+                replay->in_alarm |= (uint8_t)(1u << loop);
+                intrusion = find_intrusion(replay->capture, loop, time,
+                        response_time(result->filter, loop));
+                if (!intrusion) {
+                        ++result->nuisance[loop];
+                } else if (!intrusion->detected) {
+                        intrusion->detected = true;
+                        ++result->detected[loop];
+                        result->delay[loop] += (time > intrusion->start) ?
+                                (time - intrusion->start) : 0u;
+                }
+        }
+
+        // Rearm the loops in alarm whose signals are back to normal.
+        quiet = replay->in_alarm & (uint8_t)~(input.alarm | input.shield);
+        if (quiet) {
+                alarm_core_disarm(&replay->core, quiet);
+                alarm_core_arm(&replay->core, quiet);
+                replay->in_alarm &= (uint8_t)~quiet;
+        }
+
+        if (replay->core.entry && (replay->step_time == NEVER)) {
+                replay->step_time = time + STEP_INTERVAL;
+        }
+}
+
+/**
+ * \brief Feeds a loop sample into the debouncer
+ *
+ * As sample_loops() in main.c.
+ *
+ * \param[in,out] replay Replay state
+ * \param[in] time Current time
+ *
+ * \return Loop signals whose debounced state changed
+ */
+static uint32_t replay_sample(replay_t *replay, uint64_t time)
+{
+        uint32_t const changed = input_debounce_step(&replay->debounce,
+                replay->raw);
+
+        if ((replay->raw != replay->debounce.state) &&
+                (replay->sample_time == NEVER)) {
+                replay->sample_time = time + SAMPLE_INTERVAL;
+        }
+
+        return changed;
+}
+
+/**
+ * \brief Replays a capture with one filter width
+ *
+ * \param[in,out] capture Capture
+ * \param[in,out] result Result to add to, with the filter width
+ */
+static void replay(capture_t *capture, result_t *result)
+{
+        loop_record_t const *record = capture->records;
+        loop_record_t const * const end = record + capture->record_count;
+        replay_t state = {
+                .capture = capture,
+                .result = result,
+                .raw = input_debounce_pack(record->alarm, record->shield, 0u),
+                .sample_time = NEVER,
+                .step_time = NEVER
+        };
+
+        for (size_t i = 0u; i < capture->intrusion_count; ++i) {
+                capture->intrusions[i].detected = false;
+        }
+
+        // As at the startup: the first sample is taken as settled.
+        input_debounce_init(&state.debounce, state.raw);
+        input_debounce_set_threshold(&state.debounce, 0xFFFFFFFFu,
+                result->filter);
+        alarm_core_init(&state.core);
+        alarm_core_set_entry_delay(&state.core, delayed_loops, entry_delay);
+        alarm_core_arm(&state.core, 0xFFu);
+        replay_evaluate(&state, record->time, 0u);
+
+        // Run the loop edges and the timers in time order, until the loops
+        // have settled and no entry delay runs after the last edge.
+        for (++record; ; ) {
+                uint64_t time = (state.sample_time < state.step_time) ?
+                        state.sample_time : state.step_time;
+
+                if ((record != end) && (record->time <= time)) {
+                        uint32_t const raw = input_debounce_pack(
+                                record->alarm, record->shield, 0u);
+
+                        time = record->time;
+                        ++record;
+                        if (raw == state.raw) {
+                                continue;
+                        }
+                        state.raw = raw;
+                        (void)replay_sample(&state, time);
+                        replay_evaluate(&state, time, 0u);
+                } else if (time == NEVER) {
+                        break;
+                } else if (time == state.sample_time) {
+                        state.sample_time = NEVER;
+                        if (replay_sample(&state, time)) {
+                                replay_evaluate(&state, time, 0u);
+                        }
+                } else {
+                        state.step_time = NEVER;
+                        replay_evaluate(&state, time, 1u);
+                }
+        }
+
+        for (size_t i = 0u; i < capture->intrusion_count; ++i) {
+                if (!capture->intrusions[i].detected) {
+                        ++result->missed[capture->intrusions[i].loop];
+                }
+        }
+}
+
+/**
+ * \brief Evaluates a filter width over all the captures
+ *
+ * \param[in] point Grid point
+ * \param[out] result Result
+ */
+static void evaluate(uint32_t point, result_t *result)
+{
+        memset(result, 0, sizeof(*result));
+        result->filter = 1u + point;
+
+        for (size_t i = 0u; i < capture_count; ++i) {
+                replay(&captures[i], result);
+        }
+}
+
+/**
+ * \brief Runs a worker process
+ *
+ * Evaluates every jobs'th grid point from the first one, and writes the
+ * results into the pipe.
+ *
+ * \param[in] first First grid point
+ * \param[in] jobs Number of the workers
+ * \param[in] output Write end of the result pipe
+ */
+static void worker(uint32_t first, uint32_t jobs, int output)
+{
+        for (uint32_t point = first; point < GRID_POINTS; point += jobs) {
+                result_t result;
+
+                evaluate(point, &result);
+                if (write(output, &result, sizeof(result)) !=
+                        (ssize_t)sizeof(result)) {
+                        _exit(EXIT_FAILURE);
+                }
+        }
+        _exit(EXIT_SUCCESS);
+}
+
+/**
+ * \brief Sums the alarms of the loops
+ *
+ * \param[in] counts Counts of each loop
+ * \param[in] loops Loops to sum
+ *
+ * \return Sum
+ */
+static uint32_t sum_loops(uint32_t const *counts, uint8_t loops)
+{
+        uint32_t sum = 0u;
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if ((loops >> loop) & 1u) {
+                        sum += counts[loop];
+                }
+        }
+
+        return sum;
+}
+
+/// Loops ranked by compare_results()
+static uint8_t ranked_loops;
+
+/**
+ * \brief Ranks the results
+ *
+ * Fewer missed alarms first, then fewer nuisance alarms, then the narrower
+ * filter.
+ *
+ * \param[in] a First result
+ * \param[in] b Second result
+ *
+ * \return Order of the results
+ */
+static int compare_results(void const *a, void const *b)
+{
+        result_t const *first = a;
+        result_t const *second = b;
+        uint32_t const missed[2] = {
+                sum_loops(first->missed, ranked_loops),
+                sum_loops(second->missed, ranked_loops)
+        };
+        uint32_t const nuisance[2] = {
+                sum_loops(first->nuisance, ranked_loops),
+                sum_loops(second->nuisance, ranked_loops)
+        };
+        if (missed[0] != missed[1]) {
+                return (missed[0] > missed[1]) ? 1 : -1;
+        }
+        if (nuisance[0] != nuisance[1]) {
+                return (nuisance[0] > nuisance[1]) ? 1 : -1;
+        }
+
+        return (first->filter > second->filter) -
+                (first->filter < second->filter);
+}
+
+/**
+ * \brief Prints a ranked setting
+ *
+ * The response is the filter response time and the delay the mean
+ * detection delay, both in milliseconds. The command sets the filter width
+ * of a single loop.
+ *
+ * \param[in] label Rank or loop
+ * \param[in] result Result
+ * \param[in] loops Loops of the counts
+ */
+static void print_result(char const *label, result_t const *result,
+        uint8_t loops)
+{
+        char command[24] = "";
+
+        uint64_t delay = 0u;
+        uint32_t const detected = sum_loops(result->detected, loops);
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if ((loops >> loop) & 1u) {
+                        delay += result->delay[loop];
+                }
+        }
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if (loops == (uint8_t)(1u << loop)) {
+                        snprintf(command, sizeof(command), "config %u %u %u",
+                                FILTER_FIELD, loop, result->filter);
+                }
+        }
+
+        printf("%-6s %6u %9.1f %7u %9u %9.1f  %s\n", label, result->filter,
+                (SAMPLE_INTERVAL * result->filter) / 1000.0,
+                sum_loops(result->missed, loops),
+                sum_loops(result->nuisance, loops),
+                detected ? ((double)delay / detected / 1000.0) : 0.0,
+                command);
+}
+
+int main(int argc, char *argv[])
+{
+        static result_t results[GRID_POINTS];
+        long const cores = sysconf(_SC_NPROCESSORS_ONLN);
+        uint32_t jobs = (cores > 0) ? (uint32_t)cores : 1u;
+        uint32_t count = DEFAULT_COUNT;
+        size_t received = 0u;
+        int pipe_ends[2];
+        int option;
+        bool failed = false;
+
+        while ((option = getopt(argc, argv, "j:n:d:e:")) != -1) {
+                switch (option) {
+                case 'd':
+                        delayed_loops = (uint8_t)strtoul(optarg, NULL, 0);
+                        break;
+                case 'e':
+                        entry_delay = (uint16_t)strtoul(optarg, NULL, 0);
+                        break;
+                case 'j':
+                        jobs = (uint32_t)strtoul(optarg, NULL, 0);
+                        break;
+                case 'n':
+                        count = (uint32_t)strtoul(optarg, NULL, 0);
+                        break;
+                default:
+                        optind = argc;
+                        break;
+                }
+        }
+        if ((optind >= argc) || !jobs) {
+                fprintf(stderr, "usage: %s [-j jobs] [-n count] [-d loops] "
+                        "[-e steps] capture...\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+        if (jobs > GRID_POINTS) {
+                jobs = GRID_POINTS;
+        }
+
+        capture_count = (size_t)(argc - optind);
+        captures = calloc(capture_count, sizeof(capture_t));
+        if (!captures) {
+                return EXIT_FAILURE;
+        }
+        for (size_t i = 0u; i < capture_count; ++i) {
+                if (!load_capture(argv[optind + (int)i], &captures[i])) {
+                        return EXIT_FAILURE;
+                }
+        }
+
+        // The workers inherit the loaded captures, and each of them has its
+        // own copy of the intrusion state.
+        if (pipe(pipe_ends)) {
+                perror("pipe");
+                return EXIT_FAILURE;
+        }
+        for (uint32_t i = 0u; i < jobs; ++i) {
+                pid_t const pid = fork();
+
+                if (pid < 0) {
+                        perror("fork");
+                        return EXIT_FAILURE;
+                }
+                if (!pid) {
+                        close(pipe_ends[0]);
+                        worker(i, jobs, pipe_ends[1]);
+                }
+        }
+        close(pipe_ends[1]);
+
+        while (received < GRID_POINTS) {
+                ssize_t const length = read(pipe_ends[0], &results[received],
+                        sizeof(result_t));
+
+                if (length != (ssize_t)sizeof(result_t)) {
+                        break;
+                }
+                ++received;
+        }
+        close(pipe_ends[0]);
+        for (uint32_t i = 0u; i < jobs; ++i) {
+                int status;
+
+                if ((wait(&status) < 0) || !WIFEXITED(status) ||
+                        (WEXITSTATUS(status) != EXIT_SUCCESS)) {
+                        failed = true;
+                }
+        }
+        if (failed || (received != GRID_POINTS)) {
+                fprintf(stderr, "%s: a worker failed\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        printf("%-6s %6s %9s %7s %9s %9s  %s\n", "rank", "filter",
+                "response", "missed", "nuisance", "delay", "command");
+        ranked_loops = 0xFFu;
+        qsort(results, GRID_POINTS, sizeof(result_t), compare_results);
+        for (uint32_t i = 0u; (i < count) && (i < GRID_POINTS); ++i) {
+                char label[8];
+
+                snprintf(label, sizeof(label), "%u", i + 1u);
+                print_result(label, &results[i], ranked_loops);
+        }
+
+        printf("\n%-6s %6s %9s %7s %9s %9s  %s\n", "loop", "filter",
+                "response", "missed", "nuisance", "delay", "command");
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                char label[8];
+
+                ranked_loops = (uint8_t)(1u << loop);
+                qsort(results, GRID_POINTS, sizeof(result_t),
+                        compare_results);
+                snprintf(label, sizeof(label), "%u", loop + 1u);
+                print_result(label, &results[0], ranked_loops);
+        }
+
+        return EXIT_SUCCESS;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,468 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#define _GNU_SOURCE
+#include "sim.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/**
+ * \file       sim.c
+ * \defgroup   sim-implementation Simulation core implementation
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Maximum number of the registered peripheral models
+#define SIM_PERIPHERALS 16u
+
+/// Address range backed by RAM
+typedef struct {
+        /// Start address
+        uintptr_t start;
+        /// Size in bytes
+        size_t size;
+        /// Reset value of the bytes
+        uint8_t fill;
+} region_t;
+
+/// Address ranges of the simulated memories
+static const region_t regions[] = {
+        // AIPS and GPIO peripherals
+        { .start = 0x40000000u, .size = 0x00100000u, .fill = 0x00u },
+        // Private peripherals (MTB, MTBDWT, ROM table, MCM)
+        { .start = 0xF0000000u, .size = 0x00004000u, .fill = 0x00u },
+        // Fast GPIO
+        { .start = 0xF8000000u, .size = 0x00001000u, .fill = 0x00u },
+        // Data block of the program flash
+        { .start = SIM_FLASH_START, .size = SIM_FLASH_SIZE, .fill = 0xFFu }
+};
+
+/// Number of the simulated memories
+#define REGIONS (sizeof(regions) / sizeof(regions[0]))
+
+/// Interrupt handlers provided by the firmware or the host drivers
+extern void DMA0_IRQHandler(void) __attribute__((weak));
+extern void DMA1_IRQHandler(void) __attribute__((weak));
+extern void DMA2_IRQHandler(void) __attribute__((weak));
+extern void DMA3_IRQHandler(void) __attribute__((weak));
+extern void FTFA_IRQHandler(void) __attribute__((weak));
+extern void PMC_IRQHandler(void) __attribute__((weak));
+extern void LLWU_IRQHandler(void) __attribute__((weak));
+extern void LPUART0_IRQHandler(void) __attribute__((weak));
+extern void LPUART1_IRQHandler(void) __attribute__((weak));
+extern void ADC0_IRQHandler(void) __attribute__((weak));
+extern void CMP0_IRQHandler(void) __attribute__((weak));
+extern void TPM0_IRQHandler(void) __attribute__((weak));
+extern void TPM1_IRQHandler(void) __attribute__((weak));
+extern void TPM2_IRQHandler(void) __attribute__((weak));
+extern void RTC_IRQHandler(void) __attribute__((weak));
+extern void PIT_IRQHandler(void) __attribute__((weak));
+extern void LPTMR0_IRQHandler(void) __attribute__((weak));
+extern void PORTA_IRQHandler(void) __attribute__((weak));
+extern void PORTC_PORTD_IRQHandler(void) __attribute__((weak));
+
+/// Vector table of the device specific interrupts
+static void (* const vector[SIM_IRQS])(void) = {
+        [0] = DMA0_IRQHandler,
+        [1] = DMA1_IRQHandler,
+        [2] = DMA2_IRQHandler,
+        [3] = DMA3_IRQHandler,
+        [5] = FTFA_IRQHandler,
+        [6] = PMC_IRQHandler,
+        [7] = LLWU_IRQHandler,
+        [12] = LPUART0_IRQHandler,
+        [13] = LPUART1_IRQHandler,
+        [15] = ADC0_IRQHandler,
+        [16] = CMP0_IRQHandler,
+        [17] = TPM0_IRQHandler,
+        [18] = TPM1_IRQHandler,
+        [19] = TPM2_IRQHandler,
+        [20] = RTC_IRQHandler,
+        [22] = PIT_IRQHandler,
+        [28] = LPTMR0_IRQHandler,
+        [30] = PORTA_IRQHandler,
+        [31] = PORTC_PORTD_IRQHandler
+};
+
+/// Set when the memories have been mapped
+static bool mapped;
+/// Registered peripheral models
+static sim_peripheral_t const *peripherals[SIM_PERIPHERALS];
+/// Number of the registered peripheral models
+static uint32_t peripheral_count;
+/// Event calendar, sorted by time
+static sim_event_t *calendar;
+/// Current time
+static sim_time_t now;
+/// End time of the run
+static sim_time_t end_time;
+/// Time spent in LLS before the current sleep
+static sim_time_t lls_time;
+/// Start time of the current sleep
+static sim_time_t sleep_start;
+/// Current power mode
+static sim_mode_t mode;
+/// Return point of sim_run()
+static jmp_buf run_exit;
+/// Set while sim_run() is active
+static bool running;
+/// Pending interrupts
+static uint32_t irq_pending;
+/// Enabled interrupts
+static uint32_t irq_enabled;
+/// Interrupt priorities
+static uint8_t irq_priority[SIM_IRQS];
+/// Interrupt level sources
+static sim_irq_level_t irq_level[SIM_IRQS];
+/// Interrupt mask
+static uint32_t primask;
+/// Nesting depth of the interrupt handlers
+static uint32_t handler_depth;
+/// Number of the served interrupts
+static uint64_t irq_count;
+
+/**
+ * \brief Maps a memory range at its target address
+ *
+ * \param[in] region Address range
+ */
+static void map_region(region_t const *region)
+{
+        void *address = mmap((void *)region->start, region->size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+        if (address != (void *)region->start) {
+                fprintf(stderr, "sim: can not map 0x%08lx...0x%08lx\n",
+                        (unsigned long)region->start,
+                        (unsigned long)(region->start + region->size - 1u));
+                exit(EXIT_FAILURE);
+        }
+}
+
+/**
+ * \brief Finds the highest priority pending interrupt
+ *
+ * \param[in] mask Interrupts to consider
+ *
+ * \return Interrupt number, or -1 if none
+ */
+static int highest_pending(uint32_t mask)
+{
+        int highest = -1;
+
+        for (int irq = 0; mask; ++irq, mask >>= 1u) {
+                if ((mask & 1u) && ((highest < 0) ||
+                        (irq_priority[irq] < irq_priority[highest]))) {
+                        highest = irq;
+                }
+        }
+
+        return highest;
+}
+
+/**
+ * \brief Serves the pending interrupts
+ *
+ * Nested interrupts are not simulated: the handlers run to the end one at a
+ * time, in priority order.
+ */
+static void dispatch(void)
+{
+        int irq;
+
+        if (primask || handler_depth || (mode != SIM_MODE_RUN)) {
+                return;
+        }
+
+        ++handler_depth;
+        while ((irq = highest_pending(irq_pending & irq_enabled)) >= 0) {
+                irq_pending &= ~(1u << irq);
+                ++irq_count;
+                if (vector[irq]) {
+                        vector[irq]();
+                }
+                if (irq_level[irq] && irq_level[irq]()) {
+                        irq_pending |= 1u << irq;
+                }
+        }
+        --handler_depth;
+}
+
+/**
+ * \brief Changes the power mode
+ *
+ * \param[in] to New power mode
+ */
+static void set_mode(sim_mode_t to)
+{
+        sim_mode_t const from = mode;
+
+        if (from == to) {
+                return;
+        }
+        if (from == SIM_MODE_LLS) {
+                lls_time += now - sleep_start;
+        }
+        sleep_start = now;
+        mode = to;
+        for (uint32_t i = 0u; i < peripheral_count; ++i) {
+                if (peripherals[i]->power) {
+                        peripherals[i]->power(from, to);
+                }
+        }
+}
+
+/**
+ * \brief Advances the time
+ *
+ * \param[in] time New time
+ */
+static void advance(sim_time_t time)
+{
+        now = time;
+        for (uint32_t i = 0u; i < peripheral_count; ++i) {
+                if (peripherals[i]->sync) {
+                        peripherals[i]->sync();
+                }
+        }
+}
+
+void sim_init(void)
+{
+        for (uint32_t i = 0u; i < REGIONS; ++i) {
+                if (!mapped) {
+                        map_region(&regions[i]);
+                }
+                memset((void *)regions[i].start, regions[i].fill,
+                        regions[i].size);
+        }
+        mapped = true;
+
+        peripheral_count = 0u;
+        calendar = NULL;
+        now = 0u;
+        end_time = 0u;
+        lls_time = 0u;
+        sleep_start = 0u;
+        mode = SIM_MODE_RUN;
+        irq_pending = 0u;
+        irq_enabled = 0u;
+        primask = 0u;
+        handler_depth = 0u;
+        irq_count = 0u;
+        for (uint32_t irq = 0u; irq < SIM_IRQS; ++irq) {
+                irq_priority[irq] = 0u;
+                irq_level[irq] = NULL;
+        }
+}
+
+void sim_add_peripheral(sim_peripheral_t const *peripheral)
+{
+        if (peripheral_count >= SIM_PERIPHERALS) {
+                fprintf(stderr, "sim: too many peripherals\n");
+                exit(EXIT_FAILURE);
+        }
+        peripherals[peripheral_count++] = peripheral;
+}
+
+void sim_run(void (*entry)(void), sim_time_t end)
+{
+        end_time = end;
+        running = true;
+        if (!setjmp(run_exit)) {
+                entry();
+        }
+        running = false;
+        // The firmware was left in the middle of whatever it was doing.
+        handler_depth = 0u;
+        set_mode(SIM_MODE_RUN);
+}
+
+void sim_stop(void)
+{
+        if (running) {
+                longjmp(run_exit, 1);
+        }
+}
+
+sim_time_t sim_now(void)
+{
+        return now;
+}
+
+sim_time_t sim_clock_time(void)
+{
+        sim_time_t const stopped = (mode == SIM_MODE_LLS) ?
+                (now - sleep_start) : 0u;
+
+        return now - lls_time - stopped;
+}
+
+sim_mode_t sim_mode(void)
+{
+        return mode;
+}
+
+void sim_schedule(sim_event_t *event, sim_time_t time)
+{
+        sim_event_t **position = &calendar;
+
+        sim_cancel(event);
+        if (time < now) {
+                time = now;
+        }
+        while (*position && ((*position)->time <= time)) {
+                position = &(*position)->next;
+        }
+        event->time = time;
+        event->next = *position;
+        event->scheduled = true;
+        *position = event;
+}
+
+void sim_cancel(sim_event_t *event)
+{
+        sim_event_t **position = &calendar;
+
+        if (!event->scheduled) {
+                return;
+        }
+        while (*position != event) {
+                position = &(*position)->next;
+        }
+        *position = event->next;
+        event->next = NULL;
+        event->scheduled = false;
+}
+
+void sim_sleep(sim_mode_t sleep_mode)
+{
+        set_mode(sleep_mode);
+
+        // Like WFI, wake up on an enabled interrupt also when the interrupts
+        // are masked.
+        while (!(irq_pending & irq_enabled)) {
+                sim_event_t *event = calendar;
+
+                if (!event || (event->time > end_time)) {
+                        advance(end_time);
+                        sim_stop();
+                        // Sleep forever, if not run by sim_run().
+                        fprintf(stderr, "sim: no more events\n");
+                        exit(EXIT_FAILURE);
+                }
+                calendar = event->next;
+                event->next = NULL;
+                event->scheduled = false;
+                advance(event->time);
+                event->handler(event);
+        }
+
+        set_mode(SIM_MODE_RUN);
+        dispatch();
+}
+
+void sim_irq_set_level(int irq, sim_irq_level_t level)
+{
+        irq_level[irq] = level;
+}
+
+void sim_irq_raise(int irq)
+{
+        if (irq_level[irq] && !irq_level[irq]()) {
+                return;
+        }
+        sim_irq_set_pending(irq);
+}
+
+void sim_irq_set_pending(int irq)
+{
+        irq_pending |= 1u << irq;
+        dispatch();
+}
+
+void sim_irq_clear_pending(int irq)
+{
+        irq_pending &= ~(1u << irq);
+}
+
+bool sim_irq_is_pending(int irq)
+{
+        return (irq_pending >> irq) & 1u;
+}
+
+void sim_irq_enable(int irq)
+{
+        irq_enabled |= 1u << irq;
+        dispatch();
+}
+
+void sim_irq_disable(int irq)
+{
+        irq_enabled &= ~(1u << irq);
+}
+
+void sim_irq_set_priority(int irq, uint32_t priority)
+{
+        irq_priority[irq] = (uint8_t)priority;
+}
+
+void sim_set_primask(uint32_t mask)
+{
+        primask = mask & 1u;
+        dispatch();
+}
+
+uint32_t sim_get_primask(void)
+{
+        return primask;
+}
+
+uint64_t sim_irq_count(void)
+{
+        return irq_count;
+}
+
+uint8_t *sim_flash(void)
+{
+        return (uint8_t *)(uintptr_t)SIM_FLASH_START;
+}
+
+/** @} */
+
+/* EOF */
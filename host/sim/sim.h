@@ -0,0 +1,286 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \file       sim.h
+ * \defgroup   sim Host simulation core
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Discrete event simulation of the MKL17Z4 core for running the firmware on
+ * a Linux host.
+ *
+ * The peripheral registers are plain RAM mapped at the addresses of the
+ * MKL17Z4.h base pointers, so the firmware accesses them exactly as on the
+ * target. The host SDK drivers implement the side effects of the register
+ * writes (write-1-to-clear flags, set/clear registers, DMA requests) and
+ * schedule the peripheral events in simulated time.
+ *
+ * The simulated time only advances while the firmware sleeps: the code runs
+ * in zero time, and a sleep jumps directly to the next event. This keeps the
+ * simulation deterministic and lets it run much faster than real time.
+ *
+ * The host build is linked with -no-pie, so that the static buffers of the
+ * firmware have 32-bit addresses like on the target.
+ *
+ * @{
+ */
+
+/// Simulated time in nanoseconds
+typedef uint64_t sim_time_t;
+
+/// Nanoseconds in a microsecond
+#define SIM_US 1000ull
+/// Nanoseconds in a millisecond
+#define SIM_MS 1000000ull
+/// Nanoseconds in a second
+#define SIM_S 1000000000ull
+
+/// Number of the device specific interrupts
+#define SIM_IRQS 32u
+
+/// Start address of the simulated flash, the data block of the program flash
+#define SIM_FLASH_START 0x00020000u
+/// Size of the simulated flash in bytes
+#define SIM_FLASH_SIZE 0x00020000u
+
+/// Power modes of the core
+typedef enum {
+        /// Running
+        SIM_MODE_RUN,
+        /// Wait mode, all the peripherals running
+        SIM_MODE_WAIT,
+        /// Very low power stop, the asynchronous peripherals running
+        SIM_MODE_VLPS,
+        /// Low leakage stop, only the LLWU sources running
+        SIM_MODE_LLS
+} sim_mode_t;
+
+typedef struct sim_event sim_event_t;
+
+/**
+ * \brief Event handler
+ *
+ * \param[in] event The event which occurred
+ */
+typedef void (*sim_event_handler_t)(sim_event_t *event);
+
+/// Event in simulated time
+struct sim_event {
+        /// Time of the event
+        sim_time_t time;
+        /// Handler of the event
+        sim_event_handler_t handler;
+        /// Next event in the calendar
+        sim_event_t *next;
+        /// Set while the event is in the calendar
+        bool scheduled;
+};
+
+/**
+ * \brief Peripheral model hooks
+ *
+ * Called by the simulation core for the peripherals whose registers depend
+ * on the simulated time.
+ */
+typedef struct {
+        /// Updates the time dependent registers after the time has advanced,
+        /// or NULL
+        void (*sync)(void);
+        /// Notifies a change of the power mode, or NULL
+        void (*power)(sim_mode_t from, sim_mode_t to);
+} sim_peripheral_t;
+
+/**
+ * \brief Level of an interrupt source
+ *
+ * \return True, if the interrupt request is asserted
+ */
+typedef bool (*sim_irq_level_t)(void);
+
+/**
+ * \brief Initializes the simulation
+ *
+ * Maps the peripheral and flash address ranges, clears the registers,
+ * erases the flash and resets the time. Exits the process, if the address
+ * ranges can not be mapped.
+ */
+void sim_init(void);
+
+/**
+ * \brief Registers a peripheral model
+ *
+ * \param[in] peripheral Peripheral hooks, in static storage
+ */
+void sim_add_peripheral(sim_peripheral_t const *peripheral);
+
+/**
+ * \brief Runs the firmware
+ *
+ * Calls the entry function, and returns when the simulated time reaches the
+ * end time or sim_stop() is called.
+ *
+ * \param[in] entry Entry point of the firmware
+ * \param[in] end Simulated end time
+ */
+void sim_run(void (*entry)(void), sim_time_t end);
+
+/**
+ * \brief Stops the simulation at the current time
+ */
+void sim_stop(void);
+
+/**
+ * \brief Gets the current simulated time
+ *
+ * \return Time in nanoseconds since sim_init()
+ */
+sim_time_t sim_now(void);
+
+/**
+ * \brief Gets the time the MCGIRCLK has been running
+ *
+ * The internal reference clock stops in LLS.
+ *
+ * \return Time in nanoseconds
+ */
+sim_time_t sim_clock_time(void);
+
+/**
+ * \brief Gets the current power mode
+ *
+ * \return Power mode
+ */
+sim_mode_t sim_mode(void);
+
+/**
+ * \brief Schedules an event
+ *
+ * An event already in the calendar is moved to the new time. Events at the
+ * same time occur in the order they were scheduled.
+ *
+ * \param[in] event Event with the handler set
+ * \param[in] time Time of the event, not earlier than now
+ */
+void sim_schedule(sim_event_t *event, sim_time_t time);
+
+/**
+ * \brief Removes an event from the calendar
+ *
+ * \param[in] event Event, scheduled or not
+ */
+void sim_cancel(sim_event_t *event);
+
+/**
+ * \brief Sleeps until an enabled interrupt is pending
+ *
+ * Advances the simulated time event by event. Returns to the caller of
+ * sim_run(), if the end time is reached.
+ *
+ * \param[in] mode Power mode for the sleep
+ */
+void sim_sleep(sim_mode_t mode);
+
+/**
+ * \brief Sets the level source of an interrupt
+ *
+ * An interrupt with a level source is pended again after its handler, if
+ * the source is still asserted.
+ *
+ * \param[in] irq Interrupt number
+ * \param[in] level Level source
+ */
+void sim_irq_set_level(int irq, sim_irq_level_t level);
+
+/**
+ * \brief Pends an interrupt, if its source is asserted
+ *
+ * \param[in] irq Interrupt number
+ */
+void sim_irq_raise(int irq);
+
+/// \brief Sets an interrupt pending \param[in] irq Interrupt number
+void sim_irq_set_pending(int irq);
+/// \brief Clears a pending interrupt \param[in] irq Interrupt number
+void sim_irq_clear_pending(int irq);
+/// \brief Checks a pending interrupt \param[in] irq Interrupt number
+/// \return True, if pending
+bool sim_irq_is_pending(int irq);
+/// \brief Enables an interrupt \param[in] irq Interrupt number
+void sim_irq_enable(int irq);
+/// \brief Disables an interrupt \param[in] irq Interrupt number
+void sim_irq_disable(int irq);
+/// \brief Sets an interrupt priority \param[in] irq Interrupt number
+/// \param[in] priority Priority, 0 is the highest
+void sim_irq_set_priority(int irq, uint32_t priority);
+
+/**
+ * \brief Sets the PRIMASK
+ *
+ * Clearing the mask serves the pending interrupts.
+ *
+ * \param[in] primask 1 to mask the interrupts, 0 to unmask
+ */
+void sim_set_primask(uint32_t primask);
+
+/**
+ * \brief Gets the PRIMASK
+ *
+ * \return 1 if the interrupts are masked, else 0
+ */
+uint32_t sim_get_primask(void);
+
+/**
+ * \brief Counts the served interrupts
+ *
+ * \return Number of interrupt handler calls since sim_init()
+ */
+uint64_t sim_irq_count(void);
+
+/**
+ * \brief Gets the simulated flash
+ *
+ * \return Start of the flash, SIM_FLASH_SIZE bytes
+ */
+uint8_t *sim_flash(void);
+
+/** @} */
+
+#endif // ifndef SIM_H
+
+/* EOF */
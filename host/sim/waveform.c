@@ -0,0 +1,684 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "waveform.h"
+#include "sim_model.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \file       waveform.c
+ * \defgroup   waveform-implementation Scenario waveforms implementation
+ * \ingroup    waveform
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Longest script line
+#define LINE_LENGTH 512u
+/// Comparator input of the summed loop sense line
+#define CMP_INPUT_SUMMED 4u
+
+/// Kind of a signal
+typedef enum {
+        /// Digital input pin
+        SIGNAL_PIN,
+        /// ADC input channel
+        SIGNAL_ADC,
+        /// Comparator input
+        SIGNAL_CMP
+} signal_kind_t;
+
+/// Board input
+typedef struct {
+        /// Name in the scripts
+        char const *name;
+        /// Kind of the signal
+        signal_kind_t kind;
+        /// Port of a pin
+        sim_port_t port;
+        /// Pin, ADC channel or comparator input
+        uint32_t channel;
+} signal_t;
+
+/// Kind of a probe
+typedef enum {
+        /// Output pin level
+        PROBE_PIN,
+        /// Time spent in LLS
+        PROBE_LLS
+} probe_kind_t;
+
+/// Board output or power state checked by the scripts
+typedef struct {
+        /// Name in the scripts
+        char const *name;
+        /// Kind of the probe
+        probe_kind_t kind;
+        /// Port of a pin
+        sim_port_t port;
+        /// Pin
+        uint32_t pin;
+} probe_t;
+
+/// Kind of a step
+typedef enum {
+        /// Set a signal
+        STEP_SET,
+        /// Toggle a signal periodically
+        STEP_TOGGLE,
+        /// Receive text on the serial port
+        STEP_RX,
+        /// Check a probe
+        STEP_EXPECT,
+        /// End of the scenario
+        STEP_END
+} step_kind_t;
+
+/// Scenario step
+typedef struct {
+        /// Toggle event, first so that the step is found from the event
+        sim_event_t toggle;
+        /// Time of the step
+        sim_time_t time;
+        /// Kind of the step
+        step_kind_t kind;
+        /// Signal of a set or a toggle
+        signal_t const *signal;
+        /// Probe of an expect
+        probe_t const *probe;
+        /// Value of a set or an expect
+        uint32_t value;
+        /// Period of a toggle
+        sim_time_t period;
+        /// Remaining toggles
+        uint32_t count;
+        /// Received text
+        uint8_t *data;
+        /// Length of the received text
+        size_t length;
+        /// Line number, orders the steps of the same time
+        uint32_t line;
+} step_t;
+
+/// Board inputs
+static const signal_t signals[] = {
+        { "alarm1", SIGNAL_PIN, SIM_PORT_C, 5u },
+        { "alarm2", SIGNAL_PIN, SIM_PORT_C, 7u },
+        { "alarm3", SIGNAL_PIN, SIM_PORT_C, 9u },
+        { "alarm4", SIGNAL_PIN, SIM_PORT_C, 11u },
+        { "alarm5", SIGNAL_PIN, SIM_PORT_D, 1u },
+        { "alarm6", SIGNAL_PIN, SIM_PORT_D, 3u },
+        { "alarm7", SIGNAL_PIN, SIM_PORT_D, 5u },
+        { "alarm8", SIGNAL_PIN, SIM_PORT_D, 7u },
+        { "shield1", SIGNAL_PIN, SIM_PORT_C, 4u },
+        { "shield2", SIGNAL_PIN, SIM_PORT_C, 6u },
+        { "shield3", SIGNAL_PIN, SIM_PORT_C, 8u },
+        { "shield4", SIGNAL_PIN, SIM_PORT_C, 10u },
+        { "shield5", SIGNAL_PIN, SIM_PORT_D, 0u },
+        { "shield6", SIGNAL_PIN, SIM_PORT_D, 2u },
+        { "shield7", SIGNAL_PIN, SIM_PORT_D, 4u },
+        { "shield8", SIGNAL_PIN, SIM_PORT_D, 6u },
+        { "button1", SIGNAL_PIN, SIM_PORT_C, 3u },
+        { "button2", SIGNAL_PIN, SIM_PORT_C, 1u },
+        { "button3", SIGNAL_PIN, SIM_PORT_B, 19u },
+        { "button4", SIGNAL_PIN, SIM_PORT_B, 17u },
+        { "button5", SIGNAL_PIN, SIM_PORT_B, 3u },
+        { "button6", SIGNAL_PIN, SIM_PORT_B, 1u },
+        { "button7", SIGNAL_PIN, SIM_PORT_A, 19u },
+        { "button8", SIGNAL_PIN, SIM_PORT_A, 13u },
+        { "sense1", SIGNAL_ADC, SIM_PORT_E, 1u },
+        { "sense2", SIGNAL_ADC, SIM_PORT_E, 5u },
+        { "sense3", SIGNAL_ADC, SIM_PORT_E, 2u },
+        { "sense4", SIGNAL_ADC, SIM_PORT_E, 6u },
+        { "sense5", SIGNAL_ADC, SIM_PORT_E, 0u },
+        { "sense6", SIGNAL_ADC, SIM_PORT_E, 4u },
+        { "sense7", SIGNAL_ADC, SIM_PORT_E, 3u },
+        { "sense8", SIGNAL_ADC, SIM_PORT_E, 7u },
+        { "summed", SIGNAL_CMP, SIM_PORT_E, CMP_INPUT_SUMMED },
+        { "powerfail", SIGNAL_PIN, SIM_PORT_E, 1u }
+};
+
+/// Number of the board inputs
+#define SIGNALS (sizeof(signals) / sizeof(signals[0]))
+
+/// Board outputs and power states
+static const probe_t probes[] = {
+        { "relay", PROBE_PIN, SIM_PORT_E, 29u },
+        { "lls", PROBE_LLS, SIM_PORT_A, 0u }
+};
+
+/// Number of the probes
+#define PROBES (sizeof(probes) / sizeof(probes[0]))
+
+/// Steps sorted by time
+static step_t *steps;
+/// Number of the steps
+static size_t step_count;
+/// Allocated steps
+static size_t step_capacity;
+/// Index of the next step
+static size_t next_step;
+/// Step event
+static sim_event_t step_event;
+/// End time, or 0
+static sim_time_t end;
+/// Name of the script for the failure messages
+static char const *script_name;
+/// Failed expectations
+static uint32_t failures;
+/// Time spent in LLS up to the previous LLS expectation
+static sim_time_t lls_checked;
+
+/**
+ * \brief Finds a board input
+ *
+ * \param[in] name Name of the input
+ *
+ * \return Input, or NULL if not found
+ */
+static signal_t const *find_signal(char const *name)
+{
+        for (size_t i = 0u; i < SIGNALS; ++i) {
+                if (!strcmp(signals[i].name, name)) {
+                        return &signals[i];
+                }
+        }
+
+        return NULL;
+}
+
+/**
+ * \brief Finds a probe
+ *
+ * \param[in] name Name of the probe
+ *
+ * \return Probe, or NULL if not found
+ */
+static probe_t const *find_probe(char const *name)
+{
+        for (size_t i = 0u; i < PROBES; ++i) {
+                if (!strcmp(probes[i].name, name)) {
+                        return &probes[i];
+                }
+        }
+
+        return NULL;
+}
+
+/**
+ * \brief Parses a time
+ *
+ * \param[in] text Time with an optional unit suffix
+ * \param[out] time Time
+ *
+ * \return True, if valid
+ */
+static bool parse_time(char const *text, sim_time_t *time)
+{
+        char *suffix;
+        double const value = strtod(text, &suffix);
+        double scale;
+
+        if ((suffix == text) || (value < 0.0)) {
+                return false;
+        }
+        if (!*suffix || !strcmp(suffix, "ms")) {
+                scale = (double)SIM_MS;
+        } else if (!strcmp(suffix, "s")) {
+                scale = (double)SIM_S;
+        } else if (!strcmp(suffix, "us")) {
+                scale = (double)SIM_US;
+        } else {
+                return false;
+        }
+        *time = (sim_time_t)((value * scale) + 0.5);
+
+        return true;
+}
+
+/**
+ * \brief Parses a signal value
+ *
+ * \param[in] signal Signal
+ * \param[in] text Value
+ * \param[out] value Value
+ *
+ * \return True, if valid for the signal
+ */
+static bool parse_value(signal_t const *signal, char const *text,
+        uint32_t *value)
+{
+        char *rest;
+        unsigned long const number = strtoul(text, &rest, 0);
+        unsigned long const maximum = (signal->kind == SIGNAL_PIN) ?
+                1u : SIM_ANALOG_FULL_SCALE;
+
+        if ((rest == text) || *rest || (number > maximum)) {
+                return false;
+        }
+        *value = (uint32_t)number;
+
+        return true;
+}
+
+/**
+ * \brief Parses a quoted text
+ *
+ * \param[in] text Quoted text, with the C escapes
+ * \param[out] step Step to store the text into
+ *
+ * \return True, if valid
+ */
+static bool parse_text(char const *text, step_t *step)
+{
+        size_t length = 0u;
+        uint8_t *data;
+
+        if (*text++ != '"') {
+                return false;
+        }
+        data = malloc(strlen(text) + 1u);
+        if (!data) {
+                return false;
+        }
+        while (*text && (*text != '"')) {
+                char c = *text++;
+
+                if (c == '\\') {
+                        c = *text++;
+                        switch (c) {
+                        case 'r':
+                                c = '\r';
+                                break;
+                        case 'n':
+                                c = '\n';
+                                break;
+                        case 't':
+                                c = '\t';
+                                break;
+                        case '"':
+                        case '\\':
+                                break;
+                        default:
+                                free(data);
+                                return false;
+                        }
+                }
+                data[length++] = (uint8_t)c;
+        }
+        if (*text != '"') {
+                free(data);
+                return false;
+        }
+        step->data = data;
+        step->length = length;
+
+        return true;
+}
+
+/**
+ * \brief Adds a step
+ *
+ * \return New step, or NULL if out of memory
+ */
+static step_t *add_step(void)
+{
+        if (step_count == step_capacity) {
+                size_t const capacity = step_capacity ? (step_capacity * 2u) :
+                        64u;
+                step_t * const grown = realloc(steps,
+                        capacity * sizeof(step_t));
+
+                if (!grown) {
+                        return NULL;
+                }
+                steps = grown;
+                step_capacity = capacity;
+        }
+        memset(&steps[step_count], 0, sizeof(step_t));
+
+        return &steps[step_count++];
+}
+
+/**
+ * \brief Parses a script line
+ *
+ * \param[in] line Line without the comment
+ * \param[in] number Line number
+ * \param[in,out] previous Time of the previous step
+ *
+ * \return Error message, or NULL if valid
+ */
+static char const *parse_line(char *line, uint32_t number,
+        sim_time_t *previous)
+{
+        char *time_text = strtok(line, " \t\r\n");
+        char *command;
+        sim_time_t time;
+        step_t *step;
+        bool relative;
+
+        if (!time_text) {
+                return NULL;
+        }
+        relative = (*time_text == '+');
+        if (!parse_time(time_text + relative, &time)) {
+                return "invalid time";
+        }
+        if (relative) {
+                time += *previous;
+        }
+        *previous = time;
+
+        command = strtok(NULL, " \t\r\n");
+        if (!command) {
+                return "missing step";
+        }
+        step = add_step();
+        if (!step) {
+                return "out of memory";
+        }
+        step->time = time;
+        step->line = number;
+
+        if (!strcmp(command, "end")) {
+                step->kind = STEP_END;
+        } else if (!strcmp(command, "rx")) {
+                char *text = strtok(NULL, "");
+
+                step->kind = STEP_RX;
+                while (text && isspace((unsigned char)*text)) {
+                        ++text;
+                }
+                if (!text || !parse_text(text, step)) {
+                        return "invalid text";
+                }
+        } else if (!strcmp(command, "toggle")) {
+                char const *name = strtok(NULL, " \t\r\n");
+                char const *period = strtok(NULL, " \t\r\n");
+                char const *count = strtok(NULL, " \t\r\n");
+                char *rest;
+
+                step->kind = STEP_TOGGLE;
+                step->signal = name ? find_signal(name) : NULL;
+                if (!step->signal || (step->signal->kind != SIGNAL_PIN)) {
+                        return "invalid digital signal";
+                }
+                if (!period || !parse_time(period, &step->period) ||
+                        !step->period) {
+                        return "invalid period";
+                }
+                step->count = count ? (uint32_t)strtoul(count, &rest, 0) : 0u;
+                if (!count || *rest) {
+                        return "invalid count";
+                }
+        } else if (!strcmp(command, "expect")) {
+                char const *name = strtok(NULL, " \t\r\n");
+                char const *value = strtok(NULL, " \t\r\n");
+
+                step->kind = STEP_EXPECT;
+                step->probe = name ? find_probe(name) : NULL;
+                if (!step->probe) {
+                        return "unknown probe";
+                }
+                if (!value || (strcmp(value, "0") && strcmp(value, "1"))) {
+                        return "invalid value";
+                }
+                step->value = (*value == '1');
+        } else {
+                char const *value = strtok(NULL, " \t\r\n");
+
+                step->kind = STEP_SET;
+                step->signal = find_signal(command);
+                if (!step->signal) {
+                        return "unknown signal";
+                }
+                if (!value || !parse_value(step->signal, value,
+                        &step->value)) {
+                        return "invalid value";
+                }
+        }
+
+        if (strtok(NULL, " \t\r\n") && (step->kind != STEP_RX)) {
+                return "extra arguments";
+        }
+
+        return NULL;
+}
+
+/**
+ * \brief Orders the steps by time and line
+ *
+ * \param[in] a First step
+ * \param[in] b Second step
+ *
+ * \return Order of the steps
+ */
+static int compare_steps(void const *a, void const *b)
+{
+        step_t const *first = a;
+        step_t const *second = b;
+
+        if (first->time != second->time) {
+                return (first->time < second->time) ? -1 : 1;
+        }
+
+        return (first->line < second->line) ? -1 : (first->line > second->line);
+}
+
+/**
+ * \brief Sets a board input
+ *
+ * \param[in] signal Signal
+ * \param[in] value Value
+ */
+static void set_signal(signal_t const *signal, uint32_t value)
+{
+        switch (signal->kind) {
+        case SIGNAL_PIN:
+                sim_pin_drive(signal->port, signal->channel, value != 0u);
+                break;
+        case SIGNAL_ADC:
+                sim_adc_set_input(signal->channel, (uint16_t)value);
+                break;
+        case SIGNAL_CMP:
+                sim_cmp_set_input(signal->channel, (uint16_t)value);
+                break;
+        }
+}
+
+/**
+ * \brief Handles a toggle of a toggle step
+ *
+ * \param[in] event Toggle event of the step
+ */
+static void toggle(sim_event_t *event)
+{
+        step_t * const step = (step_t *)event;
+        signal_t const * const signal = step->signal;
+
+        set_signal(signal, !sim_pin_level(signal->port, signal->channel));
+        if (--step->count) {
+                sim_schedule(event, sim_now() + step->period);
+        }
+}
+
+/**
+ * \brief Checks the probe of an expect step
+ *
+ * Prints a failed expectation to stderr.
+ *
+ * \param[in] step Expect step
+ */
+static void check(step_t const *step)
+{
+        probe_t const * const probe = step->probe;
+        uint32_t actual = 0u;
+
+        switch (probe->kind) {
+        case PROBE_PIN:
+                actual = sim_pin_level(probe->port, probe->pin);
+                break;
+        case PROBE_LLS: {
+                sim_time_t const lls = sim_now() - sim_clock_time();
+
+                actual = lls > lls_checked;
+                lls_checked = lls;
+                break;
+        }
+        }
+
+        if (actual != step->value) {
+                fprintf(stderr, "%s:%u: expected %s %u, got %u\n",
+                        script_name, step->line, probe->name, step->value,
+                        actual);
+                ++failures;
+        }
+}
+
+/**
+ * \brief Executes the steps which are due
+ *
+ * \param[in] event Step event
+ */
+static void run_steps(sim_event_t *event)
+{
+        while ((next_step < step_count) &&
+                (steps[next_step].time <= sim_now())) {
+                step_t * const step = &steps[next_step++];
+
+                switch (step->kind) {
+                case STEP_SET:
+                        set_signal(step->signal, step->value);
+                        break;
+                case STEP_TOGGLE:
+                        if (step->count) {
+                                step->toggle.handler = toggle;
+                                sim_schedule(&step->toggle, sim_now());
+                        }
+                        break;
+                case STEP_RX:
+                        sim_serial_receive(step->data, step->length);
+                        break;
+                case STEP_EXPECT:
+                        check(step);
+                        break;
+                case STEP_END:
+                        break;
+                }
+        }
+        if (next_step < step_count) {
+                sim_schedule(event, steps[next_step].time);
+        }
+}
+
+bool waveform_load(FILE *file, char const *name)
+{
+        char line[LINE_LENGTH];
+        uint32_t number = 0u;
+        sim_time_t previous = 0u;
+        bool valid = true;
+
+        waveform_free();
+        script_name = name;
+        while (fgets(line, sizeof(line), file)) {
+                char * const comment = strchr(line, '#');
+                char const *error;
+
+                ++number;
+                // A # within the received text is not a comment.
+                if (comment && !memchr(line, '"', (size_t)(comment - line))) {
+                        *comment = '\0';
+                }
+                error = parse_line(line, number, &previous);
+                if (error) {
+                        fprintf(stderr, "%s:%u: %s\n", name, number, error);
+                        valid = false;
+                }
+        }
+
+        qsort(steps, step_count, sizeof(step_t), compare_steps);
+        for (size_t i = 0u; i < step_count; ++i) {
+                if (steps[i].kind == STEP_END) {
+                        end = steps[i].time;
+                        break;
+                }
+        }
+
+        return valid;
+}
+
+void waveform_start(void)
+{
+        next_step = 0u;
+        failures = 0u;
+        lls_checked = 0u;
+        step_event.handler = run_steps;
+        step_event.next = NULL;
+        step_event.scheduled = false;
+        for (size_t i = 0u; i < step_count; ++i) {
+                steps[i].toggle.next = NULL;
+                steps[i].toggle.scheduled = false;
+        }
+        if (step_count) {
+                sim_schedule(&step_event, steps[0].time);
+        }
+}
+
+sim_time_t waveform_end(void)
+{
+        return end;
+}
+
+uint32_t waveform_failures(void)
+{
+        return failures;
+}
+
+void waveform_free(void)
+{
+        for (size_t i = 0u; i < step_count; ++i) {
+                free(steps[i].data);
+        }
+        free(steps);
+        steps = NULL;
+        step_count = 0u;
+        step_capacity = 0u;
+        next_step = 0u;
+        end = 0u;
+}
+
+/** @} */
+
+/* EOF */
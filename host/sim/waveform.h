@@ -0,0 +1,118 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * \file       waveform.h
+ * \defgroup   waveform Scenario waveforms
+ * \ingroup    sim
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Drives the board inputs of the simulation from a scenario script. Each
+ * line of a script is a step:
+ *
+ *     <time> <signal> <value>
+ *     <time> toggle <signal> <period> <count>
+ *     <time> rx "<text>"
+ *     <time> expect <probe> <value>
+ *     <time> end
+ *
+ * The time is in seconds, milliseconds or microseconds by its suffix s, ms
+ * or us (milliseconds without a suffix). A time starting with + is relative
+ * to the previous step. Everything after # is a comment.
+ *
+ * The digital signals are alarm1...alarm8, shield1...shield8,
+ * button1...button8 and powerfail, with the values 0 and 1. The analog signals are
+ * sense1...sense8 (the ADC loop sense lines) and summed (the comparator
+ * input of the summed loop sense), with the values 0...65535. A toggle
+ * inverts a digital signal count times, once per period. The rx step
+ * receives the text on the serial port; \\r, \\n, \\t, \\" and \\\\ are
+ * escaped like in C. The end step ends the scenario.
+ *
+ * The expect step checks a probe against the value 0 or 1, and counts a
+ * failure if it does not match. The probes are relay (the relay output) and
+ * lls, which is 1 if the core has slept in LLS since the previous lls
+ * expect step.
+ *
+ * @{
+ */
+
+/**
+ * \brief Loads a scenario script
+ *
+ * Prints the errors to stderr.
+ *
+ * \param[in] file Script
+ * \param[in] name Name of the script for the error messages
+ *
+ * \return True, if the script was valid
+ */
+bool waveform_load(FILE *file, char const *name);
+
+/**
+ * \brief Starts driving the loaded scenario
+ *
+ * Call after the simulation and the peripheral models have been
+ * initialized.
+ */
+void waveform_start(void);
+
+/**
+ * \brief Gets the end time of the scenario
+ *
+ * \return Time of the end step, or 0 if the scenario has no end step
+ */
+sim_time_t waveform_end(void);
+
+/**
+ * \brief Gets the number of the failed expect steps
+ *
+ * \return Failed expectations since the scenario was started
+ */
+uint32_t waveform_failures(void);
+
+/**
+ * \brief Releases the loaded scenario
+ */
+void waveform_free(void);
+
+/** @} */
+
+#endif // ifndef WAVEFORM_H
+
+/* EOF */
@@ -0,0 +1,143 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "alarm_core.h"
+#include "backlight_io.h"
+#include "relay_io.h"
+
+/**
+ * \file       alarm_core.c
+ * \defgroup   alarm-core-implementation Alarm state machine implementation
+ * \ingroup    alarm-core
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+void alarm_core_init(alarm_core_t *core)
+{
+        core->armed = 0u;
+        core->entry = 0u;
+        core->latched = 0u;
+        core->tamper = 0u;
+        core->fault = 0u;
+        core->delayed = 0u;
+        core->entry_delay = ALARM_CORE_DEFAULT_ENTRY_DELAY;
+        core->entry_remaining = 0u;
+}
+
+void alarm_core_set_entry_delay(alarm_core_t *core, uint8_t delayed,
+        uint16_t steps)
+{
+        core->delayed = delayed;
+        core->entry_delay = steps;
+}
+
+void alarm_core_arm(alarm_core_t *core, uint8_t loops)
+{
+        core->armed |= loops;
+}
+
+void alarm_core_disarm(alarm_core_t *core, uint8_t loops)
+{
+        uint8_t const keep = (uint8_t)~loops;
+
+        core->armed &= keep;
+        core->entry &= keep;
+        core->latched &= keep;
+        core->tamper &= keep;
+}
+
+bool alarm_core_step(alarm_core_t *core, alarm_core_input_t const *input,
+        uint16_t steps)
+{
+        uint8_t const triggered = input->alarm & core->armed & ~core->latched;
+        uint8_t const was_idle = (core->entry == 0u) ? 0xFFu : 0x00u;
+        uint8_t expired;
+
+        core->entry |= triggered & core->delayed;
+
+        // Restart the delay when the first delayed loop enters it, and count
+        // down the elapsed steps while any loop is in the delay.
+        if (was_idle & core->entry) {
+                core->entry_remaining = core->entry_delay;
+        } else if (core->entry_remaining > steps) {
+                core->entry_remaining -= steps;
+        } else {
+                core->entry_remaining = 0u;
+        }
+        expired = (core->entry_remaining == 0u) ? core->entry : 0x00u;
+
+        core->latched |= (triggered & ~core->delayed) | expired;
+        core->entry &= ~expired;
+        core->tamper |= input->shield;
+        core->fault = input->fault;
+
+        return (core->latched | core->tamper) != 0u;
+}
+
+mdv_result_t alarm_core_drive_outputs(alarm_core_t const *core)
+{
+        uint8_t const fast = core->latched | core->entry;
+        uint8_t const twice = (core->tamper | core->fault) & ~fast;
+        uint8_t const steady = core->armed & ~(fast | twice);
+        mdv_result_t result;
+
+        result = relay_output.set((core->latched | core->tamper) != 0u);
+        if (result != MDV_RESULT_OK) {
+                return result;
+        }
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                uint8_t const bit = (uint8_t)(1u << loop);
+                backlight_pattern_t pattern = BACKLIGHT_PATTERN_STEADY;
+                uint8_t level = BACKLIGHT_IO_MAXIMUM_LEVEL;
+
+                if (fast & bit) {
+                        pattern = BACKLIGHT_PATTERN_FAST_BLINK;
+                } else if (twice & bit) {
+                        pattern = BACKLIGHT_PATTERN_DOUBLE_BLINK;
+                } else if (!(steady & bit)) {
+                        level = 0u;
+                }
+
+                result = backlight_io_set(loop, level, pattern);
+                if (result != MDV_RESULT_OK) {
+                        return result;
+                }
+        }
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
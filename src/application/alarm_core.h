@@ -0,0 +1,182 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ALARM_CORE_H
+#define ALARM_CORE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       alarm_core.h
+ * \defgroup   alarm-core Alarm state machine
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Alarm logic of all the loops, evaluated once per input sample.
+ *
+ * The state of the loops is held in bit-planes, where bit n of each plane
+ * belongs to loop n + 1. A loop is either disarmed or armed, and an armed
+ * loop may be in the entry delay or have its alarm latched. Tamper (shield
+ * alarm) and fault states are tracked regardless of arming. All the loops
+ * are stepped with a fixed sequence of logical operations, so the time from
+ * an input sample to the relay decision does not depend on the state or
+ * the number of active loops.
+ *
+ * The entry delay is shared by all the loops: it starts when the first
+ * delayed loop triggers, and when it expires, the alarm of every loop still
+ * in the entry delay is latched.
+ *
+ * @{
+ */
+
+/// Default entry delay in steps
+#define ALARM_CORE_DEFAULT_ENTRY_DELAY 300u
+
+/**
+ * \brief Input signals of one step
+ *
+ * All the signals are active high, i.e. a set bit means that the loop has
+ * triggered. Bit n belongs to loop n + 1.
+ */
+typedef struct {
+        /// Alarm signals
+        uint8_t alarm;
+        /// Shield alarm signals
+        uint8_t shield;
+        /// Loop faults (e.g. short circuit or cut line)
+        uint8_t fault;
+} alarm_core_input_t;
+
+/**
+ * \brief Alarm state
+ */
+typedef struct {
+        /// Armed loops
+        uint8_t armed;
+        /// Loops in the entry delay
+        uint8_t entry;
+        /// Loops with the alarm latched
+        uint8_t latched;
+        /// Loops with the tamper alarm latched
+        uint8_t tamper;
+        /// Loops with a fault
+        uint8_t fault;
+        /// Loops using the entry delay, others trigger instantly
+        uint8_t delayed;
+        /// Entry delay in steps
+        uint16_t entry_delay;
+        /// Remaining entry delay in steps
+        uint16_t entry_remaining;
+} alarm_core_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the alarm state
+ *
+ * All the loops are disarmed and trigger instantly, and the entry delay is
+ * set to the default.
+ *
+ * \param[out] core Alarm state
+ */
+void alarm_core_init(alarm_core_t *core);
+
+/**
+ * \brief Sets the loops using the entry delay and the delay time
+ *
+ * \param[in,out] core Alarm state
+ * \param[in] delayed Loops using the entry delay
+ * \param[in] steps Entry delay in steps
+ */
+void alarm_core_set_entry_delay(alarm_core_t *core, uint8_t delayed,
+        uint16_t steps);
+
+/**
+ * \brief Arms loops
+ *
+ * \param[in,out] core Alarm state
+ * \param[in] loops Loops to arm
+ */
+void alarm_core_arm(alarm_core_t *core, uint8_t loops);
+
+/**
+ * \brief Disarms loops
+ *
+ * Clears the entry delay, the latched alarm and the latched tamper alarm of
+ * the loops. A tamper alarm still active is latched again on the next step.
+ *
+ * \param[in,out] core Alarm state
+ * \param[in] loops Loops to disarm
+ */
+void alarm_core_disarm(alarm_core_t *core, uint8_t loops);
+
+/**
+ * \brief Evaluates one input sample of all the loops
+ *
+ * The entry delay counts down by the steps elapsed since the previous
+ * evaluation. An evaluation between the steps, e.g. on a loop edge, passes
+ * zero, so that it does not shorten the delay.
+ *
+ * \param[in,out] core Alarm state
+ * \param[in] input Input signals
+ * \param[in] steps Entry delay steps elapsed since the previous evaluation
+ *
+ * \return Relay state, true when any alarm or tamper alarm is latched
+ */
+bool alarm_core_step(alarm_core_t *core, alarm_core_input_t const *input,
+        uint16_t steps);
+
+/**
+ * \brief Drives the relay and the button backlights from the alarm state
+ *
+ * The relay is on while any alarm or tamper alarm is latched. Backlights
+ * are steady for armed loops, blink fast for loops in alarm or entry delay,
+ * double blink for loops with a tamper alarm or a fault, and are off for
+ * disarmed loops.
+ *
+ * \param[in] core Alarm state
+ *
+ * \return Result of the operation
+ */
+mdv_result_t alarm_core_drive_outputs(alarm_core_t const *core);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef ALARM_CORE_H
+
+/* EOF */
@@ -46,6 +46,8 @@
 #ifndef BA8_COMMON_H
 #define BA8_COMMON_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "mdv_common.h"
 
 /**
@@ -58,6 +60,33 @@
 /// Maximum loops in BA8 device
 #define BA8_MAXIMUM_LOOPS 8u
 
+/// DMA channel for the loop sense ADC results
+#define BA8_DMA_CHANNEL_LOOP_SENSE_RESULT 0u
+/// DMA channel for the loop sense ADC channel commands
+#define BA8_DMA_CHANNEL_LOOP_SENSE_COMMAND 1u
+/// DMA channel for the serial port transmitter
+#define BA8_DMA_CHANNEL_SERIAL_TX 2u
+/// DMA channel for the serial port receiver
+#define BA8_DMA_CHANNEL_SERIAL_RX 3u
+
+/// Flash sector size in bytes
+#define BA8_FLASH_SECTOR_SIZE 1024u
+/// Start address of the event journal sectors in flash
+#define BA8_FLASH_JOURNAL_START 0x0003B800u
+/// Number of the event journal sectors
+#define BA8_FLASH_JOURNAL_SECTORS 16u
+/// Start address of the configuration sectors in flash
+#define BA8_FLASH_CONFIG_START 0x0003F800u
+/// Number of the configuration sectors
+#define BA8_FLASH_CONFIG_SECTORS 2u
+
+/// Result code for an invalid parameter
+#define BA8_RESULT_INVALID_PARAMETER ((mdv_result_t)0x100u)
+/// Result code for a resource being busy
+#define BA8_RESULT_BUSY ((mdv_result_t)0x101u)
+/// Result code for a failed flash operation
+#define BA8_RESULT_FLASH_ERROR ((mdv_result_t)0x102u)
+
 /** @} */
 
 #endif // ifndef BA8_COMMON_H
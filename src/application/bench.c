@@ -0,0 +1,360 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+#include "alarm_core.h"
+#include "alarm_loop_io.h"
+#include "button_io.h"
+#include "crc16.h"
+#include "input_debounce.h"
+#include "journal.h"
+#include "telemetry.h"
+#include <stddef.h>
+
+/**
+ * \file       bench.c
+ * \defgroup   bench-implementation Microbenchmark suite implementation
+ * \ingroup    bench
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Iterations of the cases running from RAM and the registers
+#define FAST_ITERATIONS 1024u
+/// Iterations of the telemetry frame encoding
+#define ENCODE_ITERATIONS 256u
+/// Iterations of the journal append, limited to save the flash endurance
+#define APPEND_ITERATIONS 16u
+/// Maximum length of one result line including the terminator
+#define RESULT_LINE_LENGTH 96u
+
+/// Mask of all the signals in the debouncer input word
+#define INPUT_MASK (INPUT_DEBOUNCE_ALARM_MASK | INPUT_DEBOUNCE_SHIELD_MASK | \
+        INPUT_DEBOUNCE_BUTTON_MASK)
+
+/**
+ * \brief Benchmark case
+ */
+typedef struct {
+        /// Case name
+        char const *name;
+        /// Runs the iterations
+        void (*run)(uint32_t iterations);
+        /// Number of iterations
+        uint32_t iterations;
+        /// True if the case programs the flash
+        bool flash;
+} bench_case_t;
+
+/// Number of signals in the debouncer input word
+#define INPUT_SIGNALS 24u
+
+/// Results of the cases, kept so that the compiler cannot drop the work
+static volatile uint32_t sink;
+/// Debouncer state of the debounce step case
+static input_debounce_t debounce;
+/// Per-signal counters of the naive debounce case
+static uint8_t naive_counter[INPUT_SIGNALS];
+/// Debounced signal states of the naive debounce case
+static uint32_t naive_state;
+/// Alarm state of the alarm step case
+static alarm_core_t alarm;
+
+/**
+ * \brief Reads single loops through the digital input interface
+ *
+ * \param[in] iterations Number of reads
+ */
+static void loop_read(uint32_t iterations)
+{
+        uint32_t result = 0u;
+
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                result += alarm_input[i % BA8_MAXIMUM_LOOPS].get();
+        }
+        sink = result;
+}
+
+/**
+ * \brief Scans all the loop and button inputs into an input word
+ *
+ * \param[in] iterations Number of scans
+ */
+static void input_scan(uint32_t iterations)
+{
+        uint32_t result = 0u;
+
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                alarm_loop_io_snapshot_t const snapshot =
+                        alarm_loop_io_snapshot();
+
+                result ^= input_debounce_pack(snapshot.alarm, snapshot.shield,
+                        button_io_snapshot());
+        }
+        sink = result;
+}
+
+/**
+ * \brief Feeds samples into the debouncer
+ *
+ * All the signals change every 8 samples, so that the counters run and the
+ * debounced states change.
+ *
+ * \param[in] iterations Number of steps
+ */
+static void debounce_step(uint32_t iterations)
+{
+        uint32_t result = 0u;
+
+        input_debounce_init(&debounce, 0u);
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                result |= input_debounce_step(&debounce,
+                        (i & 8u) ? INPUT_MASK : 0u);
+        }
+        sink = result;
+}
+
+/**
+ * \brief Feeds samples into per-signal debounce counters
+ *
+ * The same samples and threshold as in debounce_step(), filtered with one
+ * counter per signal, for comparison with the vertical counters.
+ *
+ * \param[in] iterations Number of steps
+ */
+static void debounce_naive(uint32_t iterations)
+{
+        uint32_t result = 0u;
+
+        naive_state = 0u;
+        for (uint32_t signal = 0u; signal < INPUT_SIGNALS; ++signal) {
+                naive_counter[signal] = 0u;
+        }
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                uint32_t const delta = ((i & 8u) ? INPUT_MASK : 0u) ^
+                        naive_state;
+
+                for (uint32_t signal = 0u; signal < INPUT_SIGNALS; ++signal) {
+                        if (!((delta >> signal) & 1u)) {
+                                naive_counter[signal] = 0u;
+                        } else if (++naive_counter[signal] >=
+                                INPUT_DEBOUNCE_DEFAULT_THRESHOLD) {
+                                naive_counter[signal] = 0u;
+                                naive_state ^= 1u << signal;
+                                result |= 1u << signal;
+                        }
+                }
+        }
+        sink = result;
+}
+
+/**
+ * \brief Evaluates input samples in the alarm state machine
+ *
+ * All the loops are armed and half of them use the entry delay. The alarm
+ * and shield signals of the loops change every 16 steps.
+ *
+ * \param[in] iterations Number of steps
+ */
+static void alarm_step(uint32_t iterations)
+{
+        alarm_core_input_t input = { 0u, 0u, 0u };
+        uint32_t result = 0u;
+
+        alarm_core_init(&alarm);
+        alarm_core_set_entry_delay(&alarm, 0x0Fu,
+                ALARM_CORE_DEFAULT_ENTRY_DELAY);
+        alarm_core_arm(&alarm, 0xFFu);
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                input.alarm = (i & 16u) ? 0x55u : 0u;
+                input.shield = (i & 32u) ? 0x80u : 0u;
+                result += alarm_core_step(&alarm, &input, 1u);
+        }
+        sink = result;
+}
+
+/**
+ * \brief Calculates the CRC of a journal record
+ *
+ * \param[in] iterations Number of CRCs
+ */
+static void crc_record(uint32_t iterations)
+{
+        journal_record_t record = {
+                0u, 0u, JOURNAL_EVENT_ALARM, 0x01u, 0u, 0xFFFFu, 0u
+        };
+        uint32_t result = 0u;
+
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                record.sequence = i;
+                result += crc16_update(CRC16_INITIAL_VALUE, &record,
+                        offsetof(journal_record_t, crc));
+        }
+        sink = result;
+}
+
+/**
+ * \brief Appends records to the journal
+ *
+ * \param[in] iterations Number of records
+ */
+static void journal_append_record(uint32_t iterations)
+{
+        uint32_t result = 0u;
+
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                result |= (uint32_t)journal_append(JOURNAL_EVENT_ARM, 0u,
+                        (uint16_t)i, i);
+        }
+        sink = result;
+}
+
+/**
+ * \brief Encodes telemetry frames with the maximum payload
+ *
+ * \param[in] iterations Number of frames
+ */
+static void telemetry_frame(uint32_t iterations)
+{
+        uint8_t payload[TELEMETRY_MAXIMUM_PAYLOAD];
+        uint8_t encoded[TELEMETRY_ENCODED_MAXIMUM_SIZE];
+        uint32_t result = 0u;
+
+        for (uint32_t i = 0u; i < TELEMETRY_MAXIMUM_PAYLOAD; ++i) {
+                payload[i] = (uint8_t)i;
+        }
+        for (uint32_t i = 0u; i < iterations; ++i) {
+                result += telemetry_encode(TELEMETRY_RECORD_STATE, (uint8_t)i,
+                        payload, TELEMETRY_MAXIMUM_PAYLOAD, encoded);
+        }
+        sink = result;
+}
+
+/// Benchmark cases in the order of the output
+static bench_case_t const cases[BENCH_CASES] = {
+        { "loop_read", loop_read, FAST_ITERATIONS, false },
+        { "input_scan", input_scan, FAST_ITERATIONS, false },
+        { "debounce_step", debounce_step, FAST_ITERATIONS, false },
+        { "debounce_naive", debounce_naive, FAST_ITERATIONS, false },
+        { "alarm_step", alarm_step, FAST_ITERATIONS, false },
+        { "crc_record", crc_record, FAST_ITERATIONS, false },
+        { "journal_append", journal_append_record, APPEND_ITERATIONS, true },
+        { "telemetry_encode", telemetry_frame, ENCODE_ITERATIONS, false }
+};
+
+/**
+ * \brief Appends a decimal number to a text buffer
+ *
+ * \param[in,out] text Text buffer position
+ * \param[in] value Value to append
+ *
+ * \return Position after the appended number
+ */
+static char *append_number(char *text, uint32_t value)
+{
+        char digits[10];
+        uint32_t length = 0u;
+
+        do {
+                digits[length++] = (char)('0' + (value % 10u));
+                value /= 10u;
+        } while (value);
+
+        while (length) {
+                *text++ = digits[--length];
+        }
+
+        return text;
+}
+
+/**
+ * \brief Appends a text to a text buffer
+ *
+ * \param[in,out] text Text buffer position
+ * \param[in] source Zero terminated text to append
+ *
+ * \return Position after the appended text
+ */
+static char *append_text(char *text, char const *source)
+{
+        while (*source) {
+                *text++ = *source++;
+        }
+
+        return text;
+}
+
+void bench_run(bench_timer_t const *timer, char const *clock, bool flash,
+        bench_write_t write)
+{
+        char line[RESULT_LINE_LENGTH];
+        uint32_t overhead;
+        uint32_t start;
+        uint32_t ticks;
+
+        // Cost of the two counter reads around each case
+        start = timer->read();
+        overhead = (timer->read() - start) & timer->mask;
+
+        for (uint32_t index = 0u; index < BENCH_CASES; ++index) {
+                bench_case_t const *bench = &cases[index];
+                char *text = line;
+
+                if (bench->flash && !flash) {
+                        continue;
+                }
+
+                start = timer->read();
+                bench->run(bench->iterations);
+                ticks = (timer->read() - start) & timer->mask;
+                ticks = (ticks > overhead) ? (ticks - overhead) : 0u;
+
+                text = append_text(text, "bench ");
+                text = append_text(text, clock);
+                text = append_text(text, " ");
+                text = append_text(text, bench->name);
+                text = append_text(text, " ");
+                text = append_number(text, bench->iterations);
+                text = append_text(text, " ");
+                text = append_number(text, ticks);
+                text = append_text(text, " ");
+                text = append_number(text, timer->frequency);
+                text = append_text(text, "\r\n");
+                *text = '\0';
+
+                write(line);
+        }
+}
+
+/** @} */
+
+/* EOF */
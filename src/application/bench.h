@@ -0,0 +1,113 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       bench.h
+ * \defgroup   bench Microbenchmark suite
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Times the operations on the alarm path with a free running counter: a
+ * single loop read, a scan of all the 24 inputs, a debouncer step, the same
+ * step with per-signal counters for comparison, an alarm state machine
+ * step, the CRC of a journal record, a journal append and the encoding of a
+ * telemetry frame.
+ *
+ * Each case runs a fixed number of iterations between two counter reads,
+ * and the cost of the counter reads is subtracted. The counter must not
+ * wrap more than once during a case. The results are written as text, one
+ * line per case:
+ *
+ *     bench <clock> <case> <iterations> <ticks> <tick_hz>
+ *
+ * where ticks is the total for all the iterations and tick_hz the counter
+ * frequency. The same suite runs on the target with the SysTick counter
+ * (src/bench_main.c) and in the host simulation (host/sim/ba8_bench.c).
+ *
+ * The drivers, the flash and the journal must be initialized before running
+ * the suite. The journal append case writes records into the journal.
+ *
+ * @{
+ */
+
+/// Number of the benchmark cases
+#define BENCH_CASES 8u
+
+/**
+ * \brief Free running counter
+ */
+typedef struct {
+        /// Reads the counter, which counts up
+        uint32_t (*read)(void);
+        /// Mask of the valid counter bits
+        uint32_t mask;
+        /// Counter frequency in Hz
+        uint32_t frequency;
+} bench_timer_t;
+
+/**
+ * \brief Text output function for the results
+ *
+ * \param[in] text Zero terminated text
+ */
+typedef void (*bench_write_t)(char const *text);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Runs all the benchmark cases
+ *
+ * \param[in] timer Counter to time the cases with
+ * \param[in] clock Name of the clock configuration for the result lines
+ * \param[in] flash False to skip the cases that program the flash, e.g. in
+ *            VLPR where the flash cannot be programmed
+ * \param[in] write Text output function
+ */
+void bench_run(bench_timer_t const *timer, char const *clock, bool flash,
+        bench_write_t write);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef BENCH_H
+
+/* EOF */
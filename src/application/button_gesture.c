@@ -0,0 +1,184 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "button_gesture.h"
+
+/**
+ * \file       button_gesture.c
+ * \defgroup   button-gesture-implementation Gesture engine implementation
+ * \ingroup    button-gesture
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Saturation value of the tick counters
+#define TICKS_MAX 0xFFFFu
+
+/**
+ * \brief Counts the buttons in a bitmap
+ *
+ * \param[in] buttons Button bitmap
+ *
+ * \return Number of set bits
+ */
+static inline uint32_t count_buttons(uint32_t buttons)
+{
+        buttons = buttons - ((buttons >> 1u) & 0x55u);
+        buttons = (buttons & 0x33u) + ((buttons >> 2u) & 0x33u);
+        return (buttons + (buttons >> 4u)) & 0x0Fu;
+}
+
+/**
+ * \brief Appends an event to the event buffer if the button bitmap is not empty
+ *
+ * \param[out] events Event buffer
+ * \param[in] count Number of events in the buffer
+ * \param[in] type Gesture type
+ * \param[in] buttons Buttons involved
+ *
+ * \return New number of events in the buffer
+ */
+static inline uint32_t add_event(button_gesture_event_t *events,
+        uint32_t count, button_gesture_type_t type, uint32_t buttons)
+{
+        if (buttons) {
+                events[count].type = (uint8_t)type;
+                events[count].buttons = (uint8_t)buttons;
+                ++count;
+        }
+        return count;
+}
+
+void button_gesture_init(button_gesture_t *gesture)
+{
+        uint32_t i;
+
+        gesture->long_press_ticks = BUTTON_GESTURE_DEFAULT_LONG_PRESS_TICKS;
+        gesture->double_tap_ticks = BUTTON_GESTURE_DEFAULT_DOUBLE_TAP_TICKS;
+        gesture->tap_gap_ticks = BUTTON_GESTURE_DEFAULT_TAP_GAP_TICKS;
+        gesture->pressed = 0u;
+        gesture->long_pressed = 0u;
+        gesture->double_tapped = 0u;
+        gesture->tap_armed = 0u;
+        gesture->chord = 0u;
+        for (i = 0u; i < BA8_MAXIMUM_LOOPS; ++i) {
+                gesture->ticks[i] = TICKS_MAX;
+        }
+}
+
+uint32_t button_gesture_step(button_gesture_t *gesture, uint8_t pressed,
+        button_gesture_event_t *events)
+{
+        uint32_t const changed = (uint32_t)(pressed ^ gesture->pressed);
+        uint32_t const down = changed & pressed;
+        uint32_t const up = changed & gesture->pressed;
+        uint32_t long_press = 0u;
+        uint32_t double_tap = 0u;
+        uint32_t chord = 0u;
+        uint32_t taps = 0u;
+        uint32_t count = 0u;
+        uint32_t i;
+
+        // Update the tick counters. Only the buttons which are held down or
+        // waiting for a second tap need to be counted.
+        for (i = 0u; i < BA8_MAXIMUM_LOOPS; ++i) {
+                uint32_t const bit = 1u << i;
+
+                if (changed & bit) {
+                        // A press within the double tap time after a tap
+                        // completes a double tap, unless the button was
+                        // released for too short a time.
+                        if ((down & gesture->tap_armed & bit) &&
+                                (gesture->ticks[i] >=
+                                gesture->tap_gap_ticks) &&
+                                (gesture->ticks[i] <=
+                                gesture->double_tap_ticks)) {
+                                double_tap |= bit;
+                        }
+                        // A release before the long press time is a tap.
+                        if ((up & bit) && (gesture->ticks[i] <
+                                gesture->long_press_ticks)) {
+                                taps |= bit;
+                        }
+                        gesture->ticks[i] = 0u;
+                } else if ((pressed | gesture->tap_armed) & bit) {
+                        if (gesture->ticks[i] < TICKS_MAX) {
+                                ++gesture->ticks[i];
+                        }
+                        if ((pressed & bit) &&
+                                (gesture->ticks[i] >=
+                                gesture->long_press_ticks)) {
+                                long_press |= bit;
+                        }
+                        if (!(pressed & bit) && (gesture->ticks[i] >
+                                gesture->double_tap_ticks)) {
+                                gesture->tap_armed &= (uint8_t)~bit;
+                        }
+                }
+        }
+
+        // A new press while another button is held down starts or extends a
+        // chord. The buttons of a chord produce no individual gestures until
+        // all of them have been released.
+        if (down && (count_buttons(pressed) >= 2u)) {
+                chord = pressed;
+                gesture->chord |= pressed;
+        }
+        long_press &= ~((uint32_t)gesture->long_pressed | gesture->chord);
+        double_tap &= ~(uint32_t)gesture->chord;
+        taps &= ~((uint32_t)gesture->chord | gesture->double_tapped);
+
+        gesture->long_pressed = (uint8_t)((gesture->long_pressed | long_press) &
+                pressed);
+        gesture->double_tapped = (uint8_t)((gesture->double_tapped |
+                double_tap) & pressed);
+        gesture->tap_armed = (uint8_t)((gesture->tap_armed & ~down) | taps);
+        if (!pressed) {
+                gesture->chord = 0u;
+        }
+        gesture->pressed = pressed;
+
+        count = add_event(events, count, BUTTON_GESTURE_PRESS, down);
+        count = add_event(events, count, BUTTON_GESTURE_RELEASE, up);
+        count = add_event(events, count, BUTTON_GESTURE_LONG_PRESS,
+                long_press);
+        count = add_event(events, count, BUTTON_GESTURE_DOUBLE_TAP,
+                double_tap);
+        count = add_event(events, count, BUTTON_GESTURE_CHORD, chord);
+
+        return count;
+}
+
+/** @} */
+
+/* EOF */
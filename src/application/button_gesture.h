@@ -0,0 +1,149 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BUTTON_GESTURE_H
+#define BUTTON_GESTURE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       button_gesture.h
+ * \defgroup   button-gesture Button gesture engine
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Detects presses, releases, long presses, double taps and multi-button
+ * chords of all the buttons from one packed button bitmap per tick.
+ *
+ * The engine is stepped at a fixed tick rate, and all the timing is counted
+ * in ticks, so no timers are needed. Each event carries a bitmap of the
+ * buttons involved, so simultaneous gestures of several buttons produce one
+ * event.
+ *
+ * @{
+ */
+
+/// Maximum number of events produced by one step
+#define BUTTON_GESTURE_MAX_EVENTS 5u
+
+/// Default long press time in ticks
+#define BUTTON_GESTURE_DEFAULT_LONG_PRESS_TICKS 100u
+/// Default maximum time between the taps of a double tap in ticks
+#define BUTTON_GESTURE_DEFAULT_DOUBLE_TAP_TICKS 30u
+/// Default minimum time between the taps of a double tap in ticks
+#define BUTTON_GESTURE_DEFAULT_TAP_GAP_TICKS 2u
+
+/**
+ * \brief Gesture types
+ */
+typedef enum {
+        /// Buttons pressed
+        BUTTON_GESTURE_PRESS = 0,
+        /// Buttons released
+        BUTTON_GESTURE_RELEASE,
+        /// Buttons held down for the long press time
+        BUTTON_GESTURE_LONG_PRESS,
+        /// Buttons tapped twice within the double tap time
+        BUTTON_GESTURE_DOUBLE_TAP,
+        /// Two or more buttons pressed at the same time
+        BUTTON_GESTURE_CHORD
+} button_gesture_type_t;
+
+/**
+ * \brief Gesture event
+ */
+typedef struct {
+        /// Gesture type (see button_gesture_type_t)
+        uint8_t type;
+        /// Buttons involved, where bit n is button n + 1
+        uint8_t buttons;
+} button_gesture_event_t;
+
+/**
+ * \brief Gesture engine state
+ */
+typedef struct {
+        /// Long press time in ticks
+        uint16_t long_press_ticks;
+        /// Maximum time between the taps of a double tap in ticks
+        uint16_t double_tap_ticks;
+        /// Minimum time between the taps of a double tap in ticks, so that
+        /// a bouncing contact is not taken for a double tap
+        uint16_t tap_gap_ticks;
+        /// Button states of the previous step
+        uint8_t pressed;
+        /// Buttons whose long press has been reported during the current hold
+        uint8_t long_pressed;
+        /// Buttons whose double tap has been reported during the current hold
+        uint8_t double_tapped;
+        /// Buttons waiting for the second tap of a double tap
+        uint8_t tap_armed;
+        /// Buttons taking part in the current chord
+        uint8_t chord;
+        /// Ticks since each button was pressed or released
+        uint16_t ticks[BA8_MAXIMUM_LOOPS];
+} button_gesture_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the gesture engine with the default timing
+ *
+ * \param[out] gesture Gesture engine state
+ */
+void button_gesture_init(button_gesture_t *gesture);
+
+/**
+ * \brief Steps the gesture engine by one tick
+ *
+ * \param[in,out] gesture Gesture engine state
+ * \param[in] pressed Button states, where bit n is set when button n + 1 is
+ *            pressed
+ * \param[out] events Buffer for BUTTON_GESTURE_MAX_EVENTS events
+ *
+ * \return Number of events produced
+ */
+uint32_t button_gesture_step(button_gesture_t *gesture, uint8_t pressed,
+        button_gesture_event_t *events);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef BUTTON_GESTURE_H
+
+/* EOF */
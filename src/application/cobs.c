@@ -0,0 +1,106 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "cobs.h"
+
+/**
+ * \file       cobs.c
+ * \defgroup   cobs-implementation COBS implementation
+ * \ingroup    cobs
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Code of a full block, which is not followed by an implicit zero
+#define COBS_FULL_BLOCK 0xFFu
+
+uint32_t cobs_encode(void const *data, uint32_t length, uint8_t *output)
+{
+        uint8_t const *byte = (uint8_t const *)data;
+        uint8_t *code = output;
+        uint8_t *out = output + 1;
+        uint8_t run = 1u;
+
+        while (length--) {
+                if (*byte) {
+                        *out++ = *byte;
+                        ++run;
+                } else {
+                        *code = run;
+                        code = out++;
+                        run = 1u;
+                }
+                ++byte;
+
+                // A full block is closed without an implicit zero. At the end
+                // of the data the final code byte closes it instead.
+                if ((run == COBS_FULL_BLOCK) && length) {
+                        *code = run;
+                        code = out++;
+                        run = 1u;
+                }
+        }
+        *code = run;
+
+        return (uint32_t)(out - output);
+}
+
+mdv_result_t cobs_decode(uint8_t const *input, uint32_t length,
+        uint8_t *output, uint32_t *decoded)
+{
+        uint8_t const *const end = input + length;
+        uint8_t *out = output;
+
+        while (input < end) {
+                uint8_t const code = *input++;
+
+                if (!code || ((uint32_t)(end - input) < code - 1u)) {
+                        return BA8_RESULT_INVALID_PARAMETER;
+                }
+                for (uint8_t i = 1u; i < code; ++i) {
+                        if (!*input) {
+                                return BA8_RESULT_INVALID_PARAMETER;
+                        }
+                        *out++ = *input++;
+                }
+                if ((code != COBS_FULL_BLOCK) && (input < end)) {
+                        *out++ = 0u;
+                }
+        }
+        *decoded = (uint32_t)(out - output);
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,98 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef COBS_H
+#define COBS_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       cobs.h
+ * \defgroup   cobs Consistent overhead byte stuffing
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * COBS encoding removes all the zero bytes from a frame, so that a single
+ * zero byte can be used as an unambiguous frame delimiter on the serial line.
+ * The overhead is one byte per started 254 bytes of data.
+ *
+ * @{
+ */
+
+/// Maximum encoded size of data, excluding the frame delimiter
+#define COBS_ENCODED_SIZE(length) ((length) + (length) / 254u + 1u)
+
+/// Frame delimiter
+#define COBS_DELIMITER 0x00u
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Encodes data
+ *
+ * \param[in] data Data to encode
+ * \param[in] length Length of the data in bytes
+ * \param[out] output Encoded data, at least COBS_ENCODED_SIZE(length) bytes.
+ *             Must not overlap with the data.
+ *
+ * \return Length of the encoded data in bytes, excluding the delimiter
+ */
+uint32_t cobs_encode(void const *data, uint32_t length, uint8_t *output);
+
+/**
+ * \brief Decodes data
+ *
+ * The output may be the same buffer as the input, in which case the frame is
+ * decoded in place.
+ *
+ * \param[in] input Encoded data, excluding the delimiter
+ * \param[in] length Length of the encoded data in bytes
+ * \param[out] output Decoded data, at least length bytes
+ * \param[out] decoded Length of the decoded data in bytes
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The encoded data is corrupted
+ */
+mdv_result_t cobs_decode(uint8_t const *input, uint32_t length,
+        uint8_t *output, uint32_t *decoded);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef COBS_H
+
+/* EOF */
@@ -0,0 +1,170 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config_store.h"
+#include "crc16.h"
+#include "flash_io.h"
+#include "input_debounce.h"
+#include <stddef.h>
+
+/**
+ * \file       config_store.c
+ * \defgroup   config-store-implementation Configuration store implementation
+ * \ingroup    config-store
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Magic number of a configuration image ("BA8C")
+#define IMAGE_MAGIC 0x42413843u
+
+/// Default loop settings
+#define DEFAULT_LOOP { \
+                .enabled = 1u, \
+                .type = CONFIG_LOOP_INSTANT, \
+                .filter = INPUT_DEBOUNCE_DEFAULT_THRESHOLD, \
+                .reserved = 0u, \
+                .entry_delay = 300u, \
+                .reserved_2 = 0u \
+        }
+
+/// Default configuration
+static const config_image_t default_image = {
+        .magic = IMAGE_MAGIC,
+        .version = CONFIG_STORE_VERSION,
+        .size = sizeof(config_image_t),
+        .generation = 0u,
+        .arm_mask = 0u,
+        .glitch_filter = 0u,
+        .reserved = { 0u, 0u },
+        .loops = {
+                DEFAULT_LOOP, DEFAULT_LOOP, DEFAULT_LOOP, DEFAULT_LOOP,
+                DEFAULT_LOOP, DEFAULT_LOOP, DEFAULT_LOOP, DEFAULT_LOOP
+        },
+        .reserved_2 = 0u,
+        .crc = 0u
+};
+
+/// Active configuration image
+static config_image_t const *active;
+/// Sector of the active image, or BA8_FLASH_CONFIG_SECTORS for the defaults
+static uint32_t active_sector;
+
+/**
+ * \brief Gets the image in a sector
+ *
+ * \param[in] sector Sector index
+ *
+ * \return Image in flash
+ */
+static inline config_image_t const *image_of(uint32_t sector)
+{
+        return (config_image_t const *)(BA8_FLASH_CONFIG_START +
+                (sector * BA8_FLASH_SECTOR_SIZE));
+}
+
+/**
+ * \brief Checks whether an image is intact and of the current layout
+ *
+ * \param[in] image Image
+ *
+ * \return True if the image is valid
+ */
+static bool image_valid(config_image_t const *image)
+{
+        return (image->magic == IMAGE_MAGIC) &&
+                (image->version == CONFIG_STORE_VERSION) &&
+                (image->size == sizeof(config_image_t)) &&
+                (image->crc == crc16_update(CRC16_INITIAL_VALUE, image,
+                        offsetof(config_image_t, crc)));
+}
+
+mdv_result_t config_store_init(void)
+{
+        active = &default_image;
+        active_sector = BA8_FLASH_CONFIG_SECTORS;
+
+        for (uint32_t sector = 0u; sector < BA8_FLASH_CONFIG_SECTORS;
+                ++sector) {
+                config_image_t const *image = image_of(sector);
+
+                if (image_valid(image) &&
+                        ((active == &default_image) ||
+                        ((int32_t)(image->generation - active->generation) >
+                        0))) {
+                        active = image;
+                        active_sector = sector;
+                }
+        }
+
+        return MDV_RESULT_OK;
+}
+
+config_image_t const *config_store_get(void)
+{
+        return active;
+}
+
+mdv_result_t config_store_write(config_image_t const *image)
+{
+        uint32_t const sector = (active_sector + 1u) %
+                BA8_FLASH_CONFIG_SECTORS;
+        uint32_t const address = BA8_FLASH_CONFIG_START +
+                (sector * BA8_FLASH_SECTOR_SIZE);
+        config_image_t new_image = *image;
+        mdv_result_t result;
+
+        new_image.magic = IMAGE_MAGIC;
+        new_image.version = CONFIG_STORE_VERSION;
+        new_image.size = sizeof(config_image_t);
+        new_image.generation = active->generation + 1u;
+        new_image.crc = crc16_update(CRC16_INITIAL_VALUE, &new_image,
+                offsetof(config_image_t, crc));
+
+        result = flash_io_erase_sector(address);
+        if (result != MDV_RESULT_OK) {
+                return result;
+        }
+        result = flash_io_program(address, &new_image, sizeof(new_image));
+        if ((result != MDV_RESULT_OK) || !image_valid(image_of(sector))) {
+                return BA8_RESULT_FLASH_ERROR;
+        }
+
+        active = image_of(sector);
+        active_sector = sector;
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,161 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       config_store.h
+ * \defgroup   config-store Configuration store
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Persistent device configuration in two alternately written flash sectors.
+ *
+ * Each sector holds one configuration image with a layout version, a
+ * generation number and a CRC. A new image is always written into the
+ * sector not holding the active image, so a power loss during the write
+ * leaves the active image intact. At startup, the valid image with the
+ * newest generation is selected.
+ *
+ * The configuration is read directly from the memory-mapped flash through
+ * a const pointer, so no RAM is spent on a copy. Without a valid image, the
+ * pointer refers to the built-in defaults, which also live in flash.
+ *
+ * @{
+ */
+
+/// Configuration image layout version
+#define CONFIG_STORE_VERSION 2u
+
+/**
+ * \brief Loop types
+ */
+typedef enum {
+        /// Triggers the alarm instantly
+        CONFIG_LOOP_INSTANT = 0,
+        /// Triggers the alarm after the entry delay
+        CONFIG_LOOP_DELAYED
+} config_loop_type_t;
+
+/**
+ * \brief Loop settings
+ */
+typedef struct {
+        /// Nonzero if the loop is in use
+        uint8_t enabled;
+        /// Loop type
+        uint8_t type;
+        /// Input filter width in samples (1...16), taken 2 ms apart while
+        /// the loop settles
+        uint8_t filter;
+        /// Reserved, 0
+        uint8_t reserved;
+        /// Entry delay in 100 ms steps
+        uint16_t entry_delay;
+        /// Reserved, 0
+        uint16_t reserved_2;
+} config_loop_t;
+
+/**
+ * \brief Configuration image
+ */
+typedef struct {
+        /// Magic number
+        uint32_t magic;
+        /// Layout version
+        uint16_t version;
+        /// Size of the image in bytes
+        uint16_t size;
+        /// Generation, incremented on every write
+        uint32_t generation;
+        /// Loops armed at startup
+        uint8_t arm_mask;
+        /// Loop port groups (alarm_loop_port_group_t) with the input glitch
+        /// filter enabled, bit n for group n
+        uint8_t glitch_filter;
+        /// Reserved, 0
+        uint8_t reserved[2];
+        /// Loop settings
+        config_loop_t loops[BA8_MAXIMUM_LOOPS];
+        /// Reserved, 0
+        uint16_t reserved_2;
+        /// CRC-16 of the preceding fields
+        uint16_t crc;
+} config_image_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the configuration store
+ *
+ * Selects the newest valid configuration image.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t config_store_init(void);
+
+/**
+ * \brief Gets the active configuration
+ *
+ * \return Active configuration image in flash
+ */
+config_image_t const *config_store_get(void);
+
+/**
+ * \brief Writes a new configuration
+ *
+ * Only the settings are taken from the image: the magic number, version,
+ * size, generation and CRC are filled in by the store. The flash driver must
+ * be initialized before this.
+ *
+ * \param[in] image New configuration
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_FLASH_ERROR Erasing or programming the flash failed,
+ *         the active configuration is unchanged
+ */
+mdv_result_t config_store_write(config_image_t const *image);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef CONFIG_STORE_H
+
+/* EOF */
@@ -0,0 +1,320 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "console.h"
+#include "scheduler.h"
+#include "serial_io.h"
+#include <stddef.h>
+
+/**
+ * \file       console.c
+ * \defgroup   console-implementation Console implementation
+ * \ingroup    console
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Command index of an unknown command in the response
+#define COMMAND_UNKNOWN 0xFFu
+/// Length of the response header (command index and result)
+#define RESPONSE_HEADER_SIZE 3u
+
+/// Command table
+static console_command_t const *command_table;
+/// Number of the commands
+static uint8_t command_count;
+/// Receive position of the next unparsed byte
+static uint32_t read_position;
+
+/**
+ * \brief Gets a received byte
+ *
+ * \param[in] position Receive position
+ *
+ * \return Byte at the position
+ */
+static inline uint8_t byte_at(uint32_t position)
+{
+        return serial_io_rx_buffer()[position &
+                (SERIAL_IO_RX_BUFFER_SIZE - 1u)];
+}
+
+/**
+ * \brief Checks if a character separates commands
+ *
+ * \param[in] c Character
+ *
+ * \return True if the character ends a command
+ */
+static inline bool is_command_end(uint8_t c)
+{
+        return (c == '\n') || (c == '\r') || (c == ';');
+}
+
+/**
+ * \brief Checks if a character separates words
+ *
+ * \param[in] c Character
+ *
+ * \return True if the character ends a word
+ */
+static inline bool is_word_end(uint8_t c)
+{
+        return (c == ' ') || (c == '\t') || is_command_end(c);
+}
+
+/**
+ * \brief Skips the spaces between words
+ *
+ * \param[in] position Receive position
+ * \param[in] end End of the received data
+ *
+ * \return Position of the next word or command end
+ */
+static uint32_t skip_spaces(uint32_t position, uint32_t end)
+{
+        while ((position != end) && is_word_end(byte_at(position)) &&
+                !is_command_end(byte_at(position))) {
+                ++position;
+        }
+
+        return position;
+}
+
+/**
+ * \brief Finds the end of a word
+ *
+ * \param[in] position Start of the word
+ * \param[in] end End of the received data
+ *
+ * \return Position after the word
+ */
+static uint32_t word_end(uint32_t position, uint32_t end)
+{
+        while ((position != end) && !is_word_end(byte_at(position))) {
+                ++position;
+        }
+
+        return position;
+}
+
+/**
+ * \brief Finds a command by the name
+ *
+ * \param[in] start Start of the name
+ * \param[in] stop End of the name
+ *
+ * \return Command index, or COMMAND_UNKNOWN if not found
+ */
+static uint8_t find_command(uint32_t start, uint32_t stop)
+{
+        for (uint8_t index = 0u; index < command_count; ++index) {
+                char const *name = command_table[index].name;
+                uint32_t position = start;
+
+                while ((position != stop) && *name &&
+                        ((uint8_t)*name == byte_at(position))) {
+                        ++name;
+                        ++position;
+                }
+                if ((position == stop) && !*name) {
+                        return index;
+                }
+        }
+
+        return COMMAND_UNKNOWN;
+}
+
+/**
+ * \brief Parses a numeric argument
+ *
+ * \param[in] start Start of the argument
+ * \param[in] stop End of the argument
+ * \param[out] value Argument value
+ *
+ * \return True if the argument is a valid number, otherwise false
+ */
+static bool parse_number(uint32_t start, uint32_t stop, uint32_t *value)
+{
+        uint32_t base = 10u;
+        uint32_t result = 0u;
+
+        if ((stop - start > 2u) && (byte_at(start) == '0') &&
+                ((byte_at(start + 1u) | 0x20u) == 'x')) {
+                base = 16u;
+                start += 2u;
+        }
+        if (start == stop) {
+                return false;
+        }
+
+        for (; start != stop; ++start) {
+                uint8_t const c = byte_at(start);
+                uint8_t const lower = c | 0x20u;
+                uint32_t digit;
+
+                if ((c >= '0') && (c <= '9')) {
+                        digit = c - '0';
+                } else if ((base == 16u) && (lower >= 'a') && (lower <= 'f')) {
+                        digit = lower - 'a' + 10u;
+                } else {
+                        return false;
+                }
+                result = result * base + digit;
+        }
+        *value = result;
+
+        return true;
+}
+
+/**
+ * \brief Sends a command response
+ *
+ * \param[in] index Command index
+ * \param[in] result Result of the command
+ * \param[in] data Command specific response data
+ * \param[in] length Length of the response data
+ */
+static void respond(uint8_t index, mdv_result_t result, uint8_t const *data,
+        uint8_t length)
+{
+        uint8_t response[RESPONSE_HEADER_SIZE + CONSOLE_MAXIMUM_RESPONSE];
+
+        response[0] = index;
+        response[1] = (uint8_t)result;
+        response[2] = (uint8_t)((uint32_t)result >> 8u);
+        for (uint8_t i = 0u; i < length; ++i) {
+                response[RESPONSE_HEADER_SIZE + i] = data[i];
+        }
+
+        (void)telemetry_send(TELEMETRY_RECORD_RESPONSE, response,
+                RESPONSE_HEADER_SIZE + length);
+}
+
+/**
+ * \brief Parses and executes one command
+ *
+ * \param[in] position Start of the command name
+ * \param[in] end End of the received data
+ *
+ * \return Position after the command
+ */
+static uint32_t execute(uint32_t position, uint32_t end)
+{
+        uint32_t arguments[CONSOLE_MAXIMUM_ARGUMENTS];
+        uint8_t data[CONSOLE_MAXIMUM_RESPONSE];
+        uint8_t count = 0u;
+        uint8_t length = 0u;
+        uint32_t stop = word_end(position, end);
+        uint8_t const index = find_command(position, stop);
+        mdv_result_t result = MDV_RESULT_OK;
+
+        position = skip_spaces(stop, end);
+        while ((position != end) && !is_command_end(byte_at(position))) {
+                stop = word_end(position, end);
+                if ((count == CONSOLE_MAXIMUM_ARGUMENTS) ||
+                        !parse_number(position, stop, &arguments[count])) {
+                        result = BA8_RESULT_INVALID_PARAMETER;
+                } else {
+                        ++count;
+                }
+                position = skip_spaces(stop, end);
+        }
+
+        if (index == COMMAND_UNKNOWN) {
+                result = BA8_RESULT_INVALID_PARAMETER;
+        } else if (result == MDV_RESULT_OK) {
+                result = command_table[index].handler(arguments, count, data,
+                        &length);
+                if (length > CONSOLE_MAXIMUM_RESPONSE) {
+                        length = CONSOLE_MAXIMUM_RESPONSE;
+                }
+        }
+        respond(index, result, data, length);
+
+        return position;
+}
+
+/**
+ * \brief Handles the serial event
+ */
+static void serial_event(void)
+{
+        uint32_t const end = serial_io_rx_position();
+        uint32_t position = read_position;
+
+        // The receiver has overwritten data which was not parsed yet.
+        if (end - position > SERIAL_IO_RX_BUFFER_SIZE) {
+                read_position = end;
+                respond(COMMAND_UNKNOWN, BA8_RESULT_BUSY, NULL, 0u);
+                return;
+        }
+
+        telemetry_begin_batch();
+        while (position != end) {
+                if (is_word_end(byte_at(position))) {
+                        ++position;
+                } else {
+                        position = execute(position, end);
+                }
+        }
+        telemetry_end_batch();
+
+        read_position = end;
+}
+
+/**
+ * \brief Posts the serial event when the receive line goes idle
+ */
+static void idle_notify(void)
+{
+        scheduler_post(SCHEDULER_EVENT_SERIAL);
+}
+
+mdv_result_t console_init(console_command_t const *commands, uint8_t count)
+{
+        if (!commands || !count) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        command_table = commands;
+        command_count = count;
+        read_position = serial_io_rx_position();
+        (void)scheduler_set_handler(SCHEDULER_EVENT_SERIAL, serial_event);
+        serial_io_set_rx_notify(idle_notify);
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
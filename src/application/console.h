@@ -0,0 +1,116 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "ba8_common.h"
+#include "telemetry.h"
+
+/**
+ * \file       console.h
+ * \defgroup   console Command console
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Text commands received over the serial port.
+ *
+ * A command is a name followed by up to CONSOLE_MAXIMUM_ARGUMENTS numeric
+ * arguments, decimal or hexadecimal with the 0x prefix, separated by spaces.
+ * Commands are separated by a line feed, a carriage return or a semicolon,
+ * and the idle line after a burst of data ends the last command of the
+ * burst. E.g. "arm 0x0F;status" sends two commands.
+ *
+ * The commands are parsed in place in the serial port receive buffer when
+ * the line goes idle, without copying them out. Each command is answered
+ * with a response record in the telemetry stream, and the responses of a
+ * burst are sent out in one transfer.
+ *
+ * @{
+ */
+
+/// Maximum number of command arguments
+#define CONSOLE_MAXIMUM_ARGUMENTS 4u
+/// Maximum length of the command specific response data in bytes
+#define CONSOLE_MAXIMUM_RESPONSE (TELEMETRY_MAXIMUM_PAYLOAD - 3u)
+
+/**
+ * \brief Command handler
+ *
+ * \param[in] arguments Command arguments
+ * \param[in] count Number of the arguments
+ * \param[out] response Command specific response data,
+ *             CONSOLE_MAXIMUM_RESPONSE bytes
+ * \param[out] length Length of the response data, 0 by default
+ *
+ * \return Result of the command, sent in the response
+ */
+typedef mdv_result_t (*console_handler_t)(uint32_t const *arguments,
+        uint8_t count, uint8_t *response, uint8_t *length);
+
+/**
+ * \brief Command
+ */
+typedef struct {
+        /// Command name
+        char const *name;
+        /// Command handler
+        console_handler_t handler;
+} console_command_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the console
+ *
+ * Takes over the serial event of the scheduler. The serial port, the
+ * scheduler and the telemetry stream must be initialized before this.
+ *
+ * \param[in] commands Command table, which must remain valid
+ * \param[in] count Number of the commands (up to 255)
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The command table is NULL or empty
+ */
+mdv_result_t console_init(console_command_t const *commands, uint8_t count);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef CONSOLE_H
+
+/* EOF */
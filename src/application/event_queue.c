@@ -0,0 +1,141 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "event_queue.h"
+#include "telemetry.h"
+#include <string.h>
+
+/**
+ * \file       event_queue.c
+ * \defgroup   event-queue-implementation Event queue implementation
+ * \ingroup    event-queue
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/**
+ * \brief Queued record
+ */
+typedef struct {
+        /// Telemetry record type
+        uint8_t type;
+        /// Length of the payload
+        uint8_t length;
+        /// Payload
+        uint8_t payload[EVENT_QUEUE_MAXIMUM_PAYLOAD];
+} queued_record_t;
+
+/**
+ * \brief Record FIFO of one priority
+ */
+typedef struct {
+        /// Records
+        queued_record_t records[EVENT_QUEUE_DEPTH];
+        /// Index of the oldest record
+        uint8_t head;
+        /// Number of the records
+        uint8_t count;
+        /// Number of dropped records
+        uint32_t dropped;
+} record_fifo_t;
+
+/// Record FIFOs, highest priority first
+static record_fifo_t fifos[EVENT_QUEUE_PRIORITIES];
+
+void event_queue_init(void)
+{
+        memset(fifos, 0, sizeof(fifos));
+}
+
+mdv_result_t event_queue_post(event_queue_priority_t priority, uint8_t type,
+        void const *payload, uint8_t length)
+{
+        record_fifo_t *fifo;
+        queued_record_t *record;
+
+        if ((priority >= EVENT_QUEUE_PRIORITIES) ||
+                (length > EVENT_QUEUE_MAXIMUM_PAYLOAD) ||
+                (!payload && length)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        fifo = &fifos[priority];
+        if (fifo->count == EVENT_QUEUE_DEPTH) {
+                ++fifo->dropped;
+                return BA8_RESULT_BUSY;
+        }
+
+        record = &fifo->records[(fifo->head + fifo->count) % EVENT_QUEUE_DEPTH];
+        record->type = type;
+        record->length = length;
+        if (length) {
+                memcpy(record->payload, payload, length);
+        }
+        ++fifo->count;
+
+        return MDV_RESULT_OK;
+}
+
+void event_queue_flush(void)
+{
+        for (uint8_t priority = 0u; priority < EVENT_QUEUE_PRIORITIES;
+                ++priority) {
+                record_fifo_t *fifo = &fifos[priority];
+
+                while (fifo->count) {
+                        queued_record_t const *record =
+                                &fifo->records[fifo->head];
+
+                        // Lower priorities must not take the space either.
+                        if (!telemetry_has_space(record->length)) {
+                                return;
+                        }
+                        (void)telemetry_send(record->type, record->payload,
+                                record->length);
+                        fifo->head = (fifo->head + 1u) % EVENT_QUEUE_DEPTH;
+                        --fifo->count;
+                }
+        }
+}
+
+uint32_t event_queue_get_dropped(event_queue_priority_t priority)
+{
+        if (priority >= EVENT_QUEUE_PRIORITIES) {
+                return 0u;
+        }
+
+        return fifos[priority].dropped;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,128 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       event_queue.h
+ * \defgroup   event-queue Prioritized event queue
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Outgoing telemetry records queued by priority.
+ *
+ * Each priority has its own small FIFO. When the telemetry buffer has space,
+ * the records are moved into it highest priority first, so a tamper alarm
+ * never waits behind a backlog of lower priority records. A record is only
+ * taken out of the queue once the telemetry stream has accepted it.
+ *
+ * @{
+ */
+
+/// Number of records queued per priority
+#define EVENT_QUEUE_DEPTH 8u
+/// Maximum length of a record payload in bytes
+#define EVENT_QUEUE_MAXIMUM_PAYLOAD 12u
+
+/**
+ * \brief Event priorities, highest first
+ */
+typedef enum {
+        /// Tamper alarm
+        EVENT_QUEUE_TAMPER = 0,
+        /// Alarm
+        EVENT_QUEUE_ALARM,
+        /// Loop fault
+        EVENT_QUEUE_FAULT,
+        /// Informational, e.g. state changes
+        EVENT_QUEUE_INFO,
+        /// Number of the priorities
+        EVENT_QUEUE_PRIORITIES
+} event_queue_priority_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the queue
+ */
+void event_queue_init(void);
+
+/**
+ * \brief Queues a record
+ *
+ * Must not be called from an interrupt handler.
+ *
+ * \param[in] priority Priority of the record
+ * \param[in] type Telemetry record type
+ * \param[in] payload Record payload
+ * \param[in] length Length of the payload in bytes
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The priority is out of range or the
+ *         payload is too long
+ * \retval BA8_RESULT_BUSY The queue of the priority is full and the record
+ *         was dropped
+ */
+mdv_result_t event_queue_post(event_queue_priority_t priority, uint8_t type,
+        void const *payload, uint8_t length);
+
+/**
+ * \brief Moves the queued records into the telemetry stream
+ *
+ * Stops at the first record which does not fit into the telemetry buffer.
+ * Must not be called from an interrupt handler.
+ */
+void event_queue_flush(void);
+
+/**
+ * \brief Gets the number of dropped records
+ *
+ * \param[in] priority Priority
+ *
+ * \return Number of records of the priority dropped since the initialization
+ */
+uint32_t event_queue_get_dropped(event_queue_priority_t priority);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef EVENT_QUEUE_H
+
+/* EOF */
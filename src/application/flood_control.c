@@ -0,0 +1,119 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "flood_control.h"
+
+/**
+ * \file       flood_control.c
+ * \defgroup   flood-control-implementation Flood control implementation
+ * \ingroup    flood-control
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Allowance taken by one edge in timebase ticks
+#define EDGE_COST (TIMEBASE_IO_TICK_FREQUENCY / FLOOD_CONTROL_RATE)
+/// Capacity of a bucket in timebase ticks
+#define BUCKET_CAPACITY (FLOOD_CONTROL_BURST * EDGE_COST)
+
+void flood_control_init(flood_control_t *flood, uint32_t time)
+{
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                flood->credit[loop] = BUCKET_CAPACITY;
+                flood->refill_time[loop] = time;
+                flood->flood_start[loop] = time;
+                flood->suppressed[loop] = 0u;
+        }
+        flood->flooded = 0u;
+}
+
+bool flood_control_edge(flood_control_t *flood, uint8_t loop, uint32_t time)
+{
+        uint8_t const mask = (uint8_t)(1u << loop);
+        uint32_t elapsed;
+
+        if (loop >= BA8_MAXIMUM_LOOPS) {
+                return false;
+        }
+        elapsed = time - flood->refill_time[loop];
+
+        // The allowance grows with time, so the elapsed time is the refill.
+        // The edges come in the order of their timestamps, so the elapsed
+        // time is taken as unsigned. A loop quiet for longer than half of
+        // the timebase wrap-around is then refilled like any other.
+        flood->refill_time[loop] = time;
+        if (elapsed >= BUCKET_CAPACITY - flood->credit[loop]) {
+                flood->credit[loop] = BUCKET_CAPACITY;
+        } else {
+                flood->credit[loop] += elapsed;
+        }
+
+        if (flood->flooded & mask) {
+                ++flood->suppressed[loop];
+                return false;
+        }
+        if (flood->credit[loop] >= EDGE_COST) {
+                flood->credit[loop] -= EDGE_COST;
+                return true;
+        }
+
+        flood->flooded |= mask;
+        flood->flood_start[loop] = time;
+        flood->suppressed[loop] = 1u;
+
+        return false;
+}
+
+bool flood_control_end(flood_control_t *flood, uint32_t time,
+        flood_control_summary_t *summary)
+{
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                uint32_t const duration = time - flood->flood_start[loop];
+
+                if (!(flood->flooded & (1u << loop)) ||
+                        (duration < FLOOD_CONTROL_WINDOW)) {
+                        continue;
+                }
+
+                flood->flooded &= (uint8_t)~(1u << loop);
+                summary->loop = loop;
+                summary->edges = flood->suppressed[loop];
+                summary->duration = duration;
+                return true;
+        }
+
+        return false;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,141 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FLOOD_CONTROL_H
+#define FLOOD_CONTROL_H
+
+#include "ba8_common.h"
+#include "timebase_io.h"
+
+/**
+ * \file       flood_control.h
+ * \defgroup   flood-control Loop edge flood control
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Per-loop rate limiting of the reported loop edges.
+ *
+ * Each loop has a token bucket holding up to FLOOD_CONTROL_BURST edges,
+ * refilled at FLOOD_CONTROL_RATE edges per second. An edge which finds the
+ * bucket empty starts a flood: the loop is marked as flooded, and its edges
+ * are only counted until FLOOD_CONTROL_WINDOW has passed. The flood then
+ * ends with one summary of the suppressed edges, e.g. "loop 5: 1834 toggles
+ * in 2 s", and a loop still chattering starts a new flood with its next
+ * edge.
+ *
+ * Only the reporting is limited. The alarm evaluation still sees every loop
+ * state.
+ *
+ * @{
+ */
+
+/// Number of edges passed in a burst
+#define FLOOD_CONTROL_BURST 8u
+/// Sustained edge rate in edges per second
+#define FLOOD_CONTROL_RATE 10u
+/// Length of a flood in timebase ticks (2 s)
+#define FLOOD_CONTROL_WINDOW (2u * TIMEBASE_IO_TICK_FREQUENCY)
+
+/**
+ * \brief Flood control state
+ */
+typedef struct {
+        /// Edge allowance per loop in timebase ticks
+        uint32_t credit[BA8_MAXIMUM_LOOPS];
+        /// Time of the last refill per loop
+        uint32_t refill_time[BA8_MAXIMUM_LOOPS];
+        /// Start time of the flood per loop
+        uint32_t flood_start[BA8_MAXIMUM_LOOPS];
+        /// Number of suppressed edges per loop
+        uint32_t suppressed[BA8_MAXIMUM_LOOPS];
+        /// Flooded loops
+        uint8_t flooded;
+} flood_control_t;
+
+/**
+ * \brief Flood summary
+ */
+typedef struct {
+        /// Loop index, where 0 is loop 1
+        uint8_t loop;
+        /// Number of suppressed edges
+        uint32_t edges;
+        /// Duration of the flood in timebase ticks
+        uint32_t duration;
+} flood_control_summary_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the flood control with full buckets
+ *
+ * \param[out] flood Flood control state
+ * \param[in] time Current time
+ */
+void flood_control_init(flood_control_t *flood, uint32_t time);
+
+/**
+ * \brief Accounts a loop edge
+ *
+ * \param[in,out] flood Flood control state
+ * \param[in] loop Loop index, where 0 is loop 1
+ * \param[in] time Time of the edge
+ *
+ * \return True if the edge should be reported, false if it was suppressed
+ */
+bool flood_control_edge(flood_control_t *flood, uint8_t loop, uint32_t time);
+
+/**
+ * \brief Ends a flood whose window has passed
+ *
+ * Call repeatedly until it returns false.
+ *
+ * \param[in,out] flood Flood control state
+ * \param[in] time Current time
+ * \param[out] summary Summary of the ended flood
+ *
+ * \return True if a flood ended, otherwise false
+ */
+bool flood_control_end(flood_control_t *flood, uint32_t time,
+        flood_control_summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef FLOOD_CONTROL_H
+
+/* EOF */
@@ -0,0 +1,121 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "input_debounce.h"
+
+/**
+ * \file       input_debounce.c
+ * \defgroup   input-debounce-implementation Debouncer implementation
+ * \ingroup    input-debounce
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+// The counter update in input_debounce_step() is unrolled for four planes.
+#if INPUT_DEBOUNCE_COUNTER_PLANES != 4u
+#error "input_debounce_step() supports only four counter planes"
+#endif
+
+void input_debounce_init(input_debounce_t *debounce, uint32_t initial_state)
+{
+        uint32_t i;
+
+        debounce->state = initial_state;
+        for (i = 0u; i < INPUT_DEBOUNCE_COUNTER_PLANES; ++i) {
+                debounce->counter[i] = 0u;
+                debounce->threshold[i] = 0u;
+        }
+
+        input_debounce_set_threshold(debounce, 0xFFFFFFFFu,
+                INPUT_DEBOUNCE_DEFAULT_THRESHOLD);
+}
+
+void input_debounce_set_threshold(input_debounce_t *debounce, uint32_t mask,
+        uint32_t samples)
+{
+        uint32_t i;
+
+        if (samples < 1u) {
+                samples = 1u;
+        } else if (samples > INPUT_DEBOUNCE_MAXIMUM_THRESHOLD) {
+                samples = INPUT_DEBOUNCE_MAXIMUM_THRESHOLD;
+        }
+
+        // The counters wrap around to zero when reaching the maximum
+        // threshold, so the maximum is stored as zero.
+        for (i = 0u; i < INPUT_DEBOUNCE_COUNTER_PLANES; ++i) {
+                if ((samples >> i) & 1u) {
+                        debounce->threshold[i] |= mask;
+                } else {
+                        debounce->threshold[i] &= ~mask;
+                }
+                debounce->counter[i] &= ~mask;
+        }
+}
+
+uint32_t input_debounce_step(input_debounce_t *debounce, uint32_t sample)
+{
+        uint32_t const delta = sample ^ debounce->state;
+        uint32_t c0 = debounce->counter[0] & delta;
+        uint32_t c1 = debounce->counter[1] & delta;
+        uint32_t c2 = debounce->counter[2] & delta;
+        uint32_t c3 = debounce->counter[3] & delta;
+        uint32_t carry;
+        uint32_t reached;
+
+        // Increment the counters of the signals differing from the debounced
+        // state. The counters of the other signals were reset above.
+        carry = c0 & delta;
+        c0 ^= delta;
+        c3 ^= c2 & c1 & carry;
+        c2 ^= c1 & carry;
+        c1 ^= carry;
+
+        // Compare all the counters with their thresholds.
+        reached = delta & ~((c0 ^ debounce->threshold[0]) |
+                (c1 ^ debounce->threshold[1]) |
+                (c2 ^ debounce->threshold[2]) |
+                (c3 ^ debounce->threshold[3]));
+
+        debounce->state ^= reached;
+        debounce->counter[0] = c0 & ~reached;
+        debounce->counter[1] = c1 & ~reached;
+        debounce->counter[2] = c2 & ~reached;
+        debounce->counter[3] = c3 & ~reached;
+
+        return reached;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,150 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INPUT_DEBOUNCE_H
+#define INPUT_DEBOUNCE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       input_debounce.h
+ * \defgroup   input-debounce Input debouncer
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Bit-parallel debouncer for all the alarm, shield alarm and button inputs.
+ *
+ * The input signals are packed into one 32-bit word and filtered with
+ * vertical counters, i.e. bit n of each counter plane holds one bit of the
+ * counter of signal n. A signal changes its debounced state when it has
+ * differed from the current state for a configurable number of consecutive
+ * samples. The whole word is processed with a fixed sequence of logical
+ * operations, regardless of the number of signals or their thresholds.
+ *
+ * @{
+ */
+
+/// Bit position of the loop 1 alarm signal in the input word
+#define INPUT_DEBOUNCE_ALARM_SHIFT 0u
+/// Bit position of the loop 1 shield alarm signal in the input word
+#define INPUT_DEBOUNCE_SHIELD_SHIFT 8u
+/// Bit position of the button 1 signal in the input word
+#define INPUT_DEBOUNCE_BUTTON_SHIFT 16u
+
+/// Mask for all the alarm signals in the input word
+#define INPUT_DEBOUNCE_ALARM_MASK (0xFFu << INPUT_DEBOUNCE_ALARM_SHIFT)
+/// Mask for all the shield alarm signals in the input word
+#define INPUT_DEBOUNCE_SHIELD_MASK (0xFFu << INPUT_DEBOUNCE_SHIELD_SHIFT)
+/// Mask for all the button signals in the input word
+#define INPUT_DEBOUNCE_BUTTON_MASK (0xFFu << INPUT_DEBOUNCE_BUTTON_SHIFT)
+
+/// Number of vertical counter bit planes
+#define INPUT_DEBOUNCE_COUNTER_PLANES 4u
+/// Maximum threshold in samples
+#define INPUT_DEBOUNCE_MAXIMUM_THRESHOLD (1u << INPUT_DEBOUNCE_COUNTER_PLANES)
+/// Default threshold in samples
+#define INPUT_DEBOUNCE_DEFAULT_THRESHOLD 4u
+
+/**
+ * \brief Debouncer state
+ */
+typedef struct {
+        /// Debounced signal states
+        uint32_t state;
+        /// Vertical counter bit planes
+        uint32_t counter[INPUT_DEBOUNCE_COUNTER_PLANES];
+        /// Threshold bit planes
+        uint32_t threshold[INPUT_DEBOUNCE_COUNTER_PLANES];
+} input_debounce_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the debouncer
+ *
+ * All the signals get the default threshold.
+ *
+ * \param[out] debounce Debouncer state
+ * \param[in] initial_state Initial debounced signal states
+ */
+void input_debounce_init(input_debounce_t *debounce, uint32_t initial_state);
+
+/**
+ * \brief Sets the threshold for a group of signals
+ *
+ * \param[in,out] debounce Debouncer state
+ * \param[in] mask Signals to set
+ * \param[in] samples Number of consecutive samples required for a state change
+ *            (1...INPUT_DEBOUNCE_MAXIMUM_THRESHOLD)
+ */
+void input_debounce_set_threshold(input_debounce_t *debounce, uint32_t mask,
+        uint32_t samples);
+
+/**
+ * \brief Feeds one sample of all the signals into the debouncer
+ *
+ * \param[in,out] debounce Debouncer state
+ * \param[in] sample Raw signal states
+ *
+ * \return Mask of the signals whose debounced state changed
+ */
+uint32_t input_debounce_step(input_debounce_t *debounce, uint32_t sample);
+
+/**
+ * \brief Packs the loop and button states into an input word
+ *
+ * \param[in] alarm Alarm signal states
+ * \param[in] shield Shield alarm signal states
+ * \param[in] buttons Button signal states
+ *
+ * \return Input word
+ */
+static inline uint32_t input_debounce_pack(uint8_t alarm, uint8_t shield,
+        uint8_t buttons)
+{
+        return ((uint32_t)alarm << INPUT_DEBOUNCE_ALARM_SHIFT) |
+                ((uint32_t)shield << INPUT_DEBOUNCE_SHIELD_SHIFT) |
+                ((uint32_t)buttons << INPUT_DEBOUNCE_BUTTON_SHIFT);
+}
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef INPUT_DEBOUNCE_H
+
+/* EOF */
@@ -32,6 +32,7 @@
  */
 
 #include "alarm_loop_io.h"
+#include "timebase_io.h"
 #include "fsl_clock.h"
 #include "fsl_port.h"
 #include "fsl_gpio.h"
@@ -93,6 +94,39 @@
 /// Pin for loop 8  shield alarm input (port D)
 #define LOOP_8_SHIELD_ALARM_INPUT_PIN 6u
 
+// The snapshot packing relies on the loop pins being interleaved as shield
+// and alarm pairs on consecutive pins, starting from PTC4 and PTD0.
+#if (LOOP_1_SHIELD_ALARM_INPUT_PIN != 4u) || (LOOP_1_ALARM_INPUT_PIN != 5u) || \
+    (LOOP_2_SHIELD_ALARM_INPUT_PIN != 6u) || (LOOP_2_ALARM_INPUT_PIN != 7u) || \
+    (LOOP_3_SHIELD_ALARM_INPUT_PIN != 8u) || (LOOP_3_ALARM_INPUT_PIN != 9u) || \
+    (LOOP_4_SHIELD_ALARM_INPUT_PIN != 10u) || (LOOP_4_ALARM_INPUT_PIN != 11u) || \
+    (LOOP_5_SHIELD_ALARM_INPUT_PIN != 0u) || (LOOP_5_ALARM_INPUT_PIN != 1u) || \
+    (LOOP_6_SHIELD_ALARM_INPUT_PIN != 2u) || (LOOP_6_ALARM_INPUT_PIN != 3u) || \
+    (LOOP_7_SHIELD_ALARM_INPUT_PIN != 4u) || (LOOP_7_ALARM_INPUT_PIN != 5u) || \
+    (LOOP_8_SHIELD_ALARM_INPUT_PIN != 6u) || (LOOP_8_ALARM_INPUT_PIN != 7u)
+#error "Loop pin layout does not match alarm_loop_io_snapshot() packing"
+#endif
+
+/// First pin of the loop 1, 2, 3 and 4 signal pairs (port C)
+#define LOOPS_1_2_3_4_FIRST_PIN LOOP_1_SHIELD_ALARM_INPUT_PIN
+/// First pin of the loop 5, 6, 7 and 8 signal pairs (port D)
+#define LOOPS_5_6_7_8_FIRST_PIN LOOP_5_SHIELD_ALARM_INPUT_PIN
+/// Mask for the signal pairs of four loops
+#define LOOP_SIGNAL_PAIRS_MASK 0xFFu
+/// Number of signal pins per loop port
+#define LOOP_SIGNAL_PINS_PER_PORT 8u
+
+/// Index mask for the edge queue
+#define EDGE_QUEUE_INDEX_MASK (ALARM_LOOP_EDGE_QUEUE_LENGTH - 1u)
+/// De Bruijn sequence for finding the index of an isolated bit
+#define DE_BRUIJN_SEQUENCE 0x077CB531u
+/// Shift for getting the de Bruijn table index from the multiplied value
+#define DE_BRUIJN_SHIFT 27u
+
+#if (ALARM_LOOP_EDGE_QUEUE_LENGTH & EDGE_QUEUE_INDEX_MASK) != 0u
+#error "ALARM_LOOP_EDGE_QUEUE_LENGTH must be a power of two"
+#endif
+
 /// Port pin pull-up configuration
 #define PIN_PULL_UP_ENABLED 0
 /// Port pin slew rate select
@@ -102,13 +136,38 @@
 /// Port pin drive strength selection
 #define PIN_DRIVE_STRENGTH_FAST 0
 
-/// Common port pin configuration for all loop inputs and outputs
-static const port_pin_config_t pin_config = {
-        .pullSelect = PIN_PULL_UP_ENABLED,
-        .slewRate = PIN_SLEW_RATE_FAST,
-        .passiveFilterEnable = PIN_PASSIVE_FILTER_DISABLED,
-        .driveStrength = PIN_DRIVE_STRENGTH_FAST,
-        .mux = kPORT_MuxAsGpio
+/// Port pin configurations for the loop inputs of each port group
+static port_pin_config_t pin_config[ALARM_LOOP_PORT_GROUPS] = {
+        {
+                .pullSelect = PIN_PULL_UP_ENABLED,
+                .slewRate = PIN_SLEW_RATE_FAST,
+                .passiveFilterEnable = PIN_PASSIVE_FILTER_DISABLED,
+                .driveStrength = PIN_DRIVE_STRENGTH_FAST,
+                .mux = kPORT_MuxAsGpio
+        },
+        {
+                .pullSelect = PIN_PULL_UP_ENABLED,
+                .slewRate = PIN_SLEW_RATE_FAST,
+                .passiveFilterEnable = PIN_PASSIVE_FILTER_DISABLED,
+                .driveStrength = PIN_DRIVE_STRENGTH_FAST,
+                .mux = kPORT_MuxAsGpio
+        }
+};
+
+/// Ports of each port group
+static PORT_Type * const group_port[ALARM_LOOP_PORT_GROUPS] = {
+        PORT_FOR_LOOPS_1_2_3_4, PORT_FOR_LOOPS_5_6_7_8
+};
+
+/// GPIOs of each port group
+static GPIO_Type * const group_gpio[ALARM_LOOP_PORT_GROUPS] = {
+        GPIO_FOR_LOOPS_1_2_3_4, GPIO_FOR_LOOPS_5_6_7_8
+};
+
+/// Loop signal pin masks of each port group
+static const uint32_t group_pin_mask[ALARM_LOOP_PORT_GROUPS] = {
+        LOOP_SIGNAL_PAIRS_MASK << LOOPS_1_2_3_4_FIRST_PIN,
+        LOOP_SIGNAL_PAIRS_MASK << LOOPS_5_6_7_8_FIRST_PIN
 };
 
 /// Common GPIO configuration for all loop input pins
@@ -116,6 +175,66 @@ static const gpio_pin_config_t gpio_input_config = {
         .pinDirection = kGPIO_DigitalInput
 };
 
+/**
+ * \brief Signal pair positions indexed by de Bruijn hash of an isolated bit
+ *
+ * Maps the lowest set bit of a signal pair word directly to its bit position,
+ * where position / 2 is the loop index and position % 2 is the signal type.
+ * Cortex-M0+ has no count-leading-zeros instruction, so this avoids testing
+ * the flags pin by pin in the interrupt handler.
+ */
+static const uint8_t edge_source_table[32] = {
+        0u, 1u, 28u, 2u, 29u, 14u, 24u, 3u, 30u, 22u, 20u, 15u, 25u, 17u, 4u,
+        8u, 31u, 27u, 13u, 23u, 21u, 19u, 16u, 7u, 26u, 12u, 18u, 6u, 11u, 5u,
+        10u, 9u
+};
+
+/// Edge queue
+static alarm_loop_edge_t edge_queue[ALARM_LOOP_EDGE_QUEUE_LENGTH];
+/// Edge queue write index, written only by the interrupt handler
+static volatile uint32_t edge_queue_head;
+/// Edge queue read index, written only by the queue reader
+static volatile uint32_t edge_queue_tail;
+/// Number of edges lost because of a full queue
+static volatile uint32_t lost_edges;
+/// Edge notification callback
+static alarm_loop_edge_notify_t volatile edge_notify;
+
+/**
+ * \brief Combines the loop signal bits of ports C and D into one word
+ *
+ * \param[in] port_c Port C register value
+ * \param[in] port_d Port D register value
+ *
+ * \return Signal pairs, where even bits are shield alarm signals and odd bits
+ *         are alarm signals in loop order
+ */
+static inline uint32_t loop_signal_pairs(uint32_t port_c, uint32_t port_d)
+{
+        return ((port_c >> LOOPS_1_2_3_4_FIRST_PIN) & LOOP_SIGNAL_PAIRS_MASK) |
+                (((port_d >> LOOPS_5_6_7_8_FIRST_PIN) &
+                LOOP_SIGNAL_PAIRS_MASK) << 8u);
+}
+
+/**
+ * \brief Sets the interrupt configuration of all loop signal pins
+ *
+ * \param[in] config Interrupt configuration
+ */
+static void set_loop_pins_interrupt_config(port_interrupt_t config)
+{
+        uint32_t i;
+
+        // This device has no global interrupt control registers, so the pins
+        // have to be configured one by one.
+        for (i = 0u; i < LOOP_SIGNAL_PINS_PER_PORT; ++i) {
+                PORT_SetPinInterruptConfig(PORT_FOR_LOOPS_1_2_3_4,
+                        LOOPS_1_2_3_4_FIRST_PIN + i, config);
+                PORT_SetPinInterruptConfig(PORT_FOR_LOOPS_5_6_7_8,
+                        LOOPS_5_6_7_8_FIRST_PIN + i, config);
+        }
+}
+
 /**
  * \brief Initialize loop 1 alarm input
  *
@@ -124,7 +243,7 @@ static const gpio_pin_config_t gpio_input_config = {
 static mdv_result_t loop_1_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_1_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_1_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -160,7 +279,7 @@ static uint32_t loop_1_alarm_input_get(void)
 static mdv_result_t loop_2_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_2_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_2_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -196,7 +315,7 @@ static uint32_t loop_2_alarm_input_get(void)
 static mdv_result_t loop_3_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_3_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_3_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -232,7 +351,7 @@ static uint32_t loop_3_alarm_input_get(void)
 static mdv_result_t loop_4_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_4_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_4_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -268,7 +387,7 @@ static uint32_t loop_4_alarm_input_get(void)
 static mdv_result_t loop_5_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_5_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_5_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -304,7 +423,7 @@ static uint32_t loop_5_alarm_input_get(void)
 static mdv_result_t loop_6_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_6_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_6_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -340,7 +459,7 @@ static uint32_t loop_6_alarm_input_get(void)
 static mdv_result_t loop_7_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_7_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_7_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -376,7 +495,7 @@ static uint32_t loop_7_alarm_input_get(void)
 static mdv_result_t loop_8_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_8_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_8_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -412,7 +531,7 @@ static uint32_t loop_8_alarm_input_get(void)
 static mdv_result_t loop_1_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_1_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_1_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -449,7 +568,7 @@ static uint32_t loop_1_shield_alarm_input_get(void)
 static mdv_result_t loop_2_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_2_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
         GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_2_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -485,9 +604,9 @@ static uint32_t loop_2_shield_alarm_input_get(void)
  */
 static mdv_result_t loop_3_shield_alarm_input_init(void)
 {
-        PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_3_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
-        GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_3_SHIELD_ALARM_INPUT_PIN,
+        PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_3_SHIELD_ALARM_INPUT_PIN,
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
+        GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_3_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
         return MDV_RESULT_OK;
@@ -511,7 +630,7 @@ static mdv_result_t loop_3_shield_alarm_input_uninit(void)
  */
 static uint32_t loop_3_shield_alarm_input_get(void)
 {
-        return GPIO_PinRead(GPIO_FOR_LOOPS_5_6_7_8,
+        return GPIO_PinRead(GPIO_FOR_LOOPS_1_2_3_4,
                 LOOP_3_SHIELD_ALARM_INPUT_PIN);
 }
 
@@ -522,9 +641,9 @@ static uint32_t loop_3_shield_alarm_input_get(void)
  */
 static mdv_result_t loop_4_shield_alarm_input_init(void)
 {
-        PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_4_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
-        GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_4_SHIELD_ALARM_INPUT_PIN,
+        PORT_SetPinConfig(PORT_FOR_LOOPS_1_2_3_4, LOOP_4_SHIELD_ALARM_INPUT_PIN,
+                &pin_config[ALARM_LOOP_PORT_GROUP_1_2_3_4]);
+        GPIO_PinInit(GPIO_FOR_LOOPS_1_2_3_4, LOOP_4_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
         return MDV_RESULT_OK;
@@ -548,7 +667,7 @@ static mdv_result_t loop_4_shield_alarm_input_uninit(void)
  */
 static uint32_t loop_4_shield_alarm_input_get(void)
 {
-        return GPIO_PinRead(GPIO_FOR_LOOPS_5_6_7_8,
+        return GPIO_PinRead(GPIO_FOR_LOOPS_1_2_3_4,
                 LOOP_4_SHIELD_ALARM_INPUT_PIN);
 }
 
@@ -560,7 +679,7 @@ static uint32_t loop_4_shield_alarm_input_get(void)
 static mdv_result_t loop_5_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_5_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_5_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -597,7 +716,7 @@ static uint32_t loop_5_shield_alarm_input_get(void)
 static mdv_result_t loop_6_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_6_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_6_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -634,7 +753,7 @@ static uint32_t loop_6_shield_alarm_input_get(void)
 static mdv_result_t loop_7_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_7_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_7_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -671,7 +790,7 @@ static uint32_t loop_7_shield_alarm_input_get(void)
 static mdv_result_t loop_8_shield_alarm_input_init(void)
 {
         PORT_SetPinConfig(PORT_FOR_LOOPS_5_6_7_8, LOOP_8_SHIELD_ALARM_INPUT_PIN,
-                &pin_config);
+                &pin_config[ALARM_LOOP_PORT_GROUP_5_6_7_8]);
         GPIO_PinInit(GPIO_FOR_LOOPS_5_6_7_8, LOOP_8_SHIELD_ALARM_INPUT_PIN,
                 &gpio_input_config);
 
@@ -744,9 +863,181 @@ mdv_result_t alarm_loop_io_init(void)
         CLOCK_EnableClock(PORT_CLOCK_FOR_LOOPS_1_2_3_4);
         CLOCK_EnableClock(PORT_CLOCK_FOR_LOOPS_5_6_7_8);
 
+        // Configure all the loop pins of a port at once. The pins are made
+        // inputs before they are muxed to the GPIO.
+        for (uint32_t group = 0u; group < ALARM_LOOP_PORT_GROUPS; ++group) {
+                group_gpio[group]->PDDR &= ~group_pin_mask[group];
+                PORT_SetMultiplePinsConfig(group_port[group],
+                        group_pin_mask[group], &pin_config[group]);
+        }
+
+        return MDV_RESULT_OK;
+}
+
+alarm_loop_io_snapshot_t alarm_loop_io_snapshot(void)
+{
+        alarm_loop_io_snapshot_t snapshot;
+        uint32_t pairs;
+        uint32_t shield;
+        uint32_t alarm;
+
+        // Sample both loop ports back-to-back.
+        uint32_t const pdir_c = GPIO_FOR_LOOPS_1_2_3_4->PDIR;
+        uint32_t const pdir_d = GPIO_FOR_LOOPS_5_6_7_8->PDIR;
+
+        pairs = loop_signal_pairs(pdir_c, pdir_d);
+
+        // Unzip the even and odd bits into two packed bitmaps.
+        shield = pairs & 0x5555u;
+        alarm = (pairs >> 1u) & 0x5555u;
+        shield = (shield | (shield >> 1u)) & 0x3333u;
+        alarm = (alarm | (alarm >> 1u)) & 0x3333u;
+        shield = (shield | (shield >> 2u)) & 0x0F0Fu;
+        alarm = (alarm | (alarm >> 2u)) & 0x0F0Fu;
+        shield = (shield | (shield >> 4u)) & 0x00FFu;
+        alarm = (alarm | (alarm >> 4u)) & 0x00FFu;
+
+        snapshot.alarm = (uint8_t)alarm;
+        snapshot.shield = (uint8_t)shield;
+
+        return snapshot;
+}
+
+mdv_result_t alarm_loop_io_enable_edge_interrupts(void)
+{
+        DisableIRQ(PORTC_PORTD_IRQn);
+
+        edge_queue_head = 0u;
+        edge_queue_tail = 0u;
+        lost_edges = 0u;
+
+        set_loop_pins_interrupt_config(kPORT_InterruptEitherEdge);
+
+        // Discard the edges detected before enabling the interrupts.
+        PORT_ClearPinsInterruptFlags(PORT_FOR_LOOPS_1_2_3_4,
+                LOOP_SIGNAL_PAIRS_MASK << LOOPS_1_2_3_4_FIRST_PIN);
+        PORT_ClearPinsInterruptFlags(PORT_FOR_LOOPS_5_6_7_8,
+                LOOP_SIGNAL_PAIRS_MASK << LOOPS_5_6_7_8_FIRST_PIN);
+
+        EnableIRQ(PORTC_PORTD_IRQn);
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t alarm_loop_io_disable_edge_interrupts(void)
+{
+        set_loop_pins_interrupt_config(kPORT_InterruptOrDMADisabled);
+
+        return MDV_RESULT_OK;
+}
+
+bool alarm_loop_io_get_edge(alarm_loop_edge_t *edge)
+{
+        uint32_t const tail = edge_queue_tail;
+
+        if (tail == edge_queue_head) {
+                return false;
+        }
+
+        *edge = edge_queue[tail & EDGE_QUEUE_INDEX_MASK];
+        edge_queue_tail = tail + 1u;
+
+        return true;
+}
+
+uint32_t alarm_loop_io_get_lost_edges(void)
+{
+        return lost_edges;
+}
+
+void alarm_loop_io_set_edge_notify(alarm_loop_edge_notify_t notify)
+{
+        edge_notify = notify;
+}
+
+/**
+ * \brief Port C and D pin detect interrupt handler
+ */
+void PORTC_PORTD_IRQHandler(void)
+{
+        uint32_t const timestamp = timebase_io_now();
+        uint32_t const flags_c = PORT_GetPinsInterruptFlags(
+                PORT_FOR_LOOPS_1_2_3_4) &
+                (LOOP_SIGNAL_PAIRS_MASK << LOOPS_1_2_3_4_FIRST_PIN);
+        uint32_t const flags_d = PORT_GetPinsInterruptFlags(
+                PORT_FOR_LOOPS_5_6_7_8) &
+                (LOOP_SIGNAL_PAIRS_MASK << LOOPS_5_6_7_8_FIRST_PIN);
+        uint32_t levels;
+        uint32_t flags;
+        uint32_t head = edge_queue_head;
+
+        // Clear the flags before sampling the levels, so that an edge
+        // occurring after the sampling raises the interrupt again.
+        PORT_ClearPinsInterruptFlags(PORT_FOR_LOOPS_1_2_3_4, flags_c);
+        PORT_ClearPinsInterruptFlags(PORT_FOR_LOOPS_5_6_7_8, flags_d);
+
+        levels = loop_signal_pairs(GPIO_FOR_LOOPS_1_2_3_4->PDIR,
+                GPIO_FOR_LOOPS_5_6_7_8->PDIR);
+        flags = loop_signal_pairs(flags_c, flags_d);
+
+        while (flags) {
+                uint32_t const lowest = flags & (0u - flags);
+                uint32_t const position = edge_source_table[
+                        (lowest * DE_BRUIJN_SEQUENCE) >> DE_BRUIJN_SHIFT];
+                alarm_loop_edge_t *edge;
+
+                flags ^= lowest;
+
+                if ((head - edge_queue_tail) >= ALARM_LOOP_EDGE_QUEUE_LENGTH) {
+                        ++lost_edges;
+                        continue;
+                }
+
+                edge = &edge_queue[head & EDGE_QUEUE_INDEX_MASK];
+                edge->timestamp = timestamp;
+                edge->loop = (uint8_t)(position >> 1u);
+                edge->signal = (uint8_t)(position & 1u);
+                edge->level = (uint8_t)((levels >> position) & 1u);
+                ++head;
+        }
+
+        if (head != edge_queue_head) {
+                edge_queue_head = head;
+                if (edge_notify) {
+                        edge_notify();
+                }
+        }
+}
+
+mdv_result_t alarm_loop_io_set_filter(alarm_loop_port_group_t group,
+        bool enable)
+{
+        if (group >= ALARM_LOOP_PORT_GROUPS) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        pin_config[group].passiveFilterEnable = enable ?
+                kPORT_PassiveFilterEnable : kPORT_PassiveFilterDisable;
+
+        // Update the lower half of the pin control registers of the whole
+        // group at once. The interrupt configuration is in the upper half, so
+        // it stays intact.
+        PORT_SetMultiplePinsConfig(group_port[group], group_pin_mask[group],
+                &pin_config[group]);
+
         return MDV_RESULT_OK;
 }
 
+bool alarm_loop_io_get_filter(alarm_loop_port_group_t group)
+{
+        if (group >= ALARM_LOOP_PORT_GROUPS) {
+                return false;
+        }
+
+        return pin_config[group].passiveFilterEnable ==
+                kPORT_PassiveFilterEnable;
+}
+
 /** @} */
 
 /* EOF */
\ No newline at end of file
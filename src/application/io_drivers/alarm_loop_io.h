@@ -48,6 +48,65 @@
  * @{
  */
 
+/**
+ * \brief Snapshot of all alarm loop signals
+ *
+ * Bit n of each bitmap holds the state of loop n + 1.
+ */
+typedef struct {
+        /// Alarm input states
+        uint8_t alarm;
+        /// Shield alarm input states
+        uint8_t shield;
+} alarm_loop_io_snapshot_t;
+
+/**
+ * \brief Alarm loop signal types
+ */
+typedef enum {
+        /// Shield alarm signal
+        ALARM_LOOP_SIGNAL_SHIELD = 0,
+        /// Alarm signal
+        ALARM_LOOP_SIGNAL_ALARM = 1
+} alarm_loop_signal_t;
+
+/**
+ * \brief Alarm loop signal edge record
+ */
+typedef struct {
+        /// Timebase value at the moment when the edge was detected
+        uint32_t timestamp;
+        /// Loop index, where 0 is loop 1
+        uint8_t loop;
+        /// Signal type (see alarm_loop_signal_t)
+        uint8_t signal;
+        /// Signal level after the edge
+        uint8_t level;
+} alarm_loop_edge_t;
+
+/**
+ * \brief Alarm loop port groups
+ */
+typedef enum {
+        /// Loops 1, 2, 3 and 4 (port C)
+        ALARM_LOOP_PORT_GROUP_1_2_3_4 = 0,
+        /// Loops 5, 6, 7 and 8 (port D)
+        ALARM_LOOP_PORT_GROUP_5_6_7_8,
+        /// Number of port groups
+        ALARM_LOOP_PORT_GROUPS
+} alarm_loop_port_group_t;
+
+/// Length of the edge queue (must be a power of two)
+#define ALARM_LOOP_EDGE_QUEUE_LENGTH 32u
+
+/**
+ * \brief Edge notification callback
+ *
+ * Called from the port interrupt handler after new edges have been pushed
+ * into the edge queue.
+ */
+typedef void (*alarm_loop_edge_notify_t)(void);
+
 /**
  * \brief Alarm inputs
  */
@@ -64,9 +123,87 @@ extern "C" {
 
 /**
  * \brief Initializes the alarm input interface
+ *
+ * Configures all the alarm and shield alarm input pins. The init functions
+ * of the individual inputs are needed only to reconfigure a pin.
  */
 mdv_result_t alarm_loop_io_init(void);
 
+/**
+ * \brief Takes a snapshot of all alarm and shield alarm inputs
+ *
+ * Reads the loop ports back-to-back, so that all the 16 signals are sampled
+ * coherently instead of one pin at a time through the input drivers.
+ *
+ * \return Packed alarm and shield alarm input states in loop order
+ */
+alarm_loop_io_snapshot_t alarm_loop_io_snapshot(void);
+
+/**
+ * \brief Enables edge interrupts on all alarm loop signals
+ *
+ * Every edge on an alarm or shield alarm signal is timestamped and pushed into
+ * the edge queue by the port interrupt handler. The input pins must have been
+ * initialized before enabling the interrupts.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t alarm_loop_io_enable_edge_interrupts(void);
+
+/**
+ * \brief Disables edge interrupts on all alarm loop signals
+ *
+ * \return Result of the operation
+ */
+mdv_result_t alarm_loop_io_disable_edge_interrupts(void);
+
+/**
+ * \brief Gets the oldest edge from the edge queue
+ *
+ * \param[out] edge Edge record
+ *
+ * \return True if an edge was available, otherwise false
+ */
+bool alarm_loop_io_get_edge(alarm_loop_edge_t *edge);
+
+/**
+ * \brief Gets the number of edges lost because of a full edge queue
+ *
+ * \return Number of lost edges since the initialization
+ */
+uint32_t alarm_loop_io_get_lost_edges(void);
+
+/**
+ * \brief Sets the edge notification callback
+ *
+ * \param[in] notify Callback to call from the port interrupt handler when
+ *            new edges are available, or NULL to disable the notification
+ */
+void alarm_loop_io_set_edge_notify(alarm_loop_edge_notify_t notify);
+
+/**
+ * \brief Enables or disables the input glitch filter of a port group
+ *
+ * The setting applies to all the alarm and shield alarm pins of the group
+ * immediately, and it is retained over re-initialization of the inputs.
+ *
+ * \param[in] group Port group
+ * \param[in] enable True to enable the filter, false to disable it
+ *
+ * \return Result of the operation
+ */
+mdv_result_t alarm_loop_io_set_filter(alarm_loop_port_group_t group,
+        bool enable);
+
+/**
+ * \brief Gets the input glitch filter setting of a port group
+ *
+ * \param[in] group Port group
+ *
+ * \return True if the filter is enabled, otherwise false
+ */
+bool alarm_loop_io_get_filter(alarm_loop_port_group_t group);
+
 #ifdef __cplusplus
 extern }
 #endif // ifdef __cplusplus
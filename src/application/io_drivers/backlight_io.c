@@ -0,0 +1,256 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "backlight_io.h"
+#include "button_io.h"
+#include "fsl_clock.h"
+#include "fsl_tpm.h"
+
+/**
+ * \file       backlight_io.c
+ * \defgroup   backlight-io-implementation Driver implementation
+ * \ingroup    backlight-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// TPM instance used for the modulation
+#define BACKLIGHT_TPM TPM1
+/// Interrupt of the modulation TPM
+#define BACKLIGHT_TPM_IRQ TPM1_IRQn
+/// TPM prescaler to get 1 MHz from the 8 MHz LIRC
+#define BACKLIGHT_TPM_PRESCALE kTPM_Prescale_Divide_8
+/// Length of the least significant bit slot in TPM ticks (250 us)
+#define BACKLIGHT_SLOT_TICKS 250u
+/// Number of bit slots in a modulation frame
+#define BACKLIGHT_SLOTS 4u
+/// Number of modulation frames per pattern step (about 60 ms)
+#define BACKLIGHT_FRAMES_PER_STEP 16u
+/// Number of steps in a pattern
+#define BACKLIGHT_PATTERN_STEPS 16u
+
+/// Pattern intensities for each step, scaled to 0...15
+static const uint8_t pattern_table[BACKLIGHT_PATTERNS]
+        [BACKLIGHT_PATTERN_STEPS] = {
+        // BACKLIGHT_PATTERN_STEADY
+        { 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u,
+          15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u },
+        // BACKLIGHT_PATTERN_FAST_BLINK
+        { 15u, 15u, 0u, 0u, 15u, 15u, 0u, 0u,
+          15u, 15u, 0u, 0u, 15u, 15u, 0u, 0u },
+        // BACKLIGHT_PATTERN_DOUBLE_BLINK
+        { 15u, 15u, 0u, 0u, 15u, 15u, 0u, 0u,
+          0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+        // BACKLIGHT_PATTERN_BREATHE
+        { 0u, 2u, 4u, 6u, 8u, 10u, 12u, 15u,
+          15u, 12u, 10u, 8u, 6u, 4u, 2u, 0u }
+};
+
+/// Brightness levels of the buttons
+static volatile uint8_t button_level[BA8_MAXIMUM_LOOPS];
+/// Patterns of the buttons
+static volatile uint8_t button_pattern[BA8_MAXIMUM_LOOPS];
+/// Set when a level or pattern has changed
+static volatile bool changed;
+/// Backlight frames for each bit slot
+static uint8_t planes[BACKLIGHT_SLOTS];
+/// Current bit slot
+static uint8_t slot;
+/// Frame counter within the current pattern step
+static uint8_t frame;
+/// Current pattern step
+static uint8_t step;
+/// True while the modulation timer runs
+static bool modulating;
+
+/**
+ * \brief Builds the bit slot frames for the current pattern step
+ */
+static void build_planes(void)
+{
+        uint8_t new_planes[BACKLIGHT_SLOTS] = { 0u, 0u, 0u, 0u };
+
+        for (uint8_t button = 0u; button < BA8_MAXIMUM_LOOPS; ++button) {
+                uint32_t const scale =
+                        pattern_table[button_pattern[button]][step];
+                // level * scale / 15 without division, rounded.
+                uint32_t const brightness = ((uint32_t)button_level[button] *
+                        scale * 17u + 128u) >> 8u;
+
+                for (uint8_t bit = 0u; bit < BACKLIGHT_SLOTS; ++bit) {
+                        if (brightness & (1u << bit)) {
+                                new_planes[bit] |= (uint8_t)(1u << button);
+                        }
+                }
+        }
+
+        for (uint8_t bit = 0u; bit < BACKLIGHT_SLOTS; ++bit) {
+                planes[bit] = new_planes[bit];
+        }
+}
+
+/**
+ * \brief Modulation slot interrupt handler
+ *
+ * Bit slot n lasts 2^n slot ticks. The modulo register is buffered and
+ * takes effect at the next counter overflow, so the length of the slot
+ * after the current one is written here.
+ */
+void TPM1_IRQHandler(void)
+{
+        TPM_ClearStatusFlags(BACKLIGHT_TPM, kTPM_TimeOverflowFlag);
+
+        slot = (slot + 1u) % BACKLIGHT_SLOTS;
+        if (slot == 0u) {
+                if (++frame >= BACKLIGHT_FRAMES_PER_STEP) {
+                        frame = 0u;
+                        step = (step + 1u) % BACKLIGHT_PATTERN_STEPS;
+                        changed = true;
+                }
+                if (changed) {
+                        changed = false;
+                        build_planes();
+                }
+        }
+
+        button_io_set_backlights(planes[slot]);
+        TPM_SetTimerPeriod(BACKLIGHT_TPM, (BACKLIGHT_SLOT_TICKS <<
+                ((slot + 1u) % BACKLIGHT_SLOTS)) - 1u);
+}
+
+/**
+ * \brief Gets the backlights of a frame without modulation
+ *
+ * \param[out] lit Buttons with the backlight on
+ *
+ * \return True if every button is either off, or at the full level with the
+ *         steady pattern, otherwise false
+ */
+static bool static_frame(uint8_t *lit)
+{
+        *lit = 0u;
+        for (uint8_t button = 0u; button < BA8_MAXIMUM_LOOPS; ++button) {
+                if (!button_level[button]) {
+                        continue;
+                }
+                if ((button_level[button] != BACKLIGHT_IO_MAXIMUM_LEVEL) ||
+                        (button_pattern[button] != BACKLIGHT_PATTERN_STEADY)) {
+                        return false;
+                }
+                *lit |= (uint8_t)(1u << button);
+        }
+
+        return true;
+}
+
+/**
+ * \brief Starts or stops the modulation after a level or pattern change
+ *
+ * With only static backlights, the timer is stopped and the backlight pins
+ * are written directly. Otherwise the timer runs, restarting the patterns
+ * from the first step if it was stopped.
+ */
+static void update_modulation(void)
+{
+        uint8_t lit;
+
+        if (static_frame(&lit)) {
+                if (modulating) {
+                        DisableIRQ(BACKLIGHT_TPM_IRQ);
+                        TPM_StopTimer(BACKLIGHT_TPM);
+                        TPM_ClearStatusFlags(BACKLIGHT_TPM,
+                                kTPM_TimeOverflowFlag);
+                        NVIC_ClearPendingIRQ(BACKLIGHT_TPM_IRQ);
+                        EnableIRQ(BACKLIGHT_TPM_IRQ);
+                        modulating = false;
+                }
+                button_io_set_backlights(lit);
+        } else if (!modulating) {
+                // The planes are built at the first overflow, which starts
+                // a new frame.
+                slot = BACKLIGHT_SLOTS - 1u;
+                frame = 0u;
+                step = 0u;
+                changed = true;
+                BACKLIGHT_TPM->CNT = 0u;
+                TPM_SetTimerPeriod(BACKLIGHT_TPM, BACKLIGHT_SLOT_TICKS - 1u);
+                modulating = true;
+                TPM_StartTimer(BACKLIGHT_TPM, kTPM_SystemClock);
+        }
+}
+
+mdv_result_t backlight_io_init(void)
+{
+        tpm_config_t config;
+
+        for (uint8_t button = 0u; button < BA8_MAXIMUM_LOOPS; ++button) {
+                button_level[button] = 0u;
+                button_pattern[button] = BACKLIGHT_PATTERN_STEADY;
+        }
+        for (uint8_t bit = 0u; bit < BACKLIGHT_SLOTS; ++bit) {
+                planes[bit] = 0u;
+        }
+        modulating = false;
+        button_io_set_backlights(0u);
+
+        // The timer is started once a backlight needs the modulation.
+        TPM_GetDefaultConfig(&config);
+        config.prescale = BACKLIGHT_TPM_PRESCALE;
+        config.enableDoze = false;
+        TPM_Init(BACKLIGHT_TPM, &config);
+
+        TPM_EnableInterrupts(BACKLIGHT_TPM, kTPM_TimeOverflowInterruptEnable);
+        EnableIRQ(BACKLIGHT_TPM_IRQ);
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t backlight_io_set(uint8_t button, uint8_t level,
+        backlight_pattern_t pattern)
+{
+        if ((button >= BA8_MAXIMUM_LOOPS) ||
+                (level > BACKLIGHT_IO_MAXIMUM_LEVEL) ||
+                (pattern >= BACKLIGHT_PATTERNS)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        button_level[button] = level;
+        button_pattern[button] = (uint8_t)pattern;
+        changed = true;
+        update_modulation();
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,113 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BACKLIGHT_IO_H
+#define BACKLIGHT_IO_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       backlight_io.h
+ * \defgroup   backlight-io Backlight dimming and pattern driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Drives the button backlights with bit-angle modulation, giving each button
+ * an individual brightness level and a blink pattern. The modulation runs
+ * from the TPM1 interrupt, four interrupts per modulation frame, so the CPU
+ * can sleep in between. While every backlight is off, or on at the full
+ * level with the steady pattern, TPM1 is stopped and the backlights are
+ * driven statically.
+ *
+ * @{
+ */
+
+/// Maximum backlight brightness level
+#define BACKLIGHT_IO_MAXIMUM_LEVEL 15u
+
+/**
+ * \brief Backlight patterns
+ */
+typedef enum backlight_pattern_t {
+        /// Steady light (e.g. armed)
+        BACKLIGHT_PATTERN_STEADY,
+        /// Fast blink (e.g. alarm)
+        BACKLIGHT_PATTERN_FAST_BLINK,
+        /// Double blink (e.g. fault)
+        BACKLIGHT_PATTERN_DOUBLE_BLINK,
+        /// Slow fade in and out
+        BACKLIGHT_PATTERN_BREATHE,
+        /// Number of the patterns
+        BACKLIGHT_PATTERNS
+} backlight_pattern_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the backlight driver
+ *
+ * The button interface and the timebase must be initialized before this, as
+ * the driver writes the backlight pins set up by the button interface and
+ * uses the TPM clock selected by the timebase. All backlights start off.
+ *
+ * While the modulation runs, it owns the backlight outputs and overrides any
+ * state written through the button interface.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t backlight_io_init(void);
+
+/**
+ * \brief Sets the brightness and pattern of a button backlight
+ *
+ * \param[in] button Index of the button (0...BA8_MAXIMUM_LOOPS - 1)
+ * \param[in] level Brightness level (0...BACKLIGHT_IO_MAXIMUM_LEVEL)
+ * \param[in] pattern Blink pattern
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The button, level or pattern is out of
+ *         range
+ */
+mdv_result_t backlight_io_set(uint8_t button, uint8_t level,
+        backlight_pattern_t pattern);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef BACKLIGHT_IO_H
+
+/* EOF */
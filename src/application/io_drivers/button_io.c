@@ -99,6 +99,28 @@
 /// Pin for button 8 backlight output (port A)
 #define BUTTON_8_OUTPUT_PIN 12u
 
+/// Backlight output pin mask for buttons 1 and 2 (port C)
+#define BACKLIGHT_MASK_1_2 ((1u << BUTTON_1_OUTPUT_PIN) | \
+        (1u << BUTTON_2_OUTPUT_PIN))
+/// Backlight output pin mask for buttons 3, 4, 5 and 6 (port B)
+#define BACKLIGHT_MASK_3_4_5_6 ((1u << BUTTON_3_OUTPUT_PIN) | \
+        (1u << BUTTON_4_OUTPUT_PIN) | (1u << BUTTON_5_OUTPUT_PIN) | \
+        (1u << BUTTON_6_OUTPUT_PIN))
+/// Backlight output pin mask for buttons 7 and 8 (port A)
+#define BACKLIGHT_MASK_7_8 ((1u << BUTTON_7_OUTPUT_PIN) | \
+        (1u << BUTTON_8_OUTPUT_PIN))
+
+/// Button input pin mask for buttons 1 and 2 (port C)
+#define INPUT_MASK_1_2 ((1u << BUTTON_1_INPUT_PIN) | \
+        (1u << BUTTON_2_INPUT_PIN))
+/// Button input pin mask for buttons 3, 4, 5 and 6 (port B)
+#define INPUT_MASK_3_4_5_6 ((1u << BUTTON_3_INPUT_PIN) | \
+        (1u << BUTTON_4_INPUT_PIN) | (1u << BUTTON_5_INPUT_PIN) | \
+        (1u << BUTTON_6_INPUT_PIN))
+/// Button input pin mask for buttons 7 and 8 (port A)
+#define INPUT_MASK_7_8 ((1u << BUTTON_7_INPUT_PIN) | \
+        (1u << BUTTON_8_INPUT_PIN))
+
 /// Port pin pull-up configuration
 #define PIN_PULL_UP_DISABLED 0
 /// Port pin slew rate select
@@ -130,6 +152,81 @@ static gpio_pin_config_t gpio_output_config = {
         .outputLogic = PIN_OUTPUT_LOW_BY_DEFAULT
 };
 
+/// Port C output pins for each combination of backlights 1 and 2
+static const uint32_t backlight_pins_1_2[4] = {
+        0u,
+        (1u << BUTTON_1_OUTPUT_PIN),
+        (1u << BUTTON_2_OUTPUT_PIN),
+        (1u << BUTTON_1_OUTPUT_PIN) | (1u << BUTTON_2_OUTPUT_PIN)
+};
+
+/// Port B output pins for each combination of backlights 3, 4, 5 and 6
+static const uint32_t backlight_pins_3_4_5_6[16] = {
+        0u,
+        (1u << BUTTON_3_OUTPUT_PIN),
+        (1u << BUTTON_4_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_4_OUTPUT_PIN),
+        (1u << BUTTON_5_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_5_OUTPUT_PIN),
+        (1u << BUTTON_4_OUTPUT_PIN) | (1u << BUTTON_5_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_4_OUTPUT_PIN) |
+                (1u << BUTTON_5_OUTPUT_PIN),
+        (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_4_OUTPUT_PIN) | (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_4_OUTPUT_PIN) |
+                (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_5_OUTPUT_PIN) | (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_3_OUTPUT_PIN) | (1u << BUTTON_5_OUTPUT_PIN) |
+                (1u << BUTTON_6_OUTPUT_PIN),
+        (1u << BUTTON_4_OUTPUT_PIN) | (1u << BUTTON_5_OUTPUT_PIN) |
+                (1u << BUTTON_6_OUTPUT_PIN),
+        BACKLIGHT_MASK_3_4_5_6
+};
+
+/// Port A output pins for each combination of backlights 7 and 8
+static const uint32_t backlight_pins_7_8[4] = {
+        0u,
+        (1u << BUTTON_7_OUTPUT_PIN),
+        (1u << BUTTON_8_OUTPUT_PIN),
+        (1u << BUTTON_7_OUTPUT_PIN) | (1u << BUTTON_8_OUTPUT_PIN)
+};
+
+/**
+ * \brief Updates the backlight pins of one port
+ *
+ * \param[in] base GPIO of the port
+ * \param[in] mask Backlight pins of the port
+ * \param[in] pins Backlight pins to set, others in the mask are cleared
+ */
+static inline void update_backlight_port(GPIO_Type *base, uint32_t mask,
+        uint32_t pins)
+{
+        if ((base->PDOR & mask) != pins) {
+                GPIO_PortSet(base, pins);
+                GPIO_PortClear(base, mask & ~pins);
+        }
+}
+
+/**
+ * \brief Configures the button pins of one port
+ *
+ * The backlight outputs are driven low before they are made outputs, and
+ * the pins are muxed to the GPIO after their direction is set.
+ *
+ * \param[in] port Port of the pins
+ * \param[in] gpio GPIO of the port
+ * \param[in] inputs Button input pins of the port
+ * \param[in] outputs Backlight output pins of the port
+ */
+static void configure_port(PORT_Type *port, GPIO_Type *gpio, uint32_t inputs,
+        uint32_t outputs)
+{
+        GPIO_PortClear(gpio, outputs);
+        gpio->PDDR = (gpio->PDDR & ~inputs) | outputs;
+        PORT_SetMultiplePinsConfig(port, inputs | outputs, &pin_config);
+}
+
 /**
  * \brief Initialize button 1 input
  *
@@ -743,9 +840,44 @@ mdv_result_t button_io_init(void)
         CLOCK_EnableClock(PORT_CLOCK_FOR_BUTTONS_3_4_5_6);
         CLOCK_EnableClock(PORT_CLOCK_FOR_BUTTONS_7_8);
 
+        configure_port(PORT_FOR_BUTTONS_1_2, GPIO_FOR_BUTTONS_1_2,
+                INPUT_MASK_1_2, BACKLIGHT_MASK_1_2);
+        configure_port(PORT_FOR_BUTTONS_3_4_5_6, GPIO_FOR_BUTTONS_3_4_5_6,
+                INPUT_MASK_3_4_5_6, BACKLIGHT_MASK_3_4_5_6);
+        configure_port(PORT_FOR_BUTTONS_7_8, GPIO_FOR_BUTTONS_7_8,
+                INPUT_MASK_7_8, BACKLIGHT_MASK_7_8);
+
         return MDV_RESULT_OK;
 }
 
+uint8_t button_io_snapshot(void)
+{
+        // Sample all the button ports back-to-back.
+        uint32_t const pdir_c = GPIO_FOR_BUTTONS_1_2->PDIR;
+        uint32_t const pdir_b = GPIO_FOR_BUTTONS_3_4_5_6->PDIR;
+        uint32_t const pdir_a = GPIO_FOR_BUTTONS_7_8->PDIR;
+
+        return (uint8_t)(
+                (((pdir_c >> BUTTON_1_INPUT_PIN) & 1u) << 0u) |
+                (((pdir_c >> BUTTON_2_INPUT_PIN) & 1u) << 1u) |
+                (((pdir_b >> BUTTON_3_INPUT_PIN) & 1u) << 2u) |
+                (((pdir_b >> BUTTON_4_INPUT_PIN) & 1u) << 3u) |
+                (((pdir_b >> BUTTON_5_INPUT_PIN) & 1u) << 4u) |
+                (((pdir_b >> BUTTON_6_INPUT_PIN) & 1u) << 5u) |
+                (((pdir_a >> BUTTON_7_INPUT_PIN) & 1u) << 6u) |
+                (((pdir_a >> BUTTON_8_INPUT_PIN) & 1u) << 7u));
+}
+
+void button_io_set_backlights(uint8_t frame)
+{
+        update_backlight_port(GPIO_FOR_BUTTONS_1_2, BACKLIGHT_MASK_1_2,
+                backlight_pins_1_2[frame & 0x03u]);
+        update_backlight_port(GPIO_FOR_BUTTONS_3_4_5_6, BACKLIGHT_MASK_3_4_5_6,
+                backlight_pins_3_4_5_6[(frame >> 2u) & 0x0Fu]);
+        update_backlight_port(GPIO_FOR_BUTTONS_7_8, BACKLIGHT_MASK_7_8,
+                backlight_pins_7_8[(frame >> 6u) & 0x03u]);
+}
+
 /** @} */
 
 /* EOF */
\ No newline at end of file
@@ -65,9 +65,34 @@ extern "C" {
 
 /**
  * \brief Initializes the button interface
+ *
+ * Configures all the button input and backlight output pins, with the
+ * backlights off. The init functions of the individual inputs and outputs
+ * are needed only to reconfigure a pin.
  */
 mdv_result_t button_io_init(void);
 
+/**
+ * \brief Takes a snapshot of all button inputs
+ *
+ * Reads the button ports back-to-back, so that all the buttons are sampled
+ * coherently instead of one pin at a time through the input drivers.
+ *
+ * \return Button input states, where bit n holds the state of button n + 1
+ */
+uint8_t button_io_snapshot(void);
+
+/**
+ * \brief Sets all button backlights at once
+ *
+ * Each backlight port is updated with one set and one clear operation, and
+ * the ports whose backlights already match the frame are not touched.
+ *
+ * \param[in] frame Backlight states, where bit n is the backlight of button
+ *            n + 1
+ */
+void button_io_set_backlights(uint8_t frame);
+
 #ifdef __cplusplus
 extern }
 #endif // ifdef __cplusplus
@@ -0,0 +1,138 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "flash_io.h"
+#include "fsl_ftfx_flash.h"
+
+/**
+ * \file       flash_io.c
+ * \defgroup   flash-io-implementation Driver implementation
+ * \ingroup    flash-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// End address of the program flash
+#define FLASH_END (FLASH_IO_DATA_BLOCK_START + 0x00020000u)
+/// Value of an erased program unit
+#define ERASED_UNIT 0xFFFFFFFFu
+
+/// Flash driver state
+static flash_config_t flash_config;
+
+/**
+ * \brief Checks that a range is within the upper program flash block
+ *
+ * \param[in] address Start address
+ * \param[in] length Length in bytes
+ *
+ * \return True if the range is valid
+ */
+static inline bool in_data_block(uint32_t address, uint32_t length)
+{
+        return (address >= FLASH_IO_DATA_BLOCK_START) &&
+                (address < FLASH_END) && (length <= (FLASH_END - address));
+}
+
+/**
+ * \brief Clears the flash controller cache after a flash command
+ *
+ * Makes sure that the following reads return the new flash contents instead
+ * of stale cached data.
+ */
+static inline void clear_flash_cache(void)
+{
+        MCM->PLACR |= MCM_PLACR_CFCC_MASK;
+}
+
+mdv_result_t flash_io_init(void)
+{
+        if (FLASH_Init(&flash_config) != kStatus_FTFx_Success) {
+                return BA8_RESULT_FLASH_ERROR;
+        }
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t flash_io_erase_sector(uint32_t address)
+{
+        status_t status;
+
+        if (!in_data_block(address, BA8_FLASH_SECTOR_SIZE) ||
+                (address % BA8_FLASH_SECTOR_SIZE)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        status = FLASH_Erase(&flash_config, address, BA8_FLASH_SECTOR_SIZE,
+                kFTFx_ApiEraseKey);
+        clear_flash_cache();
+
+        return (status == kStatus_FTFx_Success) ?
+                MDV_RESULT_OK : BA8_RESULT_FLASH_ERROR;
+}
+
+mdv_result_t flash_io_program(uint32_t address, void const *data,
+        uint32_t length)
+{
+        status_t status;
+
+        if (!in_data_block(address, length) ||
+                (address % FLASH_IO_PROGRAM_UNIT) ||
+                (length % FLASH_IO_PROGRAM_UNIT)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        // The driver does not modify the source, it only lacks the const.
+        status = FLASH_Program(&flash_config, address, (uint8_t *)data,
+                length);
+        clear_flash_cache();
+
+        return (status == kStatus_FTFx_Success) ?
+                MDV_RESULT_OK : BA8_RESULT_FLASH_ERROR;
+}
+
+bool flash_io_is_erased(uint32_t address, uint32_t length)
+{
+        uint32_t const *unit = (uint32_t const *)address;
+
+        for (uint32_t i = 0u; i < length / FLASH_IO_PROGRAM_UNIT; ++i) {
+                if (unit[i] != ERASED_UNIT) {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,119 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FLASH_IO_H
+#define FLASH_IO_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       flash_io.h
+ * \defgroup   flash-io Internal flash driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Erasing and programming of the internal program flash for persistent data.
+ *
+ * The persistent data lives in the upper program flash block, and the code
+ * must fit in the lower block. The flash controller can then keep executing
+ * code and interrupt handlers from the lower block while the upper block is
+ * being erased or programmed, so the interrupts stay enabled. Programmed data
+ * is read back directly from the memory-mapped flash.
+ *
+ * @{
+ */
+
+/// Start address of the upper program flash block
+#define FLASH_IO_DATA_BLOCK_START 0x00020000u
+/// Flash programming unit in bytes
+#define FLASH_IO_PROGRAM_UNIT 4u
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the flash driver
+ *
+ * \return Result of the operation
+ */
+mdv_result_t flash_io_init(void);
+
+/**
+ * \brief Erases a flash sector
+ *
+ * \param[in] address Start address of the sector in the upper program flash
+ *            block
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The address is not the start of a
+ *         sector in the upper block
+ * \retval BA8_RESULT_FLASH_ERROR The erase failed
+ */
+mdv_result_t flash_io_erase_sector(uint32_t address);
+
+/**
+ * \brief Programs data into erased flash
+ *
+ * \param[in] address Start address in the upper program flash block,
+ *            aligned to FLASH_IO_PROGRAM_UNIT
+ * \param[in] data Data to program
+ * \param[in] length Length of the data in bytes, a multiple of
+ *            FLASH_IO_PROGRAM_UNIT
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The address or length is misaligned,
+ *         or the range is not in the upper block
+ * \retval BA8_RESULT_FLASH_ERROR The programming failed
+ */
+mdv_result_t flash_io_program(uint32_t address, void const *data,
+        uint32_t length);
+
+/**
+ * \brief Checks whether a flash range is erased
+ *
+ * \param[in] address Start address
+ * \param[in] length Length in bytes, a multiple of FLASH_IO_PROGRAM_UNIT
+ *
+ * \return True if all the bytes in the range are erased
+ */
+bool flash_io_is_erased(uint32_t address, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef FLASH_IO_H
+
+/* EOF */
@@ -0,0 +1,391 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "loop_analog_io.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "fsl_adc16.h"
+#include "fsl_dma.h"
+#include "fsl_dmamux.h"
+
+/**
+ * \file       loop_analog_io.c
+ * \defgroup   loop-analog-io-implementation Driver implementation
+ * \ingroup    loop-analog-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Port clock for the loop sense lines
+#define PORT_CLOCK_FOR_LOOP_SENSE kCLOCK_PortE
+
+/// Port for the loop sense lines
+#define PORT_FOR_LOOP_SENSE PORTE
+
+/// ADC for the loop sense lines
+#define ADC_FOR_LOOP_SENSE ADC0
+/// ADC channel group used for the conversions
+#define ADC_CHANNEL_GROUP 0u
+/// ADC channel number which disables the converter
+#define ADC_CHANNEL_DISABLED 0x1Fu
+
+/// Pin for loop 1 sense line (port E, ADC0_SE1)
+#define LOOP_1_SENSE_PIN 16u
+/// Pin for loop 2 sense line (port E, ADC0_SE5a)
+#define LOOP_2_SENSE_PIN 17u
+/// Pin for loop 3 sense line (port E, ADC0_SE2)
+#define LOOP_3_SENSE_PIN 18u
+/// Pin for loop 4 sense line (port E, ADC0_SE6a)
+#define LOOP_4_SENSE_PIN 19u
+/// Pin for loop 5 sense line (port E, ADC0_SE0)
+#define LOOP_5_SENSE_PIN 20u
+/// Pin for loop 6 sense line (port E, ADC0_SE4a)
+#define LOOP_6_SENSE_PIN 21u
+/// Pin for loop 7 sense line (port E, ADC0_SE3)
+#define LOOP_7_SENSE_PIN 22u
+/// Pin for loop 8 sense line (port E, ADC0_SE7a)
+#define LOOP_8_SENSE_PIN 23u
+
+/// Mask for all the loop sense pins
+#define LOOP_SENSE_PINS_MASK (0xFFu << LOOP_1_SENSE_PIN)
+
+/// DMA channel for the conversion results
+#define DMA_CHANNEL_RESULT BA8_DMA_CHANNEL_LOOP_SENSE_RESULT
+/// DMA channel for the channel commands
+#define DMA_CHANNEL_COMMAND BA8_DMA_CHANNEL_LOOP_SENSE_COMMAND
+
+/// Default highest reading of a short circuited loop (5 % of full scale)
+#define DEFAULT_SHORT_MAX 0x0CCCu
+/// Default lowest reading of a normal loop (45 % of full scale)
+#define DEFAULT_NORMAL_MIN 0x7333u
+/// Default highest reading of a normal loop (55 % of full scale)
+#define DEFAULT_NORMAL_MAX 0x8CCCu
+/// Default lowest reading of a cut loop (90 % of full scale)
+#define DEFAULT_CUT_MIN 0xE666u
+
+/// ADC channels of the loop sense lines in loop order
+static const uint8_t loop_sense_channel[BA8_MAXIMUM_LOOPS] = {
+        1u, 5u, 2u, 6u, 0u, 4u, 3u, 7u
+};
+
+/// Port pin configuration for the loop sense lines
+static const port_pin_config_t pin_config = {
+        .pullSelect = kPORT_PullDisable,
+        .slewRate = kPORT_SlowSlewRate,
+        .passiveFilterEnable = kPORT_PassiveFilterDisable,
+        .driveStrength = kPORT_LowDriveStrength,
+        .mux = kPORT_PinDisabledOrAnalog
+};
+
+/**
+ * \brief ADC channel commands written by DMA after each conversion
+ *
+ * The first loop is started by the CPU, and the last command disables the
+ * converter when all the loops have been converted.
+ */
+static uint32_t channel_commands[BA8_MAXIMUM_LOOPS];
+
+/// Conversion results in loop order
+static volatile uint16_t results[BA8_MAXIMUM_LOOPS];
+
+/// Loop status from the latest scan
+static volatile uint8_t status[BA8_MAXIMUM_LOOPS];
+
+/// Resistance windows of the loops
+static loop_analog_window_t windows[BA8_MAXIMUM_LOOPS];
+
+/// DMA handle for the conversion results
+static dma_handle_t result_dma;
+/// DMA handle for the channel commands
+static dma_handle_t command_dma;
+
+/// Event callback
+static loop_analog_io_callback_t event_callback;
+
+/// Guarded loop, or BA8_MAXIMUM_LOOPS if guarding is off
+static volatile uint32_t guarded_loop = BA8_MAXIMUM_LOOPS;
+
+/**
+ * \brief Classifies a reading by the resistance windows
+ *
+ * \param[in] value ADC reading
+ * \param[in] window Resistance windows
+ *
+ * \return Loop status
+ */
+static loop_analog_status_t classify(uint16_t value,
+        const loop_analog_window_t *window)
+{
+        if (value <= window->short_max) {
+                return LOOP_ANALOG_STATUS_SHORT;
+        }
+        if (value < window->normal_min) {
+                return LOOP_ANALOG_STATUS_TAMPER;
+        }
+        if (value <= window->normal_max) {
+                return LOOP_ANALOG_STATUS_NORMAL;
+        }
+        if (value < window->cut_min) {
+                return LOOP_ANALOG_STATUS_ALARM;
+        }
+        return LOOP_ANALOG_STATUS_CUT;
+}
+
+/**
+ * \brief Scan completion callback from the result DMA
+ *
+ * \param[in] handle DMA handle
+ * \param[in] user_data User data (not used)
+ */
+static void scan_done(dma_handle_t *handle, void *user_data)
+{
+        uint32_t i;
+
+        (void)handle;
+        (void)user_data;
+
+        for (i = 0u; i < BA8_MAXIMUM_LOOPS; ++i) {
+                status[i] = (uint8_t)classify(results[i], &windows[i]);
+        }
+
+        if (event_callback) {
+                event_callback(LOOP_ANALOG_EVENT_SCAN_DONE);
+        }
+}
+
+mdv_result_t loop_analog_io_init(loop_analog_io_callback_t callback)
+{
+        adc16_config_t adc_config;
+        uint32_t i;
+
+        CLOCK_EnableClock(PORT_CLOCK_FOR_LOOP_SENSE);
+        PORT_SetMultiplePinsConfig(PORT_FOR_LOOP_SENSE, LOOP_SENSE_PINS_MASK,
+                &pin_config);
+
+        ADC16_GetDefaultConfig(&adc_config);
+        adc_config.resolution = kADC16_ResolutionSE16Bit;
+        adc_config.longSampleMode = kADC16_LongSampleCycle24;
+        ADC16_Init(ADC_FOR_LOOP_SENSE, &adc_config);
+        ADC16_SetChannelMuxMode(ADC_FOR_LOOP_SENSE, kADC16_ChannelMuxA);
+        (void)ADC16_DoAutoCalibration(ADC_FOR_LOOP_SENSE);
+        ADC16_SetHardwareAverage(ADC_FOR_LOOP_SENSE,
+                kADC16_HardwareAverageCount32);
+        ADC16_SetHardwareCompareConfig(ADC_FOR_LOOP_SENSE, NULL);
+
+        for (i = 0u; i < BA8_MAXIMUM_LOOPS; ++i) {
+                windows[i].short_max = DEFAULT_SHORT_MAX;
+                windows[i].normal_min = DEFAULT_NORMAL_MIN;
+                windows[i].normal_max = DEFAULT_NORMAL_MAX;
+                windows[i].cut_min = DEFAULT_CUT_MIN;
+                status[i] = (uint8_t)LOOP_ANALOG_STATUS_NORMAL;
+                channel_commands[i] = (i + 1u < BA8_MAXIMUM_LOOPS) ?
+                        ADC_SC1_ADCH(loop_sense_channel[i + 1u]) :
+                        ADC_SC1_ADCH(ADC_CHANNEL_DISABLED);
+        }
+
+        DMAMUX_Init(DMAMUX0);
+        DMAMUX_SetSource(DMAMUX0, DMA_CHANNEL_RESULT,
+                (uint32_t)kDmaRequestMux0ADC0);
+        DMAMUX_EnableChannel(DMAMUX0, DMA_CHANNEL_RESULT);
+
+        DMA_Init(DMA0);
+        DMA_CreateHandle(&result_dma, DMA0, DMA_CHANNEL_RESULT);
+        DMA_SetCallback(&result_dma, scan_done, NULL);
+        DMA_CreateHandle(&command_dma, DMA0, DMA_CHANNEL_COMMAND);
+
+        event_callback = callback;
+        guarded_loop = BA8_MAXIMUM_LOOPS;
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t loop_analog_io_set_window(uint32_t loop,
+        const loop_analog_window_t *window)
+{
+        if ((loop >= BA8_MAXIMUM_LOOPS) || !window ||
+                (window->short_max >= window->normal_min) ||
+                (window->normal_min > window->normal_max) ||
+                (window->normal_max >= window->cut_min)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        windows[loop] = *window;
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t loop_analog_io_start_scan(void)
+{
+        dma_transfer_config_t transfer;
+        dma_channel_link_config_t link = {
+                .linkType = kDMA_ChannelLinkChannel1,
+                .channel1 = DMA_CHANNEL_COMMAND,
+                .channel2 = 0u
+        };
+        adc16_channel_config_t channel = {
+                .channelNumber = loop_sense_channel[0],
+                .enableInterruptOnConversionCompleted = false,
+                .enableDifferentialConversion = false
+        };
+
+        loop_analog_io_stop_guard();
+
+        // Results: one 16-bit result per conversion request from the ADC.
+        DMA_PrepareTransfer(&transfer,
+                (void *)&ADC_FOR_LOOP_SENSE->R[ADC_CHANNEL_GROUP],
+                sizeof(results[0]), (void *)results, sizeof(results[0]),
+                sizeof(results), kDMA_PeripheralToMemory);
+        if (DMA_SubmitTransfer(&result_dma, &transfer, kDMA_EnableInterrupt) !=
+                kStatus_Success) {
+                return BA8_RESULT_BUSY;
+        }
+
+        // After each result, the command channel starts the next conversion.
+        DMA_SetChannelLinkConfig(DMA0, DMA_CHANNEL_RESULT, &link);
+
+        DMA_PrepareTransfer(&transfer, channel_commands,
+                sizeof(channel_commands[0]),
+                (void *)&ADC_FOR_LOOP_SENSE->SC1[ADC_CHANNEL_GROUP],
+                sizeof(channel_commands[0]), sizeof(channel_commands),
+                kDMA_MemoryToPeripheral);
+        if (DMA_SubmitTransfer(&command_dma, &transfer, kDMA_NoOptions) !=
+                kStatus_Success) {
+                DMA_AbortTransfer(&result_dma);
+                return BA8_RESULT_BUSY;
+        }
+
+        DMA_StartTransfer(&result_dma);
+        ADC16_EnableDMA(ADC_FOR_LOOP_SENSE, true);
+
+        // Writing the first channel starts the scan.
+        ADC16_SetChannelConfig(ADC_FOR_LOOP_SENSE, ADC_CHANNEL_GROUP,
+                &channel);
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t loop_analog_io_start_guard(uint32_t loop)
+{
+        adc16_hardware_compare_config_t compare;
+        adc16_channel_config_t channel = {
+                .channelNumber = 0u,
+                .enableInterruptOnConversionCompleted = true,
+                .enableDifferentialConversion = false
+        };
+
+        if (loop >= BA8_MAXIMUM_LOOPS) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        DMA_AbortTransfer(&result_dma);
+        DMA_AbortTransfer(&command_dma);
+        ADC16_EnableDMA(ADC_FOR_LOOP_SENSE, false);
+
+        // The conversion completes only when the reading is outside of the
+        // normal window, so the CPU is not disturbed while the loop is intact.
+        compare.hardwareCompareMode = kADC16_HardwareCompareMode2;
+        compare.value1 = (int16_t)windows[loop].normal_min;
+        compare.value2 = (int16_t)windows[loop].normal_max;
+        ADC16_SetHardwareCompareConfig(ADC_FOR_LOOP_SENSE, &compare);
+
+        guarded_loop = loop;
+        ADC_FOR_LOOP_SENSE->SC3 |= ADC_SC3_ADCO_MASK;
+        EnableIRQ(ADC0_IRQn);
+
+        channel.channelNumber = loop_sense_channel[loop];
+        ADC16_SetChannelConfig(ADC_FOR_LOOP_SENSE, ADC_CHANNEL_GROUP,
+                &channel);
+
+        return MDV_RESULT_OK;
+}
+
+void loop_analog_io_stop_guard(void)
+{
+        adc16_channel_config_t channel = {
+                .channelNumber = ADC_CHANNEL_DISABLED,
+                .enableInterruptOnConversionCompleted = false,
+                .enableDifferentialConversion = false
+        };
+
+        DisableIRQ(ADC0_IRQn);
+        ADC_FOR_LOOP_SENSE->SC3 &= ~ADC_SC3_ADCO_MASK;
+        ADC16_SetChannelConfig(ADC_FOR_LOOP_SENSE, ADC_CHANNEL_GROUP,
+                &channel);
+        ADC16_SetHardwareCompareConfig(ADC_FOR_LOOP_SENSE, NULL);
+        guarded_loop = BA8_MAXIMUM_LOOPS;
+}
+
+loop_analog_status_t loop_analog_io_get_status(uint32_t loop)
+{
+        if (loop >= BA8_MAXIMUM_LOOPS) {
+                return LOOP_ANALOG_STATUS_CUT;
+        }
+
+        return (loop_analog_status_t)status[loop];
+}
+
+uint16_t loop_analog_io_get_value(uint32_t loop)
+{
+        if (loop >= BA8_MAXIMUM_LOOPS) {
+                return 0u;
+        }
+
+        return results[loop];
+}
+
+/**
+ * \brief ADC conversion complete interrupt handler
+ *
+ * Occurs only in guard mode, when the guarded loop left its normal window.
+ */
+void ADC0_IRQHandler(void)
+{
+        uint32_t const loop = guarded_loop;
+        uint16_t const value = (uint16_t)ADC16_GetChannelConversionValue(
+                ADC_FOR_LOOP_SENSE, ADC_CHANNEL_GROUP);
+
+        loop_analog_io_stop_guard();
+
+        if (loop < BA8_MAXIMUM_LOOPS) {
+                results[loop] = value;
+                status[loop] = (uint8_t)classify(value, &windows[loop]);
+        }
+
+        if (event_callback) {
+                event_callback(LOOP_ANALOG_EVENT_GUARD_TRIPPED);
+        }
+}
+
+/** @} */
+
+/* EOF */
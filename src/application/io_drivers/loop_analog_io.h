@@ -0,0 +1,192 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOOP_ANALOG_IO_H
+#define LOOP_ANALOG_IO_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       loop_analog_io.h
+ * \defgroup   loop-analog-io Analog loop supervision driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * End-of-line supervision of the alarm loops through the loop sense lines.
+ *
+ * Each loop has an end-of-line resistor network, which forms a voltage divider
+ * together with the pull-up of the sense line. The loop sense voltages are
+ * converted by the ADC with hardware averaging and moved to memory by DMA, and
+ * each loop is classified by the resistance window its reading falls into.
+ *
+ * @{
+ */
+
+/**
+ * \brief Loop status by resistance window
+ */
+typedef enum {
+        /// Loop resistance within the normal window
+        LOOP_ANALOG_STATUS_NORMAL = 0,
+        /// Loop opened by a sensor (alarm resistor in series)
+        LOOP_ANALOG_STATUS_ALARM,
+        /// Loop short circuited
+        LOOP_ANALOG_STATUS_SHORT,
+        /// Loop cable cut
+        LOOP_ANALOG_STATUS_CUT,
+        /// End-of-line resistor bridged or replaced
+        LOOP_ANALOG_STATUS_TAMPER
+} loop_analog_status_t;
+
+/**
+ * \brief Loop resistance windows as 16-bit ADC readings
+ *
+ * The limits must be in ascending order. Readings up to short_max are short
+ * circuits, readings between short_max and normal_min are tampering, readings
+ * between normal_max and cut_min are alarms, and readings from cut_min up are
+ * cut cables.
+ */
+typedef struct {
+        /// Highest reading of a short circuited loop
+        uint16_t short_max;
+        /// Lowest reading of a normal loop
+        uint16_t normal_min;
+        /// Highest reading of a normal loop
+        uint16_t normal_max;
+        /// Lowest reading of a cut loop
+        uint16_t cut_min;
+} loop_analog_window_t;
+
+/**
+ * \brief Loop supervision events
+ */
+typedef enum {
+        /// A scan of all the loops has been completed
+        LOOP_ANALOG_EVENT_SCAN_DONE = 0,
+        /// The guarded loop left its normal window
+        LOOP_ANALOG_EVENT_GUARD_TRIPPED
+} loop_analog_event_t;
+
+/**
+ * \brief Loop supervision event callback
+ *
+ * Called from interrupt context.
+ *
+ * \param[in] event Event
+ */
+typedef void (*loop_analog_io_callback_t)(loop_analog_event_t event);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the analog loop supervision
+ *
+ * \param[in] callback Event callback, or NULL if not used
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_analog_io_init(loop_analog_io_callback_t callback);
+
+/**
+ * \brief Sets the resistance windows of a loop
+ *
+ * \param[in] loop Loop index, where 0 is loop 1
+ * \param[in] window Resistance windows
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_analog_io_set_window(uint32_t loop,
+        const loop_analog_window_t *window);
+
+/**
+ * \brief Starts a scan of all the loops
+ *
+ * The conversions are chained by DMA without CPU intervention. The callback
+ * is called with LOOP_ANALOG_EVENT_SCAN_DONE when all the loops have been
+ * converted and classified.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_analog_io_start_scan(void);
+
+/**
+ * \brief Starts guarding a loop with the ADC hardware compare
+ *
+ * The ADC converts the loop continuously, but it raises an interrupt only when
+ * a reading is out of the normal window of the loop. Then guarding stops and
+ * the callback is called with LOOP_ANALOG_EVENT_GUARD_TRIPPED.
+ *
+ * The hardware compare works on a single channel, so only one loop can be
+ * guarded at a time, and starting a scan stops guarding. The other loops are
+ * supervised by the scans only.
+ *
+ * \param[in] loop Loop index, where 0 is loop 1
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_analog_io_start_guard(uint32_t loop);
+
+/**
+ * \brief Stops guarding
+ */
+void loop_analog_io_stop_guard(void);
+
+/**
+ * \brief Gets the status of a loop from the latest scan
+ *
+ * \param[in] loop Loop index, where 0 is loop 1
+ *
+ * \return Loop status
+ */
+loop_analog_status_t loop_analog_io_get_status(uint32_t loop);
+
+/**
+ * \brief Gets the reading of a loop from the latest scan
+ *
+ * \param[in] loop Loop index, where 0 is loop 1
+ *
+ * \return Averaged 16-bit ADC reading
+ */
+uint16_t loop_analog_io_get_value(uint32_t loop);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef LOOP_ANALOG_IO_H
+
+/* EOF */
@@ -0,0 +1,168 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "loop_wake_io.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "fsl_cmp.h"
+
+/**
+ * \file       loop_wake_io.c
+ * \defgroup   loop-wake-io-implementation Driver implementation
+ * \ingroup    loop-wake-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Port clock for the summed loop sense line
+#define PORT_CLOCK_FOR_SUMMED_SENSE kCLOCK_PortE
+
+/// Port for the summed loop sense line
+#define PORT_FOR_SUMMED_SENSE PORTE
+
+/// Pin for the summed loop sense line (port E, CMP0_IN4)
+#define SUMMED_SENSE_PIN 30u
+
+/// Comparator for the summed loop sense line
+#define CMP_FOR_SUMMED_SENSE CMP0
+/// Comparator input for the summed loop sense line
+#define CMP_INPUT_SUMMED_SENSE 4u
+/// Comparator input for the internal DAC
+#define CMP_INPUT_DAC 7u
+
+/// Comparator filter sample count in run modes
+#define CMP_FILTER_COUNT 7u
+/// Comparator filter sample period in bus clock cycles
+#define CMP_FILTER_PERIOD 255u
+
+/// Comparator events which wake up the core
+#define CMP_WAKE_INTERRUPTS (kCMP_OutputRisingInterruptEnable | \
+        kCMP_OutputFallingInterruptEnable)
+/// Comparator event flags
+#define CMP_EVENT_FLAGS (kCMP_OutputRisingEventFlag | \
+        kCMP_OutputFallingEventFlag)
+
+/// Set by the comparator interrupt when the threshold has been crossed
+static volatile bool woken;
+
+mdv_result_t loop_wake_io_init(void)
+{
+        cmp_config_t config;
+        cmp_filter_config_t filter = {
+                .filterCount = CMP_FILTER_COUNT,
+                .filterPeriod = CMP_FILTER_PERIOD
+        };
+
+        CLOCK_EnableClock(PORT_CLOCK_FOR_SUMMED_SENSE);
+        PORT_SetPinMux(PORT_FOR_SUMMED_SENSE, SUMMED_SENSE_PIN,
+                kPORT_PinDisabledOrAnalog);
+
+        // Use the maximum hysteresis, because the filter is bypassed when the
+        // bus clock is stopped in the stop modes.
+        CMP_GetDefaultConfig(&config);
+        config.enableCmp = false;
+        config.hysteresisMode = kCMP_HysteresisLevel3;
+        CMP_Init(CMP_FOR_SUMMED_SENSE, &config);
+        CMP_SetFilterConfig(CMP_FOR_SUMMED_SENSE, &filter);
+        CMP_SetInputChannels(CMP_FOR_SUMMED_SENSE, CMP_INPUT_SUMMED_SENSE,
+                CMP_INPUT_DAC);
+
+        woken = false;
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t loop_wake_io_arm(uint8_t threshold)
+{
+        cmp_dac_config_t dac = {
+                .referenceVoltageSource = kCMP_VrefSourceVin2,
+                .DACValue = threshold
+        };
+
+        if (threshold > LOOP_WAKE_IO_MAXIMUM_THRESHOLD) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        CMP_SetDACConfig(CMP_FOR_SUMMED_SENSE, &dac);
+        CMP_Enable(CMP_FOR_SUMMED_SENSE, true);
+
+        // Discard the events caused by the settling of the comparator.
+        CMP_ClearStatusFlags(CMP_FOR_SUMMED_SENSE, CMP_EVENT_FLAGS);
+        woken = false;
+
+        CMP_EnableInterrupts(CMP_FOR_SUMMED_SENSE, CMP_WAKE_INTERRUPTS);
+        EnableIRQ(CMP0_IRQn);
+
+        return MDV_RESULT_OK;
+}
+
+void loop_wake_io_disarm(void)
+{
+        DisableIRQ(CMP0_IRQn);
+        CMP_DisableInterrupts(CMP_FOR_SUMMED_SENSE, CMP_WAKE_INTERRUPTS);
+        CMP_SetDACConfig(CMP_FOR_SUMMED_SENSE, NULL);
+        CMP_Enable(CMP_FOR_SUMMED_SENSE, false);
+}
+
+bool loop_wake_io_get_wake(alarm_loop_io_snapshot_t *snapshot)
+{
+        uint32_t i;
+
+        if (!woken) {
+                return false;
+        }
+        woken = false;
+
+        snapshot->alarm = 0u;
+        snapshot->shield = 0u;
+        for (i = 0u; i < BA8_MAXIMUM_LOOPS; ++i) {
+                snapshot->alarm |= (uint8_t)((alarm_input[i].get() & 1u) << i);
+                snapshot->shield |= (uint8_t)(
+                        (shield_alarm_input[i].get() & 1u) << i);
+        }
+
+        return true;
+}
+
+/**
+ * \brief Comparator interrupt handler
+ */
+void CMP0_IRQHandler(void)
+{
+        CMP_ClearStatusFlags(CMP_FOR_SUMMED_SENSE, CMP_EVENT_FLAGS);
+        woken = true;
+}
+
+/** @} */
+
+/* EOF */
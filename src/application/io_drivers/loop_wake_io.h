@@ -0,0 +1,110 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOOP_WAKE_IO_H
+#define LOOP_WAKE_IO_H
+
+#include "ba8_common.h"
+#include "alarm_loop_io.h"
+
+/**
+ * \file       loop_wake_io.h
+ * \defgroup   loop-wake-io Loop disturbance wake-up driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Low-power supervision of the summed loop sense line with the analog
+ * comparator.
+ *
+ * The comparator compares the summed loop sense voltage against its internal
+ * 6-bit DAC. It keeps running in the stop modes, so the core can sleep until
+ * the sense voltage crosses the threshold, without ADC conversions or GPIO
+ * polling.
+ *
+ * @{
+ */
+
+/// Maximum comparator DAC threshold level
+#define LOOP_WAKE_IO_MAXIMUM_THRESHOLD 63u
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the loop disturbance wake-up interface
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_wake_io_init(void);
+
+/**
+ * \brief Arms the wake-up on a threshold crossing
+ *
+ * The threshold should be set just above the summed sense voltage of intact
+ * loops. Any crossing of the threshold, in either direction, raises the
+ * comparator interrupt which wakes the core.
+ *
+ * \param[in] threshold DAC threshold level (0...LOOP_WAKE_IO_MAXIMUM_THRESHOLD)
+ *            as a fraction of the supply voltage in 1/64 steps
+ *
+ * \return Result of the operation
+ */
+mdv_result_t loop_wake_io_arm(uint8_t threshold);
+
+/**
+ * \brief Disarms the wake-up and turns the comparator off
+ */
+void loop_wake_io_disarm(void);
+
+/**
+ * \brief Checks for a wake-up and scans the loops after it
+ *
+ * If the comparator has detected a threshold crossing, all the loops are read
+ * through the alarm and shield alarm input drivers.
+ *
+ * \param[out] snapshot Loop states after the wake-up
+ *
+ * \return True if a wake-up had occurred, otherwise false
+ */
+bool loop_wake_io_get_wake(alarm_loop_io_snapshot_t *snapshot);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef LOOP_WAKE_IO_H
+
+/* EOF */
@@ -0,0 +1,92 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "power_io.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "fsl_gpio.h"
+
+/**
+ * \file       power_io.c
+ * \defgroup   power-io-implementation Driver implementation
+ * \ingroup    power-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Port clock for the power fail input
+#define PORT_CLOCK_FOR_POWER_FAIL kCLOCK_PortE
+
+/// Port for the power fail input
+#define PORT_FOR_POWER_FAIL PORTE
+
+/// GPIO for the power fail input
+#define GPIO_FOR_POWER_FAIL GPIOE
+
+/// Pin for the power fail input (port E)
+#define POWER_FAIL_INPUT_PIN 1u
+
+/// Port pin configuration for the power fail input
+static const port_pin_config_t pin_config = {
+        .pullSelect = kPORT_PullDown,
+        .slewRate = kPORT_SlowSlewRate,
+        .passiveFilterEnable = kPORT_PassiveFilterEnable,
+        .driveStrength = kPORT_LowDriveStrength,
+        .mux = kPORT_MuxAsGpio
+};
+
+/// GPIO configuration for the power fail input
+static const gpio_pin_config_t gpio_input_config = {
+        .pinDirection = kGPIO_DigitalInput,
+        .outputLogic = 0u
+};
+
+mdv_result_t power_io_init(void)
+{
+        CLOCK_EnableClock(PORT_CLOCK_FOR_POWER_FAIL);
+        PORT_SetPinConfig(PORT_FOR_POWER_FAIL, POWER_FAIL_INPUT_PIN,
+                &pin_config);
+        GPIO_PinInit(GPIO_FOR_POWER_FAIL, POWER_FAIL_INPUT_PIN,
+                &gpio_input_config);
+
+        return MDV_RESULT_OK;
+}
+
+bool power_io_mains_failed(void)
+{
+        return GPIO_PinRead(GPIO_FOR_POWER_FAIL, POWER_FAIL_INPUT_PIN) != 0u;
+}
+
+/** @} */
+
+/* EOF */
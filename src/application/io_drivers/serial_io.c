@@ -0,0 +1,271 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "serial_io.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "fsl_dma.h"
+#include "fsl_dmamux.h"
+#include "fsl_lpuart.h"
+#include "fsl_lpuart_dma.h"
+
+/**
+ * \file       serial_io.c
+ * \defgroup   serial-io-implementation Driver implementation
+ * \ingroup    serial-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Port clock for the serial port
+#define PORT_CLOCK_FOR_SERIAL kCLOCK_PortA
+
+/// Port for the serial port
+#define PORT_FOR_SERIAL PORTA
+
+/// Pin for the receive data (port A, LPUART0_RX)
+#define SERIAL_RX_PIN 1u
+/// Pin for the transmit data (port A, LPUART0_TX)
+#define SERIAL_TX_PIN 2u
+
+/// LPUART instance used as the serial port
+#define SERIAL_LPUART LPUART0
+/// LPUART clock source selection for MCGIRCLK (LIRC 8 MHz)
+#define SERIAL_LPUART_CLOCK_SOURCE_MCGIRCLK 3u
+
+/// DMA channel for the transmitter
+#define DMA_CHANNEL_TX BA8_DMA_CHANNEL_SERIAL_TX
+/// Interrupt of the transmitter DMA channel
+#define DMA_CHANNEL_TX_IRQ DMA2_IRQn
+/// DMA channel for the receiver
+#define DMA_CHANNEL_RX BA8_DMA_CHANNEL_SERIAL_RX
+/// Interrupt of the receiver DMA channel
+#define DMA_CHANNEL_RX_IRQ DMA3_IRQn
+/// DMA destination address modulo of the receive buffer
+#define DMA_RX_MODULO kDMA_Modulo256Bytes
+
+/// Length of a receive transfer, a multiple of the receive buffer size.
+/// The DMA byte count register is 20 bits wide, so the transfer is restarted
+/// after about one million bytes.
+#define RX_TRANSFER_LENGTH 0xFFF00u
+
+/// Lowest interrupt priority
+#define IRQ_PRIORITY_LOWEST 3u
+
+/// Port pin configuration for the serial port pins
+static const port_pin_config_t pin_config = {
+        .pullSelect = kPORT_PullUp,
+        .slewRate = kPORT_SlowSlewRate,
+        .passiveFilterEnable = kPORT_PassiveFilterDisable,
+        .driveStrength = kPORT_LowDriveStrength,
+        .mux = kPORT_MuxAlt2
+};
+
+/// DMA handle of the transmitter
+static dma_handle_t tx_dma;
+/// DMA handle of the receiver
+static dma_handle_t rx_dma;
+/// LPUART DMA transfer handle
+static lpuart_dma_handle_t lpuart_dma;
+/// Transmission done notification
+static serial_io_notify_t tx_notify;
+/// Idle line notification
+static serial_io_notify_t rx_notify;
+/// Receive position at the start of the current receive transfer
+static volatile uint32_t rx_base;
+
+/// Receive buffer, aligned to its size for the DMA address modulo
+SDK_ALIGN(static uint8_t rx_buffer[SERIAL_IO_RX_BUFFER_SIZE],
+        SERIAL_IO_RX_BUFFER_SIZE);
+
+/**
+ * \brief Starts a receive transfer into the receive buffer
+ */
+static void start_receive(void)
+{
+        lpuart_transfer_t transfer = {
+                .data = rx_buffer,
+                .dataSize = RX_TRANSFER_LENGTH
+        };
+
+        (void)LPUART_TransferReceiveDMA(SERIAL_LPUART, &lpuart_dma, &transfer);
+        // The transfer is much longer than the buffer, so wrap the
+        // destination address around within the buffer.
+        DMA_SetModulo(DMA0, DMA_CHANNEL_RX, kDMA_ModuloDisable,
+                DMA_RX_MODULO);
+        // Let the receiver request transfers also in VLPS, as the LPUART
+        // keeps running on the MCGIRCLK.
+        DMA_EnableAsyncRequest(DMA0, DMA_CHANNEL_RX, true);
+}
+
+/**
+ * \brief LPUART DMA transfer callback
+ *
+ * \param[in] base LPUART base address
+ * \param[in] handle LPUART DMA handle
+ * \param[in] status Transfer status
+ * \param[in] user_data User data (not used)
+ */
+static void transfer_done(LPUART_Type *base, lpuart_dma_handle_t *handle,
+        status_t status, void *user_data)
+{
+        (void)base;
+        (void)handle;
+        (void)user_data;
+
+        if (status == kStatus_LPUART_TxIdle) {
+                if (tx_notify) {
+                        tx_notify();
+                }
+        } else if (status == kStatus_LPUART_RxIdle) {
+                // The receive transfer ran out. The length is a multiple of
+                // the buffer size, so the next one continues at the same
+                // buffer index.
+                rx_base += RX_TRANSFER_LENGTH;
+                start_receive();
+        }
+}
+
+mdv_result_t serial_io_init(void)
+{
+        lpuart_config_t config;
+
+        CLOCK_EnableClock(PORT_CLOCK_FOR_SERIAL);
+        PORT_SetPinConfig(PORT_FOR_SERIAL, SERIAL_RX_PIN, &pin_config);
+        PORT_SetPinConfig(PORT_FOR_SERIAL, SERIAL_TX_PIN, &pin_config);
+
+        CLOCK_SetLpuart0Clock(SERIAL_LPUART_CLOCK_SOURCE_MCGIRCLK);
+        LPUART_GetDefaultConfig(&config);
+        config.baudRate_Bps = SERIAL_IO_BAUD_RATE;
+        config.enableTx = true;
+        config.enableRx = true;
+        config.rxIdleType = kLPUART_IdleTypeStopBit;
+        config.rxIdleConfig = kLPUART_IdleCharacter2;
+        if (LPUART_Init(SERIAL_LPUART, &config,
+                CLOCK_GetFreq(kCLOCK_McgInternalRefClk)) != kStatus_Success) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        DMAMUX_Init(DMAMUX0);
+        DMAMUX_SetSource(DMAMUX0, DMA_CHANNEL_TX,
+                (uint32_t)kDmaRequestMux0LPUART0Tx);
+        DMAMUX_EnableChannel(DMAMUX0, DMA_CHANNEL_TX);
+        DMAMUX_SetSource(DMAMUX0, DMA_CHANNEL_RX,
+                (uint32_t)kDmaRequestMux0LPUART0Rx);
+        DMAMUX_EnableChannel(DMAMUX0, DMA_CHANNEL_RX);
+
+        DMA_Init(DMA0);
+        DMA_CreateHandle(&tx_dma, DMA0, DMA_CHANNEL_TX);
+        DMA_CreateHandle(&rx_dma, DMA0, DMA_CHANNEL_RX);
+        LPUART_TransferCreateHandleDMA(SERIAL_LPUART, &lpuart_dma,
+                transfer_done, NULL, &tx_dma, &rx_dma);
+
+        // The SDK waits for the last byte to leave the shift register in the
+        // DMA interrupt, so keep it from delaying the loop interrupts.
+        NVIC_SetPriority(DMA_CHANNEL_TX_IRQ, IRQ_PRIORITY_LOWEST);
+        NVIC_SetPriority(DMA_CHANNEL_RX_IRQ, IRQ_PRIORITY_LOWEST);
+
+        rx_base = 0u;
+        start_receive();
+
+        // Only the end of a burst raises an interrupt.
+        (void)LPUART_ClearStatusFlags(SERIAL_LPUART, kLPUART_IdleLineFlag);
+        LPUART_EnableInterrupts(SERIAL_LPUART, kLPUART_IdleLineInterruptEnable);
+        NVIC_SetPriority(LPUART0_IRQn, IRQ_PRIORITY_LOWEST);
+        EnableIRQ(LPUART0_IRQn);
+
+        return MDV_RESULT_OK;
+}
+
+void serial_io_set_tx_notify(serial_io_notify_t notify)
+{
+        tx_notify = notify;
+}
+
+void serial_io_set_rx_notify(serial_io_notify_t notify)
+{
+        rx_notify = notify;
+}
+
+uint32_t serial_io_rx_position(void)
+{
+        uint32_t base;
+        uint32_t remaining;
+
+        // The DMA interrupt may restart the transfer between the reads.
+        do {
+                base = rx_base;
+                remaining = DMA_GetRemainingBytes(DMA0, DMA_CHANNEL_RX);
+        } while (base != rx_base);
+
+        return base + RX_TRANSFER_LENGTH - remaining;
+}
+
+uint8_t const *serial_io_rx_buffer(void)
+{
+        return rx_buffer;
+}
+
+mdv_result_t serial_io_send(uint8_t const *data, uint32_t length)
+{
+        lpuart_transfer_t transfer;
+
+        if (!data || !length) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        transfer.data = (uint8_t *)data;
+        transfer.dataSize = length;
+        if (LPUART_TransferSendDMA(SERIAL_LPUART, &lpuart_dma, &transfer) !=
+                kStatus_Success) {
+                return BA8_RESULT_BUSY;
+        }
+
+        return MDV_RESULT_OK;
+}
+
+/**
+ * \brief LPUART0 status interrupt handler
+ *
+ * Only the idle line interrupt is enabled, the data is moved by DMA.
+ */
+void LPUART0_IRQHandler(void)
+{
+        (void)LPUART_ClearStatusFlags(SERIAL_LPUART, kLPUART_IdleLineFlag);
+        if (rx_notify) {
+                rx_notify();
+        }
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,142 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SERIAL_IO_H
+#define SERIAL_IO_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       serial_io.h
+ * \defgroup   serial-io Serial port driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Serial port for configuration and monitoring on LPUART0 (PTA1 RX, PTA2
+ * TX). The data is transmitted by DMA directly from the caller's buffer, so
+ * the CPU is free while a transfer is in progress.
+ *
+ * The received data is written by DMA into a circular buffer, which wraps
+ * around in hardware by the DMA destination address modulo. No interrupt is
+ * taken per byte: the receiver notifies only when the line goes idle after a
+ * burst of data. The data is read directly from the circular buffer by
+ * positions, which count the received bytes since the initialization.
+ *
+ * @{
+ */
+
+/// Serial port baud rate
+#define SERIAL_IO_BAUD_RATE 115200u
+/// Size of the receive buffer in bytes, a power of two
+#define SERIAL_IO_RX_BUFFER_SIZE 256u
+
+/**
+ * \brief Transmission done and idle line notification callback
+ *
+ * Called from an interrupt handler when all the data of a transfer has been
+ * sent out and the transmitter is ready for the next transfer, or when the
+ * receive line goes idle after a burst of data.
+ */
+typedef void (*serial_io_notify_t)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the serial port
+ *
+ * The timebase must be initialized before this, as the serial port is
+ * clocked from the MCGIRCLK enabled by the timebase.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t serial_io_init(void);
+
+/**
+ * \brief Sets the transmission done notification
+ *
+ * \param[in] notify Callback to call from the interrupt handler when a
+ *            transfer is done, or NULL to disable the notification
+ */
+void serial_io_set_tx_notify(serial_io_notify_t notify);
+
+/**
+ * \brief Sets the idle line notification
+ *
+ * \param[in] notify Callback to call from the interrupt handler when the
+ *            receive line goes idle, or NULL to disable the notification
+ */
+void serial_io_set_rx_notify(serial_io_notify_t notify);
+
+/**
+ * \brief Gets the receive position
+ *
+ * \return Number of bytes received since the initialization
+ */
+uint32_t serial_io_rx_position(void);
+
+/**
+ * \brief Gets the receive buffer
+ *
+ * The byte received at a position is found at the index position &
+ * (SERIAL_IO_RX_BUFFER_SIZE - 1), until SERIAL_IO_RX_BUFFER_SIZE more bytes
+ * have been received.
+ *
+ * \return Receive buffer
+ */
+uint8_t const *serial_io_rx_buffer(void);
+
+/**
+ * \brief Starts sending data
+ *
+ * The function returns immediately. The data buffer must remain unchanged
+ * until the transfer is done.
+ *
+ * \param[in] data Data to send
+ * \param[in] length Length of the data in bytes
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The data is NULL or empty
+ * \retval BA8_RESULT_BUSY A previous transfer is still in progress
+ */
+mdv_result_t serial_io_send(uint8_t const *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef SERIAL_IO_H
+
+/* EOF */
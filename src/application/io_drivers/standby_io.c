@@ -0,0 +1,234 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "standby_io.h"
+#include "fsl_llwu.h"
+#include "fsl_smc.h"
+
+/**
+ * \file       standby_io.c
+ * \defgroup   standby-io-implementation Driver implementation
+ * \ingroup    standby-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// LLWU internal module of the low-power timer
+#define LLWU_MODULE_LPTMR 0u
+/// LLWU internal module of the comparator
+#define LLWU_MODULE_CMP 1u
+
+/// Wake-up source is an alarm signal
+#define SOURCE_ALARM 0u
+/// Wake-up source is a shield alarm signal
+#define SOURCE_SHIELD 1u
+/// Wake-up source is a button
+#define SOURCE_BUTTON 2u
+
+/**
+ * \brief LLWU wake-up pin
+ */
+typedef struct {
+        /// LLWU pin index
+        uint8_t pin;
+        /// LLWU filter index (1...2), or 0 for an unfiltered pin
+        uint8_t filter;
+        /// Wake-up source type
+        uint8_t source;
+        /// Bit of the loop or button
+        uint8_t bit;
+} wake_pin_t;
+
+/// LLWU pins of the loop and button signals
+static const wake_pin_t wake_pins[] = {
+        // Button 2 (PTC1)
+        { .pin = 6u, .filter = 1u, .source = SOURCE_BUTTON, .bit = 1u << 1u },
+        // Button 1 (PTC3)
+        { .pin = 7u, .filter = 2u, .source = SOURCE_BUTTON, .bit = 1u << 0u },
+        // Loop 1 shield alarm (PTC4)
+        { .pin = 8u, .filter = 0u, .source = SOURCE_SHIELD, .bit = 1u << 0u },
+        // Loop 1 alarm (PTC5)
+        { .pin = 9u, .filter = 0u, .source = SOURCE_ALARM, .bit = 1u << 0u },
+        // Loop 2 shield alarm (PTC6)
+        { .pin = 10u, .filter = 0u, .source = SOURCE_SHIELD, .bit = 1u << 1u },
+        // Loop 7 shield alarm (PTD4)
+        { .pin = 14u, .filter = 0u, .source = SOURCE_SHIELD, .bit = 1u << 6u },
+        // Loop 8 shield alarm (PTD6)
+        { .pin = 15u, .filter = 0u, .source = SOURCE_SHIELD, .bit = 1u << 7u }
+};
+
+/// Number of the LLWU pins in use
+#define WAKE_PINS (sizeof(wake_pins) / sizeof(wake_pins[0]))
+
+/// Wake-up sources since the last read
+static volatile standby_io_wake_t wake_sources;
+/// Set when a wake-up has occurred
+static volatile bool woken;
+/// Wake-up notification callback
+static standby_io_notify_t wake_notify;
+
+/**
+ * \brief LLWU interrupt handler
+ *
+ * Records and clears the pin flags. The internal module flags are cleared
+ * only by the interrupt handlers of the modules, so the LLWU interrupt is
+ * disabled until the next standby entry to let those handlers run. A
+ * wake-up by the low-power timer alone is left to the timer handlers and
+ * not notified.
+ */
+void LLWU_IRQHandler(void)
+{
+        bool signal = false;
+
+        for (uint8_t i = 0u; i < WAKE_PINS; ++i) {
+                wake_pin_t const *wake_pin = &wake_pins[i];
+                bool flag;
+
+                if (wake_pin->filter) {
+                        flag = LLWU_GetPinFilterFlag(LLWU, wake_pin->filter);
+                        if (flag) {
+                                LLWU_ClearPinFilterFlag(LLWU,
+                                        wake_pin->filter);
+                        }
+                } else {
+                        flag = LLWU_GetExternalWakeupPinFlag(LLWU,
+                                wake_pin->pin);
+                        if (flag) {
+                                LLWU_ClearExternalWakeupPinFlag(LLWU,
+                                        wake_pin->pin);
+                        }
+                }
+                if (!flag) {
+                        continue;
+                }
+
+                signal = true;
+                switch (wake_pin->source) {
+                case SOURCE_ALARM:
+                        wake_sources.alarm |= wake_pin->bit;
+                        break;
+                case SOURCE_SHIELD:
+                        wake_sources.shield |= wake_pin->bit;
+                        break;
+                default:
+                        wake_sources.buttons |= wake_pin->bit;
+                        break;
+                }
+        }
+
+        if (LLWU_GetInternalWakeupModuleFlag(LLWU, LLWU_MODULE_LPTMR)) {
+                wake_sources.modules |= STANDBY_IO_WAKE_TIMER;
+        }
+        if (LLWU_GetInternalWakeupModuleFlag(LLWU, LLWU_MODULE_CMP)) {
+                wake_sources.modules |= STANDBY_IO_WAKE_COMPARATOR;
+                signal = true;
+        }
+
+        DisableIRQ(LLWU_IRQn);
+        woken = true;
+
+        if (signal && wake_notify) {
+                wake_notify();
+        }
+}
+
+mdv_result_t standby_io_init(standby_io_notify_t notify)
+{
+        for (uint8_t i = 0u; i < WAKE_PINS; ++i) {
+                wake_pin_t const *wake_pin = &wake_pins[i];
+
+                if (wake_pin->filter) {
+                        llwu_external_pin_filter_mode_t const filter = {
+                                .pinIndex = wake_pin->pin,
+                                .filterMode = kLLWU_PinFilterAnyEdge
+                        };
+
+                        // A filtered pin must not trigger the wake-up by
+                        // itself, only through its filter.
+                        LLWU_SetExternalWakeupPinMode(LLWU, wake_pin->pin,
+                                kLLWU_ExternalPinDisable);
+                        LLWU_SetPinFilterMode(LLWU, wake_pin->filter, filter);
+                } else {
+                        LLWU_SetExternalWakeupPinMode(LLWU, wake_pin->pin,
+                                kLLWU_ExternalPinAnyEdge);
+                }
+        }
+        LLWU_EnableInternalModuleInterruptWakup(LLWU, LLWU_MODULE_LPTMR, true);
+        LLWU_EnableInternalModuleInterruptWakup(LLWU, LLWU_MODULE_CMP, true);
+
+        wake_sources.alarm = 0u;
+        wake_sources.shield = 0u;
+        wake_sources.buttons = 0u;
+        wake_sources.modules = 0u;
+        woken = false;
+        wake_notify = notify;
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t standby_io_enter(void)
+{
+        status_t status;
+
+        NVIC_ClearPendingIRQ(LLWU_IRQn);
+        EnableIRQ(LLWU_IRQn);
+
+        SMC_PreEnterStopModes();
+        status = SMC_SetPowerModeLls(SMC);
+        SMC_PostExitStopModes();
+
+        return (status == kStatus_Success) ? MDV_RESULT_OK : BA8_RESULT_BUSY;
+}
+
+bool standby_io_get_wake(standby_io_wake_t *wake)
+{
+        uint32_t const primask = DisableGlobalIRQ();
+        bool const result = woken;
+
+        wake->alarm = wake_sources.alarm;
+        wake->shield = wake_sources.shield;
+        wake->buttons = wake_sources.buttons;
+        wake->modules = wake_sources.modules;
+        wake_sources.alarm = 0u;
+        wake_sources.shield = 0u;
+        wake_sources.buttons = 0u;
+        wake_sources.modules = 0u;
+        woken = false;
+
+        EnableGlobalIRQ(primask);
+
+        return result;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,134 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef STANDBY_IO_H
+#define STANDBY_IO_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       standby_io.h
+ * \defgroup   standby-io Low-leakage standby driver
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Low-leakage stop (LLS) mode with wake-up on the loop and button signals.
+ *
+ * The loop and button signals with a low-leakage wake-up unit (LLWU) pin
+ * wake the core directly on any edge. These are the alarm signal of loop 1,
+ * the shield alarm signals of loops 1, 2, 7 and 8, and buttons 1 and 2, of
+ * which the buttons go through the two LLWU digital filters. The low-power
+ * timer and the loop disturbance comparator wake the core through the LLWU
+ * internal modules, which covers the rest of the signals with periodic
+ * sampling and with the summed loop sense line.
+ *
+ * Only the LPO and the comparator keep running in LLS, so the timebase and
+ * the backlight modulation are stopped while in standby.
+ *
+ * @{
+ */
+
+/// Wake-up by the low-power timer
+#define STANDBY_IO_WAKE_TIMER 0x01u
+/// Wake-up by the loop disturbance comparator
+#define STANDBY_IO_WAKE_COMPARATOR 0x02u
+
+/**
+ * \brief Wake-up sources
+ *
+ * Bit n of the signal fields belongs to loop or button n + 1.
+ */
+typedef struct {
+        /// Alarm signals which caused a wake-up
+        uint8_t alarm;
+        /// Shield alarm signals which caused a wake-up
+        uint8_t shield;
+        /// Buttons which caused a wake-up
+        uint8_t buttons;
+        /// Internal modules which caused a wake-up
+        uint8_t modules;
+} standby_io_wake_t;
+
+/**
+ * \brief Wake-up notification callback
+ *
+ * Called from the LLWU interrupt handler after a wake-up from standby by a
+ * signal or the comparator, not after a wake-up by the low-power timer.
+ */
+typedef void (*standby_io_notify_t)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the standby interface
+ *
+ * The alarm loop and button inputs must be initialized before this. The
+ * power mode protection must allow LLS.
+ *
+ * \param[in] notify Wake-up notification callback, or NULL
+ *
+ * \return Result of the operation
+ */
+mdv_result_t standby_io_init(standby_io_notify_t notify);
+
+/**
+ * \brief Enters standby and returns after a wake-up
+ *
+ * Must be called with interrupts disabled. The interrupt that woke the core
+ * is served once the interrupts are enabled again.
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_BUSY The stop mode entry was aborted by a pending
+ *         interrupt
+ */
+mdv_result_t standby_io_enter(void);
+
+/**
+ * \brief Gets and clears the wake-up sources since the last call
+ *
+ * \param[out] wake Wake-up sources
+ *
+ * \return True if a wake-up had occurred, otherwise false
+ */
+bool standby_io_get_wake(standby_io_wake_t *wake);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef STANDBY_IO_H
+
+/* EOF */
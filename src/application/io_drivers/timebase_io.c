@@ -0,0 +1,115 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "timebase_io.h"
+#include "fsl_clock.h"
+#include "fsl_tpm.h"
+
+/**
+ * \file       timebase_io.c
+ * \defgroup   timebase-io-implementation Driver implementation
+ * \ingroup    timebase-io
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// TPM instance used as the timebase
+#define TIMEBASE_TPM TPM0
+/// Interrupt of the timebase TPM
+#define TIMEBASE_TPM_IRQ TPM0_IRQn
+/// TPM clock source selection for MCGIRCLK (LIRC 8 MHz)
+#define TIMEBASE_TPM_CLOCK_SOURCE_MCGIRCLK 3u
+/// TPM prescaler to get 1 MHz from the 8 MHz LIRC
+#define TIMEBASE_TPM_PRESCALE kTPM_Prescale_Divide_8
+/// Modulo value for the full 16-bit counter range
+#define TIMEBASE_TPM_MODULO 0xFFFFu
+/// Counter values below this are considered to be wrapped around
+#define TIMEBASE_TPM_WRAP_THRESHOLD 0x8000u
+
+/// Upper 16 bits of the timebase, incremented on every counter overflow
+static volatile uint32_t overflows;
+
+/**
+ * \brief Timebase counter overflow interrupt handler
+ */
+void TPM0_IRQHandler(void)
+{
+        TPM_ClearStatusFlags(TIMEBASE_TPM, kTPM_TimeOverflowFlag);
+        overflows += TIMEBASE_TPM_MODULO + 1u;
+}
+
+mdv_result_t timebase_io_init(void)
+{
+        tpm_config_t config;
+
+        // Keep the LIRC running as MCGIRCLK, also in stop modes, so that the
+        // timebase does not depend on the core clock configuration.
+        MCG->C1 |= MCG_C1_IRCLKEN_MASK | MCG_C1_IREFSTEN_MASK;
+        CLOCK_SetTpmClock(TIMEBASE_TPM_CLOCK_SOURCE_MCGIRCLK);
+
+        TPM_GetDefaultConfig(&config);
+        config.prescale = TIMEBASE_TPM_PRESCALE;
+        config.enableDoze = false;
+        TPM_Init(TIMEBASE_TPM, &config);
+        TPM_SetTimerPeriod(TIMEBASE_TPM, TIMEBASE_TPM_MODULO);
+
+        overflows = 0u;
+        TPM_EnableInterrupts(TIMEBASE_TPM, kTPM_TimeOverflowInterruptEnable);
+        EnableIRQ(TIMEBASE_TPM_IRQ);
+        TPM_StartTimer(TIMEBASE_TPM, kTPM_SystemClock);
+
+        return MDV_RESULT_OK;
+}
+
+uint32_t timebase_io_now(void)
+{
+        uint32_t const primask = DisableGlobalIRQ();
+        uint32_t high = overflows;
+        uint32_t const count = TIMEBASE_TPM->CNT;
+
+        // If the counter has wrapped around but the overflow interrupt has not
+        // been served yet (e.g. when called from a higher priority interrupt),
+        // account for the pending overflow here.
+        if ((TIMEBASE_TPM->STATUS & TPM_STATUS_TOF_MASK) &&
+                (count < TIMEBASE_TPM_WRAP_THRESHOLD)) {
+                high += TIMEBASE_TPM_MODULO + 1u;
+        }
+
+        EnableGlobalIRQ(primask);
+
+        return high | count;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,352 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "journal.h"
+#include "crc16.h"
+#include "flash_io.h"
+#include <stddef.h>
+
+/**
+ * \file       journal.c
+ * \defgroup   journal-implementation Event journal implementation
+ * \ingroup    journal
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Magic number of a journal sector header ("JRNL")
+#define HEADER_MAGIC 0x4A524E4Cu
+/// Sector index for no sector
+#define NO_SECTOR 0xFFFFFFFFu
+/// Maximum erase count kept in the sector header
+#define ERASE_COUNT_MAX 0xFFFFu
+
+/**
+ * \brief Journal sector header
+ */
+typedef struct {
+        /// Magic number
+        uint32_t magic;
+        /// Sector sequence number
+        uint32_t sequence;
+        /// Sequence number of the first record in the sector
+        uint32_t first_record;
+        /// Number of times the sector has been erased
+        uint16_t erase_count;
+        /// CRC-16 of the preceding fields
+        uint16_t crc;
+} sector_header_t;
+
+/// Newest sector, or NO_SECTOR when the journal is empty
+static uint32_t head;
+/// First free record slot in the newest sector
+static uint32_t next_slot;
+/// Sequence number of the next record
+static uint32_t next_record;
+
+/**
+ * \brief Gets the header of a sector
+ *
+ * \param[in] sector Sector index
+ *
+ * \return Sector header in flash
+ */
+static inline sector_header_t const *header_of(uint32_t sector)
+{
+        return (sector_header_t const *)(BA8_FLASH_JOURNAL_START +
+                (sector * BA8_FLASH_SECTOR_SIZE));
+}
+
+/**
+ * \brief Gets the address of a record slot
+ *
+ * \param[in] sector Sector index
+ * \param[in] slot Record slot in the sector
+ *
+ * \return Record address in flash
+ */
+static inline uint32_t record_address(uint32_t sector, uint32_t slot)
+{
+        return BA8_FLASH_JOURNAL_START + (sector * BA8_FLASH_SECTOR_SIZE) +
+                sizeof(journal_record_t) + (slot * sizeof(journal_record_t));
+}
+
+/**
+ * \brief Checks whether a sector header is intact
+ *
+ * \param[in] sector Sector index
+ *
+ * \return True if the header is valid
+ */
+static bool header_valid(uint32_t sector)
+{
+        sector_header_t const *header = header_of(sector);
+
+        return (header->magic == HEADER_MAGIC) &&
+                (header->crc == crc16_update(CRC16_INITIAL_VALUE, header,
+                        offsetof(sector_header_t, crc)));
+}
+
+/**
+ * \brief Checks whether a sector is newer than or as new as sector 0
+ *
+ * \param[in] sector Sector index
+ *
+ * \return True if the sector is valid and not older than sector 0
+ */
+static bool not_older_than_first(uint32_t sector)
+{
+        return header_valid(sector) && ((int32_t)(header_of(sector)->sequence -
+                header_of(0u)->sequence) >= 0);
+}
+
+/**
+ * \brief Finds the newest sector
+ *
+ * The sector sequence numbers increase along the ring up to the newest
+ * sector and drop after it, so the newest sector is the last one which is
+ * not older than sector 0. Only if sector 0 itself is not valid, e.g. when
+ * its erase was interrupted, all the headers are scanned.
+ *
+ * \return Index of the newest sector, or NO_SECTOR if there is none
+ */
+static uint32_t find_head(void)
+{
+        uint32_t low = 0u;
+        uint32_t high = BA8_FLASH_JOURNAL_SECTORS - 1u;
+
+        if (!header_valid(0u)) {
+                uint32_t newest = NO_SECTOR;
+
+                for (uint32_t sector = 1u; sector < BA8_FLASH_JOURNAL_SECTORS;
+                        ++sector) {
+                        if (header_valid(sector) && ((newest == NO_SECTOR) ||
+                                ((int32_t)(header_of(sector)->sequence -
+                                header_of(newest)->sequence) > 0))) {
+                                newest = sector;
+                        }
+                }
+
+                return newest;
+        }
+
+        while (low < high) {
+                uint32_t const middle = (low + high + 1u) / 2u;
+
+                if (not_older_than_first(middle)) {
+                        low = middle;
+                } else {
+                        high = middle - 1u;
+                }
+        }
+
+        return low;
+}
+
+/**
+ * \brief Finds the first free record slot in a sector
+ *
+ * The records are appended in order, so the erased slots are all at the end
+ * of the sector.
+ *
+ * \param[in] sector Sector index
+ *
+ * \return First free slot, or JOURNAL_RECORDS_PER_SECTOR if the sector is
+ *         full
+ */
+static uint32_t find_free_slot(uint32_t sector)
+{
+        uint32_t low = 0u;
+        uint32_t high = JOURNAL_RECORDS_PER_SECTOR;
+
+        while (low < high) {
+                uint32_t const middle = (low + high) / 2u;
+
+                if (flash_io_is_erased(record_address(sector, middle),
+                        sizeof(journal_record_t))) {
+                        high = middle;
+                } else {
+                        low = middle + 1u;
+                }
+        }
+
+        return low;
+}
+
+/**
+ * \brief Erases a sector and writes a new header into it
+ *
+ * \param[in] sector Sector index
+ * \param[in] sequence Sector sequence number
+ *
+ * \return Result of the operation
+ */
+static mdv_result_t open_sector(uint32_t sector, uint32_t sequence)
+{
+        sector_header_t header = {
+                .magic = HEADER_MAGIC,
+                .sequence = sequence,
+                .first_record = next_record,
+                .erase_count = 0u
+        };
+        uint32_t const address = BA8_FLASH_JOURNAL_START +
+                (sector * BA8_FLASH_SECTOR_SIZE);
+        mdv_result_t result;
+
+        if (header_valid(sector) &&
+                (header_of(sector)->erase_count < ERASE_COUNT_MAX)) {
+                header.erase_count = header_of(sector)->erase_count + 1u;
+        }
+        header.crc = crc16_update(CRC16_INITIAL_VALUE, &header,
+                offsetof(sector_header_t, crc));
+
+        result = flash_io_erase_sector(address);
+        if (result != MDV_RESULT_OK) {
+                return result;
+        }
+
+        return flash_io_program(address, &header, sizeof(header));
+}
+
+mdv_result_t journal_init(void)
+{
+        head = find_head();
+
+        if (head == NO_SECTOR) {
+                next_slot = 0u;
+                next_record = 0u;
+        } else {
+                next_slot = find_free_slot(head);
+                next_record = header_of(head)->first_record + next_slot;
+        }
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t journal_append(journal_event_t event, uint8_t loops,
+        uint16_t data, uint32_t time)
+{
+        journal_record_t record = {
+                .sequence = next_record,
+                .time = time,
+                .event = (uint8_t)event,
+                .loops = loops,
+                .data = data,
+                .reserved = 0xFFFFu
+        };
+        mdv_result_t result;
+
+        if (head == NO_SECTOR) {
+                result = open_sector(0u, 0u);
+                if (result != MDV_RESULT_OK) {
+                        return result;
+                }
+                head = 0u;
+                next_slot = 0u;
+        } else if (next_slot >= JOURNAL_RECORDS_PER_SECTOR) {
+                uint32_t const sector = (head + 1u) %
+                        BA8_FLASH_JOURNAL_SECTORS;
+
+                result = open_sector(sector, header_of(head)->sequence + 1u);
+                if (result != MDV_RESULT_OK) {
+                        return result;
+                }
+                head = sector;
+                next_slot = 0u;
+        }
+
+        record.crc = crc16_update(CRC16_INITIAL_VALUE, &record,
+                offsetof(journal_record_t, crc));
+
+        // The slot is used up even if the programming fails, as it may have
+        // been partially programmed.
+        result = flash_io_program(record_address(head, next_slot), &record,
+                sizeof(record));
+        ++next_slot;
+        ++next_record;
+
+        return result;
+}
+
+uint32_t journal_next_sequence(void)
+{
+        return next_record;
+}
+
+bool journal_read(uint32_t sequence, journal_record_t *record)
+{
+        uint32_t sector = head;
+
+        if ((head == NO_SECTOR) || ((int32_t)(sequence - next_record) >= 0)) {
+                return false;
+        }
+
+        for (uint32_t i = 0u; i < BA8_FLASH_JOURNAL_SECTORS; ++i) {
+                sector_header_t const *header;
+                journal_record_t const *stored;
+                uint32_t slot;
+
+                if (!header_valid(sector)) {
+                        return false;
+                }
+                header = header_of(sector);
+
+                if ((int32_t)(sequence - header->first_record) < 0) {
+                        sector = (sector + BA8_FLASH_JOURNAL_SECTORS - 1u) %
+                                BA8_FLASH_JOURNAL_SECTORS;
+                        continue;
+                }
+
+                slot = sequence - header->first_record;
+                if (slot >= JOURNAL_RECORDS_PER_SECTOR) {
+                        return false;
+                }
+
+                stored = (journal_record_t const *)record_address(sector,
+                        slot);
+                if ((stored->sequence != sequence) ||
+                        (stored->crc != crc16_update(CRC16_INITIAL_VALUE,
+                                stored, offsetof(journal_record_t, crc)))) {
+                        return false;
+                }
+
+                *record = *stored;
+
+                return true;
+        }
+
+        return false;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,166 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       journal.h
+ * \defgroup   journal Event journal
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Append-only event journal in the internal flash.
+ *
+ * The journal fills a ring of flash sectors with fixed-size records. Each
+ * sector starts with a header holding a sector sequence number, the
+ * sequence number of its first record and its erase count. Every record
+ * carries its own sequence number and CRC, so a record torn by a power loss
+ * is detected and skipped.
+ *
+ * The sectors are always written and erased in ring order, so every sector
+ * is erased once per round and the wear is spread evenly. With 16 sectors
+ * of 63 records and 10 000 erase cycles, the journal holds about 10 million
+ * records before wearing out, i.e. over 100 years at 200 events per day.
+ *
+ * At startup, the newest sector is found with a binary search over the
+ * sector headers, as the sector sequence numbers increase along the ring up
+ * to the newest one. The first free record in it is found with a binary
+ * search as well.
+ *
+ * @{
+ */
+
+/// Number of records per journal sector
+#define JOURNAL_RECORDS_PER_SECTOR \
+        ((BA8_FLASH_SECTOR_SIZE / sizeof(journal_record_t)) - 1u)
+
+/// Flag in the data of an arm or disarm record whose low byte holds the loops
+/// armed after the event
+#define JOURNAL_DATA_ARMED 0x0100u
+
+/**
+ * \brief Journal event types
+ */
+typedef enum {
+        /// Alarm latched
+        JOURNAL_EVENT_ALARM = 1,
+        /// Tamper alarm latched
+        JOURNAL_EVENT_TAMPER,
+        /// Loops armed
+        JOURNAL_EVENT_ARM,
+        /// Loops disarmed
+        JOURNAL_EVENT_DISARM,
+        /// Loop fault detected
+        JOURNAL_EVENT_FAULT,
+        /// Restarted by the COP watchdog
+        JOURNAL_EVENT_WATCHDOG
+} journal_event_t;
+
+/**
+ * \brief Journal record
+ */
+typedef struct {
+        /// Record sequence number
+        uint32_t sequence;
+        /// Event time
+        uint32_t time;
+        /// Event type
+        uint8_t event;
+        /// Loops of the event
+        uint8_t loops;
+        /// Event specific data
+        uint16_t data;
+        /// Reserved, always 0xFFFF
+        uint16_t reserved;
+        /// CRC-16 of the preceding fields
+        uint16_t crc;
+} journal_record_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the journal
+ *
+ * Locates the newest record in the flash. The flash driver must be
+ * initialized before this.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t journal_init(void);
+
+/**
+ * \brief Appends a record to the journal
+ *
+ * Erases the oldest sector when the newest one becomes full.
+ *
+ * \param[in] event Event type
+ * \param[in] loops Loops of the event
+ * \param[in] data Event specific data
+ * \param[in] time Event time
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_FLASH_ERROR Erasing or programming the flash failed
+ */
+mdv_result_t journal_append(journal_event_t event, uint8_t loops,
+        uint16_t data, uint32_t time);
+
+/**
+ * \brief Gets the sequence number of the next record to be appended
+ *
+ * \return Next sequence number
+ */
+uint32_t journal_next_sequence(void);
+
+/**
+ * \brief Reads a record
+ *
+ * \param[in] sequence Sequence number of the record
+ * \param[out] record Record
+ *
+ * \return True if the record was found and is intact, otherwise false
+ */
+bool journal_read(uint32_t sequence, journal_record_t *record);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef JOURNAL_H
+
+/* EOF */
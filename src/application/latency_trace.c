@@ -0,0 +1,287 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "latency_trace.h"
+
+/**
+ * \file       latency_trace.c
+ * \defgroup   latency-trace-implementation Latency instrumentation
+ *             implementation
+ * \ingroup    latency-trace
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+#if BA8_LATENCY_TRACE
+
+/// Saturation value of the histogram buckets
+#define BUCKET_MAX 0xFFFFu
+
+/// Latency histograms of each loop and stage
+static latency_histogram_t histograms[BA8_MAXIMUM_LOOPS][LATENCY_STAGES];
+/// Edge timestamps of the loops
+static uint32_t edge_time[BA8_MAXIMUM_LOOPS];
+/// Loops with a pending edge
+static uint8_t pending;
+
+/**
+ * \brief Gets the histogram bucket of a latency
+ *
+ * \param[in] latency Latency in timebase ticks
+ *
+ * \return Bucket index
+ */
+static uint32_t bucket_of(uint32_t latency)
+{
+        uint32_t bucket = 0u;
+
+        while ((latency >>= 1u) && (bucket < LATENCY_TRACE_BUCKETS - 1u)) {
+                ++bucket;
+        }
+
+        return bucket;
+}
+
+/**
+ * \brief Appends a decimal number to a text buffer
+ *
+ * \param[in,out] text Text buffer position
+ * \param[in] value Value to append
+ *
+ * \return Position after the appended number
+ */
+static char *append_number(char *text, uint32_t value)
+{
+        char digits[10];
+        uint32_t length = 0u;
+
+        do {
+                digits[length++] = (char)('0' + (value % 10u));
+                value /= 10u;
+        } while (value);
+
+        while (length) {
+                *text++ = digits[--length];
+        }
+
+        return text;
+}
+
+/**
+ * \brief Appends a text to a text buffer
+ *
+ * \param[in,out] text Text buffer position
+ * \param[in] source Zero terminated text to append
+ *
+ * \return Position after the appended text
+ */
+static char *append_text(char *text, char const *source)
+{
+        while (*source) {
+                *text++ = *source++;
+        }
+
+        return text;
+}
+
+void latency_trace_init(void)
+{
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                for (uint8_t stage = 0u; stage < LATENCY_STAGES; ++stage) {
+                        latency_histogram_t *histogram =
+                                &histograms[loop][stage];
+
+                        histogram->count = 0u;
+                        histogram->min = UINT32_MAX;
+                        histogram->max = 0u;
+                        for (uint8_t i = 0u; i < LATENCY_TRACE_BUCKETS; ++i) {
+                                histogram->buckets[i] = 0u;
+                        }
+                }
+        }
+        pending = 0u;
+}
+
+void latency_trace_edge(uint8_t loops, uint32_t timestamp)
+{
+        uint8_t const first = loops & ~pending;
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if (first & (1u << loop)) {
+                        edge_time[loop] = timestamp;
+                }
+        }
+        pending |= first;
+}
+
+void latency_trace_stage(latency_stage_t stage, uint8_t loops,
+        uint32_t timestamp)
+{
+        uint8_t const traced = loops & pending;
+
+        if (stage >= LATENCY_STAGES) {
+                return;
+        }
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                latency_histogram_t *histogram;
+                uint32_t latency;
+                uint32_t bucket;
+
+                if (!(traced & (1u << loop))) {
+                        continue;
+                }
+
+                histogram = &histograms[loop][stage];
+                latency = timestamp - edge_time[loop];
+                bucket = bucket_of(latency);
+
+                ++histogram->count;
+                if (latency < histogram->min) {
+                        histogram->min = latency;
+                }
+                if (latency > histogram->max) {
+                        histogram->max = latency;
+                }
+                if (histogram->buckets[bucket] < BUCKET_MAX) {
+                        ++histogram->buckets[bucket];
+                }
+        }
+}
+
+void latency_trace_finish(void)
+{
+        pending = 0u;
+}
+
+latency_histogram_t const *latency_trace_get(uint8_t loop,
+        latency_stage_t stage)
+{
+        if ((loop >= BA8_MAXIMUM_LOOPS) || (stage >= LATENCY_STAGES)) {
+                return NULL;
+        }
+
+        return &histograms[loop][stage];
+}
+
+uint32_t latency_trace_percentile(latency_histogram_t const *histogram,
+        uint8_t percent)
+{
+        uint32_t total = 0u;
+        uint32_t target;
+        uint32_t sum = 0u;
+
+        for (uint8_t i = 0u; i < LATENCY_TRACE_BUCKETS; ++i) {
+                total += histogram->buckets[i];
+        }
+        if (!total) {
+                return 0u;
+        }
+
+        // Rank of the percentile, rounded up.
+        target = (total * percent + 99u) / 100u;
+        if (!target) {
+                target = 1u;
+        }
+
+        for (uint8_t i = 0u; i < LATENCY_TRACE_BUCKETS; ++i) {
+                sum += histogram->buckets[i];
+                if (sum >= target) {
+                        uint32_t const upper = (2u << i) - 1u;
+
+                        return (upper < histogram->max) ?
+                                upper : histogram->max;
+                }
+        }
+
+        return histogram->max;
+}
+
+bool latency_trace_dump_line(uint32_t *position, char *line)
+{
+        static char const * const stage_names[LATENCY_STAGES] = {
+                "decision", "transition", "relay"
+        };
+        char *text = line;
+
+        // Position 0 is the header, and position n + 1 the histogram n in
+        // the loop and stage order.
+        if (*position == 0u) {
+                text = append_text(text,
+                        "loop stage count min p50 p90 p99 max\r\n");
+                *text = '\0';
+                ++*position;
+                return true;
+        }
+
+        while (*position <= BA8_MAXIMUM_LOOPS * LATENCY_STAGES) {
+                uint32_t const loop = (*position - 1u) / LATENCY_STAGES;
+                uint32_t const stage = (*position - 1u) % LATENCY_STAGES;
+                latency_histogram_t const *histogram =
+                        &histograms[loop][stage];
+
+                ++*position;
+                if (!histogram->count) {
+                        continue;
+                }
+
+                text = append_number(text, loop + 1u);
+                text = append_text(text, " ");
+                text = append_text(text, stage_names[stage]);
+                text = append_text(text, " ");
+                text = append_number(text, histogram->count);
+                text = append_text(text, " ");
+                text = append_number(text, histogram->min);
+                text = append_text(text, " ");
+                text = append_number(text,
+                        latency_trace_percentile(histogram, 50u));
+                text = append_text(text, " ");
+                text = append_number(text,
+                        latency_trace_percentile(histogram, 90u));
+                text = append_text(text, " ");
+                text = append_number(text,
+                        latency_trace_percentile(histogram, 99u));
+                text = append_text(text, " ");
+                text = append_number(text, histogram->max);
+                text = append_text(text, "\r\n");
+                *text = '\0';
+                return true;
+        }
+
+        return false;
+}
+
+#endif // if BA8_LATENCY_TRACE
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,208 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       latency_trace.h
+ * \defgroup   latency-trace Alarm latency instrumentation
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Measures the latency from a loop edge to each stage of the alarm
+ * processing, up to the relay output write, and keeps a histogram of the
+ * latencies of each loop and stage.
+ *
+ * The edge time comes from the timestamp of the edge interrupt, and the
+ * stages are timestamped with the same timebase. The histogram buckets are
+ * logarithmic: bucket n counts latencies of 2^n...2^(n+1) - 1 timebase
+ * ticks, and bucket 0 also counts zero latencies.
+ *
+ * The instrumentation is compiled in only when BA8_LATENCY_TRACE is
+ * nonzero, which is the default for builds without NDEBUG. Otherwise the
+ * LATENCY_TRACE_* macros expand to nothing.
+ *
+ * @{
+ */
+
+#ifndef BA8_LATENCY_TRACE
+#ifdef NDEBUG
+/// Latency instrumentation enable
+#define BA8_LATENCY_TRACE 0
+#else
+/// Latency instrumentation enable
+#define BA8_LATENCY_TRACE 1
+#endif // ifdef NDEBUG
+#endif // ifndef BA8_LATENCY_TRACE
+
+/// Number of histogram buckets
+#define LATENCY_TRACE_BUCKETS 20u
+/// Maximum length of one dump line including the terminator
+#define LATENCY_TRACE_LINE_LENGTH 96u
+
+/**
+ * \brief Alarm processing stages
+ */
+typedef enum {
+        /// Input sample accepted for the evaluation
+        LATENCY_STAGE_DECISION = 0,
+        /// Alarm state transition
+        LATENCY_STAGE_TRANSITION,
+        /// Relay output switched on by the loop
+        LATENCY_STAGE_RELAY,
+        /// Number of the stages
+        LATENCY_STAGES
+} latency_stage_t;
+
+/**
+ * \brief Latency histogram
+ */
+typedef struct {
+        /// Number of latencies
+        uint32_t count;
+        /// Minimum latency in timebase ticks
+        uint32_t min;
+        /// Maximum latency in timebase ticks
+        uint32_t max;
+        /// Histogram buckets
+        uint16_t buckets[LATENCY_TRACE_BUCKETS];
+} latency_histogram_t;
+
+#if BA8_LATENCY_TRACE
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Clears all the histograms and pending edges
+ */
+void latency_trace_init(void);
+
+/**
+ * \brief Records edges of loops
+ *
+ * Only the first edge of each loop is kept until the processing finishes.
+ *
+ * \param[in] loops Loops with an edge
+ * \param[in] timestamp Timebase value of the edge
+ */
+void latency_trace_edge(uint8_t loops, uint32_t timestamp);
+
+/**
+ * \brief Records a processing stage of loops
+ *
+ * Loops without a pending edge are ignored.
+ *
+ * \param[in] stage Processing stage
+ * \param[in] loops Loops processed
+ * \param[in] timestamp Timebase value at the stage
+ */
+void latency_trace_stage(latency_stage_t stage, uint8_t loops,
+        uint32_t timestamp);
+
+/**
+ * \brief Finishes the processing of all the pending edges
+ */
+void latency_trace_finish(void);
+
+/**
+ * \brief Gets a latency histogram
+ *
+ * \param[in] loop Index of the loop (0...BA8_MAXIMUM_LOOPS - 1)
+ * \param[in] stage Processing stage
+ *
+ * \return Histogram, or NULL if the loop or stage is out of range
+ */
+latency_histogram_t const *latency_trace_get(uint8_t loop,
+        latency_stage_t stage);
+
+/**
+ * \brief Estimates a percentile of a histogram
+ *
+ * \param[in] histogram Latency histogram
+ * \param[in] percent Percentile (0...100)
+ *
+ * \return Upper bound of the bucket holding the percentile in timebase ticks,
+ *         limited to the maximum latency
+ */
+uint32_t latency_trace_percentile(latency_histogram_t const *histogram,
+        uint8_t percent);
+
+/**
+ * \brief Formats the next line of the histogram dump
+ *
+ * The dump starts with a header line, followed by one line per loop and
+ * stage with the count, minimum, median, 90th and 99th percentile and
+ * maximum latencies in timebase ticks. The histograms without latencies
+ * are left out. The lines end with a carriage return and a line feed.
+ *
+ * \param[in,out] position Dump position, 0 for the first line. Advanced
+ *                 past the formatted line.
+ * \param[out] line Zero terminated line, LATENCY_TRACE_LINE_LENGTH bytes
+ *
+ * \return True if a line was formatted, false at the end of the dump
+ */
+bool latency_trace_dump_line(uint32_t *position, char *line);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/// Records edges of loops
+#define LATENCY_TRACE_EDGE(loops, timestamp) \
+        latency_trace_edge((loops), (timestamp))
+/// Records a processing stage of loops
+#define LATENCY_TRACE_STAGE(stage, loops, timestamp) \
+        latency_trace_stage((stage), (loops), (timestamp))
+/// Finishes the processing of all the pending edges
+#define LATENCY_TRACE_FINISH() latency_trace_finish()
+
+#else
+
+/// Records edges of loops
+#define LATENCY_TRACE_EDGE(loops, timestamp)
+/// Records a processing stage of loops
+#define LATENCY_TRACE_STAGE(stage, loops, timestamp)
+/// Finishes the processing of all the pending edges
+#define LATENCY_TRACE_FINISH()
+
+#endif // if BA8_LATENCY_TRACE
+
+/** @} */
+
+#endif // ifndef LATENCY_TRACE_H
+
+/* EOF */
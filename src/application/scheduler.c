@@ -0,0 +1,409 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "scheduler.h"
+#include "fsl_lptmr.h"
+#include "fsl_os_abstraction.h"
+#include "fsl_smc.h"
+#include "loop_wake_io.h"
+#include "standby_io.h"
+#include "watchdog.h"
+
+/**
+ * \file       scheduler.c
+ * \defgroup   scheduler-implementation Scheduler implementation
+ * \ingroup    scheduler
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Low-power timer instance
+#define SCHEDULER_LPTMR LPTMR0
+/// Interrupt of the low-power timer
+#define SCHEDULER_LPTMR_IRQ LPTMR0_IRQn
+/// Longest low-power timer period in milliseconds
+#define SCHEDULER_LPTMR_MAXIMUM_PERIOD 0xFFFFu
+/// Internal event flag for expired timers
+#define SCHEDULER_TIMER_FLAG (1u << SCHEDULER_EVENTS)
+/// Internal timer for sampling the inputs in standby
+#define STANDBY_SAMPLE_TIMER SCHEDULER_TIMERS
+/// Number of timers including the internal ones
+#define TIMER_SLOTS (SCHEDULER_TIMERS + 1u)
+/// Watchdog liveness bits of event flags
+#define WATCHDOG_SOURCES(flags) \
+        ((uint32_t)(flags) << WATCHDOG_SOURCE_SCHEDULER_FLAGS)
+
+/// Event flags
+static EVENT_HANDLE_BUFFER_DEFINE(event_handle);
+/// Event handlers
+static scheduler_handler_t event_handler[SCHEDULER_EVENTS];
+/// Timer handlers, NULL for a stopped timer
+static scheduler_handler_t timer_handler[TIMER_SLOTS];
+/// Timer deadlines in milliseconds
+static uint32_t timer_deadline[TIMER_SLOTS];
+/// Time in milliseconds at the start of the current low-power timer period
+static volatile uint32_t now;
+/// Length of the current low-power timer period, 0 when not running
+static volatile uint32_t period;
+/// Number of nested stop mode preventions
+static volatile uint32_t stop_prevented;
+/// Input sampling interval in standby in milliseconds, 0 when not in standby
+static uint32_t standby_interval;
+
+/**
+ * \brief Sets event flags
+ *
+ * The flags stay required by the watchdog until their handlers have run.
+ * Can be called from interrupt handlers.
+ *
+ * \param[in] flags Event flags
+ */
+static void set_flags(osa_event_flags_t flags)
+{
+        watchdog_require(WATCHDOG_SOURCES(flags));
+        (void)OSA_EventSet((osa_event_handle_t)event_handle, flags);
+}
+
+/**
+ * \brief Low-power timer interrupt handler
+ */
+void LPTMR0_IRQHandler(void)
+{
+        LPTMR_StopTimer(SCHEDULER_LPTMR);
+        LPTMR_ClearStatusFlags(SCHEDULER_LPTMR, kLPTMR_TimerCompareFlag);
+        now += period;
+        period = 0u;
+        set_flags(SCHEDULER_TIMER_FLAG);
+}
+
+/**
+ * \brief Stops the low-power timer and accounts the elapsed time
+ *
+ * Must be called with interrupts disabled.
+ */
+static void stop_lptmr(void)
+{
+        if (!period) {
+                return;
+        }
+
+        if (LPTMR_GetStatusFlags(SCHEDULER_LPTMR) &
+                kLPTMR_TimerCompareFlag) {
+                now += period;
+        } else {
+                now += LPTMR_GetCurrentTimerCount(SCHEDULER_LPTMR);
+        }
+        LPTMR_StopTimer(SCHEDULER_LPTMR);
+        LPTMR_ClearStatusFlags(SCHEDULER_LPTMR, kLPTMR_TimerCompareFlag);
+        NVIC_ClearPendingIRQ(SCHEDULER_LPTMR_IRQ);
+        period = 0u;
+}
+
+/**
+ * \brief Programs the nearest timer deadline into the low-power timer
+ *
+ * Must be called with interrupts disabled. If a timer has already expired,
+ * posts the timer event instead.
+ */
+static void program_lptmr(void)
+{
+        uint32_t nearest = SCHEDULER_LPTMR_MAXIMUM_PERIOD;
+        bool active = false;
+
+        stop_lptmr();
+
+        for (uint8_t timer = 0u; timer < TIMER_SLOTS; ++timer) {
+                int32_t remaining;
+
+                if (!timer_handler[timer]) {
+                        continue;
+                }
+                remaining = (int32_t)(timer_deadline[timer] - now);
+                if (remaining <= 0) {
+                        set_flags(SCHEDULER_TIMER_FLAG);
+                        return;
+                }
+                if ((uint32_t)remaining < nearest) {
+                        nearest = (uint32_t)remaining;
+                }
+                active = true;
+        }
+
+        if (active) {
+                period = nearest;
+                LPTMR_SetTimerPeriod(SCHEDULER_LPTMR, nearest);
+                LPTMR_StartTimer(SCHEDULER_LPTMR);
+        }
+}
+
+/**
+ * \brief Calls the handlers of the expired timers and reprograms the
+ *        low-power timer
+ */
+static void run_timers(void)
+{
+        scheduler_handler_t expired[TIMER_SLOTS];
+
+        OSA_DisableIRQGlobal();
+        stop_lptmr();
+        for (uint8_t timer = 0u; timer < TIMER_SLOTS; ++timer) {
+                expired[timer] = NULL;
+                if (timer_handler[timer] &&
+                        ((int32_t)(timer_deadline[timer] - now) <= 0)) {
+                        expired[timer] = timer_handler[timer];
+                        timer_handler[timer] = NULL;
+                }
+        }
+        program_lptmr();
+        OSA_EnableIRQGlobal();
+
+        for (uint8_t timer = 0u; timer < TIMER_SLOTS; ++timer) {
+                if (expired[timer]) {
+                        expired[timer]();
+                }
+        }
+}
+
+/**
+ * \brief Posts the input events after a wake-up from standby
+ */
+static void standby_wake(void)
+{
+        set_flags((1u << SCHEDULER_EVENT_LOOP) |
+                (1u << SCHEDULER_EVENT_BUTTON));
+}
+
+/**
+ * \brief Samples the inputs periodically in standby
+ *
+ * Covers the input signals which can not wake the core from standby. A
+ * sample expiring together with a timer that left the standby is dropped.
+ */
+static void standby_sample(void)
+{
+        if (!standby_interval) {
+                return;
+        }
+        standby_wake();
+
+        OSA_DisableIRQGlobal();
+        stop_lptmr();
+        timer_deadline[STANDBY_SAMPLE_TIMER] = now + standby_interval;
+        timer_handler[STANDBY_SAMPLE_TIMER] = standby_sample;
+        program_lptmr();
+        OSA_EnableIRQGlobal();
+}
+
+/**
+ * \brief Sleeps until the next interrupt
+ *
+ * Must be called with interrupts disabled. Pending interrupts still wake the
+ * CPU, and they are served once the interrupts are enabled again.
+ */
+static void enter_sleep(void)
+{
+        if (standby_interval && !stop_prevented) {
+                (void)standby_io_enter();
+        } else if (stop_prevented) {
+                SMC_PreEnterWaitModes();
+                (void)SMC_SetPowerModeWait(SMC);
+                SMC_PostExitWaitModes();
+        } else {
+                SMC_PreEnterStopModes();
+                (void)SMC_SetPowerModeVlps(SMC);
+                SMC_PostExitStopModes();
+        }
+}
+
+mdv_result_t scheduler_init(void)
+{
+        lptmr_config_t config;
+
+        for (uint8_t event = 0u; event < SCHEDULER_EVENTS; ++event) {
+                event_handler[event] = NULL;
+        }
+        for (uint8_t timer = 0u; timer < TIMER_SLOTS; ++timer) {
+                timer_handler[timer] = NULL;
+        }
+        now = 0u;
+        period = 0u;
+        stop_prevented = 0u;
+        standby_interval = 0u;
+
+        if (OSA_EventCreate((osa_event_handle_t)event_handle, 1u) !=
+                KOSA_StatusSuccess) {
+                return BA8_RESULT_BUSY;
+        }
+
+        SMC_SetPowerModeProtection(SMC, kSMC_AllowPowerModeAll);
+
+        // The low-power timer counts milliseconds from the 1 kHz LPO, which
+        // keeps running in all the stop modes.
+        LPTMR_GetDefaultConfig(&config);
+        LPTMR_Init(SCHEDULER_LPTMR, &config);
+        LPTMR_EnableInterrupts(SCHEDULER_LPTMR,
+                kLPTMR_TimerInterruptEnable);
+        EnableIRQ(SCHEDULER_LPTMR_IRQ);
+
+        (void)loop_wake_io_init();
+
+        return standby_io_init(standby_wake);
+}
+
+mdv_result_t scheduler_set_handler(scheduler_event_t event,
+        scheduler_handler_t handler)
+{
+        if (event >= SCHEDULER_EVENTS) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        event_handler[event] = handler;
+
+        return MDV_RESULT_OK;
+}
+
+void scheduler_post(scheduler_event_t event)
+{
+        set_flags(1u << event);
+}
+
+mdv_result_t scheduler_start_timer(uint8_t timer, uint32_t milliseconds,
+        scheduler_handler_t handler)
+{
+        if ((timer >= SCHEDULER_TIMERS) || !handler) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        OSA_DisableIRQGlobal();
+        stop_lptmr();
+        timer_deadline[timer] = now + milliseconds;
+        timer_handler[timer] = handler;
+        program_lptmr();
+        OSA_EnableIRQGlobal();
+
+        return MDV_RESULT_OK;
+}
+
+mdv_result_t scheduler_stop_timer(uint8_t timer)
+{
+        if (timer >= SCHEDULER_TIMERS) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        OSA_DisableIRQGlobal();
+        timer_handler[timer] = NULL;
+        program_lptmr();
+        OSA_EnableIRQGlobal();
+
+        return MDV_RESULT_OK;
+}
+
+void scheduler_prevent_stop(void)
+{
+        OSA_DisableIRQGlobal();
+        ++stop_prevented;
+        OSA_EnableIRQGlobal();
+}
+
+void scheduler_allow_stop(void)
+{
+        OSA_DisableIRQGlobal();
+        if (stop_prevented) {
+                --stop_prevented;
+        }
+        OSA_EnableIRQGlobal();
+}
+
+mdv_result_t scheduler_enter_standby(uint32_t sample_interval,
+        uint8_t wake_threshold)
+{
+        if (!sample_interval ||
+                (loop_wake_io_arm(wake_threshold) != MDV_RESULT_OK)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        standby_interval = sample_interval;
+        standby_sample();
+
+        return MDV_RESULT_OK;
+}
+
+void scheduler_exit_standby(void)
+{
+        OSA_DisableIRQGlobal();
+        standby_interval = 0u;
+        timer_handler[STANDBY_SAMPLE_TIMER] = NULL;
+        program_lptmr();
+        OSA_EnableIRQGlobal();
+
+        loop_wake_io_disarm();
+}
+
+void scheduler_run(void)
+{
+        while (1) {
+                osa_event_flags_t events = 0u;
+
+                // Check the events and go to sleep with the interrupts
+                // disabled, so that an event posted in between can not be
+                // missed. The OSA calls nest within this critical section.
+                OSA_DisableIRQGlobal();
+                if (OSA_EventWait((osa_event_handle_t)event_handle,
+                        osaEventFlagsAll_c, 0u, 0u, &events) !=
+                        KOSA_StatusSuccess) {
+                        enter_sleep();
+                }
+                OSA_EnableIRQGlobal();
+
+                if (events & SCHEDULER_TIMER_FLAG) {
+                        run_timers();
+                        watchdog_release(WATCHDOG_SOURCES(
+                                SCHEDULER_TIMER_FLAG));
+                }
+                for (uint8_t event = 0u; event < SCHEDULER_EVENTS; ++event) {
+                        if (!(events & (1u << event))) {
+                                continue;
+                        }
+                        if (event_handler[event]) {
+                                event_handler[event]();
+                        }
+                        watchdog_release(WATCHDOG_SOURCES(1u << event));
+                }
+
+                watchdog_checkin(WATCHDOG_BIT(WATCHDOG_SOURCE_MAIN_LOOP));
+                watchdog_service();
+        }
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,209 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       scheduler.h
+ * \defgroup   scheduler Event scheduler
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Cooperative, event driven scheduler.
+ *
+ * Interrupt handlers post events, and the scheduler calls the handler of
+ * each posted event from the main loop. One-shot timers are kept as
+ * deadlines, and only the nearest deadline is programmed into the low-power
+ * timer, so there is no periodic tick. When nothing is pending, the CPU
+ * sleeps in VLPS, or in WAIT while some driver needs the bus clock.
+ *
+ * In standby, e.g. on backup battery, the CPU sleeps in LLS instead. The
+ * loop and button events are then posted on every wake-up from the LLWU
+ * pins and the loop disturbance comparator, and periodically to sample the
+ * signals which can not wake the core.
+ *
+ * Each pass of the main loop checks in with the \ref watchdog, and each
+ * posted event and expired timer stays required by the watchdog until its
+ * handler has returned.
+ *
+ * @{
+ */
+
+/// Number of timers
+#define SCHEDULER_TIMERS 7u
+
+/**
+ * \brief Events
+ */
+typedef enum {
+        /// Alarm loop input changed
+        SCHEDULER_EVENT_LOOP = 0,
+        /// Button input changed
+        SCHEDULER_EVENT_BUTTON,
+        /// Serial data received or transmitted
+        SCHEDULER_EVENT_SERIAL,
+        /// Telemetry buffer space freed
+        SCHEDULER_EVENT_TELEMETRY,
+        /// Analog loop scan completed or loop guard tripped
+        SCHEDULER_EVENT_ANALOG,
+        /// Number of the events
+        SCHEDULER_EVENTS
+} scheduler_event_t;
+
+/**
+ * \brief Event and timer handler
+ */
+typedef void (*scheduler_handler_t)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the scheduler
+ *
+ * Also allows all the power modes, as the power mode protection can only be
+ * written once after reset, and initializes the standby interface and the
+ * loop disturbance wake-up. The alarm loop and button inputs must be
+ * initialized before this.
+ *
+ * \return Result of the operation
+ */
+mdv_result_t scheduler_init(void);
+
+/**
+ * \brief Sets the handler of an event
+ *
+ * \param[in] event Event
+ * \param[in] handler Handler, or NULL to ignore the event
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The event is out of range
+ */
+mdv_result_t scheduler_set_handler(scheduler_event_t event,
+        scheduler_handler_t handler);
+
+/**
+ * \brief Posts an event
+ *
+ * Can be called from interrupt handlers.
+ *
+ * \param[in] event Event
+ */
+void scheduler_post(scheduler_event_t event);
+
+/**
+ * \brief Starts or restarts a one-shot timer
+ *
+ * The timer runs on the 1 kHz low-power oscillator, and each reprogramming
+ * of the low-power timer may lose up to one millisecond.
+ *
+ * \param[in] timer Index of the timer (0...SCHEDULER_TIMERS - 1)
+ * \param[in] milliseconds Time to expiration
+ * \param[in] handler Handler called when the timer expires
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The timer is out of range or the
+ *         handler is NULL
+ */
+mdv_result_t scheduler_start_timer(uint8_t timer, uint32_t milliseconds,
+        scheduler_handler_t handler);
+
+/**
+ * \brief Stops a timer
+ *
+ * \param[in] timer Index of the timer (0...SCHEDULER_TIMERS - 1)
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The timer is out of range
+ */
+mdv_result_t scheduler_stop_timer(uint8_t timer);
+
+/**
+ * \brief Prevents the scheduler from entering stop modes
+ *
+ * Calls nest, and each call must be paired with scheduler_allow_stop().
+ * While stop modes are prevented, the scheduler sleeps in WAIT instead.
+ */
+void scheduler_prevent_stop(void);
+
+/**
+ * \brief Allows the scheduler to enter stop modes
+ */
+void scheduler_allow_stop(void);
+
+/**
+ * \brief Enters standby
+ *
+ * The loop and button events are posted immediately, and then on every
+ * wake-up and sampling interval until standby is exited. The loop
+ * disturbance wake-up is armed for the standby, see loop_wake_io_arm().
+ * Drivers which need clocks other than the LPO should prevent stop modes,
+ * or be stopped, before entering standby.
+ *
+ * \param[in] sample_interval Input sampling interval in milliseconds
+ * \param[in] wake_threshold Loop disturbance threshold
+ *            (0...LOOP_WAKE_IO_MAXIMUM_THRESHOLD)
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The sampling interval is zero or the
+ *         threshold is out of range
+ */
+mdv_result_t scheduler_enter_standby(uint32_t sample_interval,
+        uint8_t wake_threshold);
+
+/**
+ * \brief Exits standby
+ *
+ * Also disarms the loop disturbance wake-up.
+ */
+void scheduler_exit_standby(void);
+
+/**
+ * \brief Runs the scheduler
+ *
+ * Does not return.
+ */
+void scheduler_run(void);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef SCHEDULER_H
+
+/* EOF */
@@ -0,0 +1,216 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "state_delta.h"
+
+/**
+ * \file       state_delta.c
+ * \defgroup   state-delta-implementation State delta implementation
+ * \ingroup    state-delta
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Number of bytes in the state vector
+#define STATE_BYTES 4u
+/// Mask of the changed byte bits in a delta entry header
+#define HEADER_CHANGED_MASK 0x0Fu
+/// Varint continuation bit
+#define VARINT_CONTINUATION 0x80u
+/// Maximum length of a 32-bit varint in bytes
+#define VARINT_MAXIMUM_SIZE 5u
+
+/**
+ * \brief Writes a 32-bit value in little-endian byte order
+ *
+ * \param[in] value Value
+ * \param[out] output Output, 4 bytes
+ */
+static void write_u32(uint32_t value, uint8_t *output)
+{
+        for (uint8_t i = 0u; i < STATE_BYTES; ++i) {
+                output[i] = (uint8_t)(value >> (8u * i));
+        }
+}
+
+/**
+ * \brief Reads a 32-bit value in little-endian byte order
+ *
+ * \param[in] data Data, 4 bytes
+ *
+ * \return Value
+ */
+static uint32_t read_u32(uint8_t const *data)
+{
+        uint32_t value = 0u;
+
+        for (uint8_t i = 0u; i < STATE_BYTES; ++i) {
+                value |= (uint32_t)data[i] << (8u * i);
+        }
+
+        return value;
+}
+
+void state_delta_encoder_init(state_delta_encoder_t *encoder)
+{
+        encoder->state = 0u;
+        encoder->time = 0u;
+        encoder->keyframe = true;
+}
+
+void state_delta_request_keyframe(state_delta_encoder_t *encoder)
+{
+        encoder->keyframe = true;
+}
+
+uint8_t state_delta_encode(state_delta_encoder_t *encoder, uint32_t state,
+        uint32_t time, uint8_t *output)
+{
+        uint32_t const changed = state ^ encoder->state;
+        uint32_t delta = time - encoder->time;
+        uint8_t length = 1u;
+        uint8_t header = 0u;
+
+        // Timestamps taken in interrupts may be slightly older than the
+        // previous entry, so keep the time from running backwards.
+        if ((int32_t)delta < 0) {
+                delta = 0u;
+                time = encoder->time;
+        }
+
+        if (encoder->keyframe) {
+                output[0] = STATE_DELTA_KEYFRAME;
+                write_u32(time, &output[1]);
+                write_u32(state, &output[1u + STATE_BYTES]);
+                length += 2u * STATE_BYTES;
+        } else if (!changed) {
+                return 0u;
+        } else {
+                do {
+                        uint8_t byte = (uint8_t)(delta & ~VARINT_CONTINUATION);
+
+                        delta >>= 7u;
+                        if (delta) {
+                                byte |= VARINT_CONTINUATION;
+                        }
+                        output[length++] = byte;
+                } while (delta);
+
+                for (uint8_t i = 0u; i < STATE_BYTES; ++i) {
+                        uint8_t const bits = (uint8_t)(changed >> (8u * i));
+
+                        if (bits) {
+                                header |= (uint8_t)(1u << i);
+                                output[length++] = bits;
+                        }
+                }
+                output[0] = header;
+        }
+
+        encoder->state = state;
+        encoder->time = time;
+        encoder->keyframe = false;
+
+        return length;
+}
+
+void state_delta_decoder_init(state_delta_decoder_t *decoder)
+{
+        decoder->state = 0u;
+        decoder->time = 0u;
+        decoder->synchronized = false;
+}
+
+mdv_result_t state_delta_decode(state_delta_decoder_t *decoder,
+        uint8_t const *data, uint32_t length, uint32_t *used)
+{
+        uint32_t position = 1u;
+        uint32_t delta = 0u;
+        uint32_t state;
+        uint8_t header;
+
+        if (!length) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+        header = data[0];
+
+        if (header == STATE_DELTA_KEYFRAME) {
+                if (length < 1u + 2u * STATE_BYTES) {
+                        return BA8_RESULT_INVALID_PARAMETER;
+                }
+                decoder->time = read_u32(&data[1]);
+                decoder->state = read_u32(&data[1u + STATE_BYTES]);
+                decoder->synchronized = true;
+                *used = 1u + 2u * STATE_BYTES;
+                return MDV_RESULT_OK;
+        }
+        if (header & ~HEADER_CHANGED_MASK) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        for (uint8_t shift = 0u; ; shift += 7u) {
+                uint8_t byte;
+
+                if ((position == length) ||
+                        (position > VARINT_MAXIMUM_SIZE)) {
+                        return BA8_RESULT_INVALID_PARAMETER;
+                }
+                byte = data[position++];
+                delta |= (uint32_t)(byte & ~VARINT_CONTINUATION) << shift;
+                if (!(byte & VARINT_CONTINUATION)) {
+                        break;
+                }
+        }
+
+        state = decoder->state;
+        for (uint8_t i = 0u; i < STATE_BYTES; ++i) {
+                if (header & (1u << i)) {
+                        if (position == length) {
+                                return BA8_RESULT_INVALID_PARAMETER;
+                        }
+                        state ^= (uint32_t)data[position++] << (8u * i);
+                }
+        }
+
+        // Without a keyframe there is no state to apply the delta to.
+        if (decoder->synchronized) {
+                decoder->state = state;
+                decoder->time += delta;
+        }
+        *used = position;
+
+        return MDV_RESULT_OK;
+}
+
+/** @} */
+
+/* EOF */
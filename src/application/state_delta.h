@@ -0,0 +1,198 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef STATE_DELTA_H
+#define STATE_DELTA_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       state_delta.h
+ * \defgroup   state-delta State delta coding
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Change-only coding of the device state vector for the telemetry stream.
+ *
+ * The state vector is 32 bits wide: the alarm signals, the shield alarm
+ * signals, the buttons and the relay, one byte each. An entry is sent only
+ * when the state changes, and it holds the changed bits and the time since
+ * the previous entry:
+ *
+ * - Delta entry: a header byte with a mask of the changed state bytes in
+ *   bits 0...3, the time delta as an unsigned LEB128 varint, and the XOR of
+ *   the old and new value of each changed byte, lowest first.
+ * - Keyframe: the header byte STATE_DELTA_KEYFRAME, the absolute time (4
+ *   bytes, little-endian) and the full state (4 bytes, little-endian).
+ *
+ * E.g. a loop edge a second after the previous entry is coded in five
+ * bytes, and nothing is sent while the state holds. Keyframes are sent at
+ * startup, on request and after an entry was lost, and the decoder
+ * ignores the delta entries until it has seen a keyframe. The keyframes
+ * must be sent often enough for the time deltas not to wrap around.
+ *
+ * The coding has no hardware dependencies, so the decoder can be built as
+ * is into the monitoring software.
+ *
+ * @{
+ */
+
+/// Bit position of the alarm signals in the state vector
+#define STATE_DELTA_ALARM_SHIFT 0u
+/// Bit position of the shield alarm signals in the state vector
+#define STATE_DELTA_SHIELD_SHIFT 8u
+/// Bit position of the buttons in the state vector
+#define STATE_DELTA_BUTTON_SHIFT 16u
+/// Bit position of the relay in the state vector
+#define STATE_DELTA_RELAY_SHIFT 24u
+
+/// Header byte of a keyframe
+#define STATE_DELTA_KEYFRAME 0x80u
+/// Maximum length of an entry in bytes
+#define STATE_DELTA_MAXIMUM_ENTRY 10u
+
+/**
+ * \brief Encoder state
+ */
+typedef struct {
+        /// Last sent state
+        uint32_t state;
+        /// Time of the last sent entry
+        uint32_t time;
+        /// True if the next entry must be a keyframe
+        bool keyframe;
+} state_delta_encoder_t;
+
+/**
+ * \brief Decoder state
+ */
+typedef struct {
+        /// Decoded state
+        uint32_t state;
+        /// Time of the decoded state
+        uint32_t time;
+        /// True once a keyframe has been decoded
+        bool synchronized;
+} state_delta_decoder_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Packs the state vector
+ *
+ * \param[in] alarm Alarm signal states
+ * \param[in] shield Shield alarm signal states
+ * \param[in] buttons Button states
+ * \param[in] relay Relay state
+ *
+ * \return State vector
+ */
+static inline uint32_t state_delta_pack(uint8_t alarm, uint8_t shield,
+        uint8_t buttons, bool relay)
+{
+        return ((uint32_t)alarm << STATE_DELTA_ALARM_SHIFT) |
+                ((uint32_t)shield << STATE_DELTA_SHIELD_SHIFT) |
+                ((uint32_t)buttons << STATE_DELTA_BUTTON_SHIFT) |
+                ((uint32_t)relay << STATE_DELTA_RELAY_SHIFT);
+}
+
+/**
+ * \brief Initializes an encoder
+ *
+ * The first entry will be a keyframe.
+ *
+ * \param[out] encoder Encoder
+ */
+void state_delta_encoder_init(state_delta_encoder_t *encoder);
+
+/**
+ * \brief Makes the next entry a keyframe
+ *
+ * Call this when an entry was not delivered, so that the decoder can
+ * resynchronize.
+ *
+ * \param[in,out] encoder Encoder
+ */
+void state_delta_request_keyframe(state_delta_encoder_t *encoder);
+
+/**
+ * \brief Encodes the state
+ *
+ * \param[in,out] encoder Encoder
+ * \param[in] state State vector
+ * \param[in] time Time of the state. A time before the previous entry is
+ *            taken as the time of the previous entry.
+ * \param[out] output Entry, STATE_DELTA_MAXIMUM_ENTRY bytes
+ *
+ * \return Length of the entry in bytes, or 0 if the state is unchanged and
+ *         no keyframe is due
+ */
+uint8_t state_delta_encode(state_delta_encoder_t *encoder, uint32_t state,
+        uint32_t time, uint8_t *output);
+
+/**
+ * \brief Initializes a decoder
+ *
+ * Also call this when entries have been lost, e.g. on a gap in the record
+ * sequence numbers. The decoder then waits for the next keyframe.
+ *
+ * \param[out] decoder Decoder
+ */
+void state_delta_decoder_init(state_delta_decoder_t *decoder);
+
+/**
+ * \brief Decodes an entry
+ *
+ * The delta entries are skipped until a keyframe has been decoded.
+ *
+ * \param[in,out] decoder Decoder
+ * \param[in] data Encoded data
+ * \param[in] length Length of the data in bytes
+ * \param[out] used Length of the decoded entry in bytes
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The entry is truncated or malformed
+ */
+mdv_result_t state_delta_decode(state_delta_decoder_t *decoder,
+        uint8_t const *data, uint32_t length, uint32_t *used);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef STATE_DELTA_H
+
+/* EOF */
@@ -0,0 +1,227 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc16.h"
+#include "scheduler.h"
+#include "serial_io.h"
+#include "watchdog.h"
+#include "fsl_os_abstraction.h"
+#include <string.h>
+
+/**
+ * \file       telemetry.c
+ * \defgroup   telemetry-implementation Telemetry implementation
+ * \ingroup    telemetry
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Transmit buffers, one being filled and the other one being sent
+static uint8_t buffers[2][TELEMETRY_BUFFER_SIZE];
+/// Index of the buffer being filled
+static uint8_t fill;
+/// Length of the data in the buffer being filled
+static uint32_t fill_length;
+/// True while a buffer is being sent
+static bool sending;
+/// Batch nesting depth
+static uint8_t batch;
+/// Sequence number of the next record
+static uint8_t sequence;
+/// Number of dropped records
+static uint32_t dropped;
+/// Buffer space notification
+static telemetry_notify_t space_notify;
+
+/**
+ * \brief Gets the encoded length of a record
+ *
+ * \param[in] length Length of the record payload in bytes
+ *
+ * \return Maximum length of the encoded frame including the delimiter
+ */
+static inline uint32_t encoded_length(uint8_t length)
+{
+        return COBS_ENCODED_SIZE(TELEMETRY_FRAME_HEADER_SIZE + length +
+                TELEMETRY_FRAME_CRC_SIZE) + 1u;
+}
+
+/**
+ * \brief Hands the filled buffer over to DMA if the transmitter is free
+ *
+ * Must be called with the interrupts disabled.
+ */
+static void start_send(void)
+{
+        uint8_t const *buffer;
+        uint32_t length;
+
+        if (sending || batch || !fill_length) {
+                return;
+        }
+
+        buffer = buffers[fill];
+        length = fill_length;
+        fill ^= 1u;
+        fill_length = 0u;
+
+        // The transmitter does not run in the stop modes. The watchdog
+        // requires the transfer to complete.
+        scheduler_prevent_stop();
+        watchdog_require(WATCHDOG_BIT(WATCHDOG_SOURCE_SERIAL_TX));
+        sending = true;
+        if (serial_io_send(buffer, length) != MDV_RESULT_OK) {
+                sending = false;
+                watchdog_release(WATCHDOG_BIT(WATCHDOG_SOURCE_SERIAL_TX));
+                scheduler_allow_stop();
+        }
+}
+
+/**
+ * \brief Sends the next buffer when the previous transfer is done
+ */
+static void transfer_done(void)
+{
+        OSA_DisableIRQGlobal();
+        sending = false;
+        watchdog_release(WATCHDOG_BIT(WATCHDOG_SOURCE_SERIAL_TX));
+        scheduler_allow_stop();
+        start_send();
+        OSA_EnableIRQGlobal();
+
+        if (space_notify) {
+                space_notify();
+        }
+}
+
+void telemetry_init(void)
+{
+        fill = 0u;
+        fill_length = 0u;
+        sending = false;
+        batch = 0u;
+        sequence = 0u;
+        dropped = 0u;
+        space_notify = NULL;
+        serial_io_set_tx_notify(transfer_done);
+}
+
+uint32_t telemetry_encode(uint8_t type, uint8_t sequence, void const *payload,
+        uint8_t length, uint8_t *output)
+{
+        uint8_t frame[TELEMETRY_FRAME_MAXIMUM_SIZE];
+        uint32_t size = TELEMETRY_FRAME_HEADER_SIZE + length;
+        uint32_t encoded;
+        uint16_t crc;
+
+        frame[0] = type;
+        frame[1] = sequence;
+        if (length) {
+                memcpy(&frame[TELEMETRY_FRAME_HEADER_SIZE], payload, length);
+        }
+        crc = crc16_update(CRC16_INITIAL_VALUE, frame, size);
+        frame[size++] = (uint8_t)(crc >> 8u);
+        frame[size++] = (uint8_t)crc;
+        encoded = cobs_encode(frame, size, output);
+        output[encoded++] = COBS_DELIMITER;
+
+        return encoded;
+}
+
+mdv_result_t telemetry_send(uint8_t type, void const *payload,
+        uint8_t length)
+{
+        uint8_t encoded[TELEMETRY_ENCODED_MAXIMUM_SIZE];
+        uint32_t size;
+        mdv_result_t result = MDV_RESULT_OK;
+
+        if ((length > TELEMETRY_MAXIMUM_PAYLOAD) || (!payload && length)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        // Build and encode the frame before touching the shared buffers, so
+        // that the interrupts are disabled only for the copy.
+        size = telemetry_encode(type, sequence++, payload, length, encoded);
+
+        OSA_DisableIRQGlobal();
+        if (fill_length + size > TELEMETRY_BUFFER_SIZE) {
+                ++dropped;
+                result = BA8_RESULT_BUSY;
+        } else {
+                memcpy(&buffers[fill][fill_length], encoded, size);
+                fill_length += size;
+                start_send();
+        }
+        OSA_EnableIRQGlobal();
+
+        return result;
+}
+
+void telemetry_set_space_notify(telemetry_notify_t notify)
+{
+        space_notify = notify;
+}
+
+bool telemetry_has_space(uint8_t length)
+{
+        return (length <= TELEMETRY_MAXIMUM_PAYLOAD) &&
+                (fill_length + encoded_length(length) <=
+                TELEMETRY_BUFFER_SIZE);
+}
+
+void telemetry_begin_batch(void)
+{
+        OSA_DisableIRQGlobal();
+        ++batch;
+        OSA_EnableIRQGlobal();
+}
+
+void telemetry_end_batch(void)
+{
+        OSA_DisableIRQGlobal();
+        if (batch) {
+                --batch;
+        }
+        start_send();
+        OSA_EnableIRQGlobal();
+}
+
+uint32_t telemetry_get_dropped(void)
+{
+        return dropped;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,200 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "ba8_common.h"
+#include "cobs.h"
+
+/**
+ * \file       telemetry.h
+ * \defgroup   telemetry Binary telemetry stream
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Monitoring records sent over the serial port without blocking the caller.
+ *
+ * Each record is sent as a frame of a record type byte, a sequence number
+ * byte, the payload and a big-endian CRC-16 of all the preceding bytes. The
+ * frame is COBS encoded and terminated by a zero byte. A gap in the sequence
+ * numbers tells the receiver that records have been dropped.
+ *
+ * The frames are packed into one of two buffers while the other one is being
+ * sent by DMA. When the transfer is done, the buffers are swapped and the
+ * collected frames are sent at once. If the buffer being filled runs out of
+ * space, new records are dropped until it has been handed over to DMA.
+ *
+ * Records queued in a batch are held back until the end of the batch, so
+ * that they are sent out in a single transfer.
+ *
+ * @{
+ */
+
+/// Maximum length of a record payload in bytes
+#define TELEMETRY_MAXIMUM_PAYLOAD 32u
+/// Size of each of the two transmit buffers in bytes
+#define TELEMETRY_BUFFER_SIZE 256u
+/// Length of the frame header (record type and sequence number)
+#define TELEMETRY_FRAME_HEADER_SIZE 2u
+/// Length of the frame CRC
+#define TELEMETRY_FRAME_CRC_SIZE 2u
+/// Maximum length of a frame before encoding
+#define TELEMETRY_FRAME_MAXIMUM_SIZE (TELEMETRY_FRAME_HEADER_SIZE + \
+        TELEMETRY_MAXIMUM_PAYLOAD + TELEMETRY_FRAME_CRC_SIZE)
+/// Maximum length of an encoded frame including the delimiter
+#define TELEMETRY_ENCODED_MAXIMUM_SIZE \
+        (COBS_ENCODED_SIZE(TELEMETRY_FRAME_MAXIMUM_SIZE) + 1u)
+
+/**
+ * \brief Record types
+ */
+typedef enum {
+        /// State delta entries, see \ref state-delta
+        TELEMETRY_RECORD_STATE = 1,
+        /// Console command response: command index (0xFF if unknown),
+        /// result (2 bytes, little-endian) and command specific data
+        TELEMETRY_RECORD_RESPONSE = 2,
+        /// Alarm event: event type (see journal_event_t), loops and time (4
+        /// bytes, little-endian)
+        TELEMETRY_RECORD_EVENT,
+        /// Loop flood summary: loop index, number of suppressed edges (4
+        /// bytes, little-endian) and the flood duration in milliseconds (2
+        /// bytes, little-endian)
+        TELEMETRY_RECORD_FLOOD,
+        /// Text output, e.g. the latency dump. A text may be split over
+        /// several records, also in the middle of a line.
+        TELEMETRY_RECORD_TEXT
+} telemetry_record_t;
+
+/**
+ * \brief Buffer space notification callback
+ *
+ * Called from an interrupt handler when a buffer has been handed over to DMA
+ * and the other one is empty again.
+ */
+typedef void (*telemetry_notify_t)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Initializes the telemetry stream
+ *
+ * The serial port and the scheduler must be initialized before this.
+ */
+void telemetry_init(void);
+
+/**
+ * \brief Builds and encodes one frame
+ *
+ * Appends the CRC to the header and the payload, COBS encodes the frame and
+ * terminates it with the delimiter.
+ *
+ * \param[in] type Record type
+ * \param[in] sequence Sequence number of the record
+ * \param[in] payload Record payload
+ * \param[in] length Length of the payload in bytes
+ *            (0...TELEMETRY_MAXIMUM_PAYLOAD)
+ * \param[out] output Encoded frame, TELEMETRY_ENCODED_MAXIMUM_SIZE bytes
+ *
+ * \return Length of the encoded frame including the delimiter
+ */
+uint32_t telemetry_encode(uint8_t type, uint8_t sequence, void const *payload,
+        uint8_t length, uint8_t *output);
+
+/**
+ * \brief Queues a record for sending
+ *
+ * Must not be called from an interrupt handler.
+ *
+ * \param[in] type Record type
+ * \param[in] payload Record payload
+ * \param[in] length Length of the payload in bytes
+ *
+ * \return Result of the operation
+ * \retval BA8_RESULT_INVALID_PARAMETER The payload is too long
+ * \retval BA8_RESULT_BUSY The buffer is full and the record was dropped
+ */
+mdv_result_t telemetry_send(uint8_t type, void const *payload,
+        uint8_t length);
+
+/**
+ * \brief Sets the buffer space notification
+ *
+ * \param[in] notify Callback to call from the interrupt handler when buffer
+ *            space is freed, or NULL to disable the notification
+ */
+void telemetry_set_space_notify(telemetry_notify_t notify);
+
+/**
+ * \brief Checks if a record fits into the buffer
+ *
+ * The space only grows until the next record is queued, so a record which
+ * fits can be sent without being dropped.
+ *
+ * \param[in] length Length of the record payload in bytes
+ *
+ * \return True if the record fits, otherwise false
+ */
+bool telemetry_has_space(uint8_t length);
+
+/**
+ * \brief Begins a batch of records
+ *
+ * Batches nest, and each call must be paired with telemetry_end_batch().
+ * Must not be called from an interrupt handler.
+ */
+void telemetry_begin_batch(void);
+
+/**
+ * \brief Ends a batch of records and sends the queued records
+ */
+void telemetry_end_batch(void);
+
+/**
+ * \brief Gets the number of dropped records
+ *
+ * \return Number of records dropped since the initialization
+ */
+uint32_t telemetry_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef TELEMETRY_H
+
+/* EOF */
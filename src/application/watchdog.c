@@ -0,0 +1,117 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "watchdog.h"
+#include "fsl_cop.h"
+#include "fsl_os_abstraction.h"
+
+/**
+ * \file       watchdog.c
+ * \defgroup   watchdog-implementation COP watchdog supervisor implementation
+ * \ingroup    watchdog
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ * @{
+ */
+
+/// Required sources
+static volatile uint32_t required;
+/// Required sources which have not checked in during the current window
+static volatile uint32_t pending;
+
+void watchdog_init(void)
+{
+        cop_config_t config;
+
+        required = WATCHDOG_BIT(WATCHDOG_SOURCE_MAIN_LOOP);
+        pending = required;
+
+        // 2^10 cycles of the 1 kHz LPO, stopped in the stop modes and in
+        // debug halt
+        COP_GetDefaultConfig(&config);
+        config.timeoutMode = kCOP_ShortTimeoutMode;
+        config.enableStop = false;
+        config.enableDebug = false;
+        config.clockSource = kCOP_LpoClock;
+        config.timeoutCycles = kCOP_2Power10CyclesOr2Power18Cycles;
+        COP_Init(SIM, &config);
+}
+
+bool watchdog_caused_reset(void)
+{
+        return (RCM->SRS0 & RCM_SRS0_WDOG_MASK) != 0u;
+}
+
+void watchdog_require(uint32_t sources)
+{
+        OSA_DisableIRQGlobal();
+        required |= sources;
+        pending |= sources;
+        OSA_EnableIRQGlobal();
+}
+
+void watchdog_release(uint32_t sources)
+{
+        OSA_DisableIRQGlobal();
+        required &= ~sources;
+        pending &= ~sources;
+        OSA_EnableIRQGlobal();
+}
+
+void watchdog_checkin(uint32_t sources)
+{
+        OSA_DisableIRQGlobal();
+        pending &= ~sources;
+        OSA_EnableIRQGlobal();
+}
+
+void watchdog_service(void)
+{
+        if (pending) {
+                return;
+        }
+
+        // A source may have been required after the compare. The new window
+        // starts from the required sources of this moment, so it is kept.
+        OSA_DisableIRQGlobal();
+        pending = required;
+        OSA_EnableIRQGlobal();
+        COP_Refresh(SIM);
+}
+
+uint32_t watchdog_get_pending(void)
+{
+        return pending;
+}
+
+/** @} */
+
+/* EOF */
@@ -0,0 +1,151 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include "ba8_common.h"
+
+/**
+ * \file       watchdog.h
+ * \defgroup   watchdog COP watchdog supervisor
+ * \ingroup    ba8
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Refreshes the COP watchdog only while all the supervised code paths make
+ * progress.
+ *
+ * Each path owns a liveness bit. A path which must run continuously, like
+ * the scheduler main loop, stays required and checks in on every pass. A
+ * path with outstanding work, like a posted event or a serial transfer,
+ * becomes required when the work starts and is released when the work is
+ * done. The pending mask holds the required bits which have not checked in
+ * since the last refresh. The main loop refreshes the COP when the pending
+ * mask is empty, which is a single word compare, and then starts a new
+ * window with all the required bits pending.
+ *
+ * The COP times out after 1024 LPO cycles (about one second) of RUN and
+ * WAIT. It does not run in the stop modes or while the debugger halts the
+ * core, so the long sleeps of the scheduler do not need any refreshes. The
+ * COP control register can be written only once after a reset, so the
+ * startup code must leave the COP enabled (DISABLE_WDOG=0).
+ *
+ * @{
+ */
+
+/**
+ * \brief Liveness sources
+ */
+typedef enum {
+        /// Scheduler main loop, always required
+        WATCHDOG_SOURCE_MAIN_LOOP = 0,
+        /// Serial transmit transfer, from the start to the completion
+        /// interrupt
+        WATCHDOG_SOURCE_SERIAL_TX,
+        /// Scheduler event and timer flags, from the posting to the handling.
+        /// Flag n of the scheduler uses the source
+        /// WATCHDOG_SOURCE_SCHEDULER_FLAGS + n.
+        WATCHDOG_SOURCE_SCHEDULER_FLAGS
+} watchdog_source_t;
+
+/// Liveness bit of a source
+#define WATCHDOG_BIT(source) (1u << (source))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // ifdef __cplusplus
+
+/**
+ * \brief Starts the COP and the supervision
+ *
+ * Only the main loop is required at the start.
+ */
+void watchdog_init(void);
+
+/**
+ * \brief Checks if the previous reset was caused by the COP
+ *
+ * \return True, if the COP timed out
+ */
+bool watchdog_caused_reset(void);
+
+/**
+ * \brief Makes sources required
+ *
+ * The sources must check in or be released before the next refresh. Can be
+ * called from interrupt handlers.
+ *
+ * \param[in] sources Liveness bits of the sources
+ */
+void watchdog_require(uint32_t sources);
+
+/**
+ * \brief Releases sources which have finished their work
+ *
+ * Can be called from interrupt handlers.
+ *
+ * \param[in] sources Liveness bits of the sources
+ */
+void watchdog_release(uint32_t sources);
+
+/**
+ * \brief Checks in sources for the current window
+ *
+ * Can be called from interrupt handlers.
+ *
+ * \param[in] sources Liveness bits of the sources
+ */
+void watchdog_checkin(uint32_t sources);
+
+/**
+ * \brief Refreshes the COP if all the required sources have checked in
+ *
+ * Called from the scheduler main loop.
+ */
+void watchdog_service(void);
+
+/**
+ * \brief Gets the required sources which have not checked in
+ *
+ * \return Liveness bits of the sources
+ */
+uint32_t watchdog_get_pending(void);
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+/** @} */
+
+#endif // ifndef WATCHDOG_H
+
+/* EOF */
@@ -0,0 +1,206 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2020, Tuomas Terho
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench.h"
+#include "journal.h"
+#include "alarm_loop_io.h"
+#include "button_io.h"
+#include "flash_io.h"
+#include "serial_io.h"
+#include "timebase_io.h"
+#include "fsl_clock.h"
+#include "fsl_smc.h"
+
+/**
+ * \file       bench_main.c
+ * \defgroup   bench-main Target benchmark runner
+ * \ingroup    bench
+ * \copyright  Copyright &copy; 2020, Tuomas Terho. All rights reserved.
+ *
+ * Entry point of the Bench configuration of the IAR project, which builds
+ * this file instead of main.c. Runs the benchmark suite three times: at the
+ * reset clock the firmware runs at, in RUN at 48 MHz from the HIRC and in
+ * VLPR at 4 MHz from the LIRC. The cases are timed with the SysTick counter
+ * on the core clock, so the ticks are core cycles. The result lines are
+ * sent out on the serial port, which stays at its baud rate in all the
+ * configurations, as it is clocked from the 8 MHz MCGIRCLK.
+ *
+ * The journal append case is skipped in VLPR, where the flash cannot be
+ * programmed.
+ *
+ * @{
+ */
+
+/// Size of the result output buffer in bytes
+#define OUTPUT_BUFFER_SIZE 1024u
+
+/// MCG_Lite configuration for RUN at 48 MHz
+static mcglite_config_t const hirc_config = {
+        .outSrc = kMCGLITE_ClkSrcHirc,
+        .irclkEnableMode = kMCGLITE_IrclkEnable | kMCGLITE_IrclkEnableInStop,
+        .ircs = kMCGLITE_Lirc8M,
+        .fcrdiv = kMCGLITE_LircDivBy1,
+        .lircDiv2 = kMCGLITE_LircDivBy1,
+        .hircEnableInNotHircMode = false
+};
+
+/// MCG_Lite configuration for VLPR, the MCGIRCLK stays at 8 MHz
+static mcglite_config_t const lirc_config = {
+        .outSrc = kMCGLITE_ClkSrcLirc,
+        .irclkEnableMode = kMCGLITE_IrclkEnable | kMCGLITE_IrclkEnableInStop,
+        .ircs = kMCGLITE_Lirc8M,
+        .fcrdiv = kMCGLITE_LircDivBy1,
+        .lircDiv2 = kMCGLITE_LircDivBy1,
+        .hircEnableInNotHircMode = false
+};
+
+/// Clock dividers for RUN at 48 MHz: core 48 MHz, bus 24 MHz
+#define HIRC_CLKDIV1 (SIM_CLKDIV1_OUTDIV1(0u) | SIM_CLKDIV1_OUTDIV4(1u))
+/// Clock dividers for VLPR: core 4 MHz, bus 1 MHz
+#define VLPR_CLKDIV1 (SIM_CLKDIV1_OUTDIV1(1u) | SIM_CLKDIV1_OUTDIV4(3u))
+
+/// Result output buffer
+static char output[OUTPUT_BUFFER_SIZE];
+/// Length of the data in the output buffer
+static uint32_t output_length;
+/// True while the output buffer is being sent
+static volatile bool sending;
+
+/**
+ * \brief Reads the SysTick counter
+ *
+ * \return Core cycles, counting up
+ */
+static uint32_t systick_read(void)
+{
+        return SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+}
+
+/**
+ * \brief Appends a result line to the output buffer
+ *
+ * \param[in] text Zero terminated text
+ */
+static void write_output(char const *text)
+{
+        while (*text && (output_length < OUTPUT_BUFFER_SIZE)) {
+                output[output_length++] = *text++;
+        }
+}
+
+/**
+ * \brief Marks the output buffer sent
+ */
+static void transfer_done(void)
+{
+        sending = false;
+}
+
+/**
+ * \brief Sends the output buffer and waits until it is out
+ *
+ * The clock must not change while the transfer is in progress.
+ */
+static void flush_output(void)
+{
+        if (!output_length) {
+                return;
+        }
+        sending = true;
+        if (serial_io_send((uint8_t const *)output, output_length) ==
+                MDV_RESULT_OK) {
+                while (sending) {
+                }
+        }
+        sending = false;
+        output_length = 0u;
+}
+
+/**
+ * \brief Runs the suite at the current core clock
+ *
+ * \param[in] clock Name of the clock configuration
+ * \param[in] flash False to skip the cases that program the flash
+ */
+static void run_suite(char const *clock, bool flash)
+{
+        bench_timer_t timer;
+
+        SystemCoreClockUpdate();
+        timer.read = systick_read;
+        timer.mask = SysTick_LOAD_RELOAD_Msk;
+        timer.frequency = SystemCoreClock;
+
+        bench_run(&timer, clock, flash, write_output);
+        flush_output();
+}
+
+void main(void)
+{
+        (void)timebase_io_init();
+        (void)serial_io_init();
+        (void)alarm_loop_io_init();
+        (void)button_io_init();
+        (void)flash_io_init();
+        (void)journal_init();
+        serial_io_set_tx_notify(transfer_done);
+
+        // Free running SysTick on the core clock, without the interrupt
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL = 0u;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+        run_suite("reset", true);
+
+        CLOCK_SetSimSafeDivs();
+        (void)CLOCK_SetMcgliteConfig(&hirc_config);
+        SIM->CLKDIV1 = HIRC_CLKDIV1;
+        run_suite("run48", true);
+
+        // VLPR requires the LIRC and the reduced dividers before the entry.
+        // The power mode protection is write-once after a reset.
+        CLOCK_SetSimSafeDivs();
+        (void)CLOCK_SetMcgliteConfig(&lirc_config);
+        SIM->CLKDIV1 = VLPR_CLKDIV1;
+        SMC_SetPowerModeProtection(SMC, kSMC_AllowPowerModeAll);
+        (void)SMC_SetPowerModeVlpr(SMC);
+        while (SMC_GetPowerModeState(SMC) != kSMC_PowerStateVlpr) {
+        }
+        run_suite("vlpr4", false);
+
+        for (;;) {
+        }
+}
+
+/** @} */
+
+/* EOF */
@@ -1,7 +1,1364 @@
+#include "alarm_core.h"
+#include "button_gesture.h"
+#include "config_store.h"
+#include "console.h"
+#include "event_queue.h"
+#include "flood_control.h"
+#include "input_debounce.h"
+#include "journal.h"
+#include "latency_trace.h"
+#include "scheduler.h"
+#include "state_delta.h"
+#include "telemetry.h"
+#include "watchdog.h"
+#include "alarm_loop_io.h"
+#include "backlight_io.h"
+#include "button_io.h"
+#include "flash_io.h"
+#include "loop_analog_io.h"
+#include "loop_wake_io.h"
+#include "power_io.h"
+#include "relay_io.h"
+#include "serial_io.h"
+#include "standby_io.h"
+#include "timebase_io.h"
+#include <string.h>
 
+/// Timer for stepping the alarm state during the entry delay
+#define ALARM_STEP_TIMER 0u
+/// Alarm step interval in milliseconds during the entry delay
+#define ALARM_STEP_INTERVAL 100u
+/// Timer for the state telemetry keyframes
+#define KEYFRAME_TIMER 1u
+/// State telemetry keyframe interval in milliseconds, well below the
+/// 71 minute wrap-around of the microsecond timebase
+#define KEYFRAME_INTERVAL 600000u
+/// Keyframe retry interval in milliseconds after a lost state entry
+#define KEYFRAME_RETRY_INTERVAL 100u
+/// Timer for ending the loop floods
+#define FLOOD_TIMER 2u
+/// Interval for checking the loop floods in milliseconds
+#define FLOOD_CHECK_INTERVAL 250u
+/// Timer for sampling the loops and the buttons while they settle
+#define SAMPLE_TIMER 3u
+/// Sample interval in milliseconds while the loops or the buttons settle
+#define SAMPLE_INTERVAL 2u
+/// Timer for the analog loop scans
+#define SCAN_TIMER 4u
+/// Analog loop scan interval in milliseconds
+#define SCAN_INTERVAL 1000u
+/// Timer for sampling the buttons
+#define BUTTON_TIMER 5u
+/// Button gesture tick in milliseconds while a gesture is in progress
+#define GESTURE_TICK 10u
+/// Button sample interval in milliseconds between the gestures
+#define BUTTON_POLL_INTERVAL 50u
+/// Button filter width in samples of the sample interval
+#define BUTTON_FILTER 10u
+/// Timer for polling the power fail input
+#define POWER_TIMER 6u
+/// Power fail input poll interval in milliseconds
+#define POWER_POLL_INTERVAL 250u
+/// Input sampling interval in standby in milliseconds
+#define STANDBY_SAMPLE_INTERVAL 1000u
+/// Loop disturbance threshold in standby, just above the summed sense
+/// voltage of intact loops
+#define STANDBY_WAKE_THRESHOLD 24u
+
+/// Journal records after which the armed loops are recorded again, well
+/// before the journal wraps over the previous arm record
+#define ARMED_REFRESH_RECORDS (JOURNAL_RECORDS_PER_SECTOR * \
+        (BA8_FLASH_JOURNAL_SECTORS - 2u))
+
+/// Mask of the loop signals in the debouncer input word
+#define LOOP_SIGNALS_MASK (INPUT_DEBOUNCE_ALARM_MASK | \
+        INPUT_DEBOUNCE_SHIELD_MASK)
+
+/**
+ * \brief Configuration fields of the config command
+ */
+typedef enum {
+        /// Loops armed when the configuration is applied, without an index
+        CONFIG_FIELD_ARM_MASK = 0,
+        /// Loop in use (0 or 1), indexed by the loop
+        CONFIG_FIELD_ENABLED,
+        /// Loop type (config_loop_type_t), indexed by the loop
+        CONFIG_FIELD_TYPE,
+        /// Input filter width in samples, indexed by the loop
+        CONFIG_FIELD_FILTER,
+        /// Entry delay in 100 ms steps, indexed by the loop
+        CONFIG_FIELD_ENTRY_DELAY,
+        /// Input glitch filter (0 or 1), indexed by the loop port group
+        CONFIG_FIELD_GLITCH_FILTER
+} config_field_t;
+
+/// Alarm state
+static alarm_core_t alarm;
+/// State telemetry encoder
+static state_delta_encoder_t state_encoder;
+/// Loop edge flood control
+static flood_control_t flood;
+/// Loop and button signal debouncer
+static input_debounce_t debounce;
+/// Time of the newest loop edge not yet evaluated
+static uint32_t edge_time;
+/// True if edge_time holds a loop edge not yet evaluated
+static bool edge_pending;
+/// True while the entry delay step timer is running
+static bool entry_ticking;
+/// True while the sample timer is running
+static bool sampling;
+/// True while any loop signal differs from its debounced state
+static bool settling;
+/// True while an analog loop scan runs
+static bool scanning;
+/// True while in standby on the backup battery
+static bool standby;
+/// Set by the analog supervision when a scan has completed
+static volatile bool scan_complete;
+/// Loop guarded last by the analog supervision
+static uint8_t guarded_loop = BA8_MAXIMUM_LOOPS - 1u;
+/// Button gesture engine
+static button_gesture_t gesture;
+/// Time of the first loop scan after the reset
+static uint32_t first_scan_time;
+/// Sequence number of the newest journal record holding the armed loops
+static uint32_t armed_sequence;
+#if BA8_LATENCY_TRACE
+/// Position of the latency dump being streamed
+static uint32_t dump_position;
+/// Latency dump line being streamed
+static char dump_line[LATENCY_TRACE_LINE_LENGTH];
+/// Offset of the unsent part of dump_line
+static uint8_t dump_offset;
+/// True while the latency dump is being streamed
+static bool dumping;
+#endif // if BA8_LATENCY_TRACE
+
+/**
+ * \brief Gets the loops in the entry delay, alarm or tamper alarm
+ *
+ * \return Active loops
+ */
+static inline uint8_t active_loops(void)
+{
+        return alarm.entry | alarm.latched | alarm.tamper;
+}
+
+/**
+ * \brief Gets the debounced alarm signals
+ *
+ * \return Alarm signal states
+ */
+static inline uint8_t debounced_alarm(void)
+{
+        return (uint8_t)(debounce.state >> INPUT_DEBOUNCE_ALARM_SHIFT);
+}
+
+/**
+ * \brief Gets the debounced shield alarm signals
+ *
+ * \return Shield alarm signal states
+ */
+static inline uint8_t debounced_shield(void)
+{
+        return (uint8_t)(debounce.state >> INPUT_DEBOUNCE_SHIELD_SHIFT);
+}
+
+/**
+ * \brief Gets the debounced button signals
+ *
+ * \return Button states
+ */
+static inline uint8_t debounced_buttons(void)
+{
+        return (uint8_t)(debounce.state >> INPUT_DEBOUNCE_BUTTON_SHIFT);
+}
+
+/**
+ * \brief Gets the loops in a status from the latest analog scan
+ *
+ * \param[in] status Loop status
+ *
+ * \return Loops in the status
+ */
+static uint8_t analog_loops(loop_analog_status_t status)
+{
+        uint8_t loops = 0u;
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if (loop_analog_io_get_status(loop) == status) {
+                        loops |= (uint8_t)(1u << loop);
+                }
+        }
+
+        return loops;
+}
+
+/**
+ * \brief Gets the loop faults from the latest analog scan
+ *
+ * A short circuit, a cut cable or a tampered end-of-line resistor is a
+ * fault. An open loop is left to the digital alarm path.
+ *
+ * \return Faulty loops
+ */
+static inline uint8_t analog_faults(void)
+{
+        return (uint8_t)~(analog_loops(LOOP_ANALOG_STATUS_NORMAL) |
+                analog_loops(LOOP_ANALOG_STATUS_ALARM));
+}
+
+/**
+ * \brief Gets the enabled loops from the configuration
+ *
+ * \return Enabled loops
+ */
+static uint8_t enabled_loops(void)
+{
+        config_image_t const *config = config_store_get();
+        uint8_t enabled = 0u;
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                if (config->loops[loop].enabled) {
+                        enabled |= (uint8_t)(1u << loop);
+                }
+        }
+
+        return enabled;
+}
+
+/**
+ * \brief Applies the configuration to the loop inputs, the debouncer and the
+ *        alarm state
+ *
+ * The alarm state has one shared entry delay, so the longest entry delay of
+ * the delayed loops is used. The buttons are not configurable and always
+ * use the button filter. Only the enabled loops of the arm mask are left
+ * armed.
+ */
+static void apply_config(void)
+{
+        config_image_t const *config = config_store_get();
+        uint8_t delayed = 0u;
+        uint16_t entry_delay = 0u;
+        uint8_t armed;
+
+        for (uint8_t group = 0u; group < ALARM_LOOP_PORT_GROUPS; ++group) {
+                (void)alarm_loop_io_set_filter((alarm_loop_port_group_t)group,
+                        ((config->glitch_filter >> group) & 1u) != 0u);
+        }
+
+        for (uint8_t loop = 0u; loop < BA8_MAXIMUM_LOOPS; ++loop) {
+                config_loop_t const *settings = &config->loops[loop];
+
+                input_debounce_set_threshold(&debounce,
+                        input_debounce_pack((uint8_t)(1u << loop),
+                        (uint8_t)(1u << loop), 0u), settings->filter);
+                if (settings->type != CONFIG_LOOP_DELAYED) {
+                        continue;
+                }
+                delayed |= (uint8_t)(1u << loop);
+                if (settings->entry_delay > entry_delay) {
+                        entry_delay = settings->entry_delay;
+                }
+        }
+        input_debounce_set_threshold(&debounce, INPUT_DEBOUNCE_BUTTON_MASK,
+                BUTTON_FILTER);
+
+        alarm_core_set_entry_delay(&alarm, delayed, entry_delay);
+        armed = config->arm_mask & enabled_loops();
+        alarm_core_disarm(&alarm, alarm.armed & ~armed);
+        alarm_core_arm(&alarm, armed);
+}
+
+/**
+ * \brief Journals a change of the armed loops
+ *
+ * The record also holds all the loops armed after the change, from which
+ * they are restored after a reset.
+ *
+ * \param[in] event JOURNAL_EVENT_ARM or JOURNAL_EVENT_DISARM
+ * \param[in] loops Loops armed or disarmed
+ *
+ * \return Result of the operation
+ */
+static mdv_result_t journal_armed(journal_event_t event, uint8_t loops)
+{
+        armed_sequence = journal_next_sequence();
+
+        return journal_append(event, loops, JOURNAL_DATA_ARMED | alarm.armed,
+                timebase_io_now());
+}
+
+/**
+ * \brief Journals the loops armed and disarmed since an earlier state
+ *
+ * \param[in] armed Loops armed before
+ */
+static void journal_arm_changes(uint8_t armed)
+{
+        if (armed & ~alarm.armed) {
+                (void)journal_armed(JOURNAL_EVENT_DISARM,
+                        armed & ~alarm.armed);
+        }
+        if (alarm.armed & ~armed) {
+                (void)journal_armed(JOURNAL_EVENT_ARM, alarm.armed & ~armed);
+        }
+}
+
+/**
+ * \brief Restores the armed loops from the journal
+ *
+ * The newest arm or disarm record holding the armed loops wins over the arm
+ * mask of the configuration. Without one, the configuration stays in
+ * effect.
+ */
+static void restore_armed(void)
+{
+        uint32_t const next = journal_next_sequence();
+        uint32_t const records = JOURNAL_RECORDS_PER_SECTOR *
+                BA8_FLASH_JOURNAL_SECTORS;
+        journal_record_t record;
+
+        armed_sequence = next;
+        for (uint32_t i = 1u; (i <= records) && (i <= next); ++i) {
+                // Torn records are skipped.
+                if (!journal_read(next - i, &record) ||
+                        ((record.event != JOURNAL_EVENT_ARM) &&
+                        (record.event != JOURNAL_EVENT_DISARM)) ||
+                        !(record.data & JOURNAL_DATA_ARMED)) {
+                        continue;
+                }
+
+                armed_sequence = record.sequence;
+                alarm_core_disarm(&alarm, alarm.armed &
+                        ~(uint8_t)record.data);
+                alarm_core_arm(&alarm, (uint8_t)record.data &
+                        enabled_loops());
+                break;
+        }
+}
+
+/**
+ * \brief Queues an alarm event for the telemetry stream
+ *
+ * \param[in] priority Priority of the event
+ * \param[in] event Event type
+ * \param[in] loops Loops of the event
+ * \param[in] time Event time
+ */
+static void post_event(event_queue_priority_t priority, journal_event_t event,
+        uint8_t loops, uint32_t time)
+{
+        uint8_t const record[] = {
+                (uint8_t)event,
+                loops,
+                (uint8_t)time,
+                (uint8_t)(time >> 8u),
+                (uint8_t)(time >> 16u),
+                (uint8_t)(time >> 24u)
+        };
+
+        (void)event_queue_post(priority, TELEMETRY_RECORD_EVENT, record,
+                sizeof(record));
+}
+
+/**
+ * \brief Reports the new alarms, tamper alarms and faults
+ *
+ * The events are handed over to the telemetry stream before they are
+ * written into the journal.
+ *
+ * \param[in] before Alarm state before the step
+ */
+static void report_changes(alarm_core_t const *before)
+{
+        uint32_t const time = timebase_io_now();
+        uint8_t const alarms = alarm.latched & ~before->latched;
+        uint8_t const tampers = alarm.tamper & ~before->tamper;
+        uint8_t const faults = alarm.fault & ~before->fault;
+
+        if (tampers) {
+                post_event(EVENT_QUEUE_TAMPER, JOURNAL_EVENT_TAMPER, tampers,
+                        time);
+        }
+        if (alarms) {
+                post_event(EVENT_QUEUE_ALARM, JOURNAL_EVENT_ALARM, alarms,
+                        time);
+        }
+        if (faults) {
+                post_event(EVENT_QUEUE_FAULT, JOURNAL_EVENT_FAULT, faults,
+                        time);
+        }
+        event_queue_flush();
+
+        if (alarms) {
+                (void)journal_append(JOURNAL_EVENT_ALARM, alarms, 0u, time);
+        }
+        if (tampers) {
+                (void)journal_append(JOURNAL_EVENT_TAMPER, tampers, 0u, time);
+        }
+        if (faults) {
+                (void)journal_append(JOURNAL_EVENT_FAULT, faults, 0u, time);
+        }
+
+        // Record the armed loops again before the journal wraps over them.
+        if ((journal_next_sequence() - armed_sequence) >=
+                ARMED_REFRESH_RECORDS) {
+                (void)journal_armed(JOURNAL_EVENT_ARM, 0u);
+        }
+}
+
+static void send_keyframe(void);
+
+/**
+ * \brief Sends the changes of the device state to the telemetry stream
+ *
+ * The loop and button signals are reported in their debounced states.
+ *
+ * \param[in] time Time of the state
+ */
+static void send_state(uint32_t time)
+{
+        uint32_t const held = state_delta_pack(flood.flooded, flood.flooded,
+                0u, false);
+        uint32_t state = state_delta_pack(debounced_alarm(),
+                debounced_shield(), debounced_buttons(),
+                (alarm.latched | alarm.tamper) != 0u);
+        uint8_t entry[STATE_DELTA_MAXIMUM_ENTRY];
+        uint8_t length;
+
+        // The flooded loops keep their last reported state until the flood
+        // summary.
+        state = (state & ~held) | (state_encoder.state & held);
+        length = state_delta_encode(&state_encoder, state, time, entry);
+
+        // A lost entry leaves the receiver with a wrong state until the next
+        // keyframe, so retry with a keyframe shortly.
+        if (length && (event_queue_post(EVENT_QUEUE_INFO,
+                TELEMETRY_RECORD_STATE, entry, length) != MDV_RESULT_OK)) {
+                state_delta_request_keyframe(&state_encoder);
+                (void)scheduler_start_timer(KEYFRAME_TIMER,
+                        KEYFRAME_RETRY_INTERVAL, send_keyframe);
+        }
+        event_queue_flush();
+}
+
+/**
+ * \brief Sends a state keyframe and restarts the keyframe timer
+ */
+static void send_keyframe(void)
+{
+        (void)scheduler_start_timer(KEYFRAME_TIMER, KEYFRAME_INTERVAL,
+                send_keyframe);
+        state_delta_request_keyframe(&state_encoder);
+        send_state(timebase_io_now());
+}
+
+static void entry_tick(void);
+
+/**
+ * \brief Evaluates the alarm state from the debounced loop signals
+ *
+ * \param[in] steps Entry delay steps elapsed since the previous evaluation
+ */
+static void evaluate(uint16_t steps)
+{
+        uint32_t const time = edge_pending ? edge_time : timebase_io_now();
+        uint8_t const enabled = enabled_loops();
+        alarm_core_input_t input = {
+                .alarm = debounced_alarm() & enabled,
+                .shield = debounced_shield() & enabled,
+                .fault = analog_faults() & enabled
+        };
+        standby_io_wake_t wake;
+        alarm_loop_io_snapshot_t disturbed;
+        alarm_core_t const before = alarm;
+#if BA8_LATENCY_TRACE
+        uint8_t const active = active_loops();
+#endif // if BA8_LATENCY_TRACE
+
+        // A loop which woke the core from standby counts as triggered, so
+        // that a pulse shorter than the wake-up time is not missed.
+        if (standby_io_get_wake(&wake)) {
+                input.alarm |= wake.alarm & enabled;
+                input.shield |= wake.shield & enabled;
+        }
+
+        // The same for the loops read right after a wake-up by the loop
+        // disturbance comparator, which covers the loops without a wake-up
+        // pin.
+        if (loop_wake_io_get_wake(&disturbed)) {
+                input.alarm |= disturbed.alarm & enabled;
+                input.shield |= disturbed.shield & enabled;
+        }
+
+        (void)alarm_core_step(&alarm, &input, steps);
+        LATENCY_TRACE_STAGE(LATENCY_STAGE_TRANSITION,
+                active_loops() & ~active, timebase_io_now());
+
+        // Only the loops which switched the relay on reach the relay stage,
+        // not e.g. the loops entering the entry delay.
+        (void)alarm_core_drive_outputs(&alarm);
+        LATENCY_TRACE_STAGE(LATENCY_STAGE_RELAY,
+                (before.latched | before.tamper) ? 0u :
+                (alarm.latched | alarm.tamper), timebase_io_now());
+
+        // The edges of the loops still settling wait for their decision.
+        if (!settling) {
+                LATENCY_TRACE_FINISH();
+        }
+
+        // Journal only after the outputs are up to date, as a flash erase
+        // may take tens of milliseconds.
+        report_changes(&before);
+        send_state(time);
+        edge_pending = false;
+
+        // Keep stepping while the entry delay runs, otherwise sleep until
+        // the next loop edge. A running step timer is left alone, so that
+        // the loop edges do not push the steps back.
+        if (alarm.entry && !entry_ticking) {
+                entry_ticking = true;
+                (void)scheduler_start_timer(ALARM_STEP_TIMER,
+                        ALARM_STEP_INTERVAL, entry_tick);
+        }
+}
+
+/**
+ * \brief Counts down one step of the entry delay
+ */
+static void entry_tick(void)
+{
+        entry_ticking = false;
+        evaluate(1u);
+}
+
+static void sample_tick(void);
+
+/**
+ * \brief Feeds a sample of the loops and the buttons into the debouncer
+ *
+ * All the signals are sampled with the sample timer for as long as any of
+ * them differs from its debounced state.
+ *
+ * \return Signals whose debounced state changed
+ */
+static uint32_t sample_inputs(void)
+{
+        alarm_loop_io_snapshot_t const snapshot = alarm_loop_io_snapshot();
+        uint32_t const sample = input_debounce_pack(snapshot.alarm,
+                snapshot.shield, button_io_snapshot());
+        uint32_t const changed = input_debounce_step(&debounce, sample);
+        uint32_t const unsettled = sample ^ debounce.state;
+
+        LATENCY_TRACE_STAGE(LATENCY_STAGE_DECISION,
+                (uint8_t)(changed >> INPUT_DEBOUNCE_ALARM_SHIFT) |
+                (uint8_t)(changed >> INPUT_DEBOUNCE_SHIELD_SHIFT),
+                timebase_io_now());
+        settling = (unsettled & LOOP_SIGNALS_MASK) != 0u;
+        if (unsettled && !sampling) {
+                sampling = true;
+                (void)scheduler_start_timer(SAMPLE_TIMER, SAMPLE_INTERVAL,
+                        sample_tick);
+        }
+
+        return changed;
+}
+
+/**
+ * \brief Acts on the changes of a debounced sample
+ *
+ * A loop change is evaluated, and a button change alone is only sent to the
+ * telemetry stream.
+ *
+ * \param[in] changed Signals whose debounced state changed
+ */
+static void sampled(uint32_t changed)
+{
+        if (changed & LOOP_SIGNALS_MASK) {
+                evaluate(0u);
+                return;
+        }
+        if (changed) {
+                send_state(timebase_io_now());
+        }
+        if (!settling) {
+                // The loops settled back without a change.
+                LATENCY_TRACE_FINISH();
+        }
+}
+
+static void tick_gestures(void);
+static void button_tick(void);
+
+/**
+ * \brief Samples the unsettled loops and buttons
+ *
+ * A button change starts its gesture at once, unless the gesture ticks are
+ * already running.
+ */
+static void sample_tick(void)
+{
+        uint32_t changed;
+
+        sampling = false;
+        changed = sample_inputs();
+        sampled(changed);
+        if ((changed & INPUT_DEBOUNCE_BUTTON_MASK) && !gesture.pressed &&
+                !gesture.tap_armed) {
+                tick_gestures();
+        }
+}
+
+/**
+ * \brief Evaluates the loops for the first time after the reset
+ *
+ * The first loop sample is taken as settled, as there is no history to
+ * filter it against. Only the loop inputs, the outputs and the
+ * configuration are up at this point, so the changes are reported later,
+ * once the journal and the telemetry stream have been started.
+ *
+ * \param[out] before Alarm state before the scan
+ */
+static void first_scan(alarm_core_t *before)
+{
+        alarm_loop_io_snapshot_t const snapshot = alarm_loop_io_snapshot();
+        uint8_t const enabled = enabled_loops();
+        alarm_core_input_t const input = {
+                .alarm = snapshot.alarm & enabled,
+                .shield = snapshot.shield & enabled,
+                .fault = 0u
+        };
+
+        first_scan_time = timebase_io_now();
+        debounce.state = input_debounce_pack(snapshot.alarm, snapshot.shield,
+                button_io_snapshot());
+        *before = alarm;
+        (void)alarm_core_step(&alarm, &input, 0u);
+        (void)alarm_core_drive_outputs(&alarm);
+}
+
+/**
+ * \brief Ends the loop floods whose window has passed
+ *
+ * Sends a summary of each ended flood, followed by the current state of the
+ * loops.
+ */
+static void end_floods(void)
+{
+        uint32_t const time = timebase_io_now();
+        flood_control_summary_t summary;
+
+        while (flood_control_end(&flood, time, &summary)) {
+                uint32_t milliseconds = summary.duration /
+                        (TIMEBASE_IO_TICK_FREQUENCY / 1000u);
+                uint8_t record[7];
+
+                if (milliseconds > 0xFFFFu) {
+                        milliseconds = 0xFFFFu;
+                }
+                record[0] = summary.loop;
+                record[1] = (uint8_t)summary.edges;
+                record[2] = (uint8_t)(summary.edges >> 8u);
+                record[3] = (uint8_t)(summary.edges >> 16u);
+                record[4] = (uint8_t)(summary.edges >> 24u);
+                record[5] = (uint8_t)milliseconds;
+                record[6] = (uint8_t)(milliseconds >> 8u);
+                (void)event_queue_post(EVENT_QUEUE_FAULT,
+                        TELEMETRY_RECORD_FLOOD, record, sizeof(record));
+        }
+        send_state(time);
+
+        if (flood.flooded) {
+                (void)scheduler_start_timer(FLOOD_TIMER, FLOOD_CHECK_INTERVAL,
+                        end_floods);
+        }
+}
+
+/**
+ * \brief Handles the loop event
+ */
+static void loop_event(void)
+{
+        uint8_t const flooded = flood.flooded;
+        alarm_loop_edge_t edge;
+
+        // The edges only trigger a sample of all the loops, which is
+        // debounced before the evaluation. Edges beyond the rate limit of
+        // their loop are left out of the reported edge time.
+        while (alarm_loop_io_get_edge(&edge)) {
+                LATENCY_TRACE_EDGE((uint8_t)(1u << edge.loop),
+                        edge.timestamp);
+                if (flood_control_edge(&flood, edge.loop, edge.timestamp)) {
+                        edge_time = edge.timestamp;
+                        edge_pending = true;
+                }
+        }
+        if (flood.flooded && !flooded) {
+                (void)scheduler_start_timer(FLOOD_TIMER, FLOOD_CHECK_INTERVAL,
+                        end_floods);
+        }
+
+        // The entry delay counts down only in its own steps.
+        (void)sample_inputs();
+        evaluate(0u);
+}
+
+/**
+ * \brief Starts an analog scan of the loops
+ *
+ * A scan already running is left alone, and a failed start is retried
+ * after the scan interval.
+ */
+static void start_scan(void)
+{
+        if (scanning) {
+                return;
+        }
+        if (loop_analog_io_start_scan() == MDV_RESULT_OK) {
+                scanning = true;
+        } else {
+                (void)scheduler_start_timer(SCAN_TIMER, SCAN_INTERVAL,
+                        start_scan);
+        }
+}
+
+/**
+ * \brief Guards the next loop between the analog scans
+ *
+ * Only one loop can be guarded at a time, so the guard goes round the
+ * armed loops in the normal status, one loop per scan.
+ */
+static void rotate_guard(void)
+{
+        uint8_t const candidates = alarm.armed & enabled_loops() &
+                analog_loops(LOOP_ANALOG_STATUS_NORMAL);
+
+        for (uint8_t i = 1u; i <= BA8_MAXIMUM_LOOPS; ++i) {
+                uint8_t const loop = (uint8_t)((guarded_loop + i) %
+                        BA8_MAXIMUM_LOOPS);
+
+                if ((candidates >> loop) & 1u) {
+                        guarded_loop = loop;
+                        (void)loop_analog_io_start_guard(loop);
+                        break;
+                }
+        }
+}
+
+/**
+ * \brief Handles the analog supervision event
+ *
+ * After a scan, the next loop is guarded until the next scan. A tripped
+ * guard is confirmed with a scan of all the loops at once. The alarm state
+ * is evaluated whenever the loop faults change. In standby, a scan still
+ * running is completed, but no new scan or guard is started.
+ */
+static void analog_event(void)
+{
+        if (scan_complete) {
+                scan_complete = false;
+                scanning = false;
+                if (!standby) {
+                        rotate_guard();
+                        (void)scheduler_start_timer(SCAN_TIMER,
+                                SCAN_INTERVAL, start_scan);
+                }
+        } else if (!standby) {
+                start_scan();
+        }
+
+        if ((analog_faults() & enabled_loops()) != alarm.fault) {
+                evaluate(0u);
+        }
+}
+
+#if BA8_LATENCY_TRACE
+/**
+ * \brief Streams the latency dump into the telemetry stream
+ *
+ * Sends as much of the dump as fits into the telemetry buffers in text
+ * records, and goes on when buffer space is freed.
+ */
+static void stream_latency_dump(void)
+{
+        telemetry_begin_batch();
+        while (dumping) {
+                uint32_t length;
+
+                if (!dump_line[dump_offset]) {
+                        dump_offset = 0u;
+                        if (!latency_trace_dump_line(&dump_position,
+                                dump_line)) {
+                                dumping = false;
+                                break;
+                        }
+                }
+
+                length = strlen(&dump_line[dump_offset]);
+                if (length > TELEMETRY_MAXIMUM_PAYLOAD) {
+                        length = TELEMETRY_MAXIMUM_PAYLOAD;
+                }
+                if (!telemetry_has_space((uint8_t)length)) {
+                        break;
+                }
+                (void)telemetry_send(TELEMETRY_RECORD_TEXT,
+                        &dump_line[dump_offset], (uint8_t)length);
+                dump_offset += (uint8_t)length;
+        }
+        telemetry_end_batch();
+}
+#endif // if BA8_LATENCY_TRACE
+
+/**
+ * \brief Handles the telemetry event
+ *
+ * The queued events go first, and the latency dump uses the space left.
+ */
+static void telemetry_event(void)
+{
+        event_queue_flush();
+#if BA8_LATENCY_TRACE
+        stream_latency_dump();
+#endif // if BA8_LATENCY_TRACE
+}
+
+/**
+ * \brief Posts the telemetry event when buffer space is freed
+ */
+static void telemetry_space_notify(void)
+{
+        scheduler_post(SCHEDULER_EVENT_TELEMETRY);
+}
+
+/**
+ * \brief Handles the status command
+ *
+ * Responds with the armed, entry, latched, tamper and fault loops.
+ */
+static mdv_result_t status_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        (void)arguments;
+        (void)count;
+
+        response[0] = alarm.armed;
+        response[1] = alarm.entry;
+        response[2] = alarm.latched;
+        response[3] = alarm.tamper;
+        response[4] = alarm.fault;
+        *length = 5u;
+
+        return MDV_RESULT_OK;
+}
+
+/**
+ * \brief Arms loops and keeps them armed over a reset
+ *
+ * \param[in] loops Loops to arm, of which only the enabled ones are armed
+ *
+ * \return Result of persisting the armed loops
+ */
+static mdv_result_t arm_loops(uint8_t loops)
+{
+        loops &= enabled_loops();
+        alarm_core_arm(&alarm, loops);
+        scheduler_post(SCHEDULER_EVENT_LOOP);
+
+        return journal_armed(JOURNAL_EVENT_ARM, loops);
+}
+
+/**
+ * \brief Disarms loops and keeps them disarmed over a reset
+ *
+ * \param[in] loops Loops to disarm
+ *
+ * \return Result of persisting the armed loops
+ */
+static mdv_result_t disarm_loops(uint8_t loops)
+{
+        alarm_core_disarm(&alarm, loops);
+        scheduler_post(SCHEDULER_EVENT_LOOP);
+
+        return journal_armed(JOURNAL_EVENT_DISARM, loops);
+}
+
+/**
+ * \brief Acts on the button gestures
+ *
+ * A long press of a button disarms its loop if armed, and arms it
+ * otherwise. A double tap acknowledges the alarm and the tamper alarm of
+ * the loop, which is journaled as a disarm and an arm. The buttons of a
+ * chord do nothing.
+ *
+ * \param[in] buttons Button states
+ */
+static void step_gestures(uint8_t buttons)
+{
+        button_gesture_event_t events[BUTTON_GESTURE_MAX_EVENTS];
+        uint32_t const count = button_gesture_step(&gesture, buttons, events);
+
+        for (uint32_t i = 0u; i < count; ++i) {
+                uint8_t const buttons = events[i].buttons;
+                uint8_t const armed = buttons & alarm.armed;
+                uint8_t const alarmed = armed & (alarm.latched |
+                        alarm.tamper);
+
+                if (events[i].type == BUTTON_GESTURE_LONG_PRESS) {
+                        if (armed) {
+                                (void)disarm_loops(armed);
+                        }
+                        if (buttons & ~armed & enabled_loops()) {
+                                (void)arm_loops(buttons & ~armed);
+                        }
+                } else if ((events[i].type == BUTTON_GESTURE_DOUBLE_TAP) &&
+                        alarmed) {
+                        alarm_core_disarm(&alarm, alarmed);
+                        (void)journal_armed(JOURNAL_EVENT_DISARM, alarmed);
+                        alarm_core_arm(&alarm, alarmed);
+                        (void)journal_armed(JOURNAL_EVENT_ARM, alarmed);
+                        scheduler_post(SCHEDULER_EVENT_LOOP);
+                }
+        }
+}
+
+/**
+ * \brief Steps the gestures with the debounced buttons
+ *
+ * A gesture is ticked for as long as a button is held down or waits for its
+ * second tap, and the buttons are polled otherwise. In standby, the buttons
+ * wake the core through their wake-up pins, so they are not polled.
+ */
+static void tick_gestures(void)
+{
+        uint8_t const buttons = debounced_buttons();
+
+        if ((buttons != gesture.pressed) || gesture.pressed ||
+                gesture.tap_armed) {
+                step_gestures(buttons);
+        }
+
+        if (gesture.pressed || gesture.tap_armed) {
+                (void)scheduler_start_timer(BUTTON_TIMER, GESTURE_TICK,
+                        button_tick);
+        } else if (!standby) {
+                (void)scheduler_start_timer(BUTTON_TIMER,
+                        BUTTON_POLL_INTERVAL, button_tick);
+        }
+}
+
+/**
+ * \brief Samples the buttons
+ *
+ * The buttons have no edge interrupts, so they are polled. A sample which
+ * differs from the debounced buttons starts the sample timer, which then
+ * filters the buttons together with the loops. The buttons are not polled
+ * while the sample timer runs, so that the polls do not shorten the filter
+ * width of the loops.
+ */
+static void button_tick(void)
+{
+        if (!sampling) {
+                sampled(sample_inputs());
+        }
+        tick_gestures();
+}
+
+/**
+ * \brief Handles the button event
+ */
+static void button_event(void)
+{
+        button_tick();
+}
+
+/**
+ * \brief Handles the arm command
+ *
+ * Arguments: loops to arm. The loops stay armed over a reset. A failure to
+ * persist them is returned, but the loops are armed anyway.
+ */
+static mdv_result_t arm_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        (void)response;
+        (void)length;
+
+        if ((count != 1u) || (arguments[0] > 0xFFu)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        return arm_loops((uint8_t)arguments[0]);
+}
+
+/**
+ * \brief Handles the disarm command
+ *
+ * Arguments: loops to disarm. The loops stay disarmed over a reset. A
+ * failure to persist them is returned, but the loops are disarmed anyway.
+ */
+static mdv_result_t disarm_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        (void)response;
+        (void)length;
+
+        if ((count != 1u) || (arguments[0] > 0xFFu)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        return disarm_loops((uint8_t)arguments[0]);
+}
+
+/**
+ * \brief Handles the journal command
+ *
+ * Without arguments, responds with the next sequence number (4 bytes,
+ * little-endian). With a sequence number, responds with the record.
+ */
+static mdv_result_t journal_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        journal_record_t record;
+
+        if (!count) {
+                uint32_t const next = journal_next_sequence();
+
+                response[0] = (uint8_t)next;
+                response[1] = (uint8_t)(next >> 8u);
+                response[2] = (uint8_t)(next >> 16u);
+                response[3] = (uint8_t)(next >> 24u);
+                *length = 4u;
+                return MDV_RESULT_OK;
+        }
+        if ((count != 1u) || !journal_read(arguments[0], &record)) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        memcpy(response, &record, sizeof(record));
+        *length = sizeof(record);
+
+        return MDV_RESULT_OK;
+}
+
+/**
+ * \brief Handles the dropped command
+ *
+ * Responds with the number of dropped telemetry records (4 bytes,
+ * little-endian).
+ */
+static mdv_result_t dropped_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        uint32_t const dropped = telemetry_get_dropped();
+
+        (void)arguments;
+        (void)count;
+
+        response[0] = (uint8_t)dropped;
+        response[1] = (uint8_t)(dropped >> 8u);
+        response[2] = (uint8_t)(dropped >> 16u);
+        response[3] = (uint8_t)(dropped >> 24u);
+        *length = 4u;
+
+        return MDV_RESULT_OK;
+}
+
+/**
+ * \brief Changes one field of a configuration image
+ *
+ * \param[in,out] image Configuration image
+ * \param[in] field Field (config_field_t)
+ * \param[in] index Loop or port group index of the indexed fields
+ * \param[in] value New value
+ *
+ * \return True if the field was changed, false if the field, the index or
+ *         the value is invalid
+ */
+static bool set_config_field(config_image_t *image, uint32_t field,
+        uint32_t index, uint32_t value)
+{
+        config_loop_t *settings;
+
+        if (field == CONFIG_FIELD_ARM_MASK) {
+                if (value > 0xFFu) {
+                        return false;
+                }
+                image->arm_mask = (uint8_t)value;
+                return true;
+        }
+        if (field == CONFIG_FIELD_GLITCH_FILTER) {
+                if ((index >= ALARM_LOOP_PORT_GROUPS) || (value > 1u)) {
+                        return false;
+                }
+                image->glitch_filter = (uint8_t)((image->glitch_filter &
+                        ~(1u << index)) | (value << index));
+                return true;
+        }
+        if (index >= BA8_MAXIMUM_LOOPS) {
+                return false;
+        }
+
+        settings = &image->loops[index];
+        switch (field) {
+        case CONFIG_FIELD_ENABLED:
+                if (value > 1u) {
+                        return false;
+                }
+                settings->enabled = (uint8_t)value;
+                break;
+        case CONFIG_FIELD_TYPE:
+                if (value > CONFIG_LOOP_DELAYED) {
+                        return false;
+                }
+                settings->type = (uint8_t)value;
+                break;
+        case CONFIG_FIELD_FILTER:
+                if ((value < 1u) ||
+                        (value > INPUT_DEBOUNCE_MAXIMUM_THRESHOLD)) {
+                        return false;
+                }
+                settings->filter = (uint8_t)value;
+                break;
+        case CONFIG_FIELD_ENTRY_DELAY:
+                if (value > 0xFFFFu) {
+                        return false;
+                }
+                settings->entry_delay = (uint16_t)value;
+                break;
+        default:
+                return false;
+        }
+
+        return true;
+}
+
+/**
+ * \brief Handles the config command
+ *
+ * Without arguments, responds with the generation of the active
+ * configuration (4 bytes, little-endian) and the arm mask. With a loop
+ * index, responds with the settings of the loop (config_loop_t). With a
+ * field (config_field_t), a loop index and a value, writes a new
+ * configuration with the field changed and applies it. The index is
+ * ignored for the fields without one. The new configuration takes the
+ * currently armed loops as its arm mask, unless the arm mask is the field
+ * changed.
+ */
+static mdv_result_t config_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        config_image_t const *config = config_store_get();
+        config_image_t image = *config;
+        uint8_t const armed = alarm.armed;
+        mdv_result_t result;
+
+        if (!count) {
+                response[0] = (uint8_t)config->generation;
+                response[1] = (uint8_t)(config->generation >> 8u);
+                response[2] = (uint8_t)(config->generation >> 16u);
+                response[3] = (uint8_t)(config->generation >> 24u);
+                response[4] = config->arm_mask;
+                *length = 5u;
+                return MDV_RESULT_OK;
+        }
+        if ((count == 1u) && (arguments[0] < BA8_MAXIMUM_LOOPS)) {
+                memcpy(response, &config->loops[arguments[0]],
+                        sizeof(config_loop_t));
+                *length = sizeof(config_loop_t);
+                return MDV_RESULT_OK;
+        }
+        image.arm_mask = armed;
+        if ((count != 3u) || !set_config_field(&image, arguments[0],
+                arguments[1], arguments[2])) {
+                return BA8_RESULT_INVALID_PARAMETER;
+        }
+
+        result = config_store_write(&image);
+        if (result != MDV_RESULT_OK) {
+                return result;
+        }
+        apply_config();
+        journal_arm_changes(armed);
+        scheduler_post(SCHEDULER_EVENT_LOOP);
+
+        return MDV_RESULT_OK;
+}
+
+#if BA8_LATENCY_TRACE
+/**
+ * \brief Handles the latency command
+ *
+ * Starts streaming the latency histograms as text records, see
+ * latency_trace_dump_line(). The response comes before the text.
+ */
+static mdv_result_t latency_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        (void)arguments;
+        (void)count;
+        (void)response;
+        (void)length;
+
+        dump_position = 0u;
+        dump_line[0] = '\0';
+        dump_offset = 0u;
+        dumping = true;
+        scheduler_post(SCHEDULER_EVENT_TELEMETRY);
+
+        return MDV_RESULT_OK;
+}
+#endif // if BA8_LATENCY_TRACE
+
+/**
+ * \brief Handles the boot command
+ *
+ * Responds with the time of the first loop scan in timebase ticks since the
+ * timebase was started, right after the reset (4 bytes, little-endian).
+ */
+static mdv_result_t boot_command(uint32_t const *arguments, uint8_t count,
+        uint8_t *response, uint8_t *length)
+{
+        (void)arguments;
+        (void)count;
+
+        response[0] = (uint8_t)first_scan_time;
+        response[1] = (uint8_t)(first_scan_time >> 8u);
+        response[2] = (uint8_t)(first_scan_time >> 16u);
+        response[3] = (uint8_t)(first_scan_time >> 24u);
+        *length = 4u;
+
+        return MDV_RESULT_OK;
+}
+
+/**
+ * \brief Polls the power fail input
+ *
+ * Standby is entered on a mains failure and exited when the mains returns.
+ * The analog loop supervision needs the ADC, which stops in standby, so it
+ * is paused for the standby.
+ */
+static void power_tick(void)
+{
+        bool const failed = power_io_mains_failed();
+
+        if (failed && !standby && (scheduler_enter_standby(
+                STANDBY_SAMPLE_INTERVAL, STANDBY_WAKE_THRESHOLD) ==
+                MDV_RESULT_OK)) {
+                standby = true;
+                (void)scheduler_stop_timer(SCAN_TIMER);
+                loop_analog_io_stop_guard();
+        } else if (!failed && standby) {
+                standby = false;
+                scheduler_exit_standby();
+                start_scan();
+                if (!gesture.pressed && !gesture.tap_armed) {
+                        // Resume the button polls.
+                        tick_gestures();
+                }
+        }
+
+        (void)scheduler_start_timer(POWER_TIMER, POWER_POLL_INTERVAL,
+                power_tick);
+}
+
+/// Console commands
+static console_command_t const commands[] = {
+        { "status", status_command },
+        { "arm", arm_command },
+        { "disarm", disarm_command },
+        { "journal", journal_command },
+        { "dropped", dropped_command },
+        { "config", config_command },
+        { "boot", boot_command },
+#if BA8_LATENCY_TRACE
+        { "latency", latency_command }
+#endif // if BA8_LATENCY_TRACE
+};
+
+/**
+ * \brief Posts the loop event when new loop edges are available
+ */
+static void loop_edge_notify(void)
+{
+        scheduler_post(SCHEDULER_EVENT_LOOP);
+}
+
+/**
+ * \brief Posts the analog event on an analog supervision event
+ *
+ * \param[in] event Analog supervision event
+ */
+static void analog_notify(loop_analog_event_t event)
+{
+        if (event == LOOP_ANALOG_EVENT_SCAN_DONE) {
+                scan_complete = true;
+        }
+        scheduler_post(SCHEDULER_EVENT_ANALOG);
+}
 
 void main(void)
 {
-        while(1) {
+        alarm_core_t before;
+
+        // The COP has been running since the reset. Guard the loops first:
+        // only the drivers and the state needed for the first scan are
+        // started before it.
+        watchdog_init();
+        (void)timebase_io_init();
+        (void)relay_io_init();
+        (void)relay_output.init();
+        (void)alarm_loop_io_init();
+        (void)button_io_init();
+        (void)backlight_io_init();
+        (void)power_io_init();
+        (void)config_store_init();
+        (void)flash_io_init();
+        (void)journal_init();
+        alarm_core_init(&alarm);
+        input_debounce_init(&debounce, 0u);
+        apply_config();
+        restore_armed();
+        first_scan(&before);
+
+        // The serial port and the journal appends can wait.
+        (void)serial_io_init();
+        (void)scheduler_init();
+        if (watchdog_caused_reset()) {
+                (void)journal_append(JOURNAL_EVENT_WATCHDOG, 0u, 0u,
+                        timebase_io_now());
         }
+        telemetry_init();
+        (void)console_init(commands,
+                (uint8_t)(sizeof(commands) / sizeof(commands[0])));
+
+#if BA8_LATENCY_TRACE
+        latency_trace_init();
+#endif // if BA8_LATENCY_TRACE
+        state_delta_encoder_init(&state_encoder);
+        button_gesture_init(&gesture);
+        flood_control_init(&flood, timebase_io_now());
+        event_queue_init();
+        (void)scheduler_set_handler(SCHEDULER_EVENT_LOOP, loop_event);
+        (void)scheduler_set_handler(SCHEDULER_EVENT_BUTTON, button_event);
+        (void)scheduler_set_handler(SCHEDULER_EVENT_TELEMETRY,
+                telemetry_event);
+        (void)scheduler_set_handler(SCHEDULER_EVENT_ANALOG, analog_event);
+        telemetry_set_space_notify(telemetry_space_notify);
+        alarm_loop_io_set_edge_notify(loop_edge_notify);
+        (void)alarm_loop_io_enable_edge_interrupts();
+        (void)loop_analog_io_init(analog_notify);
+        report_changes(&before);
+
+        // Evaluate the initial loop states. The first state entry is a
+        // keyframe.
+        scheduler_post(SCHEDULER_EVENT_LOOP);
+        (void)scheduler_start_timer(KEYFRAME_TIMER, KEYFRAME_INTERVAL,
+                send_keyframe);
+        start_scan();
+        button_tick();
+        power_tick();
+        scheduler_run();
 }